@@ -39,6 +39,12 @@ const char kEnableDiscoverFeed[] = "enable-discover-feed";
 // Enables the upgrade sign-in promo.
 const char kEnableUpgradeSigninPromo[] = "enable-upgrade-signin-promo";
 
+// Enables the local collection of the stacks sampled on the main thread and of
+// the tasks it runs. They are written to profiler_trace.json in the cache
+// directory when the main thread freezes and recovers, and can be opened in
+// the Perfetto UI.
+const char kEnableLocalProfilerTrace[] = "enable-local-profiler-trace";
+
 // A string used to override the default user agent with a custom one.
 const char kUserAgent[] = "user-agent";
 
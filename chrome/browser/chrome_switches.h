@@ -17,6 +17,7 @@ extern const char kEnableSpotlightActions[];
 extern const char kEnableThirdPartyKeyboardWorkaround[];
 extern const char kEnableDiscoverFeed[];
 extern const char kEnableUpgradeSigninPromo[];
+extern const char kEnableLocalProfilerTrace[];
 
 extern const char kUserAgent[];
 
@@ -32,6 +32,7 @@
 #import "ios/chrome/browser/main/browser_list_factory.h"
 #include "ios/chrome/browser/sessions/ios_chrome_tab_restore_service_factory.h"
 #import "ios/chrome/browser/sessions/session_ios.h"
+#import "ios/chrome/browser/sessions/session_journal_ios.h"
 #import "ios/chrome/browser/sessions/session_restoration_browser_agent.h"
 #import "ios/chrome/browser/sessions/session_service_ios.h"
 #import "ios/chrome/browser/sessions/session_window_ios.h"
@@ -303,6 +304,11 @@ bool SessionCrashedInfoBarDelegate::ShouldExpire(
   NSFileManager* fileManager = [NSFileManager defaultManager];
   if (![fileManager fileExistsAtPath:sessionPath])
     return NO;
+  // The changes journaled since the session file was written go along with
+  // it. Once the session file is moved or deleted, the journal must not be
+  // left behind, or it would be replayed on the next launch.
+  NSString* journalPath =
+      [SessionJournalIOS journalPathForSessionPath:sessionPath];
   if (backupPath) {
     NSError* error = nil;
     BOOL fileOperationSuccess = [fileManager removeItemAtPath:backupPath
@@ -313,6 +319,10 @@ bool SessionCrashedInfoBarDelegate::ShouldExpire(
     if (!fileOperationSuccess && errorCode != NSFileNoSuchFileError) {
       return NO;
     }
+    NSString* backupJournalPath =
+        [SessionJournalIOS journalPathForSessionPath:backupPath];
+    [fileManager removeItemAtPath:backupJournalPath error:nil];
+
     // Create the backup directory, if it doesn't exist.
     NSString* directory = [backupPath stringByDeletingLastPathComponent];
     [fileManager createDirectoryAtPath:directory
@@ -329,6 +339,11 @@ bool SessionCrashedInfoBarDelegate::ShouldExpire(
     if (!fileOperationSuccess) {
       return NO;
     }
+    if ([fileManager fileExistsAtPath:journalPath]) {
+      [fileManager moveItemAtPath:journalPath
+                           toPath:backupJournalPath
+                            error:nil];
+    }
   } else {
     NSError* error;
     BOOL fileOperationSuccess = [fileManager removeItemAtPath:sessionPath
@@ -340,6 +355,8 @@ bool SessionCrashedInfoBarDelegate::ShouldExpire(
       return NO;
     }
   }
+  if ([fileManager fileExistsAtPath:journalPath])
+    [fileManager removeItemAtPath:journalPath error:nil];
   return YES;
 }
 
@@ -449,6 +466,15 @@ bool SessionCrashedInfoBarDelegate::ShouldExpire(
     [fileManager moveItemAtPath:backupPath
                          toPath:originalSessionPath
                           error:&error];
+    NSString* backupJournalPath =
+        [SessionJournalIOS journalPathForSessionPath:backupPath];
+    if ([fileManager fileExistsAtPath:backupJournalPath]) {
+      [fileManager
+          moveItemAtPath:backupJournalPath
+                  toPath:[SessionJournalIOS
+                             journalPathForSessionPath:originalSessionPath]
+                   error:&error];
+    }
 
     // Remove Parent directory for the backup path, so it doesn't show restore
     // prompt again.
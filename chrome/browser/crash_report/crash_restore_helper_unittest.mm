@@ -13,10 +13,12 @@
 #include "ios/chrome/browser/browser_state/chrome_browser_state.h"
 #include "ios/chrome/browser/browser_state/test_chrome_browser_state.h"
 #import "ios/chrome/browser/main/test_browser.h"
+#import "ios/chrome/browser/sessions/session_journal_ios.h"
 #import "ios/chrome/browser/sessions/session_service_ios.h"
 #include "ios/web/public/test/web_task_environment.h"
 #include "testing/gmock/include/gmock/gmock.h"
 #include "testing/gtest/include/gtest/gtest.h"
+#include "testing/gtest_mac.h"
 #include "testing/platform_test.h"
 #import "third_party/ocmock/OCMock/OCMock.h"
 #include "third_party/ocmock/gtest_support.h"
@@ -74,6 +76,51 @@ class CrashRestoreHelperTest : public PlatformTest {
     return true;
   }
 
+  // Creates a journal next to the session for |session_id| in every browser
+  // state. Returns |true| if the creation was successful.
+  bool CreateSessionJournal(NSString* session_id) {
+    NSFileManager* file_manager = [NSFileManager defaultManager];
+    ChromeBrowserState* browser_states[] = {
+        chrome_browser_state_.get(),
+        off_the_record_chrome_browser_state_,
+    };
+    NSData* data = [NSData dataWithBytes:"journal" length:7];
+    for (size_t index = 0; index < std::size(browser_states); ++index) {
+      NSString* session_path = [SessionServiceIOS
+          sessionPathForSessionID:session_id
+                        directory:browser_states[index]->GetStatePath()];
+      NSString* journal_path =
+          [SessionJournalIOS journalPathForSessionPath:session_path];
+      if (![file_manager createFileAtPath:journal_path
+                                 contents:data
+                               attributes:nil]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Returns |true| if the journal of the session for |session_id| was erased
+  // from its default location in every browser state.
+  bool IsSessionJournalErased(NSString* session_id) {
+    NSFileManager* file_manager = [NSFileManager defaultManager];
+    ChromeBrowserState* browser_states[] = {
+        chrome_browser_state_.get(),
+        off_the_record_chrome_browser_state_,
+    };
+    for (size_t index = 0; index < std::size(browser_states); ++index) {
+      NSString* session_path = [SessionServiceIOS
+          sessionPathForSessionID:session_id
+                        directory:browser_states[index]->GetStatePath()];
+      if ([file_manager
+              fileExistsAtPath:[SessionJournalIOS
+                                   journalPathForSessionPath:session_path]]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
   // Returns |true| if session for |session_id| was erased from its default
   // location. if |session_id| is nil, the default session location is used.
   bool IsSessionErased(NSString* session_id) {
@@ -133,4 +180,30 @@ TEST_F(CrashRestoreHelperTest, MoveAsideMultipleSessions) {
   }
 }
 
+// Tests that the session journals are moved aside with the sessions, so that
+// they are neither lost by the backup nor replayed on the next launch.
+TEST_F(CrashRestoreHelperTest, MoveAsideSessionsWithJournal) {
+  NSString* session_id = @"session_1";
+  ASSERT_TRUE(CreateSession(session_id));
+  ASSERT_TRUE(CreateSessionJournal(session_id));
+
+  [CrashRestoreHelper moveAsideSessions:[NSSet setWithObject:session_id]
+                        forBrowserState:chrome_browser_state_.get()];
+  EXPECT_TRUE(IsSessionErased(session_id));
+  EXPECT_TRUE(IsSessionJournalErased(session_id));
+
+  // Only the regular session is backed up, along with its journal.
+  NSString* backup_path = [CrashRestoreHelper
+      backupPathForSessionID:session_id
+                   directory:chrome_browser_state_->GetStatePath()];
+  NSString* backup_journal_path =
+      [SessionJournalIOS journalPathForSessionPath:backup_path];
+  NSFileManager* file_manager = [NSFileManager defaultManager];
+  EXPECT_NSEQ([NSData dataWithBytes:"journal" length:7],
+              [file_manager contentsAtPath:backup_journal_path]);
+  EXPECT_TRUE(CheckAndDeleteSessionBackedUp(session_id,
+                                            chrome_browser_state_.get()));
+  [file_manager removeItemAtPath:backup_journal_path error:nil];
+}
+
 }  // namespace
@@ -27,6 +27,10 @@
 // The result of the previous session. If this is true, the last time the
 // application was terminated, main thread was not responding.
 @property(nonatomic, readonly) BOOL lastSessionEndedFrozen;
+// Block called on the freeze detection queue when a freeze of the main thread
+// is detected, and when the main thread recovers from it. It runs before the
+// hang report is generated, so it must not block.
+@property(atomic, copy) ProceduralBlock freezeEventBlock;
 // Starts the watchdog of the main thread.
 - (void)start;
 // Stops the watchdog of the main thread.
@@ -71,6 +71,8 @@ bool IsMetricKitReport(crash_reporter::Report report) {
 - (void)runInMainLoop;
 // The callback that is called regularly on watchdog thread.
 - (void)runInFreezeDetectionQueue;
+// Calls |freezeEventBlock| if set. Called on watchdog thread.
+- (void)notifyFreezeEvent;
 // These 4 properties will be accessed from both thread. Make them atomic.
 // The date at which |runInMainLoop| was last called.
 @property(atomic) NSDate* lastSeenMainThread;
@@ -208,6 +210,7 @@ bool IsMetricKitReport(crash_reporter::Report report) {
         [[NSDate date] timeIntervalSinceDate:oldLastSeenMainThread]));
     // Restart the freeze detection.
     dispatch_async(_freezeDetectionQueue, ^{
+      [self notifyFreezeEvent];
       [self cleanAndRunInFreezeDetectionQueue];
     });
   }
@@ -237,6 +240,7 @@ bool IsMetricKitReport(crash_reporter::Report report) {
   }
   if ([[NSDate date] timeIntervalSinceDate:self.lastSeenMainThread] >
       self.delay) {
+    [self notifyFreezeEvent];
     if (crash_reporter::IsCrashpadRunning()) {
       const base::TimeTicks start = base::TimeTicks::Now();
       static crash_reporter::CrashKeyString<4> key("hang-report");
@@ -277,6 +281,13 @@ bool IsMetricKitReport(crash_reporter::Report report) {
       });
 }
 
+- (void)notifyFreezeEvent {
+  ProceduralBlock freezeEventBlock = self.freezeEventBlock;
+  if (freezeEventBlock) {
+    freezeEventBlock();
+  }
+}
+
 - (void)recordHangWithBreakpadRef:(BreakpadRef)breakpadRef {
   if (!self.running) {
     UMA_HISTOGRAM_ENUMERATION(
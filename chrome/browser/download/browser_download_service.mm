@@ -10,7 +10,6 @@
 #import "ios/chrome/browser/download/ar_quick_look_tab_helper.h"
 #include "ios/chrome/browser/download/download_manager_metric_names.h"
 #import "ios/chrome/browser/download/download_manager_tab_helper.h"
-#import "ios/chrome/browser/download/download_mimetype_util.h"
 #include "ios/chrome/browser/download/mime_type_util.h"
 #import "ios/chrome/browser/download/pass_kit_tab_helper.h"
 #import "ios/chrome/browser/download/safari_download_tab_helper.h"
@@ -52,32 +51,34 @@ void BrowserDownloadService::OnDownloadCreated(
     return;
   }
 
-  base::UmaHistogramEnumeration(
-      "Download.IOSDownloadMimeType",
-      GetDownloadMimeTypeResultFromMimeType(task->GetMimeType()));
+  const MimeTypeClassification classification =
+      ClassifyMimeType(task->GetMimeType());
+  base::UmaHistogramEnumeration("Download.IOSDownloadMimeType",
+                                classification.metric_bucket);
   base::UmaHistogramEnumeration("Download.IOSDownloadFileUI",
                                 DownloadFileUI::DownloadFilePresented,
                                 DownloadFileUI::Count);
 
-  if (task->GetMimeType() == kPkPassMimeType) {
+  if (classification.handler == DownloadMimeTypeHandler::kPassKit) {
     PassKitTabHelper* tab_helper = PassKitTabHelper::FromWebState(web_state);
     if (tab_helper)
       tab_helper->Download(std::move(task));
-  } else if (IsUsdzFileFormat(task->GetMimeType(), task->GenerateFileName()) &&
+  } else if ((classification.is_usdz ||
+              HasUsdzFileExtension(task->GenerateFileName())) &&
              !base::FeatureList::IsEnabled(kARKillSwitch)) {
     ARQuickLookTabHelper* tab_helper =
         ARQuickLookTabHelper::FromWebState(web_state);
     if (tab_helper)
       tab_helper->Download(std::move(task));
 
-  } else if (task->GetMimeType() == kMobileConfigurationType &&
+  } else if (classification.handler == DownloadMimeTypeHandler::kMobileConfig &&
              task->GetOriginalUrl().SchemeIsHTTPOrHTTPS()) {
     // SFSafariViewController can only open http and https URLs.
     SafariDownloadTabHelper* tab_helper =
         SafariDownloadTabHelper::FromWebState(web_state);
     if (tab_helper)
       tab_helper->DownloadMobileConfig(std::move(task));
-  } else if (task->GetMimeType() == kCalendarMimeType &&
+  } else if (classification.handler == DownloadMimeTypeHandler::kCalendar &&
              base::FeatureList::IsEnabled(kDownloadCalendar) &&
              task->GetOriginalUrl().SchemeIsHTTPOrHTTPS()) {
     // SFSafariViewController can only open http and https URLs.
@@ -85,7 +86,7 @@ void BrowserDownloadService::OnDownloadCreated(
         SafariDownloadTabHelper::FromWebState(web_state);
     if (tab_helper)
       tab_helper->DownloadCalendar(std::move(task));
-  } else if (task->GetMimeType() == kVcardMimeType &&
+  } else if (classification.handler == DownloadMimeTypeHandler::kVcard &&
              !base::FeatureList::IsEnabled(kVCardKillSwitch)) {
     VcardTabHelper* tab_helper = VcardTabHelper::FromWebState(web_state);
     if (tab_helper)
@@ -4,113 +4,385 @@
 
 #include "ios/chrome/browser/download/mime_type_util.h"
 
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <iterator>
+
 #include "base/files/file_path.h"
+#include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversions.h"
 
 // Extensions.
-char kUsdzFileExtension[] = ".usdz";
-char kRealityFileExtension[] = ".reality";
-
-// MIME types.
-char kMobileConfigurationType[] = "application/x-apple-aspen-config";
-char kPkPassMimeType[] = "application/vnd.apple.pkpass";
-char kVcardMimeType[] = "text/vcard";
-char kUsdzMimeType[] = "model/vnd.usdz+zip";
-char kLegacyUsdzMimeType[] = "model/usd";
-char kLegacyPixarUsdzMimeType[] = "model/vnd.pixar.usd";
-char kZipArchiveMimeType[] = "application/zip";
-char kMicrosoftApplicationMimeType[] = "application/x-msdownload";
-char kAndroidPackageArchiveMimeType[] =
+constexpr char kUsdzFileExtension[] = ".usdz";
+constexpr char kRealityFileExtension[] = ".reality";
+
+// MIME types. They are constexpr so that the classification table below can be
+// built and validated at compile time.
+constexpr char kMobileConfigurationType[] = "application/x-apple-aspen-config";
+constexpr char kPkPassMimeType[] = "application/vnd.apple.pkpass";
+constexpr char kVcardMimeType[] = "text/vcard";
+constexpr char kUsdzMimeType[] = "model/vnd.usdz+zip";
+constexpr char kLegacyUsdzMimeType[] = "model/usd";
+constexpr char kLegacyPixarUsdzMimeType[] = "model/vnd.pixar.usd";
+constexpr char kZipArchiveMimeType[] = "application/zip";
+constexpr char kMicrosoftApplicationMimeType[] = "application/x-msdownload";
+constexpr char kAndroidPackageArchiveMimeType[] =
     "application/vnd.android.package-archive";
-char kCalendarMimeType[] = "text/calendar";
-char kAppleDiskImageMimeType[] = "application/x-apple-diskimage";
-char kAppleInstallerPackageMimeType[] = "application/vnd.apple.installer+xml";
-char kSevenZipArchiveMimeType[] = "application/x-7z-compressed";
-char kRARArchiveMimeType[] = "application/x-rar-compressed";
-char kTarArchiveMimeType[] = "application/x-tar";
-char kAdobeFlashMimeType[] = "application/x-shockwave-flash";
-char kAmazonKindleBookMimeType[] = "application/vnd.amazon.ebook";
-char kBinaryDataMimeType[] = "application/octet-stream";
-char kBitTorrentMimeType[] = "application/x-bittorrent";
-char kJavaArchiveMimeType[] = "application/java-archive";
-char kAACAudioMimeType[] = "audio/aac";
-char kAbiWordDocumentMimeType[] = "application/x-abiword";
-char kArchiveDocumentMimeType[] = "application/x-freearc";
-char kAVIFImageMimeType[] = "image/avif";
-char kAVIVideoMimeType[] = "video/x-msvideo";
-char kGenericBitmapMimeType[] = "image/bmp";
-char kMicrosoftBitmapMimeType[] = "image/x-ms-bmp";
-char kBZipArchiveMimeType[] = "application/x-bzip";
-char kBZip2ArchiveMimeType[] = "application/x-bzip2";
-char kCDAudioMimeType[] = "application/x-cdf";
-char kCShellScriptMimeType[] = "application/x-csh";
-char kCascadingStyleSheetMimeType[] = "text/css";
-char kCommaSeparatedValuesMimeType[] = "text/csv";
-char kMicrosoftWordMimeType[] = "application/msword";
-char kMicrosoftWordXMLMimeType[] =
+constexpr char kCalendarMimeType[] = "text/calendar";
+constexpr char kAppleDiskImageMimeType[] = "application/x-apple-diskimage";
+constexpr char kAppleInstallerPackageMimeType[] =
+    "application/vnd.apple.installer+xml";
+constexpr char kSevenZipArchiveMimeType[] = "application/x-7z-compressed";
+constexpr char kRARArchiveMimeType[] = "application/x-rar-compressed";
+constexpr char kTarArchiveMimeType[] = "application/x-tar";
+constexpr char kAdobeFlashMimeType[] = "application/x-shockwave-flash";
+constexpr char kAmazonKindleBookMimeType[] = "application/vnd.amazon.ebook";
+constexpr char kBinaryDataMimeType[] = "application/octet-stream";
+constexpr char kBitTorrentMimeType[] = "application/x-bittorrent";
+constexpr char kJavaArchiveMimeType[] = "application/java-archive";
+constexpr char kAACAudioMimeType[] = "audio/aac";
+constexpr char kAbiWordDocumentMimeType[] = "application/x-abiword";
+constexpr char kArchiveDocumentMimeType[] = "application/x-freearc";
+constexpr char kAVIFImageMimeType[] = "image/avif";
+constexpr char kAVIVideoMimeType[] = "video/x-msvideo";
+constexpr char kGenericBitmapMimeType[] = "image/bmp";
+constexpr char kMicrosoftBitmapMimeType[] = "image/x-ms-bmp";
+constexpr char kBZipArchiveMimeType[] = "application/x-bzip";
+constexpr char kBZip2ArchiveMimeType[] = "application/x-bzip2";
+constexpr char kCDAudioMimeType[] = "application/x-cdf";
+constexpr char kCShellScriptMimeType[] = "application/x-csh";
+constexpr char kCascadingStyleSheetMimeType[] = "text/css";
+constexpr char kCommaSeparatedValuesMimeType[] = "text/csv";
+constexpr char kMicrosoftWordMimeType[] = "application/msword";
+constexpr char kMicrosoftWordXMLMimeType[] =
     "application/vnd.openxmlformats-officedocument.wordprocessingml.document";
-char kMSEmbeddedOpenTypefontMimeType[] = "application/vnd.ms-fontobject";
-char kElectronicPublicationMimeType[] = "application/epub+zip";
-char kGZipCompressedArchiveMimeType[] = "application/gzip";
-char kGraphicsInterchangeFormatMimeType[] = "image/gif";
-char kHyperTextMarkupLanguageMimeType[] = "text/html";
-char kIconFormatMimeType[] = "image/vnd.microsoft.icon";
-char kJPEGImageMimeType[] = "image/jpeg";
-char kJavaScriptMimeType[] = "text/javascript";
-char kJSONFormatMimeType[] = "application/json";
-char kJSONLDFormatMimeType[] = "application/ld+json";
-char kMusicalInstrumentDigitalInterfaceMimeType[] = "audio/midi";
-char kXMusicalInstrumentDigitalInterfaceMimeType[] = "audio/x-midi";
-char kMP3AudioMimeType[] = "audio/mpeg";
-char kMP4VideoMimeType[] = "video/mp4";
-char kMPEGVideoMimeType[] = "video/mpeg";
-char kOpenDocumentPresentationDocumentMimeType[] =
+constexpr char kMSEmbeddedOpenTypefontMimeType[] =
+    "application/vnd.ms-fontobject";
+constexpr char kElectronicPublicationMimeType[] = "application/epub+zip";
+constexpr char kGZipCompressedArchiveMimeType[] = "application/gzip";
+constexpr char kGraphicsInterchangeFormatMimeType[] = "image/gif";
+constexpr char kHyperTextMarkupLanguageMimeType[] = "text/html";
+constexpr char kIconFormatMimeType[] = "image/vnd.microsoft.icon";
+constexpr char kJPEGImageMimeType[] = "image/jpeg";
+constexpr char kJavaScriptMimeType[] = "text/javascript";
+constexpr char kJSONFormatMimeType[] = "application/json";
+constexpr char kJSONLDFormatMimeType[] = "application/ld+json";
+constexpr char kMusicalInstrumentDigitalInterfaceMimeType[] = "audio/midi";
+constexpr char kXMusicalInstrumentDigitalInterfaceMimeType[] = "audio/x-midi";
+constexpr char kMP3AudioMimeType[] = "audio/mpeg";
+constexpr char kMP4VideoMimeType[] = "video/mp4";
+constexpr char kMPEGVideoMimeType[] = "video/mpeg";
+constexpr char kOpenDocumentPresentationDocumentMimeType[] =
     "application/vnd.oasis.opendocument.presentation";
-char kOpenDocumentSpreadsheetDocumentMimeType[] =
+constexpr char kOpenDocumentSpreadsheetDocumentMimeType[] =
     "application/vnd.oasis.opendocument.spreadsheet";
-char kOpenDocumentTextDocumentMimeType[] =
+constexpr char kOpenDocumentTextDocumentMimeType[] =
     "application/vnd.oasis.opendocument.text";
-char kOGGAudioMimeType[] = "audio/ogg";
-char kOGGVideoMimeType[] = "video/ogg";
-char kOGGMimeType[] = "application/ogg";
-char kOpusAudioMimeType[] = "audio/opus";
-char kOpenTypeFontMimeType[] = "font/otf";
-char kPortableNetworkGraphicMimeType[] = "image/png";
-char kAdobePortableDocumentFormatMimeType[] = "application/pdf";
-char kHypertextPreprocessorMimeType[] = "application/x-httpd-php";
-char kMicrosoftPowerPointMimeType[] = "application/vnd.ms-powerpoint";
-char kMicrosoftPowerPointOpenXMLMimeType[] =
+constexpr char kOGGAudioMimeType[] = "audio/ogg";
+constexpr char kOGGVideoMimeType[] = "video/ogg";
+constexpr char kOGGMimeType[] = "application/ogg";
+constexpr char kOpusAudioMimeType[] = "audio/opus";
+constexpr char kOpenTypeFontMimeType[] = "font/otf";
+constexpr char kPortableNetworkGraphicMimeType[] = "image/png";
+constexpr char kAdobePortableDocumentFormatMimeType[] = "application/pdf";
+constexpr char kHypertextPreprocessorMimeType[] = "application/x-httpd-php";
+constexpr char kMicrosoftPowerPointMimeType[] = "application/vnd.ms-powerpoint";
+constexpr char kMicrosoftPowerPointOpenXMLMimeType[] =
     "application/vnd.openxmlformats-officedocument.presentationml.presentation";
-char kRARArchiveVNDMimeType[] = "application/vnd.rar";
-char kRichTextFormatMimeType[] = "application/rtf";
-char kBourneShellScriptMimeType[] = "application/x-sh";
-char kScalableVectorGraphicMimeType[] = "image/svg+xml";
-char kTaggedImageFileFormatMimeType[] = "image/tiff";
-char kMPEGTransportStreamMimeType[] = "video/mp2t";
-char kTrueTypeFontMimeType[] = "font/ttf";
-char kTextMimeType[] = "text/plain";
-char kMicrosoftVisioMimeType[] = "application/vnd.visio";
-char kWaveformAudioFormatMimeType[] = "audio/wav";
-char kWEBMAudioMimeType[] = "audio/webm";
-char kWEBMVideoMimeType[] = "video/webm";
-char kWEBPImageMimeType[] = "image/webp";
-char kWebOpenFontMimeType[] = "font/woff";
-char kWebOpenFont2MimeType[] = "font/woff2";
-char kXHTMLMimeType[] = "application/xhtml+xml";
-char kMicrosoftExcelMimeType[] = "application/vnd.ms-excel";
-char kMicrosoftExcelOpenXMLMimeType[] =
+constexpr char kRARArchiveVNDMimeType[] = "application/vnd.rar";
+constexpr char kRichTextFormatMimeType[] = "application/rtf";
+constexpr char kBourneShellScriptMimeType[] = "application/x-sh";
+constexpr char kScalableVectorGraphicMimeType[] = "image/svg+xml";
+constexpr char kTaggedImageFileFormatMimeType[] = "image/tiff";
+constexpr char kMPEGTransportStreamMimeType[] = "video/mp2t";
+constexpr char kTrueTypeFontMimeType[] = "font/ttf";
+constexpr char kTextMimeType[] = "text/plain";
+constexpr char kMicrosoftVisioMimeType[] = "application/vnd.visio";
+constexpr char kWaveformAudioFormatMimeType[] = "audio/wav";
+constexpr char kWEBMAudioMimeType[] = "audio/webm";
+constexpr char kWEBMVideoMimeType[] = "video/webm";
+constexpr char kWEBPImageMimeType[] = "image/webp";
+constexpr char kWebOpenFontMimeType[] = "font/woff";
+constexpr char kWebOpenFont2MimeType[] = "font/woff2";
+constexpr char kXHTMLMimeType[] = "application/xhtml+xml";
+constexpr char kMicrosoftExcelMimeType[] = "application/vnd.ms-excel";
+constexpr char kMicrosoftExcelOpenXMLMimeType[] =
     "application/vnd.openxmlformats-officedocument.spreadsheetml.sheet";
-char kXMLMimeType[] = "application/xml";
-char kXULMimeType[] = "application/vnd.mozilla.xul+xml";
-char k3GPPVideoMimeType[] = "video/3gpp";
-char k3GPPAudioMimeType[] = "audio/3gpp";
-char k3GPP2VideoMimeType[] = "video/3gpp2";
-char k3GPP2AudioMimeType[] = "audio/3gpp2";
+constexpr char kXMLMimeType[] = "application/xml";
+constexpr char kXULMimeType[] = "application/vnd.mozilla.xul+xml";
+constexpr char k3GPPVideoMimeType[] = "video/3gpp";
+constexpr char k3GPPAudioMimeType[] = "audio/3gpp";
+constexpr char k3GPP2VideoMimeType[] = "video/3gpp2";
+constexpr char k3GPP2AudioMimeType[] = "audio/3gpp2";
+
+namespace {
+
+using Handler = DownloadMimeTypeHandler;
+using Result = DownloadMimeTypeResult;
+
+// Entry of the MIME type classification table.
+struct MimeTypeEntry {
+  const char* mime_type;
+  MimeTypeClassification classification;
+};
+
+// Returns the entry classifying `mime_type` in the `metric_bucket` and
+// presented by `handler`.
+constexpr MimeTypeEntry Entry(const char* mime_type,
+                              Result metric_bucket,
+                              Handler handler = Handler::kDownloadManager) {
+  return {mime_type,
+          {metric_bucket, handler, handler == Handler::kARQuickLook}};
+}
+
+// The classification of the known MIME types. The MIME types must be
+// normalized (lowercase, without parameters) and unique, which is checked at
+// compile time.
+constexpr MimeTypeEntry kMimeTypeEntries[] = {
+    Entry(kPkPassMimeType, Result::PkPass, Handler::kPassKit),
+    Entry(kZipArchiveMimeType, Result::ZipArchive),
+    Entry(kMobileConfigurationType,
+          Result::iOSMobileConfig, Handler::kMobileConfig),
+    Entry(kMicrosoftApplicationMimeType, Result::MicrosoftApplication),
+    Entry(kAndroidPackageArchiveMimeType, Result::AndroidPackageArchive),
+    Entry(kVcardMimeType, Result::VirtualContactFile, Handler::kVcard),
+    Entry(kCalendarMimeType, Result::Calendar, Handler::kCalendar),
+    Entry(kLegacyUsdzMimeType,
+          Result::LegacyUniversalSceneDescription, Handler::kARQuickLook),
+    Entry(kAppleDiskImageMimeType, Result::AppleDiskImage),
+    Entry(kAppleInstallerPackageMimeType, Result::AppleInstallerPackage),
+    Entry(kSevenZipArchiveMimeType, Result::SevenZipArchive),
+    Entry(kRARArchiveMimeType, Result::RARArchive),
+    Entry(kTarArchiveMimeType, Result::TarArchive),
+    Entry(kAdobeFlashMimeType, Result::AdobeFlash),
+    Entry(kAmazonKindleBookMimeType, Result::AmazonKindleBook),
+    Entry(kBinaryDataMimeType, Result::BinaryData),
+    Entry(kBitTorrentMimeType, Result::BitTorrent),
+    Entry(kJavaArchiveMimeType, Result::JavaArchive),
+    Entry(kLegacyPixarUsdzMimeType,
+          Result::LegacyPixarUniversalSceneDescription, Handler::kARQuickLook),
+    Entry(kUsdzMimeType,
+          Result::UniversalSceneDescription, Handler::kARQuickLook),
+    Entry(kAACAudioMimeType, Result::AACAudio),
+    Entry(kAbiWordDocumentMimeType, Result::AbiWordDocument),
+    Entry(kArchiveDocumentMimeType, Result::ArchiveDocument),
+    Entry(kAVIFImageMimeType, Result::AVIFImage),
+    Entry(kAVIVideoMimeType, Result::AVIVideo),
+    Entry(kGenericBitmapMimeType, Result::GenericBitmap),
+    Entry(kMicrosoftBitmapMimeType, Result::MicrosoftBitmap),
+    Entry(kBZip2ArchiveMimeType, Result::BZip2Archive),
+    Entry(kCDAudioMimeType, Result::CDAudio),
+    Entry(kCShellScriptMimeType, Result::CShellScript),
+    Entry(kCascadingStyleSheetMimeType, Result::CascadingStyleSheet),
+    Entry(kCommaSeparatedValuesMimeType, Result::CommaSeparatedValues),
+    Entry(kMicrosoftWordMimeType, Result::MicrosoftWord),
+    Entry(kMicrosoftWordXMLMimeType, Result::MicrosoftWordXML),
+    Entry(kMSEmbeddedOpenTypefontMimeType, Result::MSEmbeddedOpenTypefont),
+    Entry(kElectronicPublicationMimeType, Result::ElectronicPublication),
+    Entry(kGZipCompressedArchiveMimeType, Result::GZipCompressedArchive),
+    Entry(kGraphicsInterchangeFormatMimeType,
+          Result::GraphicsInterchangeFormat),
+    Entry(kHyperTextMarkupLanguageMimeType, Result::HyperTextMarkupLanguage),
+    Entry(kIconFormatMimeType, Result::IconFormat),
+    Entry(kJPEGImageMimeType, Result::JPEGImage),
+    Entry(kJavaScriptMimeType, Result::JavaScript),
+    Entry(kJSONFormatMimeType, Result::JSONFormat),
+    Entry(kJSONLDFormatMimeType, Result::JSONLDFormat),
+    Entry(kMusicalInstrumentDigitalInterfaceMimeType,
+          Result::MusicalInstrumentDigitalInterface),
+    Entry(kXMusicalInstrumentDigitalInterfaceMimeType,
+          Result::XMusicalInstrumentDigitalInterface),
+    Entry(kMP3AudioMimeType, Result::MP3Audio),
+    Entry(kMP4VideoMimeType, Result::MP4Video),
+    Entry(kMPEGVideoMimeType, Result::MPEGVideo),
+    Entry(kOpenDocumentPresentationDocumentMimeType,
+          Result::OpenDocumentPresentationDocument),
+    Entry(kOpenDocumentSpreadsheetDocumentMimeType,
+          Result::OpenDocumentSpreadsheetDocument),
+    Entry(kOpenDocumentTextDocumentMimeType, Result::OpenDocumentTextDocument),
+    Entry(kOGGAudioMimeType, Result::OGGAudio),
+    Entry(kOGGVideoMimeType, Result::OGGVideo),
+    Entry(kOGGMimeType, Result::OGG),
+    Entry(kOpusAudioMimeType, Result::OpusAudio),
+    Entry(kOpenTypeFontMimeType, Result::OpenTypeFont),
+    Entry(kPortableNetworkGraphicMimeType, Result::PortableNetworkGraphic),
+    Entry(kAdobePortableDocumentFormatMimeType,
+          Result::AdobePortableDocumentFormat),
+    Entry(kHypertextPreprocessorMimeType, Result::HypertextPreprocessor),
+    Entry(kMicrosoftPowerPointMimeType, Result::MicrosoftPowerPoint),
+    Entry(kMicrosoftPowerPointOpenXMLMimeType,
+          Result::MicrosoftPowerPointOpenXML),
+    Entry(kRARArchiveVNDMimeType, Result::RARArchiveVND),
+    Entry(kRichTextFormatMimeType, Result::RichTextFormat),
+    Entry(kBourneShellScriptMimeType, Result::BourneShellScript),
+    Entry(kScalableVectorGraphicMimeType, Result::ScalableVectorGraphic),
+    Entry(kTaggedImageFileFormatMimeType, Result::TaggedImageFileFormat),
+    Entry(kMPEGTransportStreamMimeType, Result::MPEGTransportStream),
+    Entry(kTrueTypeFontMimeType, Result::TrueTypeFont),
+    Entry(kTextMimeType, Result::Text),
+    Entry(kMicrosoftVisioMimeType, Result::MicrosoftVisio),
+    Entry(kWaveformAudioFormatMimeType, Result::WaveformAudioFormat),
+    Entry(kWEBMAudioMimeType, Result::WEBMAudio),
+    Entry(kWEBMVideoMimeType, Result::WEBMVideo),
+    Entry(kWEBPImageMimeType, Result::WEBPImage),
+    Entry(kWebOpenFontMimeType, Result::WebOpenFont),
+    Entry(kWebOpenFont2MimeType, Result::WebOpenFont2),
+    Entry(kXHTMLMimeType, Result::XHTML),
+    Entry(kMicrosoftExcelMimeType, Result::MicrosoftExcel),
+    Entry(kMicrosoftExcelOpenXMLMimeType, Result::MicrosoftExcelOpenXML),
+    Entry(kXMLMimeType, Result::XML),
+    Entry(kXULMimeType, Result::XUL),
+    Entry(k3GPPVideoMimeType, Result::k3GPPVideo),
+    Entry(k3GPPAudioMimeType, Result::k3GPPAudio),
+    Entry(k3GPP2VideoMimeType, Result::k3GPP2Video),
+    Entry(k3GPP2AudioMimeType, Result::k3GPP2Audio),
+};
+
+// Classification of the MIME types missing from kMimeTypeEntries.
+constexpr MimeTypeClassification kOtherClassification =
+    Entry("", Result::Other).classification;
+
+// Returns `c` lowercased, for ASCII characters.
+constexpr char ToLower(char c) {
+  return c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c;
+}
+
+// Returns the FNV-1a hash of `mime_type` lowercased, salted with `seed`.
+constexpr uint32_t HashMimeType(base::StringPiece mime_type, uint32_t seed) {
+  uint32_t hash = 2166136261u ^ seed;
+  for (char c : mime_type) {
+    hash ^= static_cast<uint8_t>(ToLower(c));
+    hash *= 16777619u;
+  }
+  return hash ^ (hash >> 16);
+}
+
+// Returns whether `a` and `b` are equal, ignoring the case.
+constexpr bool EqualsIgnoringCase(base::StringPiece a, base::StringPiece b) {
+  if (a.size() != b.size())
+    return false;
+  for (size_t i = 0; i < a.size(); ++i) {
+    if (ToLower(a[i]) != ToLower(b[i]))
+      return false;
+  }
+  return true;
+}
+
+// Returns whether all the MIME types of kMimeTypeEntries are normalized.
+constexpr bool AreMimeTypesNormalized() {
+  for (const MimeTypeEntry& entry : kMimeTypeEntries) {
+    const base::StringPiece mime_type(entry.mime_type);
+    if (mime_type.empty())
+      return false;
+    for (char c : mime_type) {
+      if (c != ToLower(c) || c == ';' || c == ' ')
+        return false;
+    }
+  }
+  return true;
+}
+
+// Returns whether a MIME type is listed several times in kMimeTypeEntries.
+constexpr bool HasDuplicateMimeTypes() {
+  for (size_t i = 0; i < std::size(kMimeTypeEntries); ++i) {
+    for (size_t j = i + 1; j < std::size(kMimeTypeEntries); ++j) {
+      if (EqualsIgnoringCase(kMimeTypeEntries[i].mime_type,
+                             kMimeTypeEntries[j].mime_type)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+static_assert(AreMimeTypesNormalized(),
+              "MIME types must be lowercase and without parameters");
+static_assert(!HasDuplicateMimeTypes(), "MIME types must be unique");
+
+// Size of the perfect hash table. Its load factor must be low enough for a
+// seed without collisions to be found quickly at compile time.
+constexpr size_t kSlotCount = 4096;
+static_assert((kSlotCount & (kSlotCount - 1)) == 0,
+              "kSlotCount must be a power of 2");
+
+// Maximum number of seeds tried to build the perfect hash table.
+constexpr uint32_t kMaxSeedCount = 64;
+
+// Value of the slots of the perfect hash table not used by any MIME type.
+constexpr uint8_t kEmptySlot = UINT8_MAX;
+static_assert(std::size(kMimeTypeEntries) < kEmptySlot,
+              "The perfect hash table can't index all the MIME types");
+
+// Perfect hash table of kMimeTypeEntries: the slot of each MIME type, selected
+// by its hash salted with `seed`, holds its index in kMimeTypeEntries.
+struct PerfectHashTable {
+  uint32_t seed = 0;
+  bool valid = false;
+  std::array<uint8_t, kSlotCount> slots = {};
+};
+
+// Returns the slot of `mime_type` in a PerfectHashTable built with `seed`.
+constexpr size_t GetSlot(base::StringPiece mime_type, uint32_t seed) {
+  return HashMimeType(mime_type, seed) & (kSlotCount - 1);
+}
+
+// Returns the perfect hash table of kMimeTypeEntries for the first seed that
+// does not cause collisions, or an invalid table if there is none.
+constexpr PerfectHashTable BuildPerfectHashTable() {
+  for (uint32_t seed = 0; seed < kMaxSeedCount; ++seed) {
+    PerfectHashTable table;
+    table.seed = seed;
+    for (uint8_t& slot : table.slots)
+      slot = kEmptySlot;
+
+    bool has_collision = false;
+    for (size_t i = 0; i < std::size(kMimeTypeEntries); ++i) {
+      const size_t index = GetSlot(kMimeTypeEntries[i].mime_type, seed);
+      uint8_t& slot = table.slots[index];
+      if (slot != kEmptySlot) {
+        has_collision = true;
+        break;
+      }
+      slot = static_cast<uint8_t>(i);
+    }
+
+    if (!has_collision) {
+      table.valid = true;
+      return table;
+    }
+  }
+  return PerfectHashTable();
+}
+
+constexpr PerfectHashTable kPerfectHashTable = BuildPerfectHashTable();
+static_assert(kPerfectHashTable.valid,
+              "No perfect hash found, increase kSlotCount or kMaxSeedCount");
+
+}  // namespace
+
+MimeTypeClassification ClassifyMimeType(base::StringPiece mime_type) {
+  // Drop the parameters, e.g. "; charset=utf-8".
+  mime_type = mime_type.substr(0, mime_type.find(';'));
+  mime_type = base::TrimWhitespaceASCII(mime_type, base::TRIM_ALL);
+
+  const uint8_t index =
+      kPerfectHashTable.slots[GetSlot(mime_type, kPerfectHashTable.seed)];
+  if (index == kEmptySlot ||
+      !EqualsIgnoringCase(mime_type, kMimeTypeEntries[index].mime_type)) {
+    return kOtherClassification;
+  }
+  return kMimeTypeEntries[index].classification;
+}
+
+bool HasUsdzFileExtension(const base::FilePath& suggested_path) {
+  return suggested_path.MatchesExtension(kUsdzFileExtension) ||
+         suggested_path.MatchesExtension(kRealityFileExtension);
+}
 
 bool IsUsdzFileFormat(const std::string& mime_type,
                       const base::FilePath& suggested_path) {
-  return mime_type == kUsdzMimeType || mime_type == kLegacyUsdzMimeType ||
-         mime_type == kLegacyPixarUsdzMimeType ||
-         suggested_path.MatchesExtension(kUsdzFileExtension) ||
-         suggested_path.MatchesExtension(kRealityFileExtension);
+  return ClassifyMimeType(mime_type).is_usdz ||
+         HasUsdzFileExtension(suggested_path);
 }
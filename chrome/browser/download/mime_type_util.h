@@ -7,135 +7,175 @@
 
 #include <string>
 
+#include "base/strings/string_piece.h"
+#include "ios/chrome/browser/download/download_mimetype_util.h"
+
 namespace base {
 class FilePath;
 }
 
 // MIME type for iOS configuration file.
-extern char kMobileConfigurationType[];
+extern const char kMobileConfigurationType[];
 
 // MIME type for Virtual Contact File.
-extern char kVcardMimeType[];
+extern const char kVcardMimeType[];
 
 // MIME type for pass data.
-extern char kPkPassMimeType[];
+extern const char kPkPassMimeType[];
 
 // MIME Type for 3D models.
-extern char kUsdzMimeType[];
+extern const char kUsdzMimeType[];
 
 // MIME Type for ZIP archive.
-extern char kZipArchiveMimeType[];
+extern const char kZipArchiveMimeType[];
 
 // MIME Type for Microsoft application.
-extern char kMicrosoftApplicationMimeType[];
+extern const char kMicrosoftApplicationMimeType[];
 
 // MIME Type for Android package archive.
-extern char kAndroidPackageArchiveMimeType[];
+extern const char kAndroidPackageArchiveMimeType[];
 
 // MIME Type for Calendar.
-extern char kCalendarMimeType[];
+extern const char kCalendarMimeType[];
 
 // MIME Type for Apple disk image.
-extern char kAppleDiskImageMimeType[];
+extern const char kAppleDiskImageMimeType[];
 
 // MIME Type for Apple installer package.
-extern char kAppleInstallerPackageMimeType[];
+extern const char kAppleInstallerPackageMimeType[];
 
 // MIME Type for 7z archive.
-extern char kSevenZipArchiveMimeType[];
+extern const char kSevenZipArchiveMimeType[];
 
 // MIME Type for RAR archive.
-extern char kRARArchiveMimeType[];
+extern const char kRARArchiveMimeType[];
 
 // MIME Type for TAR archive.
-extern char kTarArchiveMimeType[];
+extern const char kTarArchiveMimeType[];
 
 // MIME Type for Adobe Flash.
-extern char kAdobeFlashMimeType[];
+extern const char kAdobeFlashMimeType[];
 
 // MIME Type for Amazon kindle book.
-extern char kAmazonKindleBookMimeType[];
+extern const char kAmazonKindleBookMimeType[];
 
 // MIME Type for binary data.
-extern char kBinaryDataMimeType[];
+extern const char kBinaryDataMimeType[];
 
 // MIME Type for BitTorrent.
-extern char kBitTorrentMimeType[];
+extern const char kBitTorrentMimeType[];
 
 // MIME Type for Java archive.
-extern char kJavaArchiveMimeType[];
+extern const char kJavaArchiveMimeType[];
 
 // Legacy USDZ content types.
-extern char kLegacyUsdzMimeType[];
-extern char kLegacyPixarUsdzMimeType[];
+extern const char kLegacyUsdzMimeType[];
+extern const char kLegacyPixarUsdzMimeType[];
 
 // MIME Types that don't have specific treatment.
-extern char kAACAudioMimeType[];
-extern char kAbiWordDocumentMimeType[];
-extern char kArchiveDocumentMimeType[];
-extern char kAVIFImageMimeType[];
-extern char kAVIVideoMimeType[];
-extern char kGenericBitmapMimeType[];
-extern char kMicrosoftBitmapMimeType[];
-extern char kBZip2ArchiveMimeType[];
-extern char kCDAudioMimeType[];
-extern char kCShellScriptMimeType[];
-extern char kCascadingStyleSheetMimeType[];
-extern char kCommaSeparatedValuesMimeType[];
-extern char kMicrosoftWordMimeType[];
-extern char kMicrosoftWordXMLMimeType[];
-extern char kMSEmbeddedOpenTypefontMimeType[];
-extern char kElectronicPublicationMimeType[];
-extern char kGZipCompressedArchiveMimeType[];
-extern char kGraphicsInterchangeFormatMimeType[];
-extern char kHyperTextMarkupLanguageMimeType[];
-extern char kIconFormatMimeType[];
-extern char kJPEGImageMimeType[];
-extern char kJavaScriptMimeType[];
-extern char kJSONFormatMimeType[];
-extern char kJSONLDFormatMimeType[];
-extern char kMusicalInstrumentDigitalInterfaceMimeType[];
-extern char kXMusicalInstrumentDigitalInterfaceMimeType[];
-extern char kMP3AudioMimeType[];
-extern char kMP4VideoMimeType[];
-extern char kMPEGVideoMimeType[];
-extern char kOpenDocumentPresentationDocumentMimeType[];
-extern char kOpenDocumentSpreadsheetDocumentMimeType[];
-extern char kOpenDocumentTextDocumentMimeType[];
-extern char kOGGAudioMimeType[];
-extern char kOGGVideoMimeType[];
-extern char kOGGMimeType[];
-extern char kOpusAudioMimeType[];
-extern char kOpenTypeFontMimeType[];
-extern char kPortableNetworkGraphicMimeType[];
-extern char kAdobePortableDocumentFormatMimeType[];
-extern char kHypertextPreprocessorMimeType[];
-extern char kMicrosoftPowerPointMimeType[];
-extern char kMicrosoftPowerPointOpenXMLMimeType[];
-extern char kRARArchiveVNDMimeType[];
-extern char kRichTextFormatMimeType[];
-extern char kBourneShellScriptMimeType[];
-extern char kScalableVectorGraphicMimeType[];
-extern char kTaggedImageFileFormatMimeType[];
-extern char kMPEGTransportStreamMimeType[];
-extern char kTrueTypeFontMimeType[];
-extern char kTextMimeType[];
-extern char kMicrosoftVisioMimeType[];
-extern char kWaveformAudioFormatMimeType[];
-extern char kWEBMAudioMimeType[];
-extern char kWEBMVideoMimeType[];
-extern char kWEBPImageMimeType[];
-extern char kWebOpenFontMimeType[];
-extern char kWebOpenFont2MimeType[];
-extern char kXHTMLMimeType[];
-extern char kMicrosoftExcelMimeType[];
-extern char kMicrosoftExcelOpenXMLMimeType[];
-extern char kXMLMimeType[];
-extern char kXULMimeType[];
-extern char k3GPPVideoMimeType[];
-extern char k3GPPAudioMimeType[];
-extern char k3GPP2VideoMimeType[];
-extern char k3GPP2AudioMimeType[];
+extern const char kAACAudioMimeType[];
+extern const char kAbiWordDocumentMimeType[];
+extern const char kArchiveDocumentMimeType[];
+extern const char kAVIFImageMimeType[];
+extern const char kAVIVideoMimeType[];
+extern const char kGenericBitmapMimeType[];
+extern const char kMicrosoftBitmapMimeType[];
+extern const char kBZipArchiveMimeType[];
+extern const char kBZip2ArchiveMimeType[];
+extern const char kCDAudioMimeType[];
+extern const char kCShellScriptMimeType[];
+extern const char kCascadingStyleSheetMimeType[];
+extern const char kCommaSeparatedValuesMimeType[];
+extern const char kMicrosoftWordMimeType[];
+extern const char kMicrosoftWordXMLMimeType[];
+extern const char kMSEmbeddedOpenTypefontMimeType[];
+extern const char kElectronicPublicationMimeType[];
+extern const char kGZipCompressedArchiveMimeType[];
+extern const char kGraphicsInterchangeFormatMimeType[];
+extern const char kHyperTextMarkupLanguageMimeType[];
+extern const char kIconFormatMimeType[];
+extern const char kJPEGImageMimeType[];
+extern const char kJavaScriptMimeType[];
+extern const char kJSONFormatMimeType[];
+extern const char kJSONLDFormatMimeType[];
+extern const char kMusicalInstrumentDigitalInterfaceMimeType[];
+extern const char kXMusicalInstrumentDigitalInterfaceMimeType[];
+extern const char kMP3AudioMimeType[];
+extern const char kMP4VideoMimeType[];
+extern const char kMPEGVideoMimeType[];
+extern const char kOpenDocumentPresentationDocumentMimeType[];
+extern const char kOpenDocumentSpreadsheetDocumentMimeType[];
+extern const char kOpenDocumentTextDocumentMimeType[];
+extern const char kOGGAudioMimeType[];
+extern const char kOGGVideoMimeType[];
+extern const char kOGGMimeType[];
+extern const char kOpusAudioMimeType[];
+extern const char kOpenTypeFontMimeType[];
+extern const char kPortableNetworkGraphicMimeType[];
+extern const char kAdobePortableDocumentFormatMimeType[];
+extern const char kHypertextPreprocessorMimeType[];
+extern const char kMicrosoftPowerPointMimeType[];
+extern const char kMicrosoftPowerPointOpenXMLMimeType[];
+extern const char kRARArchiveVNDMimeType[];
+extern const char kRichTextFormatMimeType[];
+extern const char kBourneShellScriptMimeType[];
+extern const char kScalableVectorGraphicMimeType[];
+extern const char kTaggedImageFileFormatMimeType[];
+extern const char kMPEGTransportStreamMimeType[];
+extern const char kTrueTypeFontMimeType[];
+extern const char kTextMimeType[];
+extern const char kMicrosoftVisioMimeType[];
+extern const char kWaveformAudioFormatMimeType[];
+extern const char kWEBMAudioMimeType[];
+extern const char kWEBMVideoMimeType[];
+extern const char kWEBPImageMimeType[];
+extern const char kWebOpenFontMimeType[];
+extern const char kWebOpenFont2MimeType[];
+extern const char kXHTMLMimeType[];
+extern const char kMicrosoftExcelMimeType[];
+extern const char kMicrosoftExcelOpenXMLMimeType[];
+extern const char kXMLMimeType[];
+extern const char kXULMimeType[];
+extern const char k3GPPVideoMimeType[];
+extern const char k3GPPAudioMimeType[];
+extern const char k3GPP2VideoMimeType[];
+extern const char k3GPP2AudioMimeType[];
+
+// Kind of UI presenting a download, selected from its MIME type.
+enum class DownloadMimeTypeHandler {
+  // Download manager UI, used by default.
+  kDownloadManager,
+  // PassKit UI for passes.
+  kPassKit,
+  // AR Quick Look for USDZ 3D models.
+  kARQuickLook,
+  // SFSafariViewController for iOS configuration files.
+  kMobileConfig,
+  // SFSafariViewController for calendars.
+  kCalendar,
+  // Contacts UI for Virtual Contact Files.
+  kVcard,
+};
+
+// Classification of a MIME type for the handling and metrics of downloads.
+struct MimeTypeClassification {
+  // Bucket of the Download.IOSDownloadMimeType histogram.
+  DownloadMimeTypeResult metric_bucket;
+  // UI presenting the download, before checking the features enabled.
+  DownloadMimeTypeHandler handler;
+  // Whether the MIME type is the one of a USDZ 3D model.
+  bool is_usdz;
+};
+
+// Returns the classification of `mime_type`, ignoring case, parameters and
+// surrounding whitespace (e.g. "Text/Calendar; charset=utf-8" is classified as
+// kCalendarMimeType). Unknown MIME types are classified as
+// DownloadMimeTypeResult::Other, presented by the download manager.
+MimeTypeClassification ClassifyMimeType(base::StringPiece mime_type);
+
+// Returns whether the file extension of `suggested_filename` is the one of a
+// USDZ 3D model.
+bool HasUsdzFileExtension(const base::FilePath& suggested_filename);
 
 // Returns whether the content-type or the file extension match those of a USDZ
 // 3D model. The file extension is checked in addition to the content-type since
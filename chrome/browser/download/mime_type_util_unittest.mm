@@ -0,0 +1,72 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ios/chrome/browser/download/mime_type_util.h"
+
+#include "base/files/file_path.h"
+#import "ios/chrome/browser/download/download_mimetype_util.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/platform_test.h"
+
+#if !defined(__has_feature) || !__has_feature(objc_arc)
+#error "This file requires ARC support."
+#endif
+
+using MimeTypeUtilTest = PlatformTest;
+
+// Tests the classification of MIME types with a dedicated handler.
+TEST_F(MimeTypeUtilTest, ClassifyHandledMimeTypes) {
+  MimeTypeClassification classification = ClassifyMimeType(kPkPassMimeType);
+  EXPECT_EQ(DownloadMimeTypeResult::PkPass, classification.metric_bucket);
+  EXPECT_EQ(DownloadMimeTypeHandler::kPassKit, classification.handler);
+  EXPECT_FALSE(classification.is_usdz);
+
+  classification = ClassifyMimeType(kVcardMimeType);
+  EXPECT_EQ(DownloadMimeTypeResult::VirtualContactFile,
+            classification.metric_bucket);
+  EXPECT_EQ(DownloadMimeTypeHandler::kVcard, classification.handler);
+
+  for (const char* mime_type :
+       {kUsdzMimeType, kLegacyUsdzMimeType, kLegacyPixarUsdzMimeType}) {
+    classification = ClassifyMimeType(mime_type);
+    EXPECT_EQ(DownloadMimeTypeHandler::kARQuickLook, classification.handler);
+    EXPECT_TRUE(classification.is_usdz);
+  }
+}
+
+// Tests that the case, parameters and surrounding whitespace are ignored.
+TEST_F(MimeTypeUtilTest, ClassifyNonNormalizedMimeTypes) {
+  EXPECT_EQ(DownloadMimeTypeHandler::kCalendar,
+            ClassifyMimeType("Text/Calendar; charset=utf-8").handler);
+  EXPECT_EQ(DownloadMimeTypeResult::AdobePortableDocumentFormat,
+            ClassifyMimeType(" APPLICATION/PDF ").metric_bucket);
+  EXPECT_TRUE(ClassifyMimeType("model/VND.USDZ+ZIP;foo").is_usdz);
+}
+
+// Tests that unknown MIME types are presented by the download manager.
+TEST_F(MimeTypeUtilTest, ClassifyUnknownMimeTypes) {
+  for (const char* mime_type : {"", ";", "application/foo", "text/vcards"}) {
+    const MimeTypeClassification classification = ClassifyMimeType(mime_type);
+    EXPECT_EQ(DownloadMimeTypeResult::Other, classification.metric_bucket);
+    EXPECT_EQ(DownloadMimeTypeHandler::kDownloadManager,
+              classification.handler);
+    EXPECT_FALSE(classification.is_usdz);
+  }
+}
+
+// Tests that 3GPP2 audio is reported in its own histogram bucket.
+TEST_F(MimeTypeUtilTest, GetDownloadMimeTypeResult) {
+  EXPECT_EQ(DownloadMimeTypeResult::k3GPPAudio,
+            GetDownloadMimeTypeResultFromMimeType(k3GPPAudioMimeType));
+  EXPECT_EQ(DownloadMimeTypeResult::k3GPP2Audio,
+            GetDownloadMimeTypeResultFromMimeType(k3GPP2AudioMimeType));
+}
+
+// Tests that USDZ files are recognized by their MIME type or extension.
+TEST_F(MimeTypeUtilTest, IsUsdzFileFormat) {
+  EXPECT_TRUE(IsUsdzFileFormat(kUsdzMimeType, base::FilePath("file")));
+  EXPECT_TRUE(IsUsdzFileFormat("", base::FilePath("file.usdz")));
+  EXPECT_TRUE(IsUsdzFileFormat("", base::FilePath("file.reality")));
+  EXPECT_FALSE(IsUsdzFileFormat(kPkPassMimeType, base::FilePath("file")));
+}
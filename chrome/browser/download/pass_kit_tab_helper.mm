@@ -29,8 +29,10 @@ DownloadPassKitResult GetUmaResult(web::DownloadTask* task) {
   if (task->GetHttpCode() == 401 || task->GetHttpCode() == 403)
     return DownloadPassKitResult::UnauthorizedFailure;
 
-  if (task->GetMimeType() != kPkPassMimeType)
+  if (ClassifyMimeType(task->GetMimeType()).handler !=
+      DownloadMimeTypeHandler::kPassKit) {
     return DownloadPassKitResult::WrongMimeTypeFailure;
+  }
 
   if (task->GetErrorCode())
     return DownloadPassKitResult::OtherFailure;
@@ -52,7 +54,8 @@ PassKitTabHelper::~PassKitTabHelper() {
 }
 
 void PassKitTabHelper::Download(std::unique_ptr<web::DownloadTask> task) {
-  DCHECK_EQ(task->GetMimeType(), kPkPassMimeType);
+  DCHECK(ClassifyMimeType(task->GetMimeType()).handler ==
+         DownloadMimeTypeHandler::kPassKit);
   web::DownloadTask* task_ptr = task.get();
   // Start may call OnDownloadUpdated immediately, so add the task to the set of
   // unfinished tasks.
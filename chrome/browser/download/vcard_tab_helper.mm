@@ -26,7 +26,8 @@ VcardTabHelper::~VcardTabHelper() {
 }
 
 void VcardTabHelper::Download(std::unique_ptr<web::DownloadTask> task) {
-  DCHECK_EQ(task->GetMimeType(), kVcardMimeType);
+  DCHECK(ClassifyMimeType(task->GetMimeType()).handler ==
+         DownloadMimeTypeHandler::kVcard);
   web::DownloadTask* task_ptr = task.get();
 
   // Add the task to the set of unfinished tasks before calling
@@ -7,16 +7,39 @@
 
 #import <Foundation/Foundation.h>
 
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "base/containers/lru_cache.h"
+#include "base/feature_list.h"
+#include "base/memory/memory_pressure_listener.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/weak_ptr.h"
 #include "base/task/cancelable_task_tracker.h"
 #include "components/keyed_service/core/keyed_service.h"
+#include "url/gurl.h"
 
-class GURL;
 @class FaviconAttributes;
 
+namespace base {
+class RefCountedMemory;
+class SequencedTaskRunner;
+}
+
 namespace favicon {
 class LargeIconService;
 }
 
+namespace favicon_base {
+struct LargeIconResult;
+}
+
+// If enabled, concurrent FaviconLoader requests for the same URL and size are
+// served by a single fetch from LargeIconService, and favicons are decoded on
+// a background sequence.
+extern const base::Feature kFaviconLoaderRequestCoalescing;
+
 // A class that manages asynchronously loading favicons or fallback attributes
 // from LargeIconService and caching them, given a URL.
 class FaviconLoader : public KeyedService {
@@ -24,6 +47,17 @@ class FaviconLoader : public KeyedService {
   // Type for completion block for FaviconForURL().
   typedef void (^FaviconAttributesCompletionBlock)(FaviconAttributes*);
 
+  // Counters of the requests served when kFaviconLoaderRequestCoalescing is
+  // enabled.
+  struct Statistics {
+    // Requests served synchronously from the cache.
+    size_t cache_hits = 0;
+    // Requests not found in the cache, including the coalesced ones.
+    size_t cache_misses = 0;
+    // Requests which joined a fetch already in flight.
+    size_t coalesced_requests = 0;
+  };
+
   explicit FaviconLoader(favicon::LargeIconService* large_icon_service);
 
   FaviconLoader(const FaviconLoader&) = delete;
@@ -80,7 +114,57 @@ class FaviconLoader : public KeyedService {
   // Return a weak pointer to the current object.
   base::WeakPtr<FaviconLoader> AsWeakPtr();
 
+  // Returns the counters of the requests served since the creation of |this|.
+  const Statistics& statistics() const { return statistics_; }
+
  private:
+  // Identifies a request in the cache and among the requests in flight.
+  struct RequestKey {
+    enum class Type { kPageUrl, kPageUrlOrHost, kIconUrl };
+
+    bool operator<(const RequestKey& other) const;
+
+    Type type;
+    GURL url;
+    int size_in_points;
+  };
+
+  // Parameters of a request, as passed to the LargeIconService.
+  struct RequestParams {
+    RequestKey key;
+    CGFloat scale = 1;
+    float min_size_in_points = 0;
+    bool fallback_to_google_server = false;
+  };
+
+  // Implementation of the public methods when kFaviconLoaderRequestCoalescing
+  // is enabled. Serves |params| from the cache, or adds |block_handler| to
+  // the waiters of the request in flight for |params.key|, or starts it.
+  // |placeholder| is passed synchronously to |block_handler| if the favicon
+  // is not in the cache.
+  void FaviconForRequest(const RequestParams& params,
+                         FaviconAttributes* placeholder,
+                         FaviconAttributesCompletionBlock block_handler);
+
+  // Fetches the favicon of the request |params| from the |large_icon_service_|.
+  void StartFetch(const RequestParams& params);
+
+  // Called when the LargeIconService returns the |result| of |params|.
+  void OnLargeIconResult(const RequestParams& params,
+                         const favicon_base::LargeIconResult& result);
+
+  // Called when the favicon of |params| has been fetched from the Google
+  // server to the local database.
+  void OnFaviconLoadedFromGoogleServer(const RequestParams& params);
+
+  // Caches |attributes| for |key| and passes them to the waiters of the
+  // request.
+  void FinishRequest(const RequestKey& key, FaviconAttributes* attributes);
+
+  // Drops the cached favicons on memory pressure.
+  void OnMemoryPressure(
+      base::MemoryPressureListener::MemoryPressureLevel level);
+
   // The LargeIconService used to retrieve favicon.
   favicon::LargeIconService* large_icon_service_;
 
@@ -92,6 +176,19 @@ class FaviconLoader : public KeyedService {
   // algorithm. Keyed by NSString of URL (page URL or icon URL) spec.
   NSCache<NSString*, FaviconAttributes*>* favicon_cache_;
 
+  // Whether kFaviconLoaderRequestCoalescing is enabled. The members below are
+  // only used if it is.
+  const bool coalesce_requests_;
+  // Holds cached favicons, replacing |favicon_cache_|.
+  base::LRUCache<RequestKey, FaviconAttributes*> coalescing_cache_;
+  // Completion blocks waiting for the requests in flight.
+  std::map<RequestKey, std::vector<FaviconAttributesCompletionBlock>>
+      pending_requests_;
+  // Sequence on which favicons are decoded.
+  scoped_refptr<base::SequencedTaskRunner> decode_task_runner_;
+  std::unique_ptr<base::MemoryPressureListener> memory_pressure_listener_;
+  Statistics statistics_;
+
   base::WeakPtrFactory<FaviconLoader> weak_ptr_factory_{this};
 };
 
@@ -6,9 +6,16 @@
 
 #import <UIKit/UIKit.h>
 
+#include <cmath>
+#include <tuple>
+#include <utility>
+
 #include "base/bind.h"
 #import "base/mac/foundation_util.h"
+#include "base/memory/ref_counted_memory.h"
 #include "base/strings/sys_string_conversions.h"
+#include "base/task/sequenced_task_runner.h"
+#include "base/task/thread_pool.h"
 #include "components/favicon/core/fallback_url_util.h"
 #include "components/favicon/core/large_icon_service.h"
 #include "components/favicon_base/fallback_icon_style.h"
@@ -27,6 +34,10 @@
 namespace {
 const CGFloat kFallbackIconDefaultTextColor = 0xAAAAAA;
 
+// Maximum number of favicons cached when kFaviconLoaderRequestCoalescing is
+// enabled.
+const int kMaxCoalescingCacheSize = 300;
+
 // NetworkTrafficAnnotationTag for fetching favicon from a Google server.
 const net::NetworkTrafficAnnotationTag kTrafficAnnotation =
     net::DefineNetworkTrafficAnnotation("favicon_loader_get_large_icon", R"(
@@ -45,11 +56,66 @@ const net::NetworkTrafficAnnotationTag kTrafficAnnotation =
         policy_exception_justification: "Not implemented."
         }
         )");
+
+// Returns the monogram attributes for |url| with |fallback_icon_style|.
+FaviconAttributes* MonogramAttributes(
+    const GURL& url,
+    const favicon_base::FallbackIconStyle& fallback_icon_style) {
+  return [FaviconAttributes
+      attributesWithMonogram:base::SysUTF16ToNSString(
+                                 favicon::GetFallbackIconText(url))
+                   textColor:UIColorFromRGB(kFallbackIconDefaultTextColor)
+             backgroundColor:UIColor.clearColor
+      defaultBackgroundColor:fallback_icon_style.is_default_background_color];
+}
+
+// Decodes the PNG-encoded favicon |data| and draws it once, so that the
+// returned image doesn't need to be decoded on the main thread when it is
+// first displayed. Returns nil if |data| can't be decoded.
+UIImage* DecodeFavicon(scoped_refptr<base::RefCountedMemory> data,
+                       CGFloat scale) {
+  UIImage* image = [UIImage
+      imageWithData:[NSData dataWithBytes:data->front() length:data->size()]
+              scale:scale];
+  if (!image)
+    return nil;
+
+  UIGraphicsImageRendererFormat* format =
+      [[UIGraphicsImageRendererFormat alloc] init];
+  format.scale = image.scale;
+  format.opaque = NO;
+  UIGraphicsImageRenderer* renderer =
+      [[UIGraphicsImageRenderer alloc] initWithSize:image.size format:format];
+  return [renderer imageWithActions:^(UIGraphicsImageRendererContext* context) {
+    [image drawAtPoint:CGPointZero];
+  }];
+}
+
 }  // namespace
 
+const base::Feature kFaviconLoaderRequestCoalescing{
+    "FaviconLoaderRequestCoalescing", base::FEATURE_DISABLED_BY_DEFAULT};
+
+bool FaviconLoader::RequestKey::operator<(const RequestKey& other) const {
+  return std::tie(type, size_in_points, url) <
+         std::tie(other.type, other.size_in_points, other.url);
+}
+
 FaviconLoader::FaviconLoader(favicon::LargeIconService* large_icon_service)
     : large_icon_service_(large_icon_service),
-      favicon_cache_([[NSCache alloc] init]) {}
+      favicon_cache_([[NSCache alloc] init]),
+      coalesce_requests_(
+          base::FeatureList::IsEnabled(kFaviconLoaderRequestCoalescing)),
+      coalescing_cache_(kMaxCoalescingCacheSize) {
+  if (coalesce_requests_) {
+    decode_task_runner_ = base::ThreadPool::CreateSequencedTaskRunner(
+        {base::TaskPriority::USER_VISIBLE,
+         base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN});
+    memory_pressure_listener_ = std::make_unique<base::MemoryPressureListener>(
+        FROM_HERE, base::BindRepeating(&FaviconLoader::OnMemoryPressure,
+                                       base::Unretained(this)));
+  }
+}
 FaviconLoader::~FaviconLoader() {}
 
 // TODO(pinkerton): How do we update the favicon if it's changed on the web?
@@ -64,6 +130,18 @@ void FaviconLoader::FaviconForPageUrl(
                                      // return valid favicon.
     FaviconAttributesCompletionBlock faviconBlockHandler) {
   DCHECK(faviconBlockHandler);
+  if (coalesce_requests_) {
+    RequestParams params;
+    params.key = {RequestKey::Type::kPageUrl, page_url,
+                  static_cast<int>(round(size_in_points))};
+    params.scale = UIScreen.mainScreen.scale;
+    params.min_size_in_points = min_size_in_points;
+    params.fallback_to_google_server = fallback_to_google_server;
+    FaviconForRequest(params, [FaviconAttributes attributesWithDefaultImage],
+                      faviconBlockHandler);
+    return;
+  }
+
   NSString* key =
       [NSString stringWithFormat:@"%d %@", (int)round(size_in_points),
                                  base::SysUTF8ToNSString(page_url.spec())];
@@ -148,6 +226,16 @@ void FaviconLoader::FaviconForPageUrlOrHost(
     float size_in_points,
     FaviconAttributesCompletionBlock favicon_block_handler) {
   DCHECK(favicon_block_handler);
+  if (coalesce_requests_) {
+    RequestParams params;
+    params.key = {RequestKey::Type::kPageUrlOrHost, page_url,
+                  static_cast<int>(round(size_in_points))};
+    params.scale = UIScreen.mainScreen.scale;
+    FaviconForRequest(params, [FaviconAttributes attributesWithDefaultImage],
+                      favicon_block_handler);
+    return;
+  }
+
   NSString* key = [NSString
       stringWithFormat:@"%d %@ with fallback", (int)round(size_in_points),
                        base::SysUTF8ToNSString(page_url.spec())];
@@ -210,6 +298,20 @@ void FaviconLoader::FaviconForIconUrl(
     float min_size_in_points,
     FaviconAttributesCompletionBlock faviconBlockHandler) {
   DCHECK(faviconBlockHandler);
+  if (coalesce_requests_) {
+    RequestParams params;
+    params.key = {RequestKey::Type::kIconUrl, icon_url,
+                  static_cast<int>(round(size_in_points))};
+    params.scale = UIScreen.mainScreen.scale;
+    params.min_size_in_points = min_size_in_points;
+    FaviconForRequest(params,
+                      [FaviconAttributes
+                          attributesWithImage:[UIImage imageNamed:
+                                                   @"default_world_favicon"]],
+                      faviconBlockHandler);
+    return;
+  }
+
   NSString* key =
       [NSString stringWithFormat:@"%d %@", (int)round(size_in_points),
                                  base::SysUTF8ToNSString(icon_url.spec())];
@@ -267,8 +369,149 @@ void FaviconLoader::FaviconForIconUrl(
 
 void FaviconLoader::CancellAllRequests() {
   cancelable_task_tracker_.TryCancelAll();
+  pending_requests_.clear();
 }
 
 base::WeakPtr<FaviconLoader> FaviconLoader::AsWeakPtr() {
   return weak_ptr_factory_.GetWeakPtr();
 }
+
+void FaviconLoader::FaviconForRequest(
+    const RequestParams& params,
+    FaviconAttributes* placeholder,
+    FaviconAttributesCompletionBlock block_handler) {
+  DCHECK(coalesce_requests_);
+  auto cached = coalescing_cache_.Get(params.key);
+  if (cached != coalescing_cache_.end()) {
+    ++statistics_.cache_hits;
+    block_handler(cached->second);
+    return;
+  }
+  ++statistics_.cache_misses;
+
+  // First, synchronously return a placeholder.
+  block_handler(placeholder);
+
+  auto pending = pending_requests_.find(params.key);
+  if (pending != pending_requests_.end()) {
+    ++statistics_.coalesced_requests;
+    pending->second.push_back(block_handler);
+    return;
+  }
+  pending_requests_[params.key].push_back(block_handler);
+  StartFetch(params);
+}
+
+void FaviconLoader::StartFetch(const RequestParams& params) {
+  DCHECK(large_icon_service_);
+  favicon_base::LargeIconCallback callback = base::BindOnce(
+      &FaviconLoader::OnLargeIconResult, weak_ptr_factory_.GetWeakPtr(),
+      params);
+  const int size_in_pixels =
+      static_cast<int>(params.scale * params.key.size_in_points);
+  const int min_size_in_pixels =
+      static_cast<int>(params.scale * params.min_size_in_points);
+  switch (params.key.type) {
+    case RequestKey::Type::kPageUrl:
+      large_icon_service_->GetLargeIconRawBitmapOrFallbackStyleForPageUrl(
+          params.key.url, min_size_in_pixels, size_in_pixels,
+          std::move(callback), &cancelable_task_tracker_);
+      break;
+    case RequestKey::Type::kPageUrlOrHost:
+      large_icon_service_->GetIconRawBitmapOrFallbackStyleForPageUrl(
+          params.key.url, size_in_pixels, std::move(callback),
+          &cancelable_task_tracker_);
+      break;
+    case RequestKey::Type::kIconUrl:
+      large_icon_service_->GetLargeIconRawBitmapOrFallbackStyleForIconUrl(
+          params.key.url, min_size_in_pixels, size_in_pixels,
+          std::move(callback), &cancelable_task_tracker_);
+      break;
+  }
+}
+
+void FaviconLoader::OnLargeIconResult(
+    const RequestParams& params,
+    const favicon_base::LargeIconResult& result) {
+  // The LargeIconService either returns a valid favicon (which can be the
+  // default favicon) or fallback attributes.
+  if (result.bitmap.is_valid()) {
+    decode_task_runner_->PostTaskAndReplyWithResult(
+        FROM_HERE,
+        base::BindOnce(&DecodeFavicon, result.bitmap.bitmap_data,
+                       params.scale),
+        base::BindOnce(
+            [](base::WeakPtr<FaviconLoader> loader, const RequestKey& key,
+               UIImage* favicon) {
+              if (!loader)
+                return;
+              // The favicon code assumes favicons are PNG-encoded, so this
+              // is not expected to fail.
+              loader->FinishRequest(
+                  key, favicon
+                           ? [FaviconAttributes attributesWithImage:favicon]
+                           : [FaviconAttributes attributesWithDefaultImage]);
+            },
+            weak_ptr_factory_.GetWeakPtr(), params.key));
+    return;
+  }
+
+  if (params.fallback_to_google_server) {
+    large_icon_service_
+        ->GetLargeIconOrFallbackStyleFromGoogleServerSkippingLocalCache(
+            params.key.url,
+            /*may_page_url_be_private=*/true,
+            /*should_trim_page_url_path=*/false, kTrafficAnnotation,
+            base::BindOnce(
+                [](base::WeakPtr<FaviconLoader> loader,
+                   const RequestParams& params,
+                   favicon_base::GoogleFaviconServerRequestStatus status) {
+                  if (loader)
+                    loader->OnFaviconLoadedFromGoogleServer(params);
+                },
+                weak_ptr_factory_.GetWeakPtr(), params));
+    return;
+  }
+
+  // Did not get valid favicon back and are not attempting to retrieve one
+  // from a Google Server.
+  DCHECK(result.fallback_icon_style);
+  FinishRequest(params.key, MonogramAttributes(params.key.url,
+                                               *result.fallback_icon_style));
+}
+
+void FaviconLoader::OnFaviconLoadedFromGoogleServer(
+    const RequestParams& params) {
+  // Update the time when the icon was last requested - postpone thus the
+  // automatic eviction of the favicon from the favicon database.
+  large_icon_service_->TouchIconFromGoogleServer(params.key.url);
+
+  // Favicon should be loaded to the db that backs LargeIconService now. Fetch
+  // it again for the same waiters. Even if the request was not successful, the
+  // fallback style will be used.
+  RequestParams local_params = params;
+  local_params.fallback_to_google_server = false;
+  StartFetch(local_params);
+}
+
+void FaviconLoader::FinishRequest(const RequestKey& key,
+                                  FaviconAttributes* attributes) {
+  if (!attributes.usesDefaultImage)
+    coalescing_cache_.Put(key, attributes);
+
+  auto pending = pending_requests_.find(key);
+  if (pending == pending_requests_.end())
+    return;
+  std::vector<FaviconAttributesCompletionBlock> block_handlers =
+      std::move(pending->second);
+  pending_requests_.erase(pending);
+  for (FaviconAttributesCompletionBlock block_handler : block_handlers)
+    block_handler(attributes);
+}
+
+void FaviconLoader::OnMemoryPressure(
+    base::MemoryPressureListener::MemoryPressureLevel level) {
+  if (level == base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_NONE)
+    return;
+  coalescing_cache_.Clear();
+}
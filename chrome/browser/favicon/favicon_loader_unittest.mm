@@ -4,6 +4,8 @@
 
 #import "ios/chrome/browser/favicon/favicon_loader.h"
 
+#include "base/test/scoped_feature_list.h"
+#include "base/test/task_environment.h"
 #include "components/favicon/core/large_icon_service_impl.h"
 #include "components/favicon_base/fallback_icon_style.h"
 #include "components/favicon_base/favicon_types.h"
@@ -55,6 +57,7 @@ class FakeLargeIconService : public favicon::LargeIconServiceImpl {
       int desired_size_in_pixel,
       favicon_base::LargeIconCallback callback,
       base::CancelableTaskTracker* tracker) override {
+    ++request_count_;
     if (page_url.spec() == kTestFaviconURL) {
       favicon_base::FaviconRawBitmapResult bitmapResult;
       bitmapResult.expired = false;
@@ -91,6 +94,12 @@ class FakeLargeIconService : public favicon::LargeIconServiceImpl {
         icon_url, min_source_size_in_pixel, desired_size_in_pixel,
         std::move(callback), tracker);
   }
+
+  // Returns the number of icons requested.
+  int request_count() const { return request_count_; }
+
+ private:
+  int request_count_ = 0;
 };
 
 class FaviconLoaderTest : public PlatformTest,
@@ -180,4 +189,90 @@ INSTANTIATE_TEST_SUITE_P(ProgrammaticFaviconLoaderTest,
                          ::testing::Values(FaviconUrlType::TEST_PAGE_URL,
                                            FaviconUrlType::TEST_ICON_URL));
 
+// Test fixture for FaviconLoader with kFaviconLoaderRequestCoalescing enabled.
+class FaviconLoaderCoalescingTest : public FaviconLoaderTest {
+ protected:
+  FaviconLoaderCoalescingTest()
+      : scoped_feature_list_(kFaviconLoaderRequestCoalescing),
+        coalescing_favicon_loader_(&large_icon_service_) {}
+
+  // Same as FaviconLoaderTest::FaviconForUrl(), with
+  // |coalescing_favicon_loader_|.
+  void FaviconForUrl(const GURL& url,
+                     FaviconLoader::FaviconAttributesCompletionBlock callback) {
+    if (GetParam() == TEST_PAGE_URL) {
+      coalescing_favicon_loader_.FaviconForPageUrl(
+          url, kTestFaviconSize, kTestFaviconSize,
+          /*fallback_to_google_server=*/false, callback);
+    } else {
+      coalescing_favicon_loader_.FaviconForIconUrl(
+          url, kTestFaviconSize, kTestFaviconSize, callback);
+    }
+  }
+
+  base::test::TaskEnvironment task_environment_;
+  base::test::ScopedFeatureList scoped_feature_list_;
+  FaviconLoader coalescing_favicon_loader_;
+};
+
+// Tests that concurrent requests for the same favicon are served by a single
+// fetch, and that the favicon is then served from the cache.
+TEST_P(FaviconLoaderCoalescingTest, CoalesceRequests) {
+  __block int callback_executed_count = 0;
+  __block int favicon_received_count = 0;
+  auto confirmation_block = ^(FaviconAttributes* favicon_attributes) {
+    ++callback_executed_count;
+    if (!favicon_attributes.usesDefaultImage) {
+      EXPECT_TRUE(favicon_attributes.faviconImage);
+      ++favicon_received_count;
+    }
+  };
+  FaviconForUrl(GURL(kTestFaviconURL), confirmation_block);
+  FaviconForUrl(GURL(kTestFaviconURL), confirmation_block);
+
+  // The placeholders are returned synchronously, and the favicon once it is
+  // decoded.
+  EXPECT_EQ(2, callback_executed_count);
+  EXPECT_EQ(0, favicon_received_count);
+  task_environment_.RunUntilIdle();
+  EXPECT_EQ(4, callback_executed_count);
+  EXPECT_EQ(2, favicon_received_count);
+  EXPECT_EQ(1, large_icon_service_.request_count());
+
+  FaviconForUrl(GURL(kTestFaviconURL), confirmation_block);
+  EXPECT_EQ(5, callback_executed_count);
+  EXPECT_EQ(3, favicon_received_count);
+  EXPECT_EQ(1, large_icon_service_.request_count());
+
+  const FaviconLoader::Statistics& statistics =
+      coalescing_favicon_loader_.statistics();
+  EXPECT_EQ(1u, statistics.cache_hits);
+  EXPECT_EQ(2u, statistics.cache_misses);
+  EXPECT_EQ(1u, statistics.coalesced_requests);
+}
+
+// Tests that fallback data is cached.
+TEST_P(FaviconLoaderCoalescingTest, FallbackIcon) {
+  __block int callback_executed_count = 0;
+  __block FaviconAttributes* last_favicon_attributes = nil;
+  auto confirmation_block = ^(FaviconAttributes* favicon_attributes) {
+    ++callback_executed_count;
+    last_favicon_attributes = favicon_attributes;
+  };
+  FaviconForUrl(GURL(kTestFallbackURL), confirmation_block);
+  EXPECT_EQ(2, callback_executed_count);
+  EXPECT_TRUE(last_favicon_attributes.monogramString);
+
+  FaviconForUrl(GURL(kTestFallbackURL), confirmation_block);
+  EXPECT_EQ(3, callback_executed_count);
+  EXPECT_TRUE(last_favicon_attributes.monogramString);
+  EXPECT_EQ(1, large_icon_service_.request_count());
+  EXPECT_EQ(1u, coalescing_favicon_loader_.statistics().cache_hits);
+}
+
+INSTANTIATE_TEST_SUITE_P(ProgrammaticFaviconLoaderCoalescingTest,
+                         FaviconLoaderCoalescingTest,
+                         ::testing::Values(FaviconUrlType::TEST_PAGE_URL,
+                                           FaviconUrlType::TEST_ICON_URL));
+
 }  // namespace
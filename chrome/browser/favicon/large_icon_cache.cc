@@ -4,56 +4,92 @@
 
 #include "ios/chrome/browser/favicon/large_icon_cache.h"
 
+#include <utility>
+
+#include "base/check_op.h"
+#include "base/memory/ref_counted_memory.h"
 #include "components/favicon_base/fallback_icon_style.h"
 #include "components/favicon_base/favicon_types.h"
 #include "url/gurl.h"
 
 namespace {
 
-const int kMaxCacheSize = 12;
+// Default budget of the cache, in bytes of bitmap data.
+const size_t kMaxCacheSizeInBytes = 512 * 1024;
+
+// Bytes accounted for each entry in addition to its bitmap data, so that
+// entries with fallback styles are bounded too.
+const size_t kEntryOverheadInBytes = 256;
+
+// Clones a LargeIconResult. The bitmap data is ref-counted and shared.
+std::unique_ptr<favicon_base::LargeIconResult> CloneLargeIconResult(
+    const favicon_base::LargeIconResult& large_icon_result) {
+  if (large_icon_result.bitmap.is_valid()) {
+    return std::make_unique<favicon_base::LargeIconResult>(
+        large_icon_result.bitmap);
+  }
+  return std::make_unique<favicon_base::LargeIconResult>(
+      new favicon_base::FallbackIconStyle(
+          *large_icon_result.fallback_icon_style.get()));
+}
+
+// Returns the number of bytes accounted for |result| in the cache budget.
+size_t GetSizeInBytes(const favicon_base::LargeIconResult& result) {
+  size_t size = kEntryOverheadInBytes;
+  if (result.bitmap.is_valid())
+    size += result.bitmap.bitmap_data->size();
+  return size;
+}
 
 }  // namespace
 
-struct LargeIconCacheEntry {
-  LargeIconCacheEntry() {}
-  ~LargeIconCacheEntry() {}
+LargeIconCacheEntry::LargeIconCacheEntry(
+    const favicon_base::LargeIconResult& result)
+    : result_(CloneLargeIconResult(result)),
+      size_in_bytes_(GetSizeInBytes(*result_)) {}
 
-  std::unique_ptr<favicon_base::LargeIconResult> result;
-};
+LargeIconCacheEntry::~LargeIconCacheEntry() = default;
 
-LargeIconCache::LargeIconCache() : cache_(kMaxCacheSize) {}
+LargeIconCache::LargeIconCache() : LargeIconCache(kMaxCacheSizeInBytes) {}
+
+LargeIconCache::LargeIconCache(size_t max_size_in_bytes)
+    : max_size_in_bytes_(max_size_in_bytes),
+      cache_(Cache::NO_AUTO_EVICT) {}
 
 LargeIconCache::~LargeIconCache() {}
 
 void LargeIconCache::SetCachedResult(
     const GURL& url,
     const favicon_base::LargeIconResult& result) {
-  std::unique_ptr<LargeIconCacheEntry> entry(new LargeIconCacheEntry);
-  entry->result = CloneLargeIconResult(result);
+  // Entries are immutable, so an updated result replaces the entry.
+  auto iter = cache_.Peek(url);
+  if (iter != cache_.end()) {
+    size_in_bytes_ -= iter->second->size_in_bytes();
+    cache_.Erase(iter);
+  }
+
+  auto entry = base::MakeRefCounted<LargeIconCacheEntry>(result);
+  if (entry->size_in_bytes() > max_size_in_bytes_)
+    return;
+  size_in_bytes_ += entry->size_in_bytes();
   cache_.Put(url, std::move(entry));
+  EvictEntriesIfNeeded();
 }
 
-std::unique_ptr<favicon_base::LargeIconResult> LargeIconCache::GetCachedResult(
+scoped_refptr<const LargeIconCacheEntry> LargeIconCache::GetCachedResult(
     const GURL& url) {
   auto iter = cache_.Get(url);
-  if (iter != cache_.end()) {
-    DCHECK(iter->second->result);
-    return CloneLargeIconResult(*iter->second->result.get());
-  }
-
-  return nullptr;
+  if (iter == cache_.end())
+    return nullptr;
+  return iter->second;
 }
 
-std::unique_ptr<favicon_base::LargeIconResult>
-LargeIconCache::CloneLargeIconResult(
-    const favicon_base::LargeIconResult& large_icon_result) {
-  std::unique_ptr<favicon_base::LargeIconResult> clone;
-  if (large_icon_result.bitmap.is_valid()) {
-    clone.reset(new favicon_base::LargeIconResult(large_icon_result.bitmap));
-  } else {
-    clone.reset(
-        new favicon_base::LargeIconResult(new favicon_base::FallbackIconStyle(
-            *large_icon_result.fallback_icon_style.get())));
+void LargeIconCache::EvictEntriesIfNeeded() {
+  while (size_in_bytes_ > max_size_in_bytes_) {
+    DCHECK(!cache_.empty());
+    auto oldest = cache_.rbegin();
+    DCHECK_GE(size_in_bytes_, oldest->second->size_in_bytes());
+    size_in_bytes_ -= oldest->second->size_in_bytes();
+    cache_.Erase(oldest);
   }
-  return clone;
 }
@@ -5,29 +5,57 @@
 #ifndef IOS_CHROME_BROWSER_FAVICON_LARGE_ICON_CACHE_H_
 #define IOS_CHROME_BROWSER_FAVICON_LARGE_ICON_CACHE_H_
 
+#include <stddef.h>
+
 #include <memory>
 
 #include "base/containers/lru_cache.h"
+#include "base/memory/ref_counted.h"
 #include "components/keyed_service/core/keyed_service.h"
 
 class GURL;
-struct LargeIconCacheEntry;
 
 namespace favicon_base {
 struct LargeIconResult;
 }
 
-// Provides a cache of most recently used LargeIconResult.
+// An immutable LargeIconResult shared by the LargeIconCache and its users, so
+// that a cache hit does not copy the result.
+class LargeIconCacheEntry : public base::RefCounted<LargeIconCacheEntry> {
+ public:
+  // Copies |result|. The bitmap data is shared, not copied.
+  explicit LargeIconCacheEntry(const favicon_base::LargeIconResult& result);
+
+  LargeIconCacheEntry(const LargeIconCacheEntry&) = delete;
+  LargeIconCacheEntry& operator=(const LargeIconCacheEntry&) = delete;
+
+  const favicon_base::LargeIconResult& result() const { return *result_; }
+
+  // Returns the number of bytes accounted for this entry in the cache budget.
+  size_t size_in_bytes() const { return size_in_bytes_; }
+
+ private:
+  friend class base::RefCounted<LargeIconCacheEntry>;
+  ~LargeIconCacheEntry();
+
+  const std::unique_ptr<const favicon_base::LargeIconResult> result_;
+  const size_t size_in_bytes_;
+};
+
+// Provides a cache of most recently used LargeIconResult, limited by the size
+// of their bitmap data.
 //
 // Example usage:
 //   LargeIconCache* large_icon_cache =
 //       IOSChromeLargeIconServiceFactory::GetForBrowserState(browser_state);
-//   std::unique_ptr<favicon_base::LargeIconResult> icon =
+//   scoped_refptr<const LargeIconCacheEntry> entry =
 //       large_icon_cache->GetCachedResult(...);
 //
 class LargeIconCache : public KeyedService {
  public:
   LargeIconCache();
+  // Creates a cache holding at most |max_size_in_bytes| of entries.
+  explicit LargeIconCache(size_t max_size_in_bytes);
 
   LargeIconCache(const LargeIconCache&) = delete;
   LargeIconCache& operator=(const LargeIconCache&) = delete;
@@ -36,19 +64,24 @@ class LargeIconCache : public KeyedService {
 
   // |LargeIconService| does everything on callbacks, and iOS needs to load the
   // icons immediately on page load. This caches the LargeIconResult so we can
-  // immediately load.
+  // immediately load. Results larger than the whole cache are not cached.
   void SetCachedResult(const GURL& url, const favicon_base::LargeIconResult&);
 
-  // Returns a cached LargeIconResult.
-  std::unique_ptr<favicon_base::LargeIconResult> GetCachedResult(
-      const GURL& url);
+  // Returns the cached LargeIconResult of |url|, or null if there is none.
+  scoped_refptr<const LargeIconCacheEntry> GetCachedResult(const GURL& url);
+
+  // Returns the number of bytes accounted for the cached entries.
+  size_t size_in_bytes() const { return size_in_bytes_; }
 
  private:
-  // Clones a LargeIconResult.
-  std::unique_ptr<favicon_base::LargeIconResult> CloneLargeIconResult(
-      const favicon_base::LargeIconResult& large_icon_result);
+  using Cache = base::LRUCache<GURL, scoped_refptr<const LargeIconCacheEntry>>;
+
+  // Evicts the least recently used entries until the cache fits its budget.
+  void EvictEntriesIfNeeded();
 
-  base::LRUCache<GURL, std::unique_ptr<LargeIconCacheEntry>> cache_;
+  const size_t max_size_in_bytes_;
+  size_t size_in_bytes_ = 0;
+  Cache cache_;
 };
 
 #endif  // IOS_CHROME_BROWSER_FAVICON_LARGE_ICON_CACHE_H_
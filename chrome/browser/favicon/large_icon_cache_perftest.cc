@@ -0,0 +1,84 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ios/chrome/browser/favicon/large_icon_cache.h"
+
+#include <string>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/memory/ref_counted_memory.h"
+#include "components/favicon_base/fallback_icon_style.h"
+#include "components/favicon_base/favicon_types.h"
+#include "ios/testing/perf_test_util.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/platform_test.h"
+#include "url/gurl.h"
+
+namespace {
+
+// Number of cache hits per measure.
+const size_t kIterations = 10000;
+
+// Size of the dummy bitmap data, similar to a PNG-encoded touch icon.
+const size_t kBitmapSize = 8 * 1024;
+
+// Returns a LargeIconResult with a bitmap of kBitmapSize bytes.
+favicon_base::LargeIconResult CreateBitmapResult() {
+  favicon_base::FaviconRawBitmapResult bitmap;
+  bitmap.bitmap_data = base::MakeRefCounted<base::RefCountedBytes>(kBitmapSize);
+  bitmap.pixel_size = gfx::Size(96, 96);
+  bitmap.icon_url = GURL("http://www.example.com/favicon.png");
+  bitmap.icon_type = favicon_base::IconType::kTouchIcon;
+  return favicon_base::LargeIconResult(bitmap);
+}
+
+// Looks |url| up in |cache|. The result is checked outside of the measure.
+void GetCachedResult(LargeIconCache* cache, const GURL& url) {
+  cache->GetCachedResult(url);
+}
+
+using LargeIconCachePerfTest = PlatformTest;
+
+// Measures the allocations and the duration of repeated cache hits, for an
+// entry with a bitmap and one with a fallback style.
+TEST_F(LargeIconCachePerfTest, Hits) {
+  LargeIconCache cache;
+  const GURL bitmap_url("http://www.example.com");
+  const GURL fallback_url("http://www.example2.com");
+  cache.SetCachedResult(bitmap_url, CreateBitmapResult());
+  cache.SetCachedResult(
+      fallback_url,
+      favicon_base::LargeIconResult(new favicon_base::FallbackIconStyle()));
+
+  for (const GURL& url : {bitmap_url, fallback_url}) {
+    const std::string story = url == bitmap_url ? "Bitmap" : "Fallback";
+
+    // The results are kept alive, so that the blocks allocated by the hits
+    // are counted.
+    std::vector<scoped_refptr<const LargeIconCacheEntry>> results;
+    results.reserve(kIterations);
+    const size_t block_count = testing::GetAllocatedBlockCount();
+    for (size_t i = 0; i < kIterations; ++i)
+      results.push_back(cache.GetCachedResult(url));
+    const size_t allocated_blocks =
+        testing::GetAllocatedBlockCount() - block_count;
+    // Hits share the cached entry, so they don't allocate.
+    EXPECT_EQ(0u, allocated_blocks);
+    ASSERT_EQ(kIterations, results.size());
+    ASSERT_TRUE(results.front());
+    EXPECT_EQ(results.front(), results.back());
+    testing::ReportPerfResult(
+        "LargeIconCache", story + "HitAllocations",
+        static_cast<double>(allocated_blocks) / kIterations, "allocations");
+
+    testing::ReportPerfResult(
+        "LargeIconCache", story + "Hit",
+        testing::MeasureMicroseconds(
+            kIterations, base::BindRepeating(&GetCachedResult, &cache, url)),
+        "us");
+  }
+}
+
+}  // namespace
@@ -4,6 +4,10 @@
 
 #include "ios/chrome/browser/favicon/large_icon_cache.h"
 
+#include <stdint.h>
+
+#include <memory>
+
 #include "components/favicon_base/fallback_icon_style.h"
 #include "components/favicon_base/favicon_types.h"
 #include "skia/ext/skia_utils_ios.h"
@@ -77,26 +81,77 @@ TEST_F(LargeIconCacheTest, RetreiveItem) {
   large_icon_cache_->SetCachedResult(GURL(kDummyUrl), *expected_result1);
   large_icon_cache_->SetCachedResult(GURL(kDummyUrl2), *expected_result2);
 
-  std::unique_ptr<favicon_base::LargeIconResult> result1 =
+  scoped_refptr<const LargeIconCacheEntry> entry1 =
       large_icon_cache_->GetCachedResult(GURL(kDummyUrl));
-  EXPECT_EQ(true, result1->bitmap.is_valid());
-  EXPECT_EQ(expected_result1->bitmap.pixel_size, result1->bitmap.pixel_size);
+  const favicon_base::LargeIconResult& result1 = entry1->result();
+  EXPECT_EQ(true, result1.bitmap.is_valid());
+  EXPECT_EQ(expected_result1->bitmap.pixel_size, result1.bitmap.pixel_size);
 
-  std::unique_ptr<favicon_base::LargeIconResult> result2 =
+  scoped_refptr<const LargeIconCacheEntry> entry2 =
       large_icon_cache_->GetCachedResult(GURL(kDummyUrl2));
-  EXPECT_EQ(false, result2->bitmap.is_valid());
+  const favicon_base::LargeIconResult& result2 = entry2->result();
+  EXPECT_EQ(false, result2.bitmap.is_valid());
   EXPECT_EQ(expected_result2->fallback_icon_style->background_color,
-            result2->fallback_icon_style->background_color);
-  EXPECT_FALSE(result2->fallback_icon_style->is_default_background_color);
+            result2.fallback_icon_style->background_color);
+  EXPECT_FALSE(result2.fallback_icon_style->is_default_background_color);
 
   // Test overwriting kDummyUrl.
   large_icon_cache_->SetCachedResult(GURL(kDummyUrl), *expected_result2);
-  std::unique_ptr<favicon_base::LargeIconResult> result3 =
-      large_icon_cache_->GetCachedResult(GURL(kDummyUrl2));
-  EXPECT_EQ(false, result3->bitmap.is_valid());
+  scoped_refptr<const LargeIconCacheEntry> entry3 =
+      large_icon_cache_->GetCachedResult(GURL(kDummyUrl));
+  const favicon_base::LargeIconResult& result3 = entry3->result();
+  EXPECT_EQ(false, result3.bitmap.is_valid());
   EXPECT_EQ(expected_result2->fallback_icon_style->background_color,
-            result3->fallback_icon_style->background_color);
-  EXPECT_FALSE(result2->fallback_icon_style->is_default_background_color);
+            result3.fallback_icon_style->background_color);
+  EXPECT_FALSE(result3.fallback_icon_style->is_default_background_color);
+
+  // The previous entry is still valid.
+  EXPECT_EQ(true, entry1->result().bitmap.is_valid());
+}
+
+// Tests that cache hits share the cached entry and its bitmap data.
+TEST_F(LargeIconCacheTest, SharedEntries) {
+  large_icon_cache_->SetCachedResult(
+      GURL(kDummyUrl), favicon_base::LargeIconResult(expected_bitmap_));
+
+  scoped_refptr<const LargeIconCacheEntry> entry1 =
+      large_icon_cache_->GetCachedResult(GURL(kDummyUrl));
+  scoped_refptr<const LargeIconCacheEntry> entry2 =
+      large_icon_cache_->GetCachedResult(GURL(kDummyUrl));
+  ASSERT_TRUE(entry1);
+  EXPECT_EQ(entry1, entry2);
+  EXPECT_EQ(expected_bitmap_.bitmap_data.get(),
+            entry1->result().bitmap.bitmap_data.get());
+}
+
+// Tests that the least recently used entries are evicted once the size of the
+// cached bitmaps exceeds the budget.
+TEST_F(LargeIconCacheTest, Eviction) {
+  const favicon_base::LargeIconResult result(expected_bitmap_);
+  large_icon_cache_ = std::make_unique<LargeIconCache>(0);
+  large_icon_cache_->SetCachedResult(GURL(kDummyUrl), result);
+  EXPECT_FALSE(large_icon_cache_->GetCachedResult(GURL(kDummyUrl)));
+  EXPECT_EQ(0u, large_icon_cache_->size_in_bytes());
+
+  // Make room for two entries.
+  large_icon_cache_ = std::make_unique<LargeIconCache>(SIZE_MAX);
+  large_icon_cache_->SetCachedResult(GURL(kDummyUrl), result);
+  const size_t entry_size = large_icon_cache_->size_in_bytes();
+  EXPECT_LT(expected_bitmap_.bitmap_data->size(), entry_size);
+  large_icon_cache_ = std::make_unique<LargeIconCache>(2 * entry_size);
+
+  const GURL url3("http://www.example3.com");
+  large_icon_cache_->SetCachedResult(GURL(kDummyUrl), result);
+  large_icon_cache_->SetCachedResult(GURL(kDummyUrl2), result);
+  EXPECT_EQ(2 * entry_size, large_icon_cache_->size_in_bytes());
+  // Use kDummyUrl so that kDummyUrl2 is the least recently used entry.
+  EXPECT_TRUE(large_icon_cache_->GetCachedResult(GURL(kDummyUrl)));
+  large_icon_cache_->SetCachedResult(url3, result);
+
+  EXPECT_EQ(2 * entry_size, large_icon_cache_->size_in_bytes());
+  EXPECT_TRUE(large_icon_cache_->GetCachedResult(GURL(kDummyUrl)));
+  EXPECT_FALSE(large_icon_cache_->GetCachedResult(GURL(kDummyUrl2)));
+  EXPECT_TRUE(large_icon_cache_->GetCachedResult(url3));
 }
 
 }  // namespace
@@ -81,6 +81,7 @@ class FindTabHelper : public web::WebStateObserver,
 
   // web::WebStateObserver.
   void WebStateRealized(web::WebState* web_state) override;
+  void WebStateUnrealized(web::WebState* web_state) override;
   void WebStateDestroyed(web::WebState* web_state) override;
   void DidFinishNavigation(web::WebState* web_state,
                            web::NavigationContext* navigation_context) override;
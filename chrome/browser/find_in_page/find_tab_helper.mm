@@ -93,6 +93,14 @@ void FindTabHelper::WebStateRealized(web::WebState* web_state) {
   CreateFindInPageController(web_state);
 }
 
+void FindTabHelper::WebStateUnrealized(web::WebState* web_state) {
+  // The controller is bound to the destroyed web view, so it is recreated
+  // when the WebState is realized again, with the same delegate.
+  response_delegate_ = controller_.responseDelegate;
+  [controller_ detachFromWebState];
+  controller_ = nil;
+}
+
 void FindTabHelper::WebStateDestroyed(web::WebState* web_state) {
   observation_.Reset();
 
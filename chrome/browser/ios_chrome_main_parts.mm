@@ -5,7 +5,9 @@
 #include "ios/chrome/browser/ios_chrome_main_parts.h"
 
 #import <Foundation/Foundation.h>
+#import <UIKit/UIKit.h>
 
+#include "base/base_paths.h"
 #include "base/check_op.h"
 #include "base/feature_list.h"
 #include "base/files/file_path.h"
@@ -51,7 +53,9 @@
 #include "ios/chrome/browser/browser_state/chrome_browser_state.h"
 #include "ios/chrome/browser/browser_state/chrome_browser_state_manager.h"
 #include "ios/chrome/browser/chrome_paths.h"
+#include "ios/chrome/browser/chrome_switches.h"
 #include "ios/chrome/browser/crash_report/crash_helper.h"
+#import "ios/chrome/browser/crash_report/main_thread_freeze_detector.h"
 #import "ios/chrome/browser/first_run/first_run.h"
 #include "ios/chrome/browser/flags/about_flags.h"
 #include "ios/chrome/browser/install_time_util.h"
@@ -67,6 +71,7 @@
 #include "ios/chrome/browser/translate/translate_service_ios.h"
 #include "ios/chrome/common/channel_info.h"
 #include "ios/components/security_interstitials/safe_browsing/safe_browsing_service.h"
+#include "ios/web/public/js_messaging/java_script_feature_util.h"
 #include "ios/web/public/thread/web_task_traits.h"
 #include "ios/web/public/thread/web_thread.h"
 #include "net/base/network_change_notifier.h"
@@ -97,6 +102,22 @@
 
 namespace {
 
+// Name of the file the local profiler trace is written to, in the cache
+// directory.
+const base::FilePath::CharType kLocalProfilerTraceFileName[] =
+    FILE_PATH_LITERAL("profiler_trace.json");
+
+// Writes the local profiler trace to disk on its own serial queue, so that
+// neither the main thread nor the freeze detection queue wait for the
+// serialization.
+void FlushLocalProfilerTraceAsync() {
+  static dispatch_queue_t queue = dispatch_queue_create(
+      "org.chromium.local_profiler_trace", DISPATCH_QUEUE_SERIAL);
+  dispatch_async(queue, ^{
+    IOSThreadProfiler::FlushLocalTrace();
+  });
+}
+
 // Sets |level| value for NSURLFileProtectionKey key for the URL with given
 // |local_state_path|.
 void SetProtectionLevel(const base::FilePath& file_path, id level) {
@@ -163,11 +184,34 @@ void IOSChromeMainParts::PreCreateMainMessageLoop() {
 }
 
 void IOSChromeMainParts::PreCreateThreads() {
-  // Create and start the stack sampling profiler if CANARY or DEV. The warning
-  // below doesn't apply.
+  // Collect a local trace of the main thread if requested. It is flushed to
+  // disk when the main thread freezes and recovers, and when the app enters
+  // the background, which also covers the cases where the freeze detector
+  // does not run (e.g. with a debugger attached).
+  const bool local_profiler_trace_enabled =
+      parsed_command_line_.HasSwitch(switches::kEnableLocalProfilerTrace);
+  base::FilePath cache_path;
+  if (local_profiler_trace_enabled &&
+      base::PathService::Get(base::DIR_CACHE, &cache_path)) {
+    IOSThreadProfiler::EnableLocalTrace(
+        cache_path.Append(kLocalProfilerTraceFileName));
+    [MainThreadFreezeDetector sharedInstance].freezeEventBlock = ^{
+      FlushLocalProfilerTraceAsync();
+    };
+    [[NSNotificationCenter defaultCenter]
+        addObserverForName:UIApplicationDidEnterBackgroundNotification
+                    object:nil
+                     queue:nil
+                usingBlock:^(NSNotification* notification) {
+                  FlushLocalProfilerTraceAsync();
+                }];
+  }
+
+  // Create and start the stack sampling profiler if CANARY or DEV, or if the
+  // local trace is enabled. The warning below doesn't apply.
   const version_info::Channel channel = ::GetChannel();
   if (channel == version_info::Channel::CANARY ||
-      channel == version_info::Channel::DEV) {
+      channel == version_info::Channel::DEV || local_profiler_trace_enabled) {
     sampling_profiler_ = IOSThreadProfiler::CreateAndStartOnMainThread();
     IOSThreadProfiler::SetMainThreadTaskRunner(
         base::ThreadTaskRunnerHandle::Get());
@@ -314,6 +358,11 @@ void IOSChromeMainParts::PreMainMessageLoopRun() {
   ChromeBrowserState* last_used_browser_state =
       browser_state_manager->GetLastUsedBrowserState();
 
+  // Load the scripts injected in the web views in the background, before the
+  // first web view of |last_used_browser_state| is configured.
+  web::java_script_features::PrewarmJavaScriptFeatureScripts(
+      last_used_browser_state);
+
   // This must occur at PreMainMessageLoopRun because |SetupMetrics()| uses the
   // blocking pool, which is disabled until the CreateThreads phase of startup.
   // TODO(crbug.com/786494): Investigate whether metrics recording can be
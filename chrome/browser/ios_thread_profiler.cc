@@ -11,19 +11,25 @@
 #include <vector>
 
 #include "base/bind.h"
+#include "base/containers/flat_map.h"
 #include "base/memory/ptr_util.h"
 #include "base/message_loop/work_id_provider.h"
 #include "base/process/process.h"
+#include "base/profiler/module_cache.h"
+#include "base/profiler/profile_builder.h"
 #include "base/profiler/profiler_buildflags.h"
 #include "base/profiler/sample_metadata.h"
 #include "base/profiler/sampling_profiler_thread_token.h"
 #include "base/rand_util.h"
+#include "base/task/current_thread.h"
+#include "base/task/task_observer.h"
 #include "base/threading/platform_thread.h"
 #include "base/threading/sequence_local_storage_slot.h"
 #include "base/threading/thread_task_runner_handle.h"
 #include "build/build_config.h"
 #include "components/metrics/call_stack_profile_builder.h"
 #include "components/metrics/call_stack_profile_metrics_provider.h"
+#include "ios/chrome/browser/profiler_trace_buffer.h"
 
 using CallStackProfileBuilder = metrics::CallStackProfileBuilder;
 using CallStackProfileParams = metrics::CallStackProfileParams;
@@ -39,6 +45,22 @@ IOSThreadProfiler* g_main_thread_instance = nullptr;
 // Run continuous profiling 2% of the time.
 constexpr double kFractionOfExecutionTimeToSample = 0.02;
 
+// The local trace samples the threads every 10ms, in collections of one
+// minute, and keeps the last 80 seconds of samples.
+constexpr base::TimeDelta kLocalTraceSamplingInterval = base::Milliseconds(10);
+constexpr int kLocalTraceSamplesPerCollection = 6000;
+constexpr size_t kLocalTraceMaxSampleCount = 8000;
+constexpr size_t kLocalTraceMaxTaskCount = 32 * 1024;
+
+// Name of the module of the frames whose module is unknown.
+const char kUnknownModuleName[] = "???";
+
+// Ring buffer and destination of the local trace, if enabled. Set once before
+// any profiler is created and never destroyed, so they can be used from any
+// thread.
+ProfilerTraceBuffer* g_local_trace_buffer = nullptr;
+const base::FilePath* g_local_trace_path = nullptr;
+
 bool IsCurrentProcessBackgrounded() {
   return base::Process::Current().IsProcessBackgrounded();
 }
@@ -60,6 +82,23 @@ const base::RepeatingClosure GetApplyPerSampleMetadataCallback(
       process_backgrounded);
 }
 
+base::StackSamplingProfiler::SamplingParams GetLocalTraceSamplingParams() {
+  base::StackSamplingProfiler::SamplingParams params;
+  params.initial_delay = base::Milliseconds(0);
+  params.sampling_interval = kLocalTraceSamplingInterval;
+  params.samples_per_profile = kLocalTraceSamplesPerCollection;
+  return params;
+}
+
+// Returns the name of the current thread in the local trace.
+std::string GetLocalTraceThreadName(CallStackProfileParams::Thread thread) {
+  const char* name = base::PlatformThread::GetName();
+  if (name && *name)
+    return name;
+  return thread == CallStackProfileParams::Thread::kMain ? "CrBrowserMain"
+                                                         : "Thread";
+}
+
 }  // namespace
 
 // The scheduler works by splitting execution time into repeated periods such
@@ -128,7 +167,122 @@ class IOSThreadProfiler::WorkIdRecorder : public metrics::WorkIdRecorder {
   base::WorkIdProvider* const work_id_provider_;
 };
 
+// Records the samples of a local trace collection in |g_local_trace_buffer|.
+// Invoked on the profiler thread.
+class IOSThreadProfiler::LocalTraceProfileBuilder
+    : public base::ProfileBuilder {
+ public:
+  LocalTraceProfileBuilder(base::PlatformThreadId thread_id,
+                           const metrics::WorkIdRecorder* work_id_recorder,
+                           base::OnceClosure completed_callback)
+      : thread_id_(thread_id),
+        work_id_recorder_(work_id_recorder),
+        completed_callback_(std::move(completed_callback)),
+        unknown_module_index_(
+            g_local_trace_buffer->InternModule(kUnknownModuleName)) {}
+
+  LocalTraceProfileBuilder(const LocalTraceProfileBuilder&) = delete;
+  LocalTraceProfileBuilder& operator=(const LocalTraceProfileBuilder&) =
+      delete;
+
+  // base::ProfileBuilder:
+  base::ModuleCache* GetModuleCache() override { return &module_cache_; }
+
+  // Invoked while the target thread is suspended.
+  void RecordMetadata(const base::MetadataRecorder::MetadataProvider&
+                          metadata_provider) override {
+    work_id_ = work_id_recorder_->RecordWorkId();
+  }
+
+  void OnSampleCompleted(std::vector<base::Frame> frames,
+                         base::TimeTicks sample_timestamp) override {
+    trace_frames_.clear();
+    for (const base::Frame& frame : frames) {
+      ProfilerTraceBuffer::Frame trace_frame;
+      if (frame.module) {
+        trace_frame.module_index = GetModuleIndex(frame.module);
+        trace_frame.offset =
+            frame.instruction_pointer - frame.module->GetBaseAddress();
+      } else {
+        trace_frame.module_index = unknown_module_index_;
+        trace_frame.offset = frame.instruction_pointer;
+      }
+      trace_frames_.push_back(trace_frame);
+    }
+    g_local_trace_buffer->AddSample(thread_id_, sample_timestamp, work_id_,
+                                    trace_frames_);
+  }
+
+  void OnProfileCompleted(base::TimeDelta profile_duration,
+                          base::TimeDelta sampling_period) override {
+    if (completed_callback_)
+      std::move(completed_callback_).Run();
+  }
+
+ private:
+  // Returns the index of |module| in |g_local_trace_buffer|.
+  size_t GetModuleIndex(const base::ModuleCache::Module* module) {
+    auto it = module_indices_.find(module);
+    if (it != module_indices_.end())
+      return it->second;
+    const size_t index = g_local_trace_buffer->InternModule(
+        module->GetDebugBasename().AsUTF8Unsafe());
+    module_indices_[module] = index;
+    return index;
+  }
+
+  const base::PlatformThreadId thread_id_;
+  const metrics::WorkIdRecorder* const work_id_recorder_;
+  base::OnceClosure completed_callback_;
+  const size_t unknown_module_index_;
+  base::ModuleCache module_cache_;
+  base::flat_map<const base::ModuleCache::Module*, size_t> module_indices_;
+  // Work id recorded for the sample being collected.
+  unsigned int work_id_ = 0;
+  // Frames of the last sample, kept to reuse their storage.
+  std::vector<ProfilerTraceBuffer::Frame> trace_frames_;
+};
+
+// Records the tasks run by the profiled thread in |g_local_trace_buffer|,
+// annotated with the location they were posted from and their work id.
+class IOSThreadProfiler::LocalTraceTaskObserver : public base::TaskObserver {
+ public:
+  explicit LocalTraceTaskObserver(base::WorkIdProvider* work_id_provider)
+      : thread_id_(base::PlatformThread::CurrentId()),
+        work_id_provider_(work_id_provider) {}
+
+  LocalTraceTaskObserver(const LocalTraceTaskObserver&) = delete;
+  LocalTraceTaskObserver& operator=(const LocalTraceTaskObserver&) = delete;
+
+  // base::TaskObserver:
+  void WillProcessTask(const base::PendingTask& pending_task,
+                       bool was_blocked_or_low_priority) override {
+    running_task_ids_.push_back(g_local_trace_buffer->WillRunTask(
+        thread_id_, base::TimeTicks::Now(), work_id_provider_->GetWorkId(),
+        pending_task.posted_from));
+  }
+
+  void DidProcessTask(const base::PendingTask& pending_task) override {
+    // The observer may have been added while a task was running.
+    if (running_task_ids_.empty())
+      return;
+    g_local_trace_buffer->DidRunTask(running_task_ids_.back(),
+                                     base::TimeTicks::Now());
+    running_task_ids_.pop_back();
+  }
+
+ private:
+  const base::PlatformThreadId thread_id_;
+  base::WorkIdProvider* const work_id_provider_;
+  // Ids of the running tasks, several if run loops are nested.
+  std::vector<uint64_t> running_task_ids_;
+};
+
 IOSThreadProfiler::~IOSThreadProfiler() {
+  if (local_trace_task_observer_ && base::CurrentThread::IsSet()) {
+    base::CurrentThread::Get()->RemoveTaskObserver(
+        local_trace_task_observer_.get());
+  }
   if (g_main_thread_instance == this)
     g_main_thread_instance = nullptr;
 }
@@ -176,6 +330,22 @@ void IOSThreadProfiler::SetCollectorForChildProcess(
       std::move(collector));
 }
 
+// static
+void IOSThreadProfiler::EnableLocalTrace(const base::FilePath& path) {
+  DCHECK(!g_local_trace_buffer);
+  DCHECK(!g_main_thread_instance);
+  g_local_trace_buffer = new ProfilerTraceBuffer(kLocalTraceMaxSampleCount,
+                                                 kLocalTraceMaxTaskCount);
+  g_local_trace_path = new base::FilePath(path);
+}
+
+// static
+void IOSThreadProfiler::FlushLocalTrace() {
+  if (!g_local_trace_buffer)
+    return;
+  g_local_trace_buffer->WriteToFile(*g_local_trace_path);
+}
+
 // static
 base::StackSamplingProfiler::SamplingParams
 IOSThreadProfiler::GetSamplingParams() {
@@ -206,6 +376,11 @@ IOSThreadProfiler::GetSamplingParams() {
 //
 // The process in previous paragraph continues until the IOSThreadProfiler is
 // destroyed prior to thread exit.
+//
+// If the local trace is enabled, a local trace profiler also samples the thread
+// continuously from creation, and is restarted the same way on completion once
+// the message loop is available. A task observer records the tasks run by the
+// thread.
 IOSThreadProfiler::IOSThreadProfiler(
     CallStackProfileParams::Thread thread,
     scoped_refptr<base::SingleThreadTaskRunner> owning_thread_task_runner)
@@ -241,8 +416,16 @@ IOSThreadProfiler::IOSThreadProfiler(
       sampling_params.samples_per_profile * sampling_params.sampling_interval,
       kFractionOfExecutionTimeToSample, startup_profiling_completion_time);
 
-  if (owning_thread_task_runner_)
+  if (g_local_trace_buffer) {
+    g_local_trace_buffer->SetThreadName(base::PlatformThread::CurrentId(),
+                                        GetLocalTraceThreadName(thread_));
+    StartLocalTraceCollection();
+  }
+
+  if (owning_thread_task_runner_) {
     ScheduleNextPeriodicCollection();
+    StartLocalTraceTaskObserver();
+  }
 }
 
 // static
@@ -264,6 +447,13 @@ void IOSThreadProfiler::SetMainThreadTaskRunnerImpl(
   DCHECK(!owning_thread_task_runner_);
   owning_thread_task_runner_ = task_runner;
   ScheduleNextPeriodicCollection();
+
+  if (g_local_trace_buffer) {
+    // Restart the local trace collection so that it is restarted on
+    // completion.
+    StartLocalTraceCollection();
+    StartLocalTraceTaskObserver();
+  }
 }
 
 void IOSThreadProfiler::ScheduleNextPeriodicCollection() {
@@ -294,3 +484,42 @@ void IOSThreadProfiler::StartPeriodicSamplingCollection() {
 
   periodic_profiler_->Start();
 }
+
+// static
+void IOSThreadProfiler::OnLocalTraceCollectionCompleted(
+    scoped_refptr<base::SingleThreadTaskRunner> owning_thread_task_runner,
+    base::WeakPtr<IOSThreadProfiler> thread_profiler) {
+  owning_thread_task_runner->PostTask(
+      FROM_HERE, base::BindOnce(&IOSThreadProfiler::StartLocalTraceCollection,
+                                thread_profiler));
+}
+
+void IOSThreadProfiler::StartLocalTraceCollection() {
+  DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+  DCHECK(g_local_trace_buffer);
+  base::OnceClosure completed_callback;
+  if (owning_thread_task_runner_) {
+    completed_callback =
+        base::BindOnce(&IOSThreadProfiler::OnLocalTraceCollectionCompleted,
+                       owning_thread_task_runner_, weak_factory_.GetWeakPtr());
+  }
+  // NB: Destroys the previous profiler as side effect.
+  local_trace_profiler_ = std::make_unique<StackSamplingProfiler>(
+      base::GetSamplingProfilerCurrentThreadToken(),
+      GetLocalTraceSamplingParams(),
+      std::make_unique<LocalTraceProfileBuilder>(
+          base::PlatformThread::CurrentId(), work_id_recorder_.get(),
+          std::move(completed_callback)),
+      CreateCoreUnwindersFactory());
+
+  local_trace_profiler_->Start();
+}
+
+void IOSThreadProfiler::StartLocalTraceTaskObserver() {
+  DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+  DCHECK(g_local_trace_buffer);
+  DCHECK(!local_trace_task_observer_);
+  local_trace_task_observer_ = std::make_unique<LocalTraceTaskObserver>(
+      base::WorkIdProvider::GetForCurrentThread());
+  base::CurrentThread::Get()->AddTaskObserver(local_trace_task_observer_.get());
+}
@@ -13,6 +13,7 @@
 #include <memory>
 
 #include "base/callback.h"
+#include "base/files/file_path.h"
 #include "base/memory/weak_ptr.h"
 #include "base/profiler/stack_sampling_profiler.h"
 #include "base/task/single_thread_task_runner.h"
@@ -108,8 +109,21 @@ class IOSThreadProfiler {
   static void SetCollectorForChildProcess(
       mojo::PendingRemote<metrics::mojom::CallStackProfileCollector> collector);
 
+  // Enables the local collection of the stacks sampled and the tasks run by
+  // the profiled threads, in addition to the profiles reported to UMA. They
+  // are kept in a ring buffer and written to |path| by FlushLocalTrace(). Must
+  // be called before any profiler is created. Meant for local debugging only.
+  static void EnableLocalTrace(const base::FilePath& path);
+
+  // Writes the content of the local trace to the path passed to
+  // EnableLocalTrace(). No-op if the local trace is not enabled. Can be called
+  // on any thread but the main thread, as it blocks.
+  static void FlushLocalTrace();
+
  private:
   class WorkIdRecorder;
+  class LocalTraceProfileBuilder;
+  class LocalTraceTaskObserver;
 
   // Creates the profiler. The task runner will be supplied for child threads
   // but not for main threads.
@@ -136,6 +150,20 @@ class IOSThreadProfiler {
   // Creates a new periodic profiler and initiates a collection with it.
   void StartPeriodicSamplingCollection();
 
+  // Posts a task on |owning_thread_task_runner| to start the next local trace
+  // collection on the completion of the previous collection.
+  static void OnLocalTraceCollectionCompleted(
+      scoped_refptr<base::SingleThreadTaskRunner> owning_thread_task_runner,
+      base::WeakPtr<IOSThreadProfiler> thread_profiler);
+
+  // Creates a new local trace profiler and initiates a collection with it. The
+  // profiler can't be restarted before |owning_thread_task_runner_| is set.
+  void StartLocalTraceCollection();
+
+  // Starts recording the tasks of the thread in the local trace. Must be
+  // called once the message loop of the thread is started.
+  void StartLocalTraceTaskObserver();
+
   const metrics::CallStackProfileParams::Process process_;
   const metrics::CallStackProfileParams::Thread thread_;
 
@@ -148,6 +176,10 @@ class IOSThreadProfiler {
   std::unique_ptr<base::StackSamplingProfiler> periodic_profiler_;
   std::unique_ptr<PeriodicSamplingScheduler> periodic_sampling_scheduler_;
 
+  // Profiler and task observer filling the local trace, if enabled.
+  std::unique_ptr<base::StackSamplingProfiler> local_trace_profiler_;
+  std::unique_ptr<LocalTraceTaskObserver> local_trace_task_observer_;
+
   THREAD_CHECKER(thread_checker_);
   base::WeakPtrFactory<IOSThreadProfiler> weak_factory_{this};
 };
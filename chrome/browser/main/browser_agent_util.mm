@@ -30,6 +30,7 @@
 #import "ios/chrome/browser/web/web_navigation_browser_agent.h"
 #import "ios/chrome/browser/web/web_state_delegate_browser_agent.h"
 #import "ios/chrome/browser/web_state_list/session_metrics.h"
+#import "ios/chrome/browser/web_state_list/tab_discard_browser_agent.h"
 #import "ios/chrome/browser/web_state_list/tab_insertion_browser_agent.h"
 #import "ios/chrome/browser/web_state_list/view_source_browser_agent.h"
 #import "ios/chrome/browser/web_state_list/web_state_list_metrics_browser_agent.h"
@@ -58,6 +59,9 @@ void AttachBrowserAgents(Browser* browser) {
   ClosingWebStateObserverBrowserAgent::CreateForBrowser(browser);
   SnapshotBrowserAgent::CreateForBrowser(browser);
 
+  if (base::FeatureList::IsEnabled(kTabDiscardOnMemoryPressure))
+    TabDiscardBrowserAgent::CreateForBrowser(browser);
+
   // PolicyWatcher is non-OTR only.
   if (!browser->GetBrowserState()->IsOffTheRecord())
     PolicyWatcherBrowserAgent::CreateForBrowser(browser);
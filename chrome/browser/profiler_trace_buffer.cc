@@ -0,0 +1,193 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ios/chrome/browser/profiler_trace_buffer.h"
+
+#include <utility>
+
+#include "base/check_op.h"
+#include "base/files/important_file_writer.h"
+#include "base/json/json_writer.h"
+#include "base/process/process_handle.h"
+#include "base/strings/stringprintf.h"
+#include "base/values.h"
+
+namespace {
+
+// Categories of the trace events.
+const char kTaskCategory[] = "task";
+const char kSampleCategory[] = "sample";
+
+// Returns the timestamp of |time| in a trace event, in microseconds.
+double ToTraceTimestamp(base::TimeTicks time) {
+  return (time - base::TimeTicks()).InMicrosecondsF();
+}
+
+// Returns a trace event of |phase| on thread |thread_id|.
+base::Value CreateTraceEvent(const char* phase,
+                             base::PlatformThreadId thread_id) {
+  base::Value event(base::Value::Type::DICTIONARY);
+  event.SetStringKey("ph", phase);
+  event.SetIntKey("pid", static_cast<int>(base::GetCurrentProcId()));
+  event.SetIntKey("tid", static_cast<int>(thread_id));
+  return event;
+}
+
+}  // namespace
+
+ProfilerTraceBuffer::Sample::Sample() = default;
+ProfilerTraceBuffer::Sample::Sample(const Sample& other) = default;
+ProfilerTraceBuffer::Sample::Sample(Sample&& other) = default;
+ProfilerTraceBuffer::Sample& ProfilerTraceBuffer::Sample::operator=(
+    const Sample& other) = default;
+ProfilerTraceBuffer::Sample& ProfilerTraceBuffer::Sample::operator=(
+    Sample&& other) = default;
+ProfilerTraceBuffer::Sample::~Sample() = default;
+
+ProfilerTraceBuffer::ProfilerTraceBuffer(size_t max_sample_count,
+                                         size_t max_task_count)
+    : max_sample_count_(max_sample_count), max_task_count_(max_task_count) {
+  DCHECK_GT(max_sample_count_, 0u);
+  DCHECK_GT(max_task_count_, 0u);
+}
+
+ProfilerTraceBuffer::~ProfilerTraceBuffer() = default;
+
+void ProfilerTraceBuffer::SetThreadName(base::PlatformThreadId thread_id,
+                                        const std::string& name) {
+  base::AutoLock auto_lock(lock_);
+  thread_names_[thread_id] = name;
+}
+
+size_t ProfilerTraceBuffer::InternModule(const std::string& name) {
+  base::AutoLock auto_lock(lock_);
+  auto it = module_indices_.find(name);
+  if (it != module_indices_.end())
+    return it->second;
+  module_names_.push_back(name);
+  module_indices_[name] = module_names_.size() - 1;
+  return module_names_.size() - 1;
+}
+
+void ProfilerTraceBuffer::AddSample(base::PlatformThreadId thread_id,
+                                    base::TimeTicks time,
+                                    unsigned int work_id,
+                                    const std::vector<Frame>& frames) {
+  base::AutoLock auto_lock(lock_);
+  if (samples_.size() < max_sample_count_)
+    samples_.emplace_back();
+  // Reuse the storage of the overwritten sample.
+  Sample& sample = samples_[next_sample_index_];
+  next_sample_index_ = (next_sample_index_ + 1) % max_sample_count_;
+  sample.thread_id = thread_id;
+  sample.time = time;
+  sample.work_id = work_id;
+  sample.frames.assign(frames.begin(), frames.end());
+}
+
+uint64_t ProfilerTraceBuffer::WillRunTask(base::PlatformThreadId thread_id,
+                                          base::TimeTicks time,
+                                          unsigned int work_id,
+                                          const base::Location& posted_from) {
+  base::AutoLock auto_lock(lock_);
+  Task task;
+  task.id = next_task_id_++;
+  task.thread_id = thread_id;
+  task.start_time = time;
+  task.work_id = work_id;
+  task.posted_from = posted_from;
+  const size_t index = task.id % max_task_count_;
+  if (index == tasks_.size()) {
+    tasks_.push_back(task);
+  } else {
+    tasks_[index] = task;
+  }
+  return task.id;
+}
+
+void ProfilerTraceBuffer::DidRunTask(uint64_t task_id, base::TimeTicks time) {
+  base::AutoLock auto_lock(lock_);
+  Task& task = tasks_[task_id % max_task_count_];
+  if (task.id == task_id)
+    task.end_time = time;
+}
+
+std::string ProfilerTraceBuffer::SerializeAsJson() const {
+  // Only copy the buffers while holding the lock, as building the events is
+  // much slower and would block AddSample() and WillRunTask() meanwhile.
+  std::map<base::PlatformThreadId, std::string> thread_names;
+  std::vector<std::string> module_names;
+  std::vector<Task> tasks;
+  std::vector<Sample> samples;
+  {
+    base::AutoLock auto_lock(lock_);
+    thread_names = thread_names_;
+    module_names = module_names_;
+    tasks = tasks_;
+    samples = samples_;
+  }
+
+  base::Value events(base::Value::Type::LIST);
+  for (const auto& pair : thread_names) {
+    base::Value event = CreateTraceEvent("M", pair.first);
+    event.SetStringKey("name", "thread_name");
+    base::Value args(base::Value::Type::DICTIONARY);
+    args.SetStringKey("name", pair.second);
+    event.SetKey("args", std::move(args));
+    events.Append(std::move(event));
+  }
+
+  // Tasks are slices of the thread tracks, in which samples appear as instant
+  // events. Events don't need to be sorted.
+  for (const Task& task : tasks) {
+    base::Value event =
+        CreateTraceEvent(task.end_time.is_null() ? "B" : "X", task.thread_id);
+    event.SetStringKey("cat", kTaskCategory);
+    event.SetStringKey("name", task.posted_from.function_name()
+                                   ? task.posted_from.function_name()
+                                   : "Task");
+    event.SetDoubleKey("ts", ToTraceTimestamp(task.start_time));
+    if (!task.end_time.is_null()) {
+      event.SetDoubleKey("dur",
+                         (task.end_time - task.start_time).InMicrosecondsF());
+    }
+    base::Value args(base::Value::Type::DICTIONARY);
+    args.SetStringKey("posted_from", task.posted_from.ToString());
+    args.SetIntKey("work_id", static_cast<int>(task.work_id));
+    event.SetKey("args", std::move(args));
+    events.Append(std::move(event));
+  }
+
+  for (const Sample& sample : samples) {
+    base::Value event = CreateTraceEvent("i", sample.thread_id);
+    event.SetStringKey("s", "t");
+    event.SetStringKey("cat", kSampleCategory);
+    event.SetStringKey("name", "StackSample");
+    event.SetDoubleKey("ts", ToTraceTimestamp(sample.time));
+    base::Value stack(base::Value::Type::LIST);
+    for (const Frame& frame : sample.frames) {
+      DCHECK_LT(frame.module_index, module_names.size());
+      stack.Append(base::StringPrintf(
+          "%s+0x%lx", module_names[frame.module_index].c_str(),
+          static_cast<unsigned long>(frame.offset)));
+    }
+    base::Value args(base::Value::Type::DICTIONARY);
+    args.SetIntKey("work_id", static_cast<int>(sample.work_id));
+    args.SetKey("stack", std::move(stack));
+    event.SetKey("args", std::move(args));
+    events.Append(std::move(event));
+  }
+
+  base::Value trace(base::Value::Type::DICTIONARY);
+  trace.SetKey("traceEvents", std::move(events));
+  trace.SetStringKey("displayTimeUnit", "ms");
+  std::string json;
+  base::JSONWriter::Write(trace, &json);
+  return json;
+}
+
+bool ProfilerTraceBuffer::WriteToFile(const base::FilePath& path) const {
+  return base::ImportantFileWriter::WriteFileAtomically(path,
+                                                        SerializeAsJson());
+}
@@ -0,0 +1,124 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef IOS_CHROME_BROWSER_PROFILER_TRACE_BUFFER_H_
+#define IOS_CHROME_BROWSER_PROFILER_TRACE_BUFFER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "base/location.h"
+#include "base/synchronization/lock.h"
+#include "base/thread_annotations.h"
+#include "base/threading/platform_thread.h"
+#include "base/time/time.h"
+
+// ProfilerTraceBuffer keeps the most recent stack samples and tasks of the
+// profiled threads in fixed-size ring buffers, so that they can be inspected
+// locally. They are serialized in the Trace Event JSON format, which is opened
+// by the Perfetto UI (ui.perfetto.dev) and chrome://tracing.
+//
+// All methods are thread-safe.
+class ProfilerTraceBuffer {
+ public:
+  // A frame of a sampled stack, as an offset in a module.
+  struct Frame {
+    // Index of the module name returned by InternModule().
+    size_t module_index = 0;
+    uintptr_t offset = 0;
+  };
+
+  ProfilerTraceBuffer(size_t max_sample_count, size_t max_task_count);
+  ~ProfilerTraceBuffer();
+
+  ProfilerTraceBuffer(const ProfilerTraceBuffer&) = delete;
+  ProfilerTraceBuffer& operator=(const ProfilerTraceBuffer&) = delete;
+
+  // Sets the |name| of the thread |thread_id| in the trace.
+  void SetThreadName(base::PlatformThreadId thread_id, const std::string& name);
+
+  // Returns the index of the module |name|, to be used in Frame.
+  size_t InternModule(const std::string& name);
+
+  // Records a stack sample of thread |thread_id| taken at |time| while it was
+  // running the work item |work_id|. |frames| are ordered from the innermost.
+  // Overwrites the oldest sample if the buffer is full.
+  void AddSample(base::PlatformThreadId thread_id,
+                 base::TimeTicks time,
+                 unsigned int work_id,
+                 const std::vector<Frame>& frames);
+
+  // Records the start at |time| of a task posted from |posted_from| on thread
+  // |thread_id|, running the work item |work_id|. Returns an id to pass to
+  // DidRunTask(). Overwrites the oldest task if the buffer is full.
+  uint64_t WillRunTask(base::PlatformThreadId thread_id,
+                       base::TimeTicks time,
+                       unsigned int work_id,
+                       const base::Location& posted_from);
+
+  // Records the end at |time| of the task |task_id|. No-op if the task has
+  // been overwritten since. Tasks which are not ended when the trace is
+  // serialized, e.g. because they froze the thread, appear as unterminated
+  // slices.
+  void DidRunTask(uint64_t task_id, base::TimeTicks time);
+
+  // Returns the content of the buffers in the Trace Event JSON format. The
+  // buffers are copied under the lock and serialized outside of it, so that
+  // the profiled threads are not blocked by the serialization.
+  std::string SerializeAsJson() const;
+
+  // Writes SerializeAsJson() to |path|, replacing its content atomically.
+  // Returns whether the write succeeded. Blocks, so it must not be called on
+  // the main thread.
+  bool WriteToFile(const base::FilePath& path) const;
+
+ private:
+  struct Sample {
+    Sample();
+    Sample(const Sample& other);
+    Sample(Sample&& other);
+    Sample& operator=(const Sample& other);
+    Sample& operator=(Sample&& other);
+    ~Sample();
+
+    base::PlatformThreadId thread_id;
+    base::TimeTicks time;
+    unsigned int work_id = 0;
+    std::vector<Frame> frames;
+  };
+
+  struct Task {
+    // Id returned by WillRunTask(), which is the number of tasks recorded
+    // before this one.
+    uint64_t id = 0;
+    base::PlatformThreadId thread_id;
+    base::TimeTicks start_time;
+    // Null if the task is still running.
+    base::TimeTicks end_time;
+    unsigned int work_id = 0;
+    base::Location posted_from;
+  };
+
+  const size_t max_sample_count_;
+  const size_t max_task_count_;
+
+  mutable base::Lock lock_;
+  std::map<base::PlatformThreadId, std::string> thread_names_
+      GUARDED_BY(lock_);
+  std::vector<std::string> module_names_ GUARDED_BY(lock_);
+  std::map<std::string, size_t> module_indices_ GUARDED_BY(lock_);
+  // Ring buffers, in which the oldest entry is at |next_sample_index_| and
+  // |next_task_id_| % |max_task_count_| once they are full.
+  std::vector<Sample> samples_ GUARDED_BY(lock_);
+  size_t next_sample_index_ GUARDED_BY(lock_) = 0;
+  std::vector<Task> tasks_ GUARDED_BY(lock_);
+  uint64_t next_task_id_ GUARDED_BY(lock_) = 0;
+};
+
+#endif  // IOS_CHROME_BROWSER_PROFILER_TRACE_BUFFER_H_
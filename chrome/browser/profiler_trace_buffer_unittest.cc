@@ -0,0 +1,121 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ios/chrome/browser/profiler_trace_buffer.h"
+
+#include <string>
+#include <vector>
+
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/json/json_reader.h"
+#include "base/values.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/platform_test.h"
+
+namespace {
+
+const base::PlatformThreadId kThreadId = 42;
+
+// Returns the trace events of |buffer| with phase |phase|.
+std::vector<base::Value> GetTraceEvents(const ProfilerTraceBuffer& buffer,
+                                        const std::string& phase) {
+  absl::optional<base::Value> trace =
+      base::JSONReader::Read(buffer.SerializeAsJson());
+  std::vector<base::Value> events;
+  if (!trace || !trace->is_dict())
+    return events;
+  const base::Value* trace_events = trace->FindListKey("traceEvents");
+  if (!trace_events)
+    return events;
+  for (const base::Value& event : trace_events->GetListDeprecated()) {
+    const std::string* event_phase = event.FindStringKey("ph");
+    if (event_phase && *event_phase == phase)
+      events.push_back(event.Clone());
+  }
+  return events;
+}
+
+}  // namespace
+
+using ProfilerTraceBufferTest = PlatformTest;
+
+// Tests that the oldest samples are overwritten once the buffer is full, and
+// that their frames are serialized as offsets in modules.
+TEST_F(ProfilerTraceBufferTest, Samples) {
+  ProfilerTraceBuffer buffer(/*max_sample_count=*/2, /*max_task_count=*/2);
+  const size_t module_index = buffer.InternModule("Chromium");
+  EXPECT_EQ(module_index, buffer.InternModule("Chromium"));
+
+  const base::TimeTicks time = base::TimeTicks() + base::Milliseconds(1);
+  for (unsigned int work_id = 1; work_id <= 3; ++work_id) {
+    ProfilerTraceBuffer::Frame frame;
+    frame.module_index = module_index;
+    frame.offset = 0x10 * work_id;
+    buffer.AddSample(kThreadId, time + base::Milliseconds(work_id), work_id,
+                     {frame});
+  }
+
+  std::vector<base::Value> samples = GetTraceEvents(buffer, "i");
+  ASSERT_EQ(2u, samples.size());
+  for (const base::Value& sample : samples) {
+    EXPECT_EQ(static_cast<int>(kThreadId), sample.FindIntKey("tid"));
+    absl::optional<int> work_id = sample.FindIntPath("args.work_id");
+    ASSERT_TRUE(work_id);
+    EXPECT_GE(*work_id, 2);
+    const base::Value* stack = sample.FindListPath("args.stack");
+    ASSERT_TRUE(stack);
+    ASSERT_EQ(1u, stack->GetListDeprecated().size());
+    EXPECT_EQ(*work_id == 2 ? "Chromium+0x20" : "Chromium+0x30",
+              stack->GetListDeprecated()[0].GetString());
+  }
+}
+
+// Tests that ended tasks are serialized as complete slices, and running tasks
+// as unterminated slices.
+TEST_F(ProfilerTraceBufferTest, Tasks) {
+  ProfilerTraceBuffer buffer(/*max_sample_count=*/2, /*max_task_count=*/2);
+  buffer.SetThreadName(kThreadId, "CrBrowserMain");
+
+  const base::TimeTicks time = base::TimeTicks() + base::Milliseconds(1);
+  const uint64_t overwritten_task =
+      buffer.WillRunTask(kThreadId, time, 1, FROM_HERE);
+  buffer.DidRunTask(overwritten_task, time);
+  const uint64_t ended_task =
+      buffer.WillRunTask(kThreadId, time + base::Milliseconds(1), 2, FROM_HERE);
+  buffer.WillRunTask(kThreadId, time + base::Milliseconds(2), 3, FROM_HERE);
+  buffer.DidRunTask(ended_task, time + base::Milliseconds(3));
+  // The first task is overwritten, so this is a no-op.
+  buffer.DidRunTask(overwritten_task, time + base::Milliseconds(4));
+
+  std::vector<base::Value> ended_tasks = GetTraceEvents(buffer, "X");
+  ASSERT_EQ(1u, ended_tasks.size());
+  EXPECT_EQ(2, ended_tasks[0].FindIntPath("args.work_id"));
+  EXPECT_EQ(2000.0, ended_tasks[0].FindDoubleKey("dur"));
+
+  std::vector<base::Value> running_tasks = GetTraceEvents(buffer, "B");
+  ASSERT_EQ(1u, running_tasks.size());
+  EXPECT_EQ(3, running_tasks[0].FindIntPath("args.work_id"));
+
+  std::vector<base::Value> metadata = GetTraceEvents(buffer, "M");
+  ASSERT_EQ(1u, metadata.size());
+  const std::string* name = metadata[0].FindStringPath("args.name");
+  ASSERT_TRUE(name);
+  EXPECT_EQ("CrBrowserMain", *name);
+}
+
+// Tests that the trace is written to a file.
+TEST_F(ProfilerTraceBufferTest, WriteToFile) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  const base::FilePath path = temp_dir.GetPath().Append("trace.json");
+
+  ProfilerTraceBuffer buffer(/*max_sample_count=*/2, /*max_task_count=*/2);
+  buffer.WillRunTask(kThreadId, base::TimeTicks::Now(), 1, FROM_HERE);
+  ASSERT_TRUE(buffer.WriteToFile(path));
+
+  std::string content;
+  ASSERT_TRUE(base::ReadFileToString(path, &content));
+  EXPECT_EQ(buffer.SerializeAsJson(), content);
+}
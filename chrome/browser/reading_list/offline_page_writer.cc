@@ -0,0 +1,95 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ios/chrome/browser/reading_list/offline_page_writer.h"
+
+#include <algorithm>
+
+#include "base/base64.h"
+#include "base/check_op.h"
+#include "base/containers/span.h"
+#include "base/files/file_util.h"
+
+namespace reading_list {
+
+namespace {
+
+// Size of the chunks encoded at once by WriteBase64(). Must be a multiple of 3
+// so that the encodings of consecutive chunks can be concatenated.
+const size_t kBase64ChunkSize = 48 * 1024;
+static_assert(kBase64ChunkSize % 3 == 0, "Chunks must not need padding");
+
+}  // namespace
+
+OfflinePageWriter::OfflinePageWriter(const base::FilePath& path,
+                                     int64_t max_size)
+    : path_(path),
+      max_size_(max_size),
+      file_(path, base::File::FLAG_CREATE_ALWAYS | base::File::FLAG_WRITE) {
+  failed_ = !file_.IsValid();
+}
+
+OfflinePageWriter::~OfflinePageWriter() {
+  if (finished_)
+    return;
+  file_.Close();
+  base::DeleteFile(path_);
+}
+
+bool OfflinePageWriter::Write(base::StringPiece data) {
+  return Reserve(data.size()) && WriteToFile(data);
+}
+
+bool OfflinePageWriter::WriteBase64(base::StringPiece data) {
+  if (!Reserve(4 * ((data.size() + 2) / 3)))
+    return false;
+
+  while (!data.empty()) {
+    const base::StringPiece chunk =
+        data.substr(0, std::min(data.size(), kBase64ChunkSize));
+    base::Base64Encode(chunk, &encoded_chunk_);
+    if (!WriteToFile(encoded_chunk_))
+      return false;
+    data.remove_prefix(chunk.size());
+  }
+  return true;
+}
+
+bool OfflinePageWriter::Finish() {
+  DCHECK(!finished_);
+  if (failed_)
+    return false;
+  if (!file_.Flush()) {
+    failed_ = true;
+    return false;
+  }
+  file_.Close();
+  finished_ = true;
+  return true;
+}
+
+bool OfflinePageWriter::Reserve(int64_t size) {
+  if (failed_)
+    return false;
+  if (written_size_ + size > max_size_) {
+    failed_ = true;
+    exceeded_budget_ = true;
+    return false;
+  }
+  return true;
+}
+
+bool OfflinePageWriter::WriteToFile(base::StringPiece data) {
+  DCHECK(!failed_);
+  if (data.empty())
+    return true;
+  if (!file_.WriteAtCurrentPosAndCheck(base::as_bytes(base::make_span(data)))) {
+    failed_ = true;
+    return false;
+  }
+  written_size_ += data.size();
+  return true;
+}
+
+}  // namespace reading_list
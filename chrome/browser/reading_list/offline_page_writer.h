@@ -0,0 +1,76 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef IOS_CHROME_BROWSER_READING_LIST_OFFLINE_PAGE_WRITER_H_
+#define IOS_CHROME_BROWSER_READING_LIST_OFFLINE_PAGE_WRITER_H_
+
+#include <stdint.h>
+
+#include <string>
+
+#include "base/files/file.h"
+#include "base/files/file_path.h"
+#include "base/strings/string_piece.h"
+
+namespace reading_list {
+
+// Writes the offline version of a page to a file in a single pass, without
+// holding the whole page in memory. Data is appended as is with Write(), or
+// base64 encoded chunk by chunk with WriteBase64(), so that the memory used
+// is bounded by the largest input. Writing stops as soon as the size of the
+// file would exceed the budget given at construction. Must be used on a
+// sequence allowing blocking calls.
+class OfflinePageWriter {
+ public:
+  // Creates a writer to the file at |path|, replacing any existing file,
+  // which accepts at most |max_size| bytes.
+  OfflinePageWriter(const base::FilePath& path, int64_t max_size);
+
+  OfflinePageWriter(const OfflinePageWriter&) = delete;
+  OfflinePageWriter& operator=(const OfflinePageWriter&) = delete;
+
+  // Deletes the file if Finish() did not succeed.
+  ~OfflinePageWriter();
+
+  // Appends |data| to the file. Returns false, writing nothing, if the budget
+  // would be exceeded or if the file could not be written. Once a call failed,
+  // all the following calls fail.
+  bool Write(base::StringPiece data);
+
+  // Appends the base64 encoding of |data| to the file. The budget is checked
+  // against the size of the encoding before anything is encoded.
+  bool WriteBase64(base::StringPiece data);
+
+  // Closes the file. Returns whether all the writes succeeded and the file
+  // was flushed. The file is kept only if this returns true.
+  bool Finish();
+
+  // Returns the number of bytes written to the file.
+  int64_t written_size() const { return written_size_; }
+
+  // Returns whether a write failed because the budget would be exceeded.
+  bool exceeded_budget() const { return exceeded_budget_; }
+
+ private:
+  // Returns whether |size| more bytes fit in the budget. Marks the writer as
+  // failed if they don't.
+  bool Reserve(int64_t size);
+
+  // Appends |data| to the file, without checking the budget.
+  bool WriteToFile(base::StringPiece data);
+
+  const base::FilePath path_;
+  const int64_t max_size_;
+  base::File file_;
+  int64_t written_size_ = 0;
+  bool failed_ = false;
+  bool exceeded_budget_ = false;
+  bool finished_ = false;
+  // Buffer for the base64 encoding of a chunk.
+  std::string encoded_chunk_;
+};
+
+}  // namespace reading_list
+
+#endif  // IOS_CHROME_BROWSER_READING_LIST_OFFLINE_PAGE_WRITER_H_
@@ -0,0 +1,75 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ios/chrome/browser/reading_list/offline_page_writer.h"
+
+#include <string>
+
+#include "base/base64.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/platform_test.h"
+
+namespace reading_list {
+
+class OfflinePageWriterTest : public PlatformTest {
+ protected:
+  void SetUp() override {
+    PlatformTest::SetUp();
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    path_ = temp_dir_.GetPath().Append("page.html");
+  }
+
+  // Returns the content of the file written.
+  std::string ReadFile() {
+    std::string content;
+    EXPECT_TRUE(base::ReadFileToString(path_, &content));
+    return content;
+  }
+
+  base::ScopedTempDir temp_dir_;
+  base::FilePath path_;
+};
+
+// Tests that raw and base64 encoded data is written in order, and that the
+// base64 encoding spanning several chunks matches a one-shot encoding.
+TEST_F(OfflinePageWriterTest, Write) {
+  std::string image(100 * 1024 + 1, '\0');
+  for (size_t i = 0; i < image.size(); ++i)
+    image[i] = static_cast<char>(i * 7);
+  std::string encoded_image;
+  base::Base64Encode(image, &encoded_image);
+
+  OfflinePageWriter writer(path_, 1024 * 1024);
+  EXPECT_TRUE(writer.Write("<html>"));
+  EXPECT_TRUE(writer.WriteBase64(image));
+  EXPECT_TRUE(writer.Write("</html>"));
+  EXPECT_TRUE(writer.Finish());
+
+  const std::string expected = "<html>" + encoded_image + "</html>";
+  EXPECT_EQ(expected, ReadFile());
+  EXPECT_EQ(static_cast<int64_t>(expected.size()), writer.written_size());
+  EXPECT_FALSE(writer.exceeded_budget());
+}
+
+// Tests that writing stops before the budget is exceeded, and that the file
+// is deleted.
+TEST_F(OfflinePageWriterTest, ExceedBudget) {
+  {
+    OfflinePageWriter writer(path_, 10);
+    EXPECT_TRUE(writer.Write("<html>"));
+    // "abcd" is encoded in 8 bytes.
+    EXPECT_FALSE(writer.WriteBase64("abcd"));
+    EXPECT_TRUE(writer.exceeded_budget());
+    EXPECT_EQ(6, writer.written_size());
+
+    // Following writes fail, even if they fit.
+    EXPECT_FALSE(writer.Write("a"));
+    EXPECT_FALSE(writer.Finish());
+  }
+  EXPECT_FALSE(base::PathExists(path_));
+}
+
+}  // namespace reading_list
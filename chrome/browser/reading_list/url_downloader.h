@@ -27,6 +27,7 @@ class SimpleURLLoader;
 }
 
 namespace reading_list {
+class OfflinePageWriter;
 class ReadingListDistillerPageFactory;
 }
 
@@ -145,17 +146,21 @@ class URLDownloader : reading_list::ReadingListDistillerPageDelegate {
 
   // HTML processing methods.
 
-  // Injects script to replace images in |images| array with a data-uri
-  // of their contents. If the data does not represent an image, it is
-  // skipped.
-  std::string ReplaceImagesInHTML(
-      const GURL& url,
+  // Returns whether |image| can be inlined in the offline page: it must be
+  // valid image data, and not mixed content.
+  bool IsImageInlinable(
+      const dom_distiller::DistillerViewerInterface::ImageInfo& image) const;
+  // Writes |html| to |writer|, followed by a script replacing the images in
+  // |images| array with a data-uri of their contents. If the data does not
+  // represent an image, it is skipped. Returns false as soon as a write
+  // fails.
+  bool WriteOfflinePage(
       const std::string& html,
       const std::vector<dom_distiller::DistillerViewerInterface::ImageInfo>&
-          images);
-  // Saves |html| to disk in the correct location for |url|; returns success.
-  bool SaveHTMLForURL(std::string html, const GURL& url);
-  // Saves distilled html to disk, including saving images and main file.
+          images,
+      reading_list::OfflinePageWriter* writer);
+  // Saves distilled html to disk in the correct location for |url|, with the
+  // images inlined, in a single pass.
   SuccessState SaveDistilledHTML(
       const GURL& url,
       const std::vector<dom_distiller::DistillerViewerInterface::ImageInfo>&
@@ -7,7 +7,6 @@
 #include <string>
 #include <vector>
 
-#include "base/base64.h"
 #include "base/bind.h"
 #include "base/containers/contains.h"
 #include "base/files/file_path.h"
@@ -17,11 +16,11 @@
 #include "base/metrics/histogram_macros.h"
 #include "base/path_service.h"
 #include "base/strings/string_util.h"
-#include "base/strings/stringprintf.h"
 #include "base/task/thread_pool.h"
 #include "components/reading_list/core/offline_url_utils.h"
 #include "ios/chrome/browser/chrome_paths.h"
 #include "ios/chrome/browser/dom_distiller/distiller_viewer.h"
+#include "ios/chrome/browser/reading_list/offline_page_writer.h"
 #include "ios/chrome/browser/reading_list/reading_list_distiller_page.h"
 #include "ios/chrome/browser/reading_list/reading_list_distiller_page_factory.h"
 #include "net/base/load_flags.h"
@@ -50,12 +49,14 @@ const char kDisableImageContextMenuScript[] =
     "}, false);"
     "</script>";
 
-// This script replaces any downloaded images with a data uri.
-const char kReplaceDownloadedImagesScript[] =
+// This script replaces any downloaded images with a data uri. The entries of
+// |imgData| are written between the prefix and the suffix.
+const char kReplaceDownloadedImagesScriptPrefix[] =
     "<script nonce=\"$1\">"
     "document.addEventListener('DOMContentLoaded', function (event) {"
     "    var imgData = {};"
-    "    $2"
+    "    ";
+const char kReplaceDownloadedImagesScriptSuffix[] =
     "    var imgTags = document.getElementsByTagName(\"img\");"
     "    for(image of imgTags) {"
     "        image.src = imgData[image.src] || image.src;"
@@ -63,10 +64,9 @@ const char kReplaceDownloadedImagesScript[] =
     "}, false);"
     "</script>";
 
-// The maximum size for the distilled page.
-// Note that the sum of the size of the resources will be used for this check,
-// so the total size of the page after processing can be slightly more than
-// this.
+// The maximum size for the distilled page, including the inlined images. The
+// page is written to disk in a single pass and the download fails as soon as
+// it would exceed this size.
 const int kMaximumTotalPageSize = 10 * 1024 * 1024;
 
 // The maximum size for a single raw image. If a bigger image is found, the
@@ -332,28 +332,31 @@ URLDownloader::SuccessState URLDownloader::SaveDistilledHTML(
     const std::vector<dom_distiller::DistillerViewerInterface::ImageInfo>&
         images,
     const std::string& html) {
-  int total_size = html.size();
   for (size_t i = 0; i < images.size(); i++) {
     if (images[i].data.size() > kMaximumImageSize) {
       UMA_HISTOGRAM_MEMORY_KB("IOS.ReadingList.ImageTooLargeFailure",
                               images[i].data.size() / 1024);
       return PERMANENT_ERROR;
     }
-    // Image will be base64 encoded.
-    total_size += 4 * images[i].data.size() / 3;
-  }
-  if (total_size > kMaximumTotalPageSize) {
-    UMA_HISTOGRAM_MEMORY_KB("IOS.ReadingList.PageTooLargeFailure",
-                            total_size / 1024);
-    return PERMANENT_ERROR;
   }
 
-  if (CreateOfflineURLDirectory(url)) {
-    return SaveHTMLForURL(ReplaceImagesInHTML(url, html, images), url)
-               ? DOWNLOAD_SUCCESS
-               : ERROR;
+  if (html.empty() || !CreateOfflineURLDirectory(url))
+    return ERROR;
+
+  base::FilePath path = reading_list::OfflineURLAbsolutePathFromRelativePath(
+      base_directory_,
+      reading_list::OfflinePagePath(url, reading_list::OFFLINE_TYPE_HTML));
+  reading_list::OfflinePageWriter writer(path, kMaximumTotalPageSize);
+  if (!WriteOfflinePage(html, images, &writer) || !writer.Finish()) {
+    if (writer.exceeded_budget()) {
+      UMA_HISTOGRAM_MEMORY_KB("IOS.ReadingList.PageTooLargeFailure",
+                              writer.written_size() / 1024);
+      return PERMANENT_ERROR;
+    }
+    return ERROR;
   }
-  return ERROR;
+  saved_size_ += writer.written_size();
+  return DOWNLOAD_SUCCESS;
 }
 
 bool URLDownloader::CreateOfflineURLDirectory(const GURL& url) {
@@ -365,80 +368,64 @@ bool URLDownloader::CreateOfflineURLDirectory(const GURL& url) {
   return true;
 }
 
-std::string URLDownloader::ReplaceImagesInHTML(
-    const GURL& url,
-    const std::string& html,
-    const std::vector<dom_distiller::DistillerViewerInterface::ImageInfo>&
-        images) {
-  std::string mutable_html = html;
-  std::string image_js;
-  bool local_images_found = false;
-  for (size_t i = 0; i < images.size(); i++) {
-    if (images[i].url.SchemeIs(url::kDataScheme)) {
-      // Data URI, the data part of the image is empty, no need to store it.
-      continue;
-    }
-    std::string local_image_name;
-    // Mixed content is HTTP images on HTTPS pages.
-    bool image_is_mixed_content = distilled_url_.SchemeIsCryptographic() &&
-                                  !images[i].url.SchemeIsCryptographic();
-    // Only inline images if it is not mixed content and image data is valid.
-    if (image_is_mixed_content || !images[i].url.is_valid() ||
-        images[i].data.empty()) {
-      continue;
-    }
-
-    // Try to detect the mime-type from the bytes so an arbitrary page cannot
-    // be included. Returned mime-type must start with "image/".
-    std::string sniffed_type;
-    if (!net::SniffMimeTypeFromLocalData(images[i].data, &sniffed_type)) {
-      continue;
-    }
-
-    if (!base::StartsWith(sniffed_type, "image/")) {
-      continue;
-    }
-
-    std::string image_url;
-    std::string image_data;
-    base::Value value(images[i].url.spec());
-
-    base::JSONWriter::Write(value, &image_url);
-    base::Base64Encode(images[i].data, &image_data);
-
-    std::string src_with_data =
-        base::StringPrintf("data:image/png;base64,%s", image_data.c_str());
-    image_js += "imgData[" + image_url + "] = \"" + src_with_data + "\";";
-
-    local_images_found = true;
+bool URLDownloader::IsImageInlinable(
+    const dom_distiller::DistillerViewerInterface::ImageInfo& image) const {
+  if (image.url.SchemeIs(url::kDataScheme)) {
+    // Data URI, the data part of the image is empty, no need to store it.
+    return false;
   }
-
-  if (local_images_found) {
-    std::vector<std::string> substitutions;
-    substitutions.push_back(distiller_->GetCspNonce());
-
-    mutable_html += base::ReplaceStringPlaceholders(
-        kDisableImageContextMenuScript, substitutions, nullptr);
-
-    substitutions.push_back(image_js);
-    mutable_html += base::ReplaceStringPlaceholders(
-        kReplaceDownloadedImagesScript, substitutions, nullptr);
+  // Mixed content is HTTP images on HTTPS pages.
+  bool image_is_mixed_content = distilled_url_.SchemeIsCryptographic() &&
+                                !image.url.SchemeIsCryptographic();
+  // Only inline images if it is not mixed content and image data is valid.
+  if (image_is_mixed_content || !image.url.is_valid() || image.data.empty()) {
+    return false;
   }
 
-  return mutable_html;
+  // Try to detect the mime-type from the bytes so an arbitrary page cannot
+  // be included. Returned mime-type must start with "image/".
+  std::string sniffed_type;
+  if (!net::SniffMimeTypeFromLocalData(image.data, &sniffed_type)) {
+    return false;
+  }
+  return base::StartsWith(sniffed_type, "image/");
 }
 
-bool URLDownloader::SaveHTMLForURL(std::string html, const GURL& url) {
-  if (html.empty()) {
+bool URLDownloader::WriteOfflinePage(
+    const std::string& html,
+    const std::vector<dom_distiller::DistillerViewerInterface::ImageInfo>&
+        images,
+    reading_list::OfflinePageWriter* writer) {
+  if (!writer->Write(html))
     return false;
+
+  std::vector<const dom_distiller::DistillerViewerInterface::ImageInfo*>
+      inlined_images;
+  for (const auto& image : images) {
+    if (IsImageInlinable(image))
+      inlined_images.push_back(&image);
   }
-  base::FilePath path = reading_list::OfflineURLAbsolutePathFromRelativePath(
-      base_directory_,
-      reading_list::OfflinePagePath(url, reading_list::OFFLINE_TYPE_HTML));
-  int written = base::WriteFile(path, html.c_str(), html.length());
-  if (written <= 0) {
+  if (inlined_images.empty())
+    return true;
+
+  const std::vector<std::string> substitutions = {distiller_->GetCspNonce()};
+  if (!writer->Write(base::ReplaceStringPlaceholders(
+          kDisableImageContextMenuScript, substitutions, nullptr)) ||
+      !writer->Write(base::ReplaceStringPlaceholders(
+          kReplaceDownloadedImagesScriptPrefix, substitutions, nullptr))) {
     return false;
   }
-  saved_size_ += written;
-  return true;
+
+  // Each image is base64 encoded straight to the file, so that only one image
+  // is held in memory at a time.
+  for (const auto* image : inlined_images) {
+    std::string image_url;
+    base::JSONWriter::Write(base::Value(image->url.spec()), &image_url);
+    if (!writer->Write("imgData[") || !writer->Write(image_url) ||
+        !writer->Write("] = \"data:image/png;base64,") ||
+        !writer->WriteBase64(image->data) || !writer->Write("\";")) {
+      return false;
+    }
+  }
+  return writer->Write(kReplaceDownloadedImagesScriptSuffix);
 }
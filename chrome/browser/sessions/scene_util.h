@@ -14,6 +14,10 @@
 // Name of the file storing the list of tabs.
 extern const base::FilePath::CharType kSessionFileName[];
 
+// Name of the file storing the changes journaled since the list of tabs was
+// last written.
+extern const base::FilePath::CharType kSessionJournalFileName[];
+
 // Name of the directory containing the tab snapshots.
 extern const base::FilePath::CharType kSnapshotsDirectoryName[];
 
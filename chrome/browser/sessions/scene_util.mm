@@ -61,8 +61,8 @@ SessionMigration MigrateSessionStorageForDirectoryImpl(
 
   // List of files to use to identify the previous session directory (and also
   // to migrate to the new path).
-  const base::FilePath::CharType* kCandidateNames[] = {kSessionFileName,
-                                                       kSnapshotsDirectoryName};
+  const base::FilePath::CharType* kCandidateNames[] = {
+      kSessionFileName, kSessionJournalFileName, kSnapshotsDirectoryName};
 
   // Try to identify the previous session directory. This is done by iterating
   // over the possible previous session identifier, and looking for the files
@@ -141,6 +141,9 @@ SessionMigration MigrateSessionStorageForDirectoryImpl(
 const base::FilePath::CharType kSessionFileName[] =
     FILE_PATH_LITERAL("session.plist");
 
+const base::FilePath::CharType kSessionJournalFileName[] =
+    FILE_PATH_LITERAL("session.plist-journal");
+
 const base::FilePath::CharType kSnapshotsDirectoryName[] =
     FILE_PATH_LITERAL("Snapshots");
 
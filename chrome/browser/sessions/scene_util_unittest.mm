@@ -135,6 +135,7 @@ TEST_F(SceneUtilTest, MigrateSessionStorageForDirectory_FromM86OrOlder) {
       "Snapshots/1.png",
       "Snapshots/2.png",
       "session.plist",
+      "session.plist-journal",
   });
 
   ASSERT_TRUE(temp_directory.IsValid());
@@ -146,6 +147,8 @@ TEST_F(SceneUtilTest, MigrateSessionStorageForDirectory_FromM86OrOlder) {
       base::FilePath(FILE_PATH_LITERAL("Sessions/session-id/Snapshots/1.png")),
       base::FilePath(FILE_PATH_LITERAL("Sessions/session-id/Snapshots/2.png")),
       base::FilePath(FILE_PATH_LITERAL("Sessions/session-id/session.plist")),
+      base::FilePath(
+          FILE_PATH_LITERAL("Sessions/session-id/session.plist-journal")),
   };
 
   EXPECT_EQ(expected, GetDirectoryContent(directory));
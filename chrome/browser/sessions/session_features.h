@@ -15,6 +15,14 @@ extern const base::Feature kSaveSessionTabsToSeparateFiles;
 // If enabled, save each tab content to a separate file.
 bool ShouldSaveSessionTabsToSeparateFiles();
 
+// If enabled, session saves append the changed tabs and the tab order to a
+// session journal instead of rewriting the whole session file, which is only
+// rewritten when the journal grows too large.
+extern const base::Feature kSaveSessionJournal;
+
+// Returns whether sessions should be saved to a session journal.
+bool ShouldSaveSessionJournal();
+
 }  // namespace sessions
 
 #endif  // IOS_CHROME_BROWSER_SESSIONS_SESSION_FEATURES_H_
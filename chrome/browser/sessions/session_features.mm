@@ -17,4 +17,11 @@ bool ShouldSaveSessionTabsToSeparateFiles() {
   return base::FeatureList::IsEnabled(kSaveSessionTabsToSeparateFiles);
 }
 
+const base::Feature kSaveSessionJournal{"SaveSessionJournal",
+                                        base::FEATURE_DISABLED_BY_DEFAULT};
+
+bool ShouldSaveSessionJournal() {
+  return base::FeatureList::IsEnabled(kSaveSessionJournal);
+}
+
 }  // namespace sessions
@@ -13,6 +13,7 @@ class WebState;
 
 class WebStateList;
 @class SessionIOS;
+@class SessionJournalRecord;
 
 // A factory that is used to create a SessionIOS object for a specific
 // WebStateList. It's the responsibility of the owner of the SessionIOSFactory
@@ -36,6 +37,17 @@ class WebStateList;
 // Dirty webStates are reset when calling |sessionForSaving|.
 - (void)markWebStateDirty:(web::WebState*)webState;
 
+// Returns the session journal records describing the changes since the last
+// call to |sessionForSaving| or |journalRecordsForSaving|: the session of the
+// dirty webStates and of the webStates whose opener moved, followed by the
+// order of the webStates if it changed. The array is empty if nothing changed.
+// Returns nil if the session can't be journaled, either because it can't be
+// saved or because |sessionForSaving| was never called, in which case a full
+// save is needed.
+// Dirty webStates are reset when calling |journalRecordsForSaving|, but are
+// still serialized by the next call to |sessionForSaving|.
+- (NSArray<SessionJournalRecord*>*)journalRecordsForSaving;
+
 @end
 
 #endif  // IOS_CHROME_BROWSER_SESSIONS_SESSION_IOS_FACTORY_H_
@@ -5,8 +5,11 @@
 #import "ios/chrome/browser/sessions/session_ios_factory.h"
 
 #import "ios/chrome/browser/sessions/session_ios.h"
+#import "ios/chrome/browser/sessions/session_journal_ios.h"
+#import "ios/chrome/browser/sessions/session_window_ios.h"
 #import "ios/chrome/browser/web_state_list/web_state_list.h"
 #import "ios/chrome/browser/web_state_list/web_state_list_serialization.h"
+#import "ios/web/public/session/crw_session_storage.h"
 #import "ios/web/public/web_state.h"
 
 #if !defined(__has_feature) || !__has_feature(objc_arc)
@@ -21,6 +24,15 @@
 @implementation SessionIOSFactory {
   WebStateList* _webStateList;
   NSMutableSet<NSString*>* _dirtyWebStates;
+  // The webStates journaled since the last call to |sessionForSaving|. They
+  // are serialized again by the next call, so that their tab contents are
+  // written when the tabs are saved to separate files.
+  NSMutableSet<NSString*>* _journaledWebStates;
+  // The order of the webStates and the selected index as of the last saved
+  // session or journal records. |_savedIdentifiers| is nil until the first
+  // call to |sessionForSaving|.
+  NSArray<NSString*>* _savedIdentifiers;
+  NSUInteger _savedSelectedIndex;
 }
 
 #pragma mark - Initialization
@@ -30,6 +42,7 @@
     DCHECK(webStateList);
     _webStateList = webStateList;
     _dirtyWebStates = [[NSMutableSet alloc] init];
+    _journaledWebStates = [[NSMutableSet alloc] init];
   }
   return self;
 }
@@ -47,13 +60,55 @@
   // be done on a separate thread.
   // TODO(crbug.com/661986): This could get expensive especially since this
   // window may never be saved (if another call comes in before the delay).
-  SessionIOS* session = [[SessionIOS alloc]
-      initWithWindows:@[ SerializeWebStateList(_webStateList,
-                                               _dirtyWebStates) ]];
+  [_dirtyWebStates unionSet:_journaledWebStates];
+  SessionWindowIOS* window =
+      SerializeWebStateList(_webStateList, _dirtyWebStates);
+  SessionIOS* session = [[SessionIOS alloc] initWithWindows:@[ window ]];
   [_dirtyWebStates removeAllObjects];
+  [_journaledWebStates removeAllObjects];
+
+  NSMutableArray<NSString*>* identifiers =
+      [NSMutableArray arrayWithCapacity:window.sessions.count];
+  for (CRWSessionStorage* sessionStorage in window.sessions)
+    [identifiers addObject:sessionStorage.stableIdentifier];
+  _savedIdentifiers = [identifiers copy];
+  _savedSelectedIndex = window.selectedIndex;
   return session;
 }
 
+- (NSArray<SessionJournalRecord*>*)journalRecordsForSaving {
+  if (!_savedIdentifiers || ![self canSaveCurrentSession])
+    return nil;
+
+  NSArray<NSString*>* identifiers = nil;
+  NSUInteger selectedIndex = NSNotFound;
+  NSDictionary<NSString*, CRWSessionStorage*>* sessionStorages =
+      SerializeWebStateListIncrementally(_webStateList, _dirtyWebStates,
+                                         &identifiers, &selectedIndex);
+  [_journaledWebStates unionSet:_dirtyWebStates];
+  [_dirtyWebStates removeAllObjects];
+
+  NSMutableArray<SessionJournalRecord*>* records = [NSMutableArray array];
+  for (NSString* identifier in identifiers) {
+    CRWSessionStorage* sessionStorage = sessionStorages[identifier];
+    if (!sessionStorage)
+      continue;
+    [records addObject:[SessionJournalRecord
+                           recordWithSessionStorage:sessionStorage
+                                         identifier:identifier]];
+  }
+
+  if (![identifiers isEqualToArray:_savedIdentifiers] ||
+      selectedIndex != _savedSelectedIndex) {
+    [records addObject:[SessionJournalRecord
+                           recordWithIdentifiers:identifiers
+                                   selectedIndex:selectedIndex]];
+    _savedIdentifiers = identifiers;
+    _savedSelectedIndex = selectedIndex;
+  }
+  return records;
+}
+
 - (void)markWebStateDirty:(web::WebState*)webState {
   NSString* webStateID = webState->GetStableIdentifier();
   [_dirtyWebStates addObject:webStateID];
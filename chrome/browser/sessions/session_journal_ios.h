@@ -0,0 +1,79 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef IOS_CHROME_BROWSER_SESSIONS_SESSION_JOURNAL_IOS_H_
+#define IOS_CHROME_BROWSER_SESSIONS_SESSION_JOURNAL_IOS_H_
+
+#import <Foundation/Foundation.h>
+
+@class CRWSessionStorage;
+@class SessionIOS;
+
+// A single entry of a session journal. A journal is an append-only log of
+// records that are replayed on top of the last full session file (the
+// "compacted" session) to recover the current state of a session.
+@interface SessionJournalRecord : NSObject <NSCoding>
+
+// Creates a record storing the session of the WebState with |identifier|.
+// Replaying it replaces any previous session for that WebState.
++ (instancetype)recordWithSessionStorage:(CRWSessionStorage*)sessionStorage
+                              identifier:(NSString*)identifier;
+
+// Creates a record storing the order of the WebStates in the WebStateList, by
+// stable identifier, and the selected index. Replaying it drops the sessions
+// of the WebStates that are no longer in |identifiers|.
++ (instancetype)recordWithIdentifiers:(NSArray<NSString*>*)identifiers
+                        selectedIndex:(NSUInteger)selectedIndex;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+// The stable identifier of the WebState for WebState records, nil otherwise.
+@property(nonatomic, readonly) NSString* identifier;
+
+// The session storage for WebState records, nil otherwise.
+@property(nonatomic, readonly) CRWSessionStorage* sessionStorage;
+
+// The ordered stable identifiers for WebStateList records, nil otherwise.
+@property(nonatomic, readonly) NSArray<NSString*>* identifiers;
+
+// The selected index for WebStateList records, NSNotFound otherwise.
+@property(nonatomic, readonly) NSUInteger selectedIndex;
+
+@end
+
+// Reads and writes session journal files. The journal of a session is stored
+// next to the session file. Each record is written as a little-endian uint32
+// payload length, a uint32 checksum of the payload and the keyed archive of
+// the record, so that a record torn by a crash can be detected and ignored.
+// All methods perform blocking I/O and must not be called on the main thread,
+// except the ones that don't access the disk.
+@interface SessionJournalIOS : NSObject
+
+// Returns the path of the journal of the session file at |sessionPath|.
++ (NSString*)journalPathForSessionPath:(NSString*)sessionPath;
+
+// Encodes |records| in the journal file format. Does not access the disk.
+// Returns nil on error.
++ (NSData*)dataForRecords:(NSArray<SessionJournalRecord*>*)records;
+
+// Appends |data|, as returned by +dataForRecords:, to the journal at
+// |journalPath|, creating it if needed. Returns whether the data was written.
++ (BOOL)appendData:(NSData*)data toJournalAtPath:(NSString*)journalPath;
+
+// Returns the records of the journal at |journalPath|, in order. Stops at the
+// first truncated or corrupted record. Returns an empty array if there is no
+// journal.
++ (NSArray<SessionJournalRecord*>*)recordsOfJournalAtPath:
+    (NSString*)journalPath;
+
+// Returns the session obtained by replaying |records| on top of |session|.
+// |session| may be nil if there is no compacted session. Returns nil if the
+// resulting session is empty and |session| was nil.
++ (SessionIOS*)sessionByReplayingRecords:
+                   (NSArray<SessionJournalRecord*>*)records
+                               onSession:(SessionIOS*)session;
+
+@end
+
+#endif  // IOS_CHROME_BROWSER_SESSIONS_SESSION_JOURNAL_IOS_H_
@@ -0,0 +1,299 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#import "ios/chrome/browser/sessions/session_journal_ios.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include "base/hash/hash.h"
+#include "base/logging.h"
+#import "base/mac/foundation_util.h"
+#include "base/strings/sys_string_conversions.h"
+#import "ios/chrome/browser/sessions/NSCoder+Compatibility.h"
+#import "ios/chrome/browser/sessions/session_ios.h"
+#import "ios/chrome/browser/sessions/session_window_ios.h"
+#import "ios/web/public/session/crw_session_storage.h"
+
+#if !defined(__has_feature) || !__has_feature(objc_arc)
+#error "This file requires ARC support."
+#endif
+
+// When C++ exceptions are disabled, the C++ library defines |try| and
+// |catch| so as to allow exception-expecting C++ code to build properly when
+// language support for exceptions is not present.  These macros interfere
+// with the use of |@try| and |@catch| in Objective-C files such as this one.
+// Undefine these macros here, after everything has been #included, since
+// there will be no C++ uses and only Objective-C uses from this point on.
+#undef try
+#undef catch
+
+namespace {
+// Serialization keys.
+NSString* const kIdentifierKey = @"identifier";
+NSString* const kSessionStorageKey = @"sessionStorage";
+NSString* const kIdentifiersKey = @"identifiers";
+NSString* const kSelectedIndexKey = @"selectedIndex";
+
+// Suffix appended to the session path to get the journal path. Must match
+// kSessionJournalFileName.
+NSString* const kJournalSuffix = @"-journal";
+
+// Size of the header preceding each record: payload length and checksum.
+const size_t kRecordHeaderSize = 2 * sizeof(uint32_t);
+
+// Returns the checksum of |data|.
+uint32_t ChecksumForData(NSData* data) {
+  return base::PersistentHash(data.bytes, data.length);
+}
+
+// Returns |index| if it is a valid selected index for |count| sessions,
+// otherwise the closest valid one.
+NSUInteger ValidSelectedIndex(NSUInteger index, NSUInteger count) {
+  if (!count)
+    return NSNotFound;
+  if (index == static_cast<NSUInteger>(NSNotFound) || index >= count)
+    return 0;
+  return index;
+}
+}  // namespace
+
+@implementation SessionJournalRecord
+
++ (instancetype)recordWithSessionStorage:(CRWSessionStorage*)sessionStorage
+                              identifier:(NSString*)identifier {
+  DCHECK(sessionStorage);
+  DCHECK(identifier.length);
+  return [[self alloc] initWithIdentifier:identifier
+                           sessionStorage:sessionStorage
+                              identifiers:nil
+                            selectedIndex:NSNotFound];
+}
+
++ (instancetype)recordWithIdentifiers:(NSArray<NSString*>*)identifiers
+                        selectedIndex:(NSUInteger)selectedIndex {
+  DCHECK(identifiers);
+  return [[self alloc] initWithIdentifier:nil
+                           sessionStorage:nil
+                              identifiers:identifiers
+                            selectedIndex:selectedIndex];
+}
+
+- (instancetype)initWithIdentifier:(NSString*)identifier
+                    sessionStorage:(CRWSessionStorage*)sessionStorage
+                       identifiers:(NSArray<NSString*>*)identifiers
+                     selectedIndex:(NSUInteger)selectedIndex {
+  if ((self = [super init])) {
+    _identifier = [identifier copy];
+    _sessionStorage = sessionStorage;
+    _identifiers = [identifiers copy];
+    _selectedIndex = selectedIndex;
+  }
+  return self;
+}
+
+#pragma mark - NSCoding
+
+- (instancetype)initWithCoder:(NSCoder*)aDecoder {
+  NSString* identifier = base::mac::ObjCCast<NSString>(
+      [aDecoder decodeObjectForKey:kIdentifierKey]);
+  CRWSessionStorage* sessionStorage = base::mac::ObjCCast<CRWSessionStorage>(
+      [aDecoder decodeObjectForKey:kSessionStorageKey]);
+  NSArray<NSString*>* identifiers = base::mac::ObjCCast<NSArray>(
+      [aDecoder decodeObjectForKey:kIdentifiersKey]);
+
+  // A record is either a WebState record or a WebStateList record.
+  if (!identifiers == !(identifier && sessionStorage))
+    return nil;
+
+  return [self initWithIdentifier:identifier
+                   sessionStorage:sessionStorage
+                      identifiers:identifiers
+                    selectedIndex:[aDecoder
+                                      cr_decodeIndexForKey:kSelectedIndexKey]];
+}
+
+- (void)encodeWithCoder:(NSCoder*)aCoder {
+  [aCoder encodeObject:_identifier forKey:kIdentifierKey];
+  [aCoder encodeObject:_sessionStorage forKey:kSessionStorageKey];
+  [aCoder encodeObject:_identifiers forKey:kIdentifiersKey];
+  [aCoder cr_encodeIndex:_selectedIndex forKey:kSelectedIndexKey];
+}
+
+@end
+
+@implementation SessionJournalIOS
+
++ (NSString*)journalPathForSessionPath:(NSString*)sessionPath {
+  return [sessionPath stringByAppendingString:kJournalSuffix];
+}
+
++ (NSData*)dataForRecords:(NSArray<SessionJournalRecord*>*)records {
+  NSMutableData* data = [NSMutableData data];
+  for (SessionJournalRecord* record in records) {
+    NSData* payload = nil;
+    @try {
+      NSError* error = nil;
+      payload = [NSKeyedArchiver archivedDataWithRootObject:record
+                                      requiringSecureCoding:NO
+                                                      error:&error];
+      if (!payload || error) {
+        DLOG(WARNING) << "Error serializing session journal record: "
+                      << base::SysNSStringToUTF8([error description]);
+        return nil;
+      }
+    } @catch (NSException* exception) {
+      NOTREACHED() << "Error serializing session journal record: "
+                   << base::SysNSStringToUTF8([exception description]);
+      return nil;
+    }
+
+    const uint32_t header[] = {
+        static_cast<uint32_t>(payload.length),
+        ChecksumForData(payload),
+    };
+    [data appendBytes:header length:sizeof(header)];
+    [data appendData:payload];
+  }
+  return data;
+}
+
++ (BOOL)appendData:(NSData*)data toJournalAtPath:(NSString*)journalPath {
+  NSError* error = nil;
+  NSFileManager* fileManager = [NSFileManager defaultManager];
+  if (![fileManager fileExistsAtPath:journalPath]) {
+    NSDataWritingOptions options =
+        NSDataWritingAtomic |
+        NSDataWritingFileProtectionCompleteUntilFirstUserAuthentication;
+    if (![data writeToFile:journalPath options:options error:&error]) {
+      DLOG(WARNING) << "Error creating session journal: "
+                    << base::SysNSStringToUTF8(journalPath) << ": "
+                    << base::SysNSStringToUTF8([error description]);
+      return NO;
+    }
+    return YES;
+  }
+
+  NSFileHandle* fileHandle = [NSFileHandle
+      fileHandleForWritingToURL:[NSURL fileURLWithPath:journalPath]
+                          error:&error];
+  unsigned long long offset = 0;
+  BOOL success = fileHandle &&
+                 [fileHandle seekToEndReturningOffset:&offset error:&error] &&
+                 [fileHandle writeData:data error:&error];
+  [fileHandle closeAndReturnError:nil];
+  if (!success) {
+    DLOG(WARNING) << "Error appending to session journal: "
+                  << base::SysNSStringToUTF8(journalPath) << ": "
+                  << base::SysNSStringToUTF8([error description]);
+  }
+  return success;
+}
+
++ (NSArray<SessionJournalRecord*>*)recordsOfJournalAtPath:
+    (NSString*)journalPath {
+  NSData* data = [NSData dataWithContentsOfFile:journalPath];
+  NSMutableArray<SessionJournalRecord*>* records = [NSMutableArray array];
+  const uint8_t* bytes = static_cast<const uint8_t*>(data.bytes);
+  size_t offset = 0;
+  while (data.length - offset >= kRecordHeaderSize) {
+    uint32_t header[2];
+    memcpy(header, bytes + offset, sizeof(header));
+    offset += kRecordHeaderSize;
+    if (header[0] > data.length - offset) {
+      DLOG(WARNING) << "Truncated session journal record: "
+                    << base::SysNSStringToUTF8(journalPath);
+      break;
+    }
+
+    NSData* payload = [data subdataWithRange:NSMakeRange(offset, header[0])];
+    offset += header[0];
+    if (ChecksumForData(payload) != header[1]) {
+      DLOG(WARNING) << "Corrupted session journal record: "
+                    << base::SysNSStringToUTF8(journalPath);
+      break;
+    }
+
+    SessionJournalRecord* record = nil;
+    @try {
+      NSError* error = nil;
+      NSKeyedUnarchiver* unarchiver =
+          [[NSKeyedUnarchiver alloc] initForReadingFromData:payload
+                                                      error:&error];
+      unarchiver.requiresSecureCoding = NO;
+      record = base::mac::ObjCCast<SessionJournalRecord>(
+          [unarchiver decodeObjectForKey:NSKeyedArchiveRootObjectKey]);
+    } @catch (NSException* exception) {
+      DLOG(WARNING) << "Error decoding session journal record: "
+                    << base::SysNSStringToUTF8([exception reason]);
+    }
+    if (!record)
+      break;
+    [records addObject:record];
+  }
+  return records;
+}
+
++ (SessionIOS*)sessionByReplayingRecords:
+                   (NSArray<SessionJournalRecord*>*)records
+                               onSession:(SessionIOS*)session {
+  if (!records.count)
+    return session;
+
+  DCHECK_LE(session.sessionWindows.count, 1u);
+  SessionWindowIOS* window = session.sessionWindows.firstObject;
+
+  NSMutableDictionary<NSString*, CRWSessionStorage*>* storages =
+      [NSMutableDictionary dictionary];
+  NSMutableArray<NSString*>* identifiers = [NSMutableArray array];
+  for (CRWSessionStorage* storage in window.sessions) {
+    if (!storage.stableIdentifier.length)
+      continue;
+    storages[storage.stableIdentifier] = storage;
+    [identifiers addObject:storage.stableIdentifier];
+  }
+  NSUInteger selectedIndex = window ? window.selectedIndex : NSNotFound;
+
+  for (SessionJournalRecord* record in records) {
+    if (record.identifiers) {
+      identifiers = [record.identifiers mutableCopy];
+      selectedIndex = record.selectedIndex;
+      // Forget the sessions of the closed WebStates.
+      NSSet<NSString*>* keptIdentifiers = [NSSet setWithArray:identifiers];
+      for (NSString* identifier in [storages allKeys]) {
+        if (![keptIdentifiers containsObject:identifier])
+          [storages removeObjectForKey:identifier];
+      }
+    } else {
+      storages[record.identifier] = record.sessionStorage;
+    }
+  }
+
+  // Sessions whose record was lost are skipped. The selection is kept on the
+  // same WebState if it is still present.
+  NSMutableArray<CRWSessionStorage*>* sessions =
+      [NSMutableArray arrayWithCapacity:identifiers.count];
+  NSUInteger replayedSelectedIndex = NSNotFound;
+  for (NSUInteger index = 0; index < identifiers.count; ++index) {
+    CRWSessionStorage* storage = storages[identifiers[index]];
+    if (!storage)
+      continue;
+    if (index == selectedIndex)
+      replayedSelectedIndex = sessions.count;
+    [sessions addObject:storage];
+  }
+
+  if (!session && !sessions.count)
+    return nil;
+
+  SessionWindowIOS* replayedWindow = [[SessionWindowIOS alloc]
+      initWithSessions:sessions
+       sessionsSummary:nil
+           tabContents:nil
+         selectedIndex:ValidSelectedIndex(replayedSelectedIndex,
+                                         sessions.count)];
+  return [[SessionIOS alloc] initWithWindows:@[ replayedWindow ]];
+}
+
+@end
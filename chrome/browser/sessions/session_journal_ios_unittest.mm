@@ -0,0 +1,157 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#import "ios/chrome/browser/sessions/session_journal_ios.h"
+
+#import <Foundation/Foundation.h>
+
+#include "base/files/scoped_temp_dir.h"
+#include "base/strings/sys_string_conversions.h"
+#import "ios/chrome/browser/sessions/session_ios.h"
+#import "ios/chrome/browser/sessions/session_window_ios.h"
+#import "ios/web/public/session/crw_session_storage.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/gtest_mac.h"
+#include "testing/platform_test.h"
+
+#if !defined(__has_feature) || !__has_feature(objc_arc)
+#error "This file requires ARC support."
+#endif
+
+namespace {
+
+// Returns a session storage with |identifier|.
+CRWSessionStorage* CreateSessionStorage(NSString* identifier) {
+  CRWSessionStorage* session_storage = [[CRWSessionStorage alloc] init];
+  session_storage.stableIdentifier = identifier;
+  return session_storage;
+}
+
+// Returns a session with one window containing sessions for |identifiers|.
+SessionIOS* CreateSession(NSArray<NSString*>* identifiers,
+                          NSUInteger selected_index) {
+  NSMutableArray<CRWSessionStorage*>* sessions = [NSMutableArray array];
+  for (NSString* identifier in identifiers)
+    [sessions addObject:CreateSessionStorage(identifier)];
+  SessionWindowIOS* window =
+      [[SessionWindowIOS alloc] initWithSessions:sessions
+                                 sessionsSummary:nil
+                                     tabContents:nil
+                                   selectedIndex:selected_index];
+  return [[SessionIOS alloc] initWithWindows:@[ window ]];
+}
+
+// Returns the stable identifiers of the sessions of the window of |session|.
+NSArray<NSString*>* IdentifiersOfSession(SessionIOS* session) {
+  NSMutableArray<NSString*>* identifiers = [NSMutableArray array];
+  for (CRWSessionStorage* storage in session.sessionWindows[0].sessions)
+    [identifiers addObject:storage.stableIdentifier];
+  return identifiers;
+}
+
+class SessionJournalIOSTest : public PlatformTest {
+ protected:
+  void SetUp() override {
+    PlatformTest::SetUp();
+    ASSERT_TRUE(scoped_temp_directory_.CreateUniqueTempDir());
+    journal_path_ = [SessionJournalIOS
+        journalPathForSessionPath:base::SysUTF8ToNSString(
+                                      scoped_temp_directory_.GetPath()
+                                          .Append("session.plist")
+                                          .AsUTF8Unsafe())];
+  }
+
+  base::ScopedTempDir scoped_temp_directory_;
+  NSString* journal_path_ = nil;
+};
+
+// Tests that records are read back in the order they were appended.
+TEST_F(SessionJournalIOSTest, AppendAndReadRecords) {
+  NSData* data = [SessionJournalIOS dataForRecords:@[
+    [SessionJournalRecord recordWithSessionStorage:CreateSessionStorage(@"a")
+                                        identifier:@"a"],
+  ]];
+  ASSERT_TRUE(data);
+  EXPECT_TRUE(
+      [SessionJournalIOS appendData:data toJournalAtPath:journal_path_]);
+
+  data = [SessionJournalIOS dataForRecords:@[
+    [SessionJournalRecord recordWithIdentifiers:@[ @"a", @"b" ]
+                                  selectedIndex:1],
+  ]];
+  ASSERT_TRUE(data);
+  EXPECT_TRUE(
+      [SessionJournalIOS appendData:data toJournalAtPath:journal_path_]);
+
+  NSArray<SessionJournalRecord*>* records =
+      [SessionJournalIOS recordsOfJournalAtPath:journal_path_];
+  ASSERT_EQ(2u, records.count);
+  EXPECT_NSEQ(@"a", records[0].identifier);
+  EXPECT_NSEQ(@"a", records[0].sessionStorage.stableIdentifier);
+  EXPECT_FALSE(records[0].identifiers);
+  EXPECT_FALSE(records[1].identifier);
+  EXPECT_NSEQ((@[ @"a", @"b" ]), records[1].identifiers);
+  EXPECT_EQ(1u, records[1].selectedIndex);
+}
+
+// Tests that a record torn by a crash is ignored, as well as the following
+// ones.
+TEST_F(SessionJournalIOSTest, TruncatedRecordIgnored) {
+  NSData* data = [SessionJournalIOS dataForRecords:@[
+    [SessionJournalRecord recordWithIdentifiers:@[ @"a" ] selectedIndex:0],
+    [SessionJournalRecord recordWithIdentifiers:@[ @"b" ] selectedIndex:0],
+  ]];
+  ASSERT_TRUE(data);
+  NSData* truncated_data =
+      [data subdataWithRange:NSMakeRange(0, data.length - 1)];
+  EXPECT_TRUE([SessionJournalIOS appendData:truncated_data
+                            toJournalAtPath:journal_path_]);
+
+  NSArray<SessionJournalRecord*>* records =
+      [SessionJournalIOS recordsOfJournalAtPath:journal_path_];
+  ASSERT_EQ(1u, records.count);
+  EXPECT_NSEQ(@[ @"a" ], records[0].identifiers);
+}
+
+// Tests that reading a missing journal returns no records.
+TEST_F(SessionJournalIOSTest, MissingJournal) {
+  EXPECT_EQ(0u, [SessionJournalIOS recordsOfJournalAtPath:journal_path_].count);
+}
+
+// Tests that replaying records updates, reorders and drops sessions.
+TEST_F(SessionJournalIOSTest, ReplayRecords) {
+  SessionIOS* session = CreateSession(@[ @"a", @"b", @"c" ], 2);
+  CRWSessionStorage* new_b = CreateSessionStorage(@"b");
+  NSArray<SessionJournalRecord*>* records = @[
+    [SessionJournalRecord recordWithSessionStorage:new_b identifier:@"b"],
+    [SessionJournalRecord recordWithSessionStorage:CreateSessionStorage(@"d")
+                                        identifier:@"d"],
+    [SessionJournalRecord recordWithIdentifiers:@[ @"d", @"c", @"b" ]
+                                  selectedIndex:1],
+  ];
+
+  SessionIOS* replayed_session =
+      [SessionJournalIOS sessionByReplayingRecords:records onSession:session];
+  ASSERT_EQ(1u, replayed_session.sessionWindows.count);
+  EXPECT_NSEQ((@[ @"d", @"c", @"b" ]), IdentifiersOfSession(replayed_session));
+  EXPECT_EQ(new_b, replayed_session.sessionWindows[0].sessions[2]);
+  EXPECT_EQ(1u, replayed_session.sessionWindows[0].selectedIndex);
+}
+
+// Tests that WebStates whose session record is missing are skipped and that
+// the selection follows the selected WebState.
+TEST_F(SessionJournalIOSTest, ReplayRecordsWithMissingSession) {
+  SessionIOS* session = CreateSession(@[ @"a", @"b" ], 0);
+  NSArray<SessionJournalRecord*>* records = @[
+    [SessionJournalRecord recordWithIdentifiers:@[ @"a", @"x", @"b" ]
+                                  selectedIndex:2],
+  ];
+
+  SessionIOS* replayed_session =
+      [SessionJournalIOS sessionByReplayingRecords:records onSession:session];
+  EXPECT_NSEQ((@[ @"a", @"b" ]), IdentifiersOfSession(replayed_session));
+  EXPECT_EQ(1u, replayed_session.sessionWindows[0].selectedIndex);
+}
+
+}  // namespace
@@ -98,6 +98,9 @@ class SessionRestorationBrowserAgent
   void WillDetachWebStateAt(WebStateList* web_state_list,
                             web::WebState* web_state,
                             int index) override;
+  void WillDetachWebStatesAt(WebStateList* web_state_list,
+                             const std::vector<web::WebState*>& web_states,
+                             const std::vector<int>& indices) override;
   void WebStateInsertedAt(WebStateList* web_state_list,
                           web::WebState* web_state,
                           int index,
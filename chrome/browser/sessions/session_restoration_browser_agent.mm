@@ -4,6 +4,8 @@
 
 #include "ios/chrome/browser/sessions/session_restoration_browser_agent.h"
 
+#include <algorithm>
+
 #import "base/ios/ios_util.h"
 #include "base/memory/ptr_util.h"
 #include "base/strings/sys_string_conversions.h"
@@ -256,6 +258,21 @@ void SessionRestorationBrowserAgent::WillDetachWebStateAt(
   SaveSession(/*immediately=*/false);
 }
 
+void SessionRestorationBrowserAgent::WillDetachWebStatesAt(
+    WebStateList* web_state_list,
+    const std::vector<web::WebState*>& web_states,
+    const std::vector<int>& indices) {
+  // Persist the session state once if any background tab is detached.
+  const int active_index = web_state_list->active_index();
+  const bool only_active_detached =
+      std::all_of(indices.begin(), indices.end(),
+                  [active_index](int index) { return index == active_index; });
+  if (only_active_detached)
+    return;
+
+  SaveSession(/*immediately=*/false);
+}
+
 void SessionRestorationBrowserAgent::WebStateInsertedAt(
     WebStateList* web_state_list,
     web::WebState* web_state,
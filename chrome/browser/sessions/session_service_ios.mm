@@ -25,6 +25,7 @@
 #include "ios/chrome/browser/sessions/session_features.h"
 #import "ios/chrome/browser/sessions/session_ios.h"
 #import "ios/chrome/browser/sessions/session_ios_factory.h"
+#import "ios/chrome/browser/sessions/session_journal_ios.h"
 #import "ios/chrome/browser/sessions/session_window_ios.h"
 #import "ios/web/public/session/crw_navigation_item_storage.h"
 #import "ios/web/public/session/crw_session_certificate_policy_cache_storage.h"
@@ -46,6 +47,12 @@
 namespace {
 const NSTimeInterval kSaveDelay = 2.5;     // Value taken from Desktop Chrome.
 NSString* const kRootObjectKey = @"root";  // Key for the root object.
+
+// Minimum size of a session journal before the session is compacted, i.e.
+// fully saved again. Above it, the session is compacted once its journal is
+// larger than the last full session, so that the bytes written stay
+// proportional to the size of the changes.
+const NSUInteger kMinJournalSizeForCompaction = 256 * 1024;
 }
 
 @implementation NSKeyedUnarchiver (CrLegacySessionCompatibility)
@@ -65,6 +72,11 @@ NSString* const kRootObjectKey = @"root";  // Key for the root object.
   // Maps session path to the pending session factories for the delayed save
   // behaviour. SessionIOSFactory pointers are weak.
   NSMapTable<NSString*, SessionIOSFactory*>* _pendingSessions;
+
+  // Maps session path to the size of the last full session saved there, and
+  // to the size of the journal records appended since then.
+  NSMutableDictionary<NSString*, NSNumber*>* _compactedSessionSizes;
+  NSMutableDictionary<NSString*, NSNumber*>* _journalSizes;
 }
 
 #pragma mark - NSObject overrides
@@ -93,6 +105,8 @@ NSString* const kRootObjectKey = @"root";  // Key for the root object.
   self = [super init];
   if (self) {
     _pendingSessions = [NSMapTable strongToWeakObjectsMapTable];
+    _compactedSessionSizes = [NSMutableDictionary dictionary];
+    _journalSizes = [NSMutableDictionary dictionary];
     _taskRunner = taskRunner;
   }
   return self;
@@ -130,45 +144,19 @@ NSString* const kRootObjectKey = @"root";  // Key for the root object.
 }
 
 - (SessionIOS*)loadSessionFromPath:(NSString*)sessionPath {
-  NSObject<NSCoding>* rootObject = nil;
-  @try {
-    NSData* data = [NSData dataWithContentsOfFile:sessionPath];
-    if (!data)
-      return nil;
-
-    NSError* error = nil;
-    NSKeyedUnarchiver* unarchiver =
-        [[NSKeyedUnarchiver alloc] initForReadingFromData:data error:&error];
-    if (!unarchiver || error) {
-      DLOG(WARNING) << "Error creating unarchiver, session file: "
-                    << base::SysNSStringToUTF8(sessionPath) << ": "
-                    << base::SysNSStringToUTF8([error description]);
-      return nil;
-    }
-
-    unarchiver.requiresSecureCoding = NO;
-
-    // Register compatibility aliases to support legacy saved sessions.
-    [unarchiver cr_registerCompatibilityAliases];
-    rootObject = [unarchiver decodeObjectForKey:kRootObjectKey];
-  } @catch (NSException* exception) {
-    NOTREACHED() << "Error loading session file: "
-                 << base::SysNSStringToUTF8(sessionPath) << ": "
-                 << base::SysNSStringToUTF8([exception reason]);
-  }
-
-  if (!rootObject)
+  SessionIOS* session = [self loadCompactedSessionFromPath:sessionPath];
+  // A journal is only appended to once its session file is written, so a
+  // journal without a session file is left over from a deleted session.
+  if (!session)
     return nil;
 
-  // Support for legacy saved session that contained a single SessionWindowIOS
-  // object as the root object (pre-M-59).
-  if ([rootObject isKindOfClass:[SessionWindowIOS class]]) {
-    return [[SessionIOS alloc] initWithWindows:@[
-      base::mac::ObjCCastStrict<SessionWindowIOS>(rootObject)
-    ]];
-  }
-
-  return base::mac::ObjCCastStrict<SessionIOS>(rootObject);
+  // Replay the changes journaled since the session file was last written.
+  NSString* journalPath =
+      [SessionJournalIOS journalPathForSessionPath:sessionPath];
+  NSArray<SessionJournalRecord*>* records =
+      [SessionJournalIOS recordsOfJournalAtPath:journalPath];
+  return [SessionJournalIOS sessionByReplayingRecords:records
+                                            onSession:session];
 }
 
 - (void)deleteAllSessionFilesInDirectory:(const base::FilePath&)directory
@@ -219,6 +207,50 @@ NSString* const kRootObjectKey = @"root";  // Key for the root object.
 
 #pragma mark - Private methods
 
+// Loads the session from the session file at |sessionPath|, ignoring the
+// session journal.
+- (SessionIOS*)loadCompactedSessionFromPath:(NSString*)sessionPath {
+  NSObject<NSCoding>* rootObject = nil;
+  @try {
+    NSData* data = [NSData dataWithContentsOfFile:sessionPath];
+    if (!data)
+      return nil;
+
+    NSError* error = nil;
+    NSKeyedUnarchiver* unarchiver =
+        [[NSKeyedUnarchiver alloc] initForReadingFromData:data error:&error];
+    if (!unarchiver || error) {
+      DLOG(WARNING) << "Error creating unarchiver, session file: "
+                    << base::SysNSStringToUTF8(sessionPath) << ": "
+                    << base::SysNSStringToUTF8([error description]);
+      return nil;
+    }
+
+    unarchiver.requiresSecureCoding = NO;
+
+    // Register compatibility aliases to support legacy saved sessions.
+    [unarchiver cr_registerCompatibilityAliases];
+    rootObject = [unarchiver decodeObjectForKey:kRootObjectKey];
+  } @catch (NSException* exception) {
+    NOTREACHED() << "Error loading session file: "
+                 << base::SysNSStringToUTF8(sessionPath) << ": "
+                 << base::SysNSStringToUTF8([exception reason]);
+  }
+
+  if (!rootObject)
+    return nil;
+
+  // Support for legacy saved session that contained a single SessionWindowIOS
+  // object as the root object (pre-M-59).
+  if ([rootObject isKindOfClass:[SessionWindowIOS class]]) {
+    return [[SessionIOS alloc] initWithWindows:@[
+      base::mac::ObjCCastStrict<SessionWindowIOS>(rootObject)
+    ]];
+  }
+
+  return base::mac::ObjCCastStrict<SessionIOS>(rootObject);
+}
+
 // Delete files/folders of the given |paths|.
 - (void)deletePaths:(NSArray<NSString*>*)paths
          completion:(base::OnceClosure)callback {
@@ -281,6 +313,18 @@ NSString* const kRootObjectKey = @"root";  // Key for the root object.
   // non-threadsafe objects on a background thread.
   SessionIOSFactory* factory = [_pendingSessions objectForKey:sessionPath];
   [_pendingSessions removeObjectForKey:sessionPath];
+
+  // Only append the changes to the session journal unless the session needs
+  // to be compacted.
+  if (sessions::ShouldSaveSessionJournal() &&
+      ![self shouldCompactSessionAtPath:sessionPath]) {
+    NSArray<SessionJournalRecord*>* records = [factory journalRecordsForSaving];
+    if (records) {
+      [self appendJournalRecords:records sessionPath:sessionPath];
+      return;
+    }
+  }
+
   SessionIOS* session = [factory sessionForSaving];
   // Because the factory may be called asynchronously after the underlying
   // web state list is destroyed, the session may be nil; if so, do nothing.
@@ -314,6 +358,9 @@ NSString* const kRootObjectKey = @"root";  // Key for the root object.
     base::UmaHistogramCounts100000("Session.WebStates.SerializedSize",
                                    sessionData.length / 1024);
 
+    _compactedSessionSizes[sessionPath] = @(sessionData.length);
+    [_journalSizes removeObjectForKey:sessionPath];
+
     _taskRunner->PostTask(FROM_HERE, base::BindOnce(^{
                             [self performSaveSessionData:sessionData
                                              tabContents:tabContentsById
@@ -327,6 +374,41 @@ NSString* const kRootObjectKey = @"root";  // Key for the root object.
   }
 }
 
+// Returns YES if the next save of the session at |sessionPath| must rewrite
+// the session file instead of appending to its journal.
+- (BOOL)shouldCompactSessionAtPath:(NSString*)sessionPath {
+  NSNumber* compactedSessionSize = _compactedSessionSizes[sessionPath];
+  if (!compactedSessionSize)
+    return YES;
+  NSUInteger journalSize = [_journalSizes[sessionPath] unsignedIntegerValue];
+  return journalSize >= kMinJournalSizeForCompaction &&
+         journalSize >= [compactedSessionSize unsignedIntegerValue];
+}
+
+// Appends |records| to the journal of the session at |sessionPath| on a
+// background thread.
+- (void)appendJournalRecords:(NSArray<SessionJournalRecord*>*)records
+                 sessionPath:(NSString*)sessionPath {
+  if (!records.count)
+    return;
+
+  NSData* data = [SessionJournalIOS dataForRecords:records];
+  if (!data)
+    return;
+
+  _journalSizes[sessionPath] =
+      @([_journalSizes[sessionPath] unsignedIntegerValue] + data.length);
+
+  NSString* journalPath =
+      [SessionJournalIOS journalPathForSessionPath:sessionPath];
+  _taskRunner->PostTask(FROM_HERE, base::BindOnce(^{
+                          base::ScopedBlockingCall scoped_blocking_call(
+                              FROM_HERE, base::BlockingType::MAY_BLOCK);
+                          [SessionJournalIOS appendData:data
+                                        toJournalAtPath:journalPath];
+                        }));
+}
+
 @end
 
 @implementation SessionServiceIOS (SubClassing)
@@ -367,8 +449,12 @@ NSString* const kRootObjectKey = @"root";  // Key for the root object.
       NSDataWritingAtomic |
       NSDataWritingFileProtectionCompleteUntilFirstUserAuthentication;
 
-  NSMutableArray* filesToKeep =
-      [NSMutableArray arrayWithArray:@[ sessionFilename ]];
+  // The journal is only deleted once the session file containing its changes
+  // has been written.
+  NSString* journalPath =
+      [SessionJournalIOS journalPathForSessionPath:sessionPath];
+  NSMutableArray* filesToKeep = [NSMutableArray
+      arrayWithArray:@[ sessionFilename, [journalPath lastPathComponent] ]];
   if (sessions::ShouldSaveSessionTabsToSeparateFiles()) {
     for (NSString* sessionId : tabContents) {
       [filesToKeep
@@ -403,6 +489,13 @@ NSString* const kRootObjectKey = @"root";  // Key for the root object.
   }
   UmaHistogramTimes("Session.WebStates.WriteToFileTime",
                     base::TimeTicks::Now() - start_time);
+
+  if ([fileManager fileExistsAtPath:journalPath] &&
+      ![fileManager removeItemAtPath:journalPath error:&error]) {
+    DLOG(WARNING) << "Error deleting session journal: "
+                  << base::SysNSStringToUTF8(journalPath) << ": "
+                  << base::SysNSStringToUTF8([error description]);
+  }
 }
 
 @end
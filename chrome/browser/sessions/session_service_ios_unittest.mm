@@ -21,6 +21,7 @@
 #include "ios/chrome/browser/sessions/session_features.h"
 #import "ios/chrome/browser/sessions/session_ios.h"
 #import "ios/chrome/browser/sessions/session_ios_factory.h"
+#import "ios/chrome/browser/sessions/session_journal_ios.h"
 #import "ios/chrome/browser/sessions/session_service_ios.h"
 #import "ios/chrome/browser/sessions/session_window_ios.h"
 #import "ios/chrome/browser/web_state_list/fake_web_state_list_delegate.h"
@@ -464,4 +465,155 @@ TEST_F(SessionServiceTest, LoadM58Session) {
   EXPECT_EQ(1u, session.sessionWindows.count);
 }
 
+// Tests that, with the journal enabled, saves after the first one only append
+// the changes to the journal and that loading the session replays them.
+TEST_F(SessionServiceTest, Journal_SaveAndLoadSession) {
+  base::test::ScopedFeatureList features;
+  features.InitAndEnableFeature(sessions::kSaveSessionJournal);
+
+  std::unique_ptr<WebStateList> web_state_list = CreateWebStateList(2);
+  SessionIOSFactory* factory =
+      [[SessionIOSFactory alloc] initWithWebStateList:web_state_list.get()];
+  NSString* session_id = [[NSUUID UUID] UUIDString];
+  NSString* session_path =
+      [SessionServiceIOS sessionPathForSessionID:session_id
+                                       directory:directory()];
+  NSString* journal_path =
+      [SessionJournalIOS journalPathForSessionPath:session_path];
+  NSFileManager* file_manager = [NSFileManager defaultManager];
+
+  // The first save writes the full session.
+  [session_service() saveSession:factory
+                       sessionID:session_id
+                       directory:directory()
+                     immediately:YES];
+  base::RunLoop().RunUntilIdle();
+  EXPECT_TRUE([file_manager fileExistsAtPath:session_path]);
+  EXPECT_FALSE([file_manager fileExistsAtPath:journal_path]);
+  NSData* session_data = [NSData dataWithContentsOfFile:session_path];
+
+  // Close the first WebState and insert a new one.
+  web_state_list->CloseWebStateAt(0, WebStateList::CLOSE_NO_FLAGS);
+  auto web_state = std::make_unique<web::FakeWebState>(@"2");
+  web_state->SetNavigationItemCount(1);
+  web_state_list->InsertWebState(1, std::move(web_state),
+                                 WebStateList::INSERT_FORCE_INDEX |
+                                     WebStateList::INSERT_ACTIVATE,
+                                 WebStateOpener());
+
+  // The second save only appends to the journal.
+  [session_service() saveSession:factory
+                       sessionID:session_id
+                       directory:directory()
+                     immediately:YES];
+  base::RunLoop().RunUntilIdle();
+  EXPECT_TRUE([file_manager fileExistsAtPath:journal_path]);
+  EXPECT_NSEQ(session_data, [NSData dataWithContentsOfFile:session_path]);
+
+  SessionIOS* session = [session_service() loadSessionFromPath:session_path];
+  ASSERT_EQ(1u, session.sessionWindows.count);
+  SessionWindowIOS* session_window = session.sessionWindows[0];
+  ASSERT_EQ(2u, session_window.sessions.count);
+  EXPECT_NSEQ(@"1", session_window.sessions[0].stableIdentifier);
+  EXPECT_NSEQ(@"2", session_window.sessions[1].stableIdentifier);
+  EXPECT_EQ(1u, session_window.selectedIndex);
+}
+
+// Tests that a full save deletes the journal.
+TEST_F(SessionServiceTest, Journal_FullSaveDeletesJournal) {
+  base::test::ScopedFeatureList features;
+  features.InitAndEnableFeature(sessions::kSaveSessionJournal);
+
+  std::unique_ptr<WebStateList> web_state_list = CreateWebStateList(2);
+  SessionIOSFactory* factory =
+      [[SessionIOSFactory alloc] initWithWebStateList:web_state_list.get()];
+  NSString* session_id = [[NSUUID UUID] UUIDString];
+  NSString* session_path =
+      [SessionServiceIOS sessionPathForSessionID:session_id
+                                       directory:directory()];
+  NSString* journal_path =
+      [SessionJournalIOS journalPathForSessionPath:session_path];
+
+  [session_service() saveSession:factory
+                       sessionID:session_id
+                       directory:directory()
+                     immediately:YES];
+  base::RunLoop().RunUntilIdle();
+  web_state_list->ActivateWebStateAt(1);
+  [session_service() saveSession:factory
+                       sessionID:session_id
+                       directory:directory()
+                     immediately:YES];
+  base::RunLoop().RunUntilIdle();
+  ASSERT_TRUE([[NSFileManager defaultManager] fileExistsAtPath:journal_path]);
+
+  // A new service has no compacted session yet, so it does a full save.
+  SessionServiceIOS* other_session_service = [[SessionServiceIOS alloc]
+      initWithTaskRunner:base::ThreadTaskRunnerHandle::Get()];
+  [other_session_service saveSession:factory
+                           sessionID:session_id
+                           directory:directory()
+                         immediately:YES];
+  base::RunLoop().RunUntilIdle();
+  EXPECT_FALSE([[NSFileManager defaultManager] fileExistsAtPath:journal_path]);
+
+  SessionIOS* session = [session_service() loadSessionFromPath:session_path];
+  ASSERT_EQ(1u, session.sessionWindows.count);
+  EXPECT_EQ(2u, session.sessionWindows[0].sessions.count);
+  EXPECT_EQ(1u, session.sessionWindows[0].selectedIndex);
+}
+
+// Tests that the tab contents of the webStates journaled since the last full
+// save are written by the next full save when tabs are saved to separate
+// files.
+TEST_F(SessionServiceTest, Journal_SeparateFilesWrittenOnCompaction) {
+  base::test::ScopedFeatureList features;
+  features.InitWithFeatures({sessions::kSaveSessionJournal,
+                             sessions::kSaveSessionTabsToSeparateFiles},
+                            {});
+
+  std::unique_ptr<WebStateList> web_state_list = CreateWebStateList(2);
+  SessionIOSFactory* factory =
+      [[SessionIOSFactory alloc] initWithWebStateList:web_state_list.get()];
+  NSString* session_id = [[NSUUID UUID] UUIDString];
+  NSString* session_path =
+      [SessionServiceIOS sessionPathForSessionID:session_id
+                                       directory:directory()];
+  NSString* session_tab_1_path =
+      [SessionServiceIOS filePathForTabID:@"1" sessionPath:session_path];
+
+  [session_service() saveSession:factory
+                       sessionID:session_id
+                       directory:directory()
+                     immediately:YES];
+  base::RunLoop().RunUntilIdle();
+
+  // The dirty webState is only journaled.
+  [factory markWebStateDirty:web_state_list->GetWebStateAt(1)];
+  [session_service() saveSession:factory
+                       sessionID:session_id
+                       directory:directory()
+                     immediately:YES];
+  base::RunLoop().RunUntilIdle();
+  EXPECT_FALSE([[NSFileManager defaultManager]
+      fileExistsAtPath:session_tab_1_path]);
+
+  // A new service has no compacted session yet, so it does a full save, which
+  // writes the tab contents of the journaled webState.
+  SessionServiceIOS* other_session_service = [[SessionServiceIOS alloc]
+      initWithTaskRunner:base::ThreadTaskRunnerHandle::Get()];
+  [other_session_service saveSession:factory
+                           sessionID:session_id
+                           directory:directory()
+                         immediately:YES];
+  base::RunLoop().RunUntilIdle();
+
+  CRWSessionStorage* storage =
+      web_state_list->GetWebStateAt(1)->BuildSessionStorage();
+  NSData* data = [NSKeyedArchiver archivedDataWithRootObject:storage
+                                       requiringSecureCoding:NO
+                                                       error:nil];
+  EXPECT_NSEQ(data, [NSData dataWithContentsOfFile:session_tab_1_path]);
+}
+
 }  // anonymous namespace
@@ -14,6 +14,23 @@ class Time;
 
 @protocol SnapshotCacheObserver;
 
+// Configuration of the storage of the snapshots of a SnapshotCache.
+struct SnapshotCacheStorageConfig {
+  // Quality of the JPEG encoding of the snapshots written to disk, from 0.0
+  // (smallest files) to 1.0 (no compression).
+  CGFloat jpeg_quality = 1.0;
+  // Maximum number of color snapshots kept in memory, or 0 for no limit.
+  NSUInteger max_images_in_memory = 6;
+  // Maximum decoded size in bytes of the color snapshots kept in memory, and
+  // separately of the thumbnails kept in memory, or 0 for no limit.
+  size_t max_bytes_in_memory = 0;
+  // Maximum width in points of the thumbnails, or 0 to disable thumbnails.
+  CGFloat thumbnail_width = 0;
+};
+
+// Returns the storage configuration for the enabled features.
+SnapshotCacheStorageConfig DefaultSnapshotCacheStorageConfig();
+
 // A class providing an in-memory and on-disk cache of tab snapshots.
 // A snapshot is a full-screen image of the contents of the page at the current
 // scroll offset and zoom level, used to stand in for the WKWebView if it has
@@ -28,9 +45,13 @@ class Time;
 // Designated initializer. |storagePath| is the file path where all images
 // managed by this SnapshotCache is stored. |storagePath| is not guaranteed to
 // exist. The contents of |storagePath| are entirely managed by this
-// SnapshotCache.
+// SnapshotCache. |storageConfig| controls the compression of the images on
+// disk and how many are kept in memory.
 - (instancetype)initWithStoragePath:(const base::FilePath&)storagePath
+                      storageConfig:(const SnapshotCacheStorageConfig&)config
     NS_DESIGNATED_INITIALIZER;
+// Initializes with the default storage configuration.
+- (instancetype)initWithStoragePath:(const base::FilePath&)storagePath;
 - (instancetype)init NS_UNAVAILABLE;
 
 // The scale that should be used for snapshots.
@@ -43,6 +64,15 @@ class Time;
 - (void)retrieveImageForSnapshotID:(NSString*)snapshotID
                           callback:(void (^)(UIImage*))callback;
 
+// Retrieve a downscaled snapshot for the |snapshotID|, cropped to the top of
+// the page, suitable for the tab grid. The callback is guaranteed to be called
+// synchronously if the thumbnail or the snapshot is in memory. Otherwise it is
+// called asynchronously once the thumbnail has been read from disk, or
+// generated from the snapshot on disk, or with nil if there is no snapshot.
+// Returns the snapshot itself if thumbnails are disabled.
+- (void)retrieveThumbnailImageForSnapshotID:(NSString*)snapshotID
+                                   callback:(void (^)(UIImage*))callback;
+
 // Request the grey snapshot for |snapshotID|. If the image is already loaded in
 // memory, this will immediately call back on |callback|.
 - (void)retrieveGreyImageForSnapshotID:(NSString*)snapshotID
@@ -103,7 +133,9 @@ class Time;
 @interface SnapshotCache (TestingAdditions)
 - (BOOL)hasImageInMemory:(NSString*)snapshotID;
 - (BOOL)hasGreyImageInMemory:(NSString*)snapshotID;
+- (BOOL)hasThumbnailImageInMemory:(NSString*)snapshotID;
 - (NSUInteger)lruCacheMaxSize;
+- (NSUInteger)lruCacheTotalCost;
 @end
 
 #endif  // IOS_CHROME_BROWSER_SNAPSHOTS_SNAPSHOT_CACHE_H_
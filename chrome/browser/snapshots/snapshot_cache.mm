@@ -5,8 +5,11 @@
 #import "ios/chrome/browser/snapshots/snapshot_cache.h"
 #import "ios/chrome/browser/snapshots/snapshot_cache_internal.h"
 
+#import <ImageIO/ImageIO.h>
 #import <UIKit/UIKit.h>
 
+#include <algorithm>
+#include <cmath>
 #include <set>
 
 #include "base/base_paths.h"
@@ -18,6 +21,8 @@
 #import "base/ios/crb_protocol_observers.h"
 #include "base/logging.h"
 #import "base/mac/backup_util.h"
+#import "base/mac/foundation_util.h"
+#include "base/mac/scoped_cftyperef.h"
 #include "base/metrics/histogram_functions.h"
 #include "base/path_service.h"
 #include "base/sequence_checker.h"
@@ -28,6 +33,7 @@
 #include "base/threading/scoped_blocking_call.h"
 #include "base/time/time.h"
 #import "ios/chrome/browser/snapshots/snapshot_cache_observer.h"
+#import "ios/chrome/browser/snapshots/snapshot_features.h"
 #import "ios/chrome/browser/snapshots/snapshot_lru_cache.h"
 #import "ios/chrome/browser/ui/util/uikit_ui_util.h"
 #include "ui/base/device_form_factor.h"
@@ -57,6 +63,7 @@ namespace {
 enum ImageType {
   IMAGE_TYPE_COLOR,
   IMAGE_TYPE_GREYSCALE,
+  IMAGE_TYPE_THUMBNAIL,
 };
 
 enum ImageScale {
@@ -66,16 +73,22 @@ enum ImageScale {
 };
 
 const ImageType kImageTypes[] = {
-    IMAGE_TYPE_COLOR, IMAGE_TYPE_GREYSCALE,
+    IMAGE_TYPE_COLOR,
+    IMAGE_TYPE_GREYSCALE,
+    IMAGE_TYPE_THUMBNAIL,
 };
 
 const NSUInteger kGreyInitialCapacity = 8;
-const CGFloat kJPEGImageQuality = 1.0;  // Highest quality. No compression.
 
 // Maximum size in number of elements that the LRU cache can hold before
 // starting to evict elements.
 const NSUInteger kLRUCacheMaxCapacity = 6;
 
+// Maximum ratio between the height and the width of the thumbnails. The tab
+// grid only displays the top of the snapshots, in cells that are at most
+// slightly taller than wide, so the rest of the page is cropped.
+const CGFloat kThumbnailMaxAspectRatio = 1.5;
+
 // Returns the path of the image for |snapshot_id|, in |cache_directory|,
 // of type |image_type| and scale |image_scale|.
 base::FilePath ImagePath(NSString* snapshot_id,
@@ -90,6 +103,9 @@ base::FilePath ImagePath(NSString* snapshot_id,
     case IMAGE_TYPE_GREYSCALE:
       filename = [filename stringByAppendingString:@"Grey"];
       break;
+    case IMAGE_TYPE_THUMBNAIL:
+      filename = [filename stringByAppendingString:@"Thumb"];
+      break;
   }
   switch (image_scale) {
     case IMAGE_SCALE_1X:
@@ -148,7 +164,101 @@ UIImage* ReadImageForSnapshotIDFromDisk(NSString* snapshot_id,
                                      : ScaleFromImageScale(image_scale))];
 }
 
-void WriteImageToDisk(UIImage* image, const base::FilePath& file_path) {
+// Returns the size in bytes of the decoded bitmap of |image|.
+NSUInteger ImageDecodedSize(UIImage* image) {
+  CGImageRef cg_image = image.CGImage;
+  if (!cg_image)
+    return 0;
+  return CGImageGetBytesPerRow(cg_image) * CGImageGetHeight(cg_image);
+}
+
+// Returns the size of the thumbnail of an image of |image_size|, for a
+// thumbnail of width |thumbnail_width|. The image is never upscaled.
+CGSize ThumbnailSize(CGSize image_size, CGFloat thumbnail_width) {
+  CGFloat width = std::min(image_size.width, thumbnail_width);
+  return CGSizeMake(width, std::min(image_size.height,
+                                    width * kThumbnailMaxAspectRatio));
+}
+
+// Returns a thumbnail of width |thumbnail_width| of |image|, cropped to its
+// top. The thumbnail has the same scale as |image|.
+UIImage* ThumbnailFromImage(UIImage* image, CGFloat thumbnail_width) {
+  if (!image)
+    return nil;
+
+  CGSize thumbnail_size = ThumbnailSize(image.size, thumbnail_width);
+  CGFloat ratio = thumbnail_size.width / image.size.width;
+  UIGraphicsImageRendererFormat* format =
+      [UIGraphicsImageRendererFormat preferredFormat];
+  format.scale = image.scale;
+  format.opaque = YES;
+  UIGraphicsImageRenderer* renderer =
+      [[UIGraphicsImageRenderer alloc] initWithSize:thumbnail_size
+                                             format:format];
+  return [renderer imageWithActions:^(UIGraphicsImageRendererContext* context) {
+    [image drawInRect:CGRectMake(0, 0, thumbnail_size.width,
+                                 image.size.height * ratio)];
+  }];
+}
+
+// Returns a thumbnail of width |thumbnail_width| of the image at |file_path|,
+// decoded directly at the thumbnail resolution so that the full resolution
+// bitmap is never allocated.
+UIImage* ReadThumbnailFromImageFile(const base::FilePath& file_path,
+                                    CGFloat scale,
+                                    CGFloat thumbnail_width) {
+  base::ScopedBlockingCall scoped_blocking_call(FROM_HERE,
+                                                base::BlockingType::WILL_BLOCK);
+  NSURL* url =
+      [NSURL fileURLWithPath:base::SysUTF8ToNSString(file_path.AsUTF8Unsafe())];
+  base::ScopedCFTypeRef<CGImageSourceRef> source(
+      CGImageSourceCreateWithURL(base::mac::NSToCFCast(url), nullptr));
+  if (!source)
+    return nil;
+
+  // Read the dimensions of the image without decoding it.
+  base::ScopedCFTypeRef<CFDictionaryRef> cf_properties(
+      CGImageSourceCopyPropertiesAtIndex(source, 0, nullptr));
+  NSDictionary* properties = base::mac::CFToNSCast(cf_properties.get());
+  CGFloat pixel_width = [properties[base::mac::CFToNSCast(
+      kCGImagePropertyPixelWidth)] floatValue];
+  CGFloat pixel_height = [properties[base::mac::CFToNSCast(
+      kCGImagePropertyPixelHeight)] floatValue];
+  if (pixel_width <= 0 || pixel_height <= 0)
+    return nil;
+
+  CGFloat max_pixel_width = thumbnail_width * scale;
+  CGFloat ratio = std::min<CGFloat>(max_pixel_width / pixel_width, 1.0);
+  NSDictionary* options = @{
+    base::mac::CFToNSCast(kCGImageSourceCreateThumbnailFromImageAlways) : @YES,
+    base::mac::CFToNSCast(kCGImageSourceShouldCacheImmediately) : @YES,
+    base::mac::CFToNSCast(kCGImageSourceThumbnailMaxPixelSize) :
+        @(std::ceil(std::max(pixel_width, pixel_height) * ratio)),
+  };
+  base::ScopedCFTypeRef<CGImageRef> downscaled_image(
+      CGImageSourceCreateThumbnailAtIndex(source, 0,
+                                          base::mac::NSToCFCast(options)));
+  if (!downscaled_image)
+    return nil;
+
+  // Crop to the top of the page.
+  CGSize thumbnail_size = ThumbnailSize(
+      CGSizeMake(CGImageGetWidth(downscaled_image),
+                 CGImageGetHeight(downscaled_image)),
+      max_pixel_width);
+  base::ScopedCFTypeRef<CGImageRef> thumbnail(CGImageCreateWithImageInRect(
+      downscaled_image, CGRectMake(0, 0, thumbnail_size.width,
+                                   std::floor(thumbnail_size.height))));
+  if (!thumbnail)
+    return nil;
+  return [UIImage imageWithCGImage:thumbnail
+                             scale:scale
+                       orientation:UIImageOrientationUp];
+}
+
+void WriteImageToDisk(UIImage* image,
+                      const base::FilePath& file_path,
+                      CGFloat jpeg_quality) {
   if (!image)
     return;
 
@@ -165,8 +275,8 @@ void WriteImageToDisk(UIImage* image, const base::FilePath& file_path) {
   NSString* path = base::SysUTF8ToNSString(file_path.AsUTF8Unsafe());
   base::ScopedBlockingCall scoped_blocking_call(FROM_HERE,
                                                 base::BlockingType::WILL_BLOCK);
-  [UIImageJPEGRepresentation(image, kJPEGImageQuality) writeToFile:path
-                                                        atomically:YES];
+  [UIImageJPEGRepresentation(image, jpeg_quality) writeToFile:path
+                                                   atomically:YES];
 
   // Encrypt the snapshot file (mostly for Incognito, but can't hurt to
   // always do it).
@@ -183,10 +293,61 @@ void WriteImageToDisk(UIImage* image, const base::FilePath& file_path) {
   }
 }
 
+// Writes |image| to disk and, if |thumbnail_width| is non zero, its thumbnail.
+// Returns the thumbnail.
+UIImage* WriteImageAndThumbnailToDisk(UIImage* image,
+                                      NSString* snapshot_id,
+                                      ImageScale image_scale,
+                                      const base::FilePath& cache_directory,
+                                      CGFloat jpeg_quality,
+                                      CGFloat thumbnail_width) {
+  WriteImageToDisk(
+      image,
+      ImagePath(snapshot_id, IMAGE_TYPE_COLOR, image_scale, cache_directory),
+      jpeg_quality);
+
+  base::FilePath thumbnail_path = ImagePath(snapshot_id, IMAGE_TYPE_THUMBNAIL,
+                                            image_scale, cache_directory);
+  if (!thumbnail_width) {
+    // Do not leave a stale thumbnail in case thumbnails are enabled later.
+    base::DeleteFile(thumbnail_path);
+    return nil;
+  }
+
+  UIImage* thumbnail = ThumbnailFromImage(image, thumbnail_width);
+  WriteImageToDisk(thumbnail, thumbnail_path, jpeg_quality);
+  return thumbnail;
+}
+
+// Reads the thumbnail for |snapshot_id| from disk. If it does not exist, it is
+// generated from the color snapshot on disk and saved.
+UIImage* ReadThumbnailForSnapshotIDFromDisk(
+    NSString* snapshot_id,
+    ImageScale image_scale,
+    const base::FilePath& cache_directory,
+    CGFloat jpeg_quality,
+    CGFloat thumbnail_width) {
+  base::FilePath thumbnail_path = ImagePath(snapshot_id, IMAGE_TYPE_THUMBNAIL,
+                                            image_scale, cache_directory);
+  base::ScopedBlockingCall scoped_blocking_call(FROM_HERE,
+                                                base::BlockingType::WILL_BLOCK);
+  if (base::PathExists(thumbnail_path)) {
+    return ReadThumbnailFromImageFile(
+        thumbnail_path, ScaleFromImageScale(image_scale), thumbnail_width);
+  }
+
+  UIImage* thumbnail = ReadThumbnailFromImageFile(
+      ImagePath(snapshot_id, IMAGE_TYPE_COLOR, image_scale, cache_directory),
+      ScaleFromImageScale(image_scale), thumbnail_width);
+  WriteImageToDisk(thumbnail, thumbnail_path, jpeg_quality);
+  return thumbnail;
+}
+
 void ConvertAndSaveGreyImage(NSString* snapshot_id,
                              ImageScale image_scale,
                              UIImage* color_image,
-                             const base::FilePath& cache_directory) {
+                             const base::FilePath& cache_directory,
+                             CGFloat jpeg_quality) {
   base::ScopedBlockingCall scoped_blocking_call(FROM_HERE,
                                                 base::BlockingType::WILL_BLOCK);
   if (!color_image) {
@@ -198,7 +359,7 @@ void ConvertAndSaveGreyImage(NSString* snapshot_id,
   UIImage* grey_image = GreyImage(color_image);
   base::FilePath image_path = ImagePath(snapshot_id, IMAGE_TYPE_GREYSCALE,
                                         image_scale, cache_directory);
-  WriteImageToDisk(grey_image, image_path);
+  WriteImageToDisk(grey_image, image_path, jpeg_quality);
   base::mac::SetBackupExclusion(image_path);
 }
 
@@ -331,11 +492,38 @@ UIImage* GreyImageFromCachedImage(const base::FilePath& cache_directory,
 
 }  // anonymous namespace
 
+SnapshotCacheStorageConfig DefaultSnapshotCacheStorageConfig() {
+  SnapshotCacheStorageConfig config;
+  if (!IsCompressedSnapshotCacheEnabled())
+    return config;
+
+  config.jpeg_quality = GetSnapshotJPEGQuality();
+  config.max_bytes_in_memory = GetSnapshotMemoryBudgetInBytes();
+  // The in-memory snapshots are only limited by their size.
+  if (config.max_bytes_in_memory)
+    config.max_images_in_memory = 0;
+  config.thumbnail_width = GetSnapshotThumbnailWidth();
+  return config;
+}
+
 @implementation SnapshotCache {
   // Cache to hold color snapshots in memory. n.b. Color snapshots are not
   // kept in memory on tablets.
   SnapshotLRUCache* _lruCache;
 
+  // Cache to hold thumbnails in memory. Nil if thumbnails are disabled.
+  SnapshotLRUCache* _thumbnailCache;
+
+  // Token of the latest thumbnail read or write in flight, by snapshot ID.
+  // Replies only cache their thumbnail if their request is still the latest
+  // one for the snapshot, so that a thumbnail is not cached again after its
+  // snapshot was removed or replaced while the request was in flight.
+  NSMutableDictionary<NSString*, NSNumber*>* _pendingThumbnailRequests;
+  NSUInteger _nextThumbnailRequestToken;
+
+  // Configuration of the storage of the snapshots.
+  SnapshotCacheStorageConfig _storageConfig;
+
   // Temporary dictionary to hold grey snapshots for tablet side swipe. This
   // will be nil before -createGreyCache is called and after -removeGreyCache
   // is called.
@@ -368,10 +556,26 @@ UIImage* GreyImageFromCachedImage(const base::FilePath& cache_directory,
 }
 
 - (instancetype)initWithStoragePath:(const base::FilePath&)storagePath {
+  return [self initWithStoragePath:storagePath
+                     storageConfig:DefaultSnapshotCacheStorageConfig()];
+}
+
+- (instancetype)initWithStoragePath:(const base::FilePath&)storagePath
+                      storageConfig:(const SnapshotCacheStorageConfig&)config {
   DCHECK_CALLED_ON_VALID_SEQUENCE(_sequenceChecker);
+  DCHECK(config.max_images_in_memory || config.max_bytes_in_memory);
   if ((self = [super init])) {
-    _lruCache =
-        [[SnapshotLRUCache alloc] initWithCacheSize:kLRUCacheMaxCapacity];
+    _storageConfig = config;
+    _lruCache = [[SnapshotLRUCache alloc]
+        initWithCacheSize:config.max_images_in_memory
+             maxTotalCost:config.max_bytes_in_memory];
+    if (config.thumbnail_width) {
+      _thumbnailCache = [[SnapshotLRUCache alloc]
+          initWithCacheSize:config.max_bytes_in_memory ? 0
+                                                       : kLRUCacheMaxCapacity
+               maxTotalCost:config.max_bytes_in_memory];
+      _pendingThumbnailRequests = [[NSMutableDictionary alloc] init];
+    }
     _cacheDirectory = storagePath;
     _snapshotsScale = ImageScaleForDevice();
 
@@ -445,8 +649,50 @@ UIImage* GreyImageFromCachedImage(const base::FilePath& cache_directory,
       base::BindOnce(&ReadImageForSnapshotIDFromDisk, snapshotID,
                      IMAGE_TYPE_COLOR, _snapshotsScale, _cacheDirectory),
       base::BindOnce(^(UIImage* image) {
-        if (image)
-          [weakLRUCache setObject:image forKey:snapshotID];
+        if (image) {
+          [weakLRUCache setObject:image
+                           forKey:snapshotID
+                             cost:ImageDecodedSize(image)];
+        }
+        callback(image);
+      }));
+}
+
+- (void)retrieveThumbnailImageForSnapshotID:(NSString*)snapshotID
+                                   callback:(void (^)(UIImage*))callback {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(_sequenceChecker);
+  DCHECK(snapshotID);
+  DCHECK(callback);
+
+  // The snapshot is already decoded, so there is no point in loading its
+  // thumbnail.
+  if (!_thumbnailCache || [_lruCache objectForKey:snapshotID]) {
+    [self retrieveImageForSnapshotID:snapshotID callback:callback];
+    return;
+  }
+
+  if (UIImage* image = [_thumbnailCache objectForKey:snapshotID]) {
+    callback(image);
+    return;
+  }
+
+  if (!_taskRunner) {
+    callback(nil);
+    return;
+  }
+
+  __weak SnapshotCache* weakSelf = self;
+  NSNumber* requestToken = [self startThumbnailRequestForSnapshotID:snapshotID];
+  base::PostTaskAndReplyWithResult(
+      _taskRunner.get(), FROM_HERE,
+      base::BindOnce(&ReadThumbnailForSnapshotIDFromDisk, snapshotID,
+                     _snapshotsScale, _cacheDirectory,
+                     _storageConfig.jpeg_quality,
+                     _storageConfig.thumbnail_width),
+      base::BindOnce(^(UIImage* image) {
+        [weakSelf finishThumbnailRequest:requestToken
+                           forSnapshotID:snapshotID
+                               thumbnail:image];
         callback(image);
       }));
 }
@@ -456,26 +702,37 @@ UIImage* GreyImageFromCachedImage(const base::FilePath& cache_directory,
   if (!image || !snapshotID || !_taskRunner)
     return;
 
-  [_lruCache setObject:image forKey:snapshotID];
+  [_lruCache setObject:image forKey:snapshotID cost:ImageDecodedSize(image)];
+  [_thumbnailCache removeObjectForKey:snapshotID];
 
-  // Each image in the cache has the same resolution and hence the same size.
-  size_t imageSizes = CGImageGetBytesPerRow(image.CGImage) *
-                      CGImageGetHeight(image.CGImage) * [_lruCache count];
-  base::UmaHistogramMemoryKB("IOS.Snapshots.CacheSize", imageSizes / 1024);
+  base::UmaHistogramMemoryKB("IOS.Snapshots.CacheSize",
+                             [_lruCache totalCost] / 1024);
 
   [self.observers snapshotCache:self didUpdateSnapshotForIdentifier:snapshotID];
 
-  // Save the image to disk.
-  _taskRunner->PostTask(
-      FROM_HERE, base::BindOnce(&WriteImageToDisk, image,
-                                ImagePath(snapshotID, IMAGE_TYPE_COLOR,
-                                          _snapshotsScale, _cacheDirectory)));
+  // Save the image and its thumbnail to disk. The thumbnail is then kept in
+  // memory, as it is likely to be displayed in the tab grid.
+  __weak SnapshotCache* weakSelf = self;
+  NSNumber* requestToken = [self startThumbnailRequestForSnapshotID:snapshotID];
+  base::PostTaskAndReplyWithResult(
+      _taskRunner.get(), FROM_HERE,
+      base::BindOnce(&WriteImageAndThumbnailToDisk, image, snapshotID,
+                     _snapshotsScale, _cacheDirectory,
+                     _storageConfig.jpeg_quality,
+                     _storageConfig.thumbnail_width),
+      base::BindOnce(^(UIImage* thumbnail) {
+        [weakSelf finishThumbnailRequest:requestToken
+                           forSnapshotID:snapshotID
+                               thumbnail:thumbnail];
+      }));
 }
 
 - (void)removeImageWithSnapshotID:(NSString*)snapshotID {
   DCHECK_CALLED_ON_VALID_SEQUENCE(_sequenceChecker);
 
   [_lruCache removeObjectForKey:snapshotID];
+  [_thumbnailCache removeObjectForKey:snapshotID];
+  [_pendingThumbnailRequests removeObjectForKey:snapshotID];
 
   [self.observers snapshotCache:self didUpdateSnapshotForIdentifier:snapshotID];
 
@@ -491,6 +748,8 @@ UIImage* GreyImageFromCachedImage(const base::FilePath& cache_directory,
   DCHECK_CALLED_ON_VALID_SEQUENCE(_sequenceChecker);
 
   [_lruCache removeAllObjects];
+  [_thumbnailCache removeAllObjects];
+  [_pendingThumbnailRequests removeAllObjects];
 
   if (!_taskRunner)
     return;
@@ -509,6 +768,11 @@ UIImage* GreyImageFromCachedImage(const base::FilePath& cache_directory,
                    _cacheDirectory);
 }
 
+- (base::FilePath)thumbnailImagePathForSnapshotID:(NSString*)snapshotID {
+  return ImagePath(snapshotID, IMAGE_TYPE_THUMBNAIL, _snapshotsScale,
+                   _cacheDirectory);
+}
+
 - (void)migrateSnapshotsWithIDs:(NSSet<NSString*>*)snapshotIDs
                  fromSourcePath:(const base::FilePath&)sourcePath {
   DCHECK_CALLED_ON_VALID_SEQUENCE(_sequenceChecker);
@@ -551,15 +815,22 @@ UIImage* GreyImageFromCachedImage(const base::FilePath& cache_directory,
       [dictionary setObject:image forKey:snapshotID];
   }
   [_lruCache removeAllObjects];
-  for (NSString* snapshotID in self.pinnedIDs)
-    [_lruCache setObject:[dictionary objectForKey:snapshotID]
-                  forKey:snapshotID];
+  [_thumbnailCache removeAllObjects];
+  for (NSString* snapshotID in self.pinnedIDs) {
+    UIImage* image = [dictionary objectForKey:snapshotID];
+    if (image) {
+      [_lruCache setObject:image
+                    forKey:snapshotID
+                      cost:ImageDecodedSize(image)];
+    }
+  }
 }
 
-// Remove all UIImages from |lruCache_|.
+// Remove all UIImages from |lruCache_| and |_thumbnailCache|.
 - (void)handleEnterBackground {
   DCHECK_CALLED_ON_VALID_SEQUENCE(_sequenceChecker);
   [_lruCache removeAllObjects];
+  [_thumbnailCache removeAllObjects];
 }
 
 // Restore adjacent UIImages to |lruCache_|.
@@ -697,7 +968,8 @@ UIImage* GreyImageFromCachedImage(const base::FilePath& cache_directory,
   _taskRunner->PostTask(
       FROM_HERE,
       base::BindOnce(&ConvertAndSaveGreyImage, snapshotID, _snapshotsScale,
-                     _backgroundingColorImage, _cacheDirectory));
+                     _backgroundingColorImage, _cacheDirectory,
+                     _storageConfig.jpeg_quality));
 }
 
 - (void)addObserver:(id<SnapshotCacheObserver>)observer {
@@ -723,6 +995,31 @@ UIImage* GreyImageFromCachedImage(const base::FilePath& cache_directory,
                         base::BindOnce(CreateCacheDirectory, _cacheDirectory));
 }
 
+// Records a thumbnail read or write for |snapshotID|, superseding the ones
+// in flight, and returns its token.
+- (NSNumber*)startThumbnailRequestForSnapshotID:(NSString*)snapshotID {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(_sequenceChecker);
+  NSNumber* requestToken = @(++_nextThumbnailRequestToken);
+  _pendingThumbnailRequests[snapshotID] = requestToken;
+  return requestToken;
+}
+
+// Caches |thumbnail| for |snapshotID| if the request with |requestToken| is
+// still the latest one for the snapshot.
+- (void)finishThumbnailRequest:(NSNumber*)requestToken
+                 forSnapshotID:(NSString*)snapshotID
+                     thumbnail:(UIImage*)thumbnail {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(_sequenceChecker);
+  if (![_pendingThumbnailRequests[snapshotID] isEqualToNumber:requestToken])
+    return;
+  [_pendingThumbnailRequests removeObjectForKey:snapshotID];
+  if (thumbnail) {
+    [_thumbnailCache setObject:thumbnail
+                        forKey:snapshotID
+                          cost:ImageDecodedSize(thumbnail)];
+  }
+}
+
 @end
 
 @implementation SnapshotCache (TestingAdditions)
@@ -735,8 +1032,16 @@ UIImage* GreyImageFromCachedImage(const base::FilePath& cache_directory,
   return [_greyImageDictionary objectForKey:snapshotID] != nil;
 }
 
+- (BOOL)hasThumbnailImageInMemory:(NSString*)snapshotID {
+  return [_thumbnailCache objectForKey:snapshotID] != nil;
+}
+
 - (NSUInteger)lruCacheMaxSize {
   return [_lruCache maxCacheSize];
 }
 
+- (NSUInteger)lruCacheTotalCost {
+  return [_lruCache totalCost];
+}
+
 @end
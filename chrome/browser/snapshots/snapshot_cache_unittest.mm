@@ -84,6 +84,15 @@ class SnapshotCacheTest : public PlatformTest {
 
   SnapshotCache* GetSnapshotCache() { return snapshotCache_; }
 
+  // Replaces the snapshot cache by one using |config|, with the same storage
+  // path.
+  void ResetSnapshotCache(const SnapshotCacheStorageConfig& config) {
+    [snapshotCache_ shutdown];
+    snapshotCache_ = [[SnapshotCache alloc]
+        initWithStoragePath:scoped_temp_directory_.GetPath()
+              storageConfig:config];
+  }
+
   // Adds a fake snapshot file into |directory| using |snapshot_id| in the
   // filename.
   base::FilePath AddSnapshotFileToDirectory(const base::FilePath directory,
@@ -697,4 +706,93 @@ TEST_F(SnapshotCacheTest, ObserversNotifiedOnSetAndRemoveImage) {
   EXPECT_NSEQ(snapshotID, observer.lastUpdatedIdentifier);
   [cache removeObserver:observer];
 }
+
+// Tests that the in-memory snapshots are evicted by decoded size when the
+// cache has a byte budget.
+TEST_F(SnapshotCacheTest, EvictByDecodedSize) {
+  UIImage* image = [testImages_ objectAtIndex:0];
+  const NSUInteger imageSize =
+      CGImageGetBytesPerRow(image.CGImage) * CGImageGetHeight(image.CGImage);
+  SnapshotCacheStorageConfig config;
+  config.max_images_in_memory = 0;
+  config.max_bytes_in_memory = 3 * imageSize;
+  ResetSnapshotCache(config);
+  SnapshotCache* cache = GetSnapshotCache();
+
+  LoadAllColorImagesIntoCache(true);
+  EXPECT_EQ(3 * imageSize, [cache lruCacheTotalCost]);
+  for (NSUInteger i = 0; i < kSnapshotCount; ++i) {
+    EXPECT_EQ(i >= kSnapshotCount - 3,
+              [cache hasImageInMemory:snapshotIDs_[i]]);
+  }
+}
+
+// Tests that thumbnails are saved with the snapshots, kept in memory, and
+// regenerated from the snapshot on disk when missing.
+TEST_F(SnapshotCacheTest, Thumbnails) {
+  SnapshotCacheStorageConfig config;
+  config.jpeg_quality = 0.5;
+  config.thumbnail_width = kSnapshotPixelSize / 2;
+  ResetSnapshotCache(config);
+  SnapshotCache* cache = GetSnapshotCache();
+
+  // Use a tall snapshot, like the ones of the pages, to check cropping.
+  NSString* snapshotID = [snapshotIDs_ objectAtIndex:0];
+  UIImage* image = GenerateRandomImage(
+      CGSizeMake(kSnapshotPixelSize, 4 * kSnapshotPixelSize));
+  [cache setImage:image withSnapshotID:snapshotID];
+  FlushRunLoops();
+  base::FilePath thumbnailPath =
+      [cache thumbnailImagePathForSnapshotID:snapshotID];
+  EXPECT_TRUE(base::PathExists(thumbnailPath));
+  EXPECT_TRUE([cache hasThumbnailImageInMemory:snapshotID]);
+
+  // Reload the thumbnail from a fresh cache, after deleting it from disk.
+  ResetSnapshotCache(config);
+  cache = GetSnapshotCache();
+  ASSERT_TRUE(base::DeleteFile(thumbnailPath));
+  __block UIImage* thumbnail = nil;
+  [cache retrieveThumbnailImageForSnapshotID:snapshotID
+                                    callback:^(UIImage* image) {
+                                      thumbnail = image;
+                                    }];
+  FlushRunLoops();
+  ASSERT_TRUE(thumbnail);
+  EXPECT_TRUE(base::PathExists(thumbnailPath));
+  EXPECT_TRUE([cache hasThumbnailImageInMemory:snapshotID]);
+  EXPECT_FALSE([cache hasImageInMemory:snapshotID]);
+
+  // The thumbnail is downscaled and cropped to the top of the snapshot.
+  EXPECT_EQ(kSnapshotPixelSize / 2, thumbnail.size.width);
+  EXPECT_EQ(kSnapshotPixelSize * 3 / 4, thumbnail.size.height);
+  EXPECT_EQ([cache snapshotScaleForDevice], thumbnail.scale);
+}
+
+// Tests that the thumbnail of a snapshot removed while it is being written is
+// not cached when the write completes.
+TEST_F(SnapshotCacheTest, ThumbnailNotCachedAfterRemoval) {
+  SnapshotCacheStorageConfig config;
+  config.thumbnail_width = kSnapshotPixelSize / 2;
+  ResetSnapshotCache(config);
+  SnapshotCache* cache = GetSnapshotCache();
+  UIImage* image = [testImages_ objectAtIndex:0];
+  NSString* snapshotID = [snapshotIDs_ objectAtIndex:0];
+
+  [cache setImage:image withSnapshotID:snapshotID];
+  [cache removeImageWithSnapshotID:snapshotID];
+  FlushRunLoops();
+  EXPECT_FALSE([cache hasThumbnailImageInMemory:snapshotID]);
+  EXPECT_FALSE(
+      base::PathExists([cache thumbnailImagePathForSnapshotID:snapshotID]));
+
+  [cache setImage:image withSnapshotID:snapshotID];
+  [cache removeAllImages];
+  FlushRunLoops();
+  EXPECT_FALSE([cache hasThumbnailImageInMemory:snapshotID]);
+
+  // A write that is not interrupted still caches the thumbnail.
+  [cache setImage:image withSnapshotID:snapshotID];
+  FlushRunLoops();
+  EXPECT_TRUE([cache hasThumbnailImageInMemory:snapshotID]);
+}
 }  // namespace
@@ -0,0 +1,43 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef IOS_CHROME_BROWSER_SNAPSHOTS_SNAPSHOT_FEATURES_H_
+#define IOS_CHROME_BROWSER_SNAPSHOTS_SNAPSHOT_FEATURES_H_
+
+#include <stddef.h>
+
+#include "base/feature_list.h"
+
+// If enabled, snapshots are stored on disk with JPEG compression, the
+// in-memory snapshots are limited by their decoded size in bytes instead of by
+// count, and downscaled thumbnails are stored for the tab grid.
+extern const base::Feature kCompressedSnapshotCache;
+
+// Feature param under `kCompressedSnapshotCache` for the JPEG quality of the
+// snapshots stored on disk, between 0.0 and 1.0.
+extern const char kCompressedSnapshotCacheJPEGQuality[];
+
+// Feature param under `kCompressedSnapshotCache` for the maximum decoded size
+// in KB of the snapshots kept in memory.
+extern const char kCompressedSnapshotCacheMemoryBudgetKB[];
+
+// Feature param under `kCompressedSnapshotCache` for the maximum width in
+// points of the thumbnails.
+extern const char kCompressedSnapshotCacheThumbnailWidth[];
+
+// Whether the compressed snapshot cache is enabled.
+bool IsCompressedSnapshotCacheEnabled();
+
+// Returns the JPEG quality of the snapshots stored on disk.
+double GetSnapshotJPEGQuality();
+
+// Returns the maximum decoded size in bytes of the snapshots kept in memory,
+// or 0 if the in-memory snapshots are not limited by size.
+size_t GetSnapshotMemoryBudgetInBytes();
+
+// Returns the maximum width in points of the thumbnails, or 0 if thumbnails
+// are disabled.
+double GetSnapshotThumbnailWidth();
+
+#endif  // IOS_CHROME_BROWSER_SNAPSHOTS_SNAPSHOT_FEATURES_H_
@@ -0,0 +1,50 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#import "ios/chrome/browser/snapshots/snapshot_features.h"
+
+#include <algorithm>
+
+#include "base/metrics/field_trial_params.h"
+
+#if !defined(__has_feature) || !__has_feature(objc_arc)
+#error "This file requires ARC support."
+#endif
+
+const base::Feature kCompressedSnapshotCache{"CompressedSnapshotCache",
+                                             base::FEATURE_DISABLED_BY_DEFAULT};
+
+const char kCompressedSnapshotCacheJPEGQuality[] = "jpeg_quality";
+const char kCompressedSnapshotCacheMemoryBudgetKB[] = "memory_budget_kb";
+const char kCompressedSnapshotCacheThumbnailWidth[] = "thumbnail_width";
+
+bool IsCompressedSnapshotCacheEnabled() {
+  return base::FeatureList::IsEnabled(kCompressedSnapshotCache);
+}
+
+double GetSnapshotJPEGQuality() {
+  // Highest quality. No compression.
+  if (!IsCompressedSnapshotCacheEnabled())
+    return 1.0;
+  double quality = base::GetFieldTrialParamByFeatureAsDouble(
+      kCompressedSnapshotCache, kCompressedSnapshotCacheJPEGQuality, 0.75);
+  return std::clamp(quality, 0.0, 1.0);
+}
+
+size_t GetSnapshotMemoryBudgetInBytes() {
+  if (!IsCompressedSnapshotCacheEnabled())
+    return 0;
+  int budget_kb = base::GetFieldTrialParamByFeatureAsInt(
+      kCompressedSnapshotCache, kCompressedSnapshotCacheMemoryBudgetKB,
+      24 * 1024 /*default to 24 MB*/);
+  return std::max(budget_kb, 0) * static_cast<size_t>(1024);
+}
+
+double GetSnapshotThumbnailWidth() {
+  if (!IsCompressedSnapshotCacheEnabled())
+    return 0;
+  double width = base::GetFieldTrialParamByFeatureAsDouble(
+      kCompressedSnapshotCache, kCompressedSnapshotCacheThumbnailWidth, 288);
+  return std::max(width, 0.0);
+}
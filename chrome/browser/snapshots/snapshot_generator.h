@@ -32,6 +32,11 @@ class WebState;
 // been retrieved. Invokes |callback| with nil if a snapshot does not exist.
 - (void)retrieveSnapshot:(void (^)(UIImage*))callback;
 
+// Gets a downscaled color snapshot for the current page, suitable for the tab
+// grid, calling |callback| once it has been retrieved. Invokes |callback| with
+// nil if a snapshot does not exist.
+- (void)retrieveThumbnailSnapshot:(void (^)(UIImage*))callback;
+
 // Gets a grey snapshot for the current page, calling |callback| once it has
 // been retrieved or regenerated. If the snapshot cannot be generated, the
 // |callback| will be called with nil.
@@ -97,6 +97,16 @@ BOOL ViewHierarchyContainsWKWebView(UIView* view) {
   }
 }
 
+- (void)retrieveThumbnailSnapshot:(void (^)(UIImage*))callback {
+  DCHECK(callback);
+  if (self.snapshotCache) {
+    [self.snapshotCache retrieveThumbnailImageForSnapshotID:self.tabID
+                                                   callback:callback];
+  } else {
+    callback(nil);
+  }
+}
+
 - (void)retrieveGreySnapshot:(void (^)(UIImage*))callback {
   DCHECK(callback);
 
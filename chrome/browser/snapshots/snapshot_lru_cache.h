@@ -9,7 +9,9 @@
 
 // This class implements a cache with a limited size. Once the cache reach its
 // size limit, it will start to evict items in a Least Recently Used order
-// (where the term "used" is determined in terms of query to the cache).
+// (where the term "used" is determined in terms of query to the cache). The
+// size of the cache can be limited by number of items, by total cost of the
+// items, or both.
 @interface SnapshotLRUCache : NSObject
 
 // The maximum amount of items that the cache can hold before starting to
@@ -17,13 +19,26 @@
 // amount of elements (i.e. never evicts).
 @property(nonatomic, readonly) NSUInteger maxCacheSize;
 
+// The maximum total cost of the items that the cache can hold before starting
+// to evict. The value 0 is used to signify that the total cost is unlimited.
+@property(nonatomic, readonly) NSUInteger maxTotalCost;
+
+// The total cost of the items currently held by the cache.
+@property(nonatomic, readonly) NSUInteger totalCost;
+
 // Use the initWithCacheSize: designated initializer. The is no good general
 // default value for the cache size.
 - (instancetype)init NS_UNAVAILABLE;
 
 // |maxCacheSize| value is used to specify the maximum amount of items that the
 // cache can hold before starting to evict items.
+- (instancetype)initWithCacheSize:(NSUInteger)maxCacheSize;
+
+// |maxCacheSize| and |maxTotalCost| are used to specify the maximum amount of
+// items and the maximum total cost of the items that the cache can hold before
+// starting to evict items.
 - (instancetype)initWithCacheSize:(NSUInteger)maxCacheSize
+                     maxTotalCost:(NSUInteger)maxTotalCost
     NS_DESIGNATED_INITIALIZER;
 
 // Query the cache for an item corresponding to the |key|. Returns nil if there
@@ -36,6 +51,14 @@
 // that key is replaced by |object|.
 - (void)setObject:(id<NSObject>)object forKey:(NSObject*)key;
 
+// Adds the pair |key|, |obj| to the cache with the given |cost| (e.g. its
+// size in bytes). The least recently used items are evicted until the total
+// cost fits in maxTotalCost, if non zero. An item whose cost is larger than
+// maxTotalCost is not added.
+- (void)setObject:(id<NSObject>)object
+           forKey:(NSObject*)key
+             cost:(NSUInteger)cost;
+
 // Remove the key, value pair corresponding to the given |key|.
 - (void)removeObjectForKey:(id<NSObject>)key;
 
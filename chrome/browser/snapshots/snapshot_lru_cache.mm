@@ -27,45 +27,78 @@ struct NSObjectHash {
   std::size_t operator()(id<NSObject> obj) const { return [obj hash]; }
 };
 
+// An item of the cache and its cost.
+struct CostedObject {
+  id<NSObject> object;
+  NSUInteger cost;
+};
+
 using NSObjectLRUCache = base::
-    HashingLRUCache<id<NSObject>, id<NSObject>, NSObjectHash, NSObjectEqualTo>;
+    HashingLRUCache<id<NSObject>, CostedObject, NSObjectHash, NSObjectEqualTo>;
 
 }  // namespace
 
 @implementation SnapshotLRUCache {
+  // Eviction is done by this class rather than by the underlying cache, so
+  // that the total cost can be kept up to date.
   std::unique_ptr<NSObjectLRUCache> _cache;
 }
 
 - (instancetype)initWithCacheSize:(NSUInteger)maxCacheSize {
+  return [self initWithCacheSize:maxCacheSize maxTotalCost:0];
+}
+
+- (instancetype)initWithCacheSize:(NSUInteger)maxCacheSize
+                     maxTotalCost:(NSUInteger)maxTotalCost {
   if ((self = [super init])) {
-    _cache = std::make_unique<NSObjectLRUCache>(maxCacheSize);
+    _cache =
+        std::make_unique<NSObjectLRUCache>(NSObjectLRUCache::NO_AUTO_EVICT);
+    _maxCacheSize = maxCacheSize;
+    _maxTotalCost = maxTotalCost;
   }
   return self;
 }
 
-- (NSUInteger)maxCacheSize {
-  return _cache->max_size();
-}
-
 - (id)objectForKey:(id<NSObject>)key {
   auto it = _cache->Get(key);
   if (it == _cache->end())
     return nil;
-  return it->second;
+  return it->second.object;
 }
 
 - (void)setObject:(id<NSObject>)value forKey:(NSObject*)key {
-  _cache->Put([key copy], value);
+  [self setObject:value forKey:key cost:0];
+}
+
+- (void)setObject:(id<NSObject>)value
+           forKey:(NSObject*)key
+             cost:(NSUInteger)cost {
+  [self removeObjectForKey:key];
+  if (_maxTotalCost && cost > _maxTotalCost)
+    return;
+
+  while (!_cache->empty() &&
+         ((_maxCacheSize && _cache->size() >= _maxCacheSize) ||
+          (_maxTotalCost && _totalCost + cost > _maxTotalCost))) {
+    _totalCost -= _cache->rbegin()->second.cost;
+    _cache->Erase(_cache->rbegin());
+  }
+
+  _cache->Put([key copy], CostedObject{value, cost});
+  _totalCost += cost;
 }
 
 - (void)removeObjectForKey:(id<NSObject>)key {
   auto it = _cache->Peek(key);
-  if (it != _cache->end())
-    _cache->Erase(it);
+  if (it == _cache->end())
+    return;
+  _totalCost -= it->second.cost;
+  _cache->Erase(it);
 }
 
 - (void)removeAllObjects {
   _cache->Clear();
+  _totalCost = 0;
 }
 
 - (NSUInteger)count {
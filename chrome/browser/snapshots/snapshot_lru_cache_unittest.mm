@@ -48,4 +48,37 @@ TEST_F(SnapshotLRUCacheTest, Basic) {
   EXPECT_TRUE([cache isEmpty]);
 }
 
+// Tests that items are evicted in LRU order once the total cost exceeds the
+// budget, regardless of the number of items.
+TEST_F(SnapshotLRUCacheTest, EvictByCost) {
+  SnapshotLRUCache* cache = [[SnapshotLRUCache alloc] initWithCacheSize:0
+                                                            maxTotalCost:100];
+
+  [cache setObject:@"Value 1" forKey:@"VALUE 1" cost:40];
+  [cache setObject:@"Value 2" forKey:@"VALUE 2" cost:40];
+  EXPECT_EQ(80u, [cache totalCost]);
+
+  // Use the first item so that the second one is the least recently used.
+  EXPECT_TRUE([cache objectForKey:@"VALUE 1"]);
+  [cache setObject:@"Value 3" forKey:@"VALUE 3" cost:50];
+  EXPECT_EQ(2u, [cache count]);
+  EXPECT_EQ(90u, [cache totalCost]);
+  EXPECT_FALSE([cache objectForKey:@"VALUE 2"]);
+  EXPECT_TRUE([cache objectForKey:@"VALUE 1"]);
+
+  // Replacing an item updates the total cost.
+  [cache setObject:@"Value 3" forKey:@"VALUE 3" cost:10];
+  EXPECT_EQ(50u, [cache totalCost]);
+
+  // Items larger than the budget are not added.
+  [cache setObject:@"Value 4" forKey:@"VALUE 4" cost:101];
+  EXPECT_FALSE([cache objectForKey:@"VALUE 4"]);
+  EXPECT_EQ(2u, [cache count]);
+
+  [cache removeObjectForKey:@"VALUE 1"];
+  EXPECT_EQ(10u, [cache totalCost]);
+  [cache removeAllObjects];
+  EXPECT_EQ(0u, [cache totalCost]);
+}
+
 }  // namespace
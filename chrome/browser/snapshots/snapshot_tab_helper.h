@@ -49,6 +49,14 @@ class SnapshotTabHelper : public web::WebStateObserver,
   // snapshot does not exist.
   void RetrieveColorSnapshot(void (^callback)(UIImage*));
 
+  // Retrieves a downscaled color snapshot for the current page, cropped to the
+  // top of the page, invoking |callback| with the image. This is cheaper than
+  // RetrieveColorSnapshot() and meant for small previews such as the tab grid.
+  // The callback may be called synchronously if there is a cached thumbnail
+  // available in memory. Invokes |callback| with nil if a snapshot does not
+  // exist.
+  void RetrieveThumbnailSnapshot(void (^callback)(UIImage*));
+
   // Retrieves a grey snapshot for the current page, invoking |callback|
   // with the image. The callback may be called synchronously is there is
   // a cached snapshot available in memory, otherwise it will be invoked
@@ -64,6 +64,11 @@ void SnapshotTabHelper::RetrieveColorSnapshot(void (^callback)(UIImage*)) {
   [snapshot_generator_ retrieveSnapshot:callback];
 }
 
+void SnapshotTabHelper::RetrieveThumbnailSnapshot(
+    void (^callback)(UIImage*)) {
+  [snapshot_generator_ retrieveThumbnailSnapshot:callback];
+}
+
 void SnapshotTabHelper::RetrieveGreySnapshot(void (^callback)(UIImage*)) {
   [snapshot_generator_ retrieveGreySnapshot:callback];
 }
@@ -0,0 +1,183 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef IOS_CHROME_BROWSER_TABS_SEARCH_TABS_SEARCH_INDEX_H_
+#define IOS_CHROME_BROWSER_TABS_SEARCH_TABS_SEARCH_INDEX_H_
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "base/check.h"
+#include "base/strings/utf_string_conversions.h"
+#include "third_party/abseil-cpp/absl/types/optional.h"
+#include "url/gurl.h"
+
+namespace tabs_search {
+
+// Returns |text| with its accents removed and its case folded.
+std::u16string FoldForSearch(const std::u16string& text);
+
+// Appends to |trigrams| the trigrams of the folded form of |text|, encoded as
+// integers. Returns false, leaving |trigrams| in an unspecified state, if the
+// folded text contains characters whose collation equivalents can't be
+// captured by trigrams (anything but printable ASCII). Texts shorter than
+// three characters are indexable but have no trigrams.
+bool AppendTrigrams(const std::u16string& text,
+                    std::vector<uint32_t>* trigrams);
+
+}  // namespace tabs_search
+
+// Index of the accent-folded and case-folded trigrams of the title and URL of
+// documents identified by a |Key|. It is used to avoid running ICU matching on
+// every document for each query: only the candidates it returns need to be
+// verified with base::i18n::FixedPatternStringSearchIgnoringCaseAndAccents.
+// Candidates are a superset of the matching documents: documents which can't
+// be indexed, and queries which can't be split in trigrams, fall back to
+// verifying everything. |Key| must be copyable and ordered by operator<.
+template <typename Key>
+class TabsSearchIndex {
+ public:
+  TabsSearchIndex() = default;
+
+  TabsSearchIndex(const TabsSearchIndex&) = delete;
+  TabsSearchIndex& operator=(const TabsSearchIndex&) = delete;
+
+  ~TabsSearchIndex() = default;
+
+  // Indexes |title| and |url| as the content of the document |key|, replacing
+  // any previous content. Does nothing if the content is unchanged.
+  void Update(const Key& key, const std::u16string& title, const GURL& url) {
+    auto iter = documents_.find(key);
+    if (iter != documents_.end()) {
+      if (iter->second.title == title && iter->second.url == url)
+        return;
+      Remove(key);
+    }
+
+    Document& document = documents_[key];
+    document.title = title;
+    document.url = url;
+    std::vector<uint32_t> trigrams;
+    if (!tabs_search::AppendTrigrams(title, &trigrams) ||
+        !tabs_search::AppendTrigrams(base::UTF8ToUTF16(url.spec()),
+                                     &trigrams)) {
+      unindexed_keys_.insert(key);
+      return;
+    }
+
+    std::sort(trigrams.begin(), trigrams.end());
+    trigrams.erase(std::unique(trigrams.begin(), trigrams.end()),
+                   trigrams.end());
+    for (uint32_t trigram : trigrams)
+      postings_[trigram].insert(key);
+    document.trigrams = std::move(trigrams);
+  }
+
+  // Removes the document |key| from the index, if present.
+  void Remove(const Key& key) {
+    auto iter = documents_.find(key);
+    if (iter == documents_.end())
+      return;
+
+    for (uint32_t trigram : iter->second.trigrams) {
+      auto posting = postings_.find(trigram);
+      DCHECK(posting != postings_.end());
+      posting->second.erase(key);
+      if (posting->second.empty())
+        postings_.erase(posting);
+    }
+    unindexed_keys_.erase(key);
+    documents_.erase(iter);
+  }
+
+  // Removes all the documents from the index.
+  void Clear() {
+    documents_.clear();
+    postings_.clear();
+    unindexed_keys_.clear();
+  }
+
+  // Returns whether the document |key| is in the index.
+  bool Contains(const Key& key) const {
+    return documents_.find(key) != documents_.end();
+  }
+
+  // Returns the keys of all the documents in the index.
+  std::set<Key> GetKeys() const {
+    std::set<Key> keys;
+    for (const auto& pair : documents_)
+      keys.insert(keys.end(), pair.first);
+    return keys;
+  }
+
+  // Returns the number of documents in the index.
+  size_t size() const { return documents_.size(); }
+
+  // Returns the keys of the indexed documents which may match |term|. Returns
+  // absl::nullopt if |term| can't be looked up in the index, in which case all
+  // the documents have to be verified.
+  absl::optional<std::set<Key>> GetCandidates(
+      const std::u16string& term) const {
+    std::vector<uint32_t> trigrams;
+    if (!tabs_search::AppendTrigrams(term, &trigrams) || trigrams.empty())
+      return absl::nullopt;
+
+    // Intersect the postings, starting with the shortest one.
+    std::vector<const std::set<Key>*> postings;
+    for (uint32_t trigram : trigrams) {
+      auto iter = postings_.find(trigram);
+      if (iter == postings_.end()) {
+        postings.clear();
+        break;
+      }
+      postings.push_back(&iter->second);
+    }
+
+    std::set<Key> candidates;
+    if (!postings.empty()) {
+      std::sort(postings.begin(), postings.end(),
+                [](const std::set<Key>* lhs, const std::set<Key>* rhs) {
+                  return lhs->size() < rhs->size();
+                });
+      candidates = *postings.front();
+      for (size_t i = 1; i < postings.size() && !candidates.empty(); ++i) {
+        std::set<Key> intersection;
+        std::set_intersection(
+            candidates.begin(), candidates.end(), postings[i]->begin(),
+            postings[i]->end(),
+            std::inserter(intersection, intersection.end()));
+        candidates = std::move(intersection);
+      }
+    }
+
+    candidates.insert(unindexed_keys_.begin(), unindexed_keys_.end());
+    return candidates;
+  }
+
+ private:
+  // The content of an indexed document.
+  struct Document {
+    std::u16string title;
+    GURL url;
+    // The sorted, distinct trigrams of the document. Empty if the document is
+    // in |unindexed_keys_|.
+    std::vector<uint32_t> trigrams;
+  };
+
+  std::map<Key, Document> documents_;
+  // The documents containing each trigram.
+  std::unordered_map<uint32_t, std::set<Key>> postings_;
+  // The documents which can't be indexed and are always candidates.
+  std::set<Key> unindexed_keys_;
+};
+
+#endif  // IOS_CHROME_BROWSER_TABS_SEARCH_TABS_SEARCH_INDEX_H_
@@ -0,0 +1,77 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#import "ios/chrome/browser/tabs_search/tabs_search_index.h"
+
+#include "base/i18n/case_conversion.h"
+#include "third_party/icu/source/common/unicode/normalizer2.h"
+#include "third_party/icu/source/common/unicode/uchar.h"
+#include "third_party/icu/source/common/unicode/unistr.h"
+
+#if !defined(__has_feature) || !__has_feature(objc_arc)
+#error "This file requires ARC support."
+#endif
+
+namespace tabs_search {
+
+namespace {
+
+// Returns whether |c| is a folded character which is matched the same way by
+// trigrams and by a primary strength collator. ASCII control characters are
+// ignorable when collating, so they can't be indexed either.
+bool IsIndexableCharacter(char16_t c) {
+  return c >= 0x20 && c < 0x7F;
+}
+
+}  // namespace
+
+std::u16string FoldForSearch(const std::u16string& text) {
+  UErrorCode status = U_ZERO_ERROR;
+  const icu::Normalizer2* normalizer = icu::Normalizer2::getNFDInstance(status);
+  if (U_FAILURE(status))
+    return base::i18n::FoldCase(text);
+
+  icu::UnicodeString decomposed = normalizer->normalize(
+      icu::UnicodeString(FALSE, text.data(), text.length()), status);
+  if (U_FAILURE(status))
+    return base::i18n::FoldCase(text);
+
+  // Drop the combining marks left by the decomposition.
+  std::u16string stripped;
+  stripped.reserve(decomposed.length());
+  for (int32_t i = 0; i < decomposed.length(); ++i) {
+    char16_t c = decomposed.charAt(i);
+    if (u_charType(c) != U_NON_SPACING_MARK)
+      stripped.push_back(c);
+  }
+  return base::i18n::FoldCase(stripped);
+}
+
+bool AppendTrigrams(const std::u16string& text,
+                    std::vector<uint32_t>* trigrams) {
+  DCHECK(trigrams);
+  // Most titles and URLs are ASCII and only need their case folded.
+  bool is_ascii = true;
+  for (char16_t c : text) {
+    if (c >= 0x80) {
+      is_ascii = false;
+      break;
+    }
+  }
+  const std::u16string folded =
+      is_ascii ? base::i18n::FoldCase(text) : FoldForSearch(text);
+
+  for (char16_t c : folded) {
+    if (!IsIndexableCharacter(c))
+      return false;
+  }
+  for (size_t i = 2; i < folded.length(); ++i) {
+    trigrams->push_back(static_cast<uint32_t>(folded[i - 2]) << 16 |
+                        static_cast<uint32_t>(folded[i - 1]) << 8 |
+                        static_cast<uint32_t>(folded[i]));
+  }
+  return true;
+}
+
+}  // namespace tabs_search
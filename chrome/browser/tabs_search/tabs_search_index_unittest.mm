@@ -0,0 +1,74 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ios/chrome/browser/tabs_search/tabs_search_index.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/platform_test.h"
+#include "url/gurl.h"
+
+#if !defined(__has_feature) || !__has_feature(objc_arc)
+#error "This file requires ARC support."
+#endif
+
+using TabsSearchIndexTest = PlatformTest;
+
+// Tests that accents and case are folded.
+TEST_F(TabsSearchIndexTest, FoldForSearch) {
+  EXPECT_EQ(u"cafe creme", tabs_search::FoldForSearch(u"Café Crème"));
+  EXPECT_EQ(u"strasse", tabs_search::FoldForSearch(u"STRAßE"));
+  EXPECT_EQ(u"www.url.com", tabs_search::FoldForSearch(u"WWW.url.COM"));
+}
+
+// Tests that only candidates containing all the query trigrams are returned.
+TEST_F(TabsSearchIndexTest, GetCandidates) {
+  TabsSearchIndex<int> index;
+  index.Update(1, u"Café Crème", GURL("http://www.example.com/"));
+  index.Update(2, u"Chromium", GURL("http://www.chromium.org/"));
+  index.Update(3, u"News", GURL("http://news.example.com/path"));
+  EXPECT_EQ(3u, index.size());
+
+  EXPECT_EQ((std::set<int>{1}), index.GetCandidates(u"CAFE"));
+  EXPECT_EQ((std::set<int>{1, 3}), index.GetCandidates(u"example"));
+  EXPECT_EQ((std::set<int>{2}), index.GetCandidates(u"chrom"));
+  EXPECT_EQ((std::set<int>{3}), index.GetCandidates(u"path"));
+  EXPECT_EQ(std::set<int>(), index.GetCandidates(u"missing"));
+}
+
+// Tests that short or non-indexable queries can't be looked up.
+TEST_F(TabsSearchIndexTest, QueriesWithoutCandidates) {
+  TabsSearchIndex<int> index;
+  index.Update(1, u"Chromium", GURL("http://www.chromium.org/"));
+
+  EXPECT_FALSE(index.GetCandidates(u"ch"));
+  EXPECT_FALSE(index.GetCandidates(u"Ørsted"));
+}
+
+// Tests that documents which can't be indexed are always candidates.
+TEST_F(TabsSearchIndexTest, UnindexedDocuments) {
+  TabsSearchIndex<int> index;
+  index.Update(1, u"Chromium", GURL("http://www.chromium.org/"));
+  index.Update(2, u"日本語", GURL("http://www.example.jp/"));
+
+  EXPECT_EQ((std::set<int>{1, 2}), index.GetCandidates(u"chromium"));
+  EXPECT_EQ((std::set<int>{2}), index.GetCandidates(u"other"));
+
+  index.Remove(2);
+  EXPECT_EQ(std::set<int>(), index.GetCandidates(u"other"));
+}
+
+// Tests that updating or removing a document updates its candidacy.
+TEST_F(TabsSearchIndexTest, UpdateAndRemove) {
+  TabsSearchIndex<int> index;
+  index.Update(1, u"Chromium", GURL("http://www.chromium.org/"));
+  index.Update(1, u"Example", GURL("http://www.example.com/"));
+  EXPECT_EQ(1u, index.size());
+  EXPECT_EQ(std::set<int>(), index.GetCandidates(u"chromium"));
+  EXPECT_EQ((std::set<int>{1}), index.GetCandidates(u"example"));
+
+  index.Remove(1);
+  EXPECT_FALSE(index.Contains(1));
+  EXPECT_EQ(std::set<int>(), index.GetCandidates(u"example"));
+  EXPECT_TRUE(index.GetKeys().empty());
+}
@@ -5,16 +5,31 @@
 #ifndef IOS_CHROME_BROWSER_TABS_SEARCH_TABS_SEARCH_SERVICE_H_
 #define IOS_CHROME_BROWSER_TABS_SEARCH_TABS_SEARCH_SERVICE_H_
 
+#include <map>
+#include <memory>
 #include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "base/callback.h"
+#include "base/callback_list.h"
+#include "base/scoped_multi_source_observation.h"
+#include "base/scoped_observation.h"
 #include "components/keyed_service/core/keyed_service.h"
 #include "components/sessions/core/session_id.h"
+#include "components/sessions/core/tab_restore_service.h"
+#include "components/sessions/core/tab_restore_service_observer.h"
+#import "ios/chrome/browser/main/browser_list.h"
+#import "ios/chrome/browser/main/browser_list_observer.h"
+#include "ios/chrome/browser/tabs_search/tabs_search_index.h"
 #import "ios/chrome/browser/ui/history/ios_browsing_history_driver.h"
 #import "ios/chrome/browser/ui/history/ios_browsing_history_driver_delegate.h"
+#import "ios/chrome/browser/web_state_list/web_state_list.h"
+#import "ios/chrome/browser/web_state_list/web_state_list_observer.h"
+#include "ios/web/public/web_state_observer.h"
 
+class AllWebStateObservationForwarder;
 class Browser;
 class ChromeBrowserState;
 
@@ -28,13 +43,22 @@ class SyncedSessions;
 }  // namespace synced_sessions
 
 namespace web {
+class NavigationContext;
 class WebState;
 }  // namespace web
 
 // Service which provides search functionality across currently open application
 // tabs.
+// The titles and URLs of the open, recently closed and synced tabs are indexed
+// by TabsSearchIndex once they have been searched, and the indexes are kept up
+// to date by observing the Browsers, the TabRestoreService and the
+// SessionSyncService, so that each query only verifies candidate tabs.
 class TabsSearchService : public IOSBrowsingHistoryDriverDelegate,
-                          public KeyedService {
+                          public KeyedService,
+                          public BrowserListObserver,
+                          public WebStateListObserver,
+                          public web::WebStateObserver,
+                          public sessions::TabRestoreServiceObserver {
  public:
   TabsSearchService(ChromeBrowserState* browser_state);
   ~TabsSearchService() override;
@@ -91,7 +115,71 @@ class TabsSearchService : public IOSBrowsingHistoryDriverDelegate,
   TabsSearchService(const TabsSearchService&) = delete;
   TabsSearchService& operator=(const TabsSearchService&) = delete;
 
+  // KeyedService:
+  void Shutdown() override;
+
  private:
+  // Identifies a synced tab by its session tag and its id in that session.
+  using RemoteTabKey = std::pair<std::string, SessionID>;
+
+  // Starts indexing the tabs of the Browsers of |browser_state_| and of the
+  // Browsers added later, if not done yet.
+  void StartIndexingOpenTabs();
+  // Starts or stops indexing the tabs of |browser|.
+  void StartIndexingBrowser(Browser* browser);
+  void StopIndexingBrowser(Browser* browser);
+  // Updates the title and URL of |web_state| in |open_tabs_index_|.
+  void IndexWebState(web::WebState* web_state);
+
+  // Updates |recently_closed_index_| from the entries of |restore_service|.
+  void IndexRecentlyClosedTabs(sessions::TabRestoreService* restore_service);
+
+  // Updates |remote_tabs_index_| from |synced_sessions|.
+  void IndexRemoteTabs(const synced_sessions::SyncedSessions& synced_sessions);
+  // Called when the synced sessions change.
+  void OnForeignSessionsChanged();
+
+  // BrowserListObserver:
+  void OnBrowserAdded(const BrowserList* browser_list,
+                      Browser* browser) override;
+  void OnIncognitoBrowserAdded(const BrowserList* browser_list,
+                               Browser* browser) override;
+  void OnBrowserRemoved(const BrowserList* browser_list,
+                        Browser* browser) override;
+  void OnIncognitoBrowserRemoved(const BrowserList* browser_list,
+                                 Browser* browser) override;
+  void OnBrowserListShutdown(BrowserList* browser_list) override;
+
+  // WebStateListObserver:
+  void WebStateInsertedAt(WebStateList* web_state_list,
+                          web::WebState* web_state,
+                          int index,
+                          bool activating) override;
+  void WebStateReplacedAt(WebStateList* web_state_list,
+                          web::WebState* old_web_state,
+                          web::WebState* new_web_state,
+                          int index) override;
+  void WebStateDetachedAt(WebStateList* web_state_list,
+                          web::WebState* web_state,
+                          int index) override;
+
+  // web::WebStateObserver:
+  void DidStartNavigation(web::WebState* web_state,
+                          web::NavigationContext* navigation_context) override;
+  void DidRedirectNavigation(
+      web::WebState* web_state,
+      web::NavigationContext* navigation_context) override;
+  void DidFinishNavigation(web::WebState* web_state,
+                           web::NavigationContext* navigation_context) override;
+  void TitleWasSet(web::WebState* web_state) override;
+  void WebStateRealized(web::WebState* web_state) override;
+  void WebStateDestroyed(web::WebState* web_state) override;
+
+  // sessions::TabRestoreServiceObserver:
+  void TabRestoreServiceChanged(sessions::TabRestoreService* service) override;
+  void TabRestoreServiceDestroyed(
+      sessions::TabRestoreService* service) override;
+
   // Performs a search for |term| within |browsers|, returning the matching
   // WebStates and associated Browser to |completion|. Results are passed back
   // in instances of TabsSearchBrowserResults.
@@ -124,6 +212,28 @@ class TabsSearchService : public IOSBrowsingHistoryDriverDelegate,
   std::unique_ptr<history::BrowsingHistoryService> history_service_;
   // Provides dependencies and funnels callbacks from BrowsingHistoryService.
   std::unique_ptr<IOSBrowsingHistoryDriver> history_driver_;
+
+  // Index of the open tabs of the Browsers in |web_state_forwarders_|.
+  TabsSearchIndex<web::WebState*> open_tabs_index_;
+  // Forwards the events of the WebStates of each indexed Browser to this.
+  std::map<Browser*, std::unique_ptr<AllWebStateObservationForwarder>>
+      web_state_forwarders_;
+  base::ScopedObservation<BrowserList, BrowserListObserver>
+      browser_list_observation_{this};
+  base::ScopedMultiSourceObservation<WebStateList, WebStateListObserver>
+      web_state_list_observations_{this};
+
+  // Index of the recently closed tabs, by entry id.
+  TabsSearchIndex<SessionID> recently_closed_index_;
+  base::ScopedObservation<sessions::TabRestoreService,
+                          sessions::TabRestoreServiceObserver>
+      tab_restore_service_observation_{this};
+
+  // Index of the synced tabs. Updated on the next search when
+  // |remote_tabs_index_outdated_| is true.
+  TabsSearchIndex<RemoteTabKey> remote_tabs_index_;
+  bool remote_tabs_index_outdated_ = true;
+  base::CallbackListSubscription foreign_sessions_subscription_;
 };
 
 #endif  // IOS_CHROME_BROWSER_TABS_SEARCH_TABS_SEARCH_SERVICE_H_
@@ -6,6 +6,7 @@
 
 #import <Foundation/Foundation.h>
 
+#include "base/bind.h"
 #include "base/i18n/break_iterator.h"
 #include "base/i18n/string_search.h"
 #import "base/strings/sys_string_conversions.h"
@@ -28,6 +29,7 @@
 #include "ios/chrome/browser/sync/sync_service_factory.h"
 #import "ios/chrome/browser/tabs/tab_title_util.h"
 #include "ios/chrome/browser/ui/recent_tabs/synced_sessions.h"
+#import "ios/chrome/browser/web_state_list/all_web_state_observation_forwarder.h"
 #import "ios/chrome/browser/web_state_list/web_state_list.h"
 #import "ios/web/public/web_state.h"
 
@@ -55,10 +57,20 @@ TabsSearchService::TabsSearchBrowserResults::TabsSearchBrowserResults(
 
 TabsSearchService::~TabsSearchService() = default;
 
+void TabsSearchService::Shutdown() {
+  foreign_sessions_subscription_ = {};
+  tab_restore_service_observation_.Reset();
+  recently_closed_index_.Clear();
+  while (!web_state_forwarders_.empty())
+    StopIndexingBrowser(web_state_forwarders_.begin()->first);
+  browser_list_observation_.Reset();
+}
+
 void TabsSearchService::Search(
     const std::u16string& term,
     base::OnceCallback<void(std::vector<TabsSearchBrowserResults>)>
         completion) {
+  StartIndexingOpenTabs();
   BrowserList* browser_list =
       BrowserListFactory::GetForBrowserState(browser_state_);
   std::set<Browser*> browsers = browser_state_->IsOffTheRecord()
@@ -76,6 +88,13 @@ void TabsSearchService::SearchRecentlyClosed(
   std::vector<RecentlyClosedItemPair> results;
   sessions::TabRestoreService* restore_service =
       IOSChromeTabRestoreServiceFactory::GetForBrowserState(browser_state_);
+  if (!tab_restore_service_observation_.IsObserving()) {
+    tab_restore_service_observation_.Observe(restore_service);
+    IndexRecentlyClosedTabs(restore_service);
+  }
+  const absl::optional<std::set<SessionID>> candidates =
+      recently_closed_index_.GetCandidates(term);
+
   for (auto iter = restore_service->entries().begin();
        iter != restore_service->entries().end(); ++iter) {
     const sessions::TabRestoreService::Entry* entry = iter->get();
@@ -83,6 +102,9 @@ void TabsSearchService::SearchRecentlyClosed(
     // Only TAB type is handled.
     // TODO(crbug.com/1056596) : Support WINDOW restoration under multi-window.
     DCHECK_EQ(sessions::TabRestoreService::TAB, entry->type);
+    if (candidates && !candidates->count(entry->id))
+      continue;
+
     const sessions::TabRestoreService::Tab* tab =
         static_cast<const sessions::TabRestoreService::Tab*>(entry);
     const sessions::SerializedNavigationEntry& navigationEntry =
@@ -124,6 +146,20 @@ void TabsSearchService::SearchRemoteTabs(
   auto synced_sessions =
       std::make_unique<synced_sessions::SyncedSessions>(sync_service);
 
+  if (!foreign_sessions_subscription_) {
+    // base::Unretained() is safe because the subscription is owned by this.
+    foreign_sessions_subscription_ =
+        sync_service->SubscribeToForeignSessionsChanged(
+            base::BindRepeating(&TabsSearchService::OnForeignSessionsChanged,
+                                base::Unretained(this)));
+  }
+  if (remote_tabs_index_outdated_) {
+    IndexRemoteTabs(*synced_sessions);
+    remote_tabs_index_outdated_ = false;
+  }
+  const absl::optional<std::set<RemoteTabKey>> candidates =
+      remote_tabs_index_.GetCandidates(term);
+
   for (size_t s = 0; s < synced_sessions->GetSessionCount(); s++) {
     const synced_sessions::DistantSession* session =
         synced_sessions->GetSession(s);
@@ -133,6 +169,10 @@ void TabsSearchService::SearchRemoteTabs(
 
     std::vector<synced_sessions::DistantTab*> tabs;
     for (auto&& distant_tab : session->tabs) {
+      if (candidates && !candidates->count(RemoteTabKey(
+                            distant_tab->session_tag, distant_tab->tab_id))) {
+        continue;
+      }
       if (query_search.Search(distant_tab->title, /*match_index=*/nullptr,
                               /*match_length=*/nullptr) ||
           query_search.Search(
@@ -189,11 +229,20 @@ void TabsSearchService::SearchWithinBrowsers(
 
   std::vector<TabsSearchBrowserResults> results;
 
+  const absl::optional<std::set<web::WebState*>> candidates =
+      open_tabs_index_.GetCandidates(term);
+
   for (Browser* browser : browsers) {
+    // The tabs of the Browsers which are not indexed are all verified.
+    const bool use_candidates =
+        candidates && web_state_forwarders_.count(browser);
     std::vector<web::WebState*> matching_web_states;
     WebStateList* webStateList = browser->GetWebStateList();
     for (int index = 0; index < webStateList->count(); ++index) {
       web::WebState* web_state = webStateList->GetWebStateAt(index);
+      if (use_candidates && !candidates->count(web_state))
+        continue;
+
       auto title = base::SysNSStringToUTF16(tab_util::GetTabTitle(web_state));
       auto url_string = base::UTF8ToUTF16(web_state->GetVisibleURL().spec());
       if (query_search.Search(title, /*match_index=*/nullptr,
@@ -213,6 +262,190 @@ void TabsSearchService::SearchWithinBrowsers(
   std::move(completion).Run(results);
 }
 
+void TabsSearchService::StartIndexingOpenTabs() {
+  if (browser_list_observation_.IsObserving())
+    return;
+
+  BrowserList* browser_list =
+      BrowserListFactory::GetForBrowserState(browser_state_);
+  browser_list_observation_.Observe(browser_list);
+  std::set<Browser*> browsers = browser_state_->IsOffTheRecord()
+                                    ? browser_list->AllIncognitoBrowsers()
+                                    : browser_list->AllRegularBrowsers();
+  for (Browser* browser : browsers)
+    StartIndexingBrowser(browser);
+}
+
+void TabsSearchService::StartIndexingBrowser(Browser* browser) {
+  if (web_state_forwarders_.count(browser))
+    return;
+
+  WebStateList* web_state_list = browser->GetWebStateList();
+  web_state_forwarders_[browser] =
+      std::make_unique<AllWebStateObservationForwarder>(web_state_list, this);
+  web_state_list_observations_.AddObservation(web_state_list);
+  for (int index = 0; index < web_state_list->count(); ++index)
+    IndexWebState(web_state_list->GetWebStateAt(index));
+}
+
+void TabsSearchService::StopIndexingBrowser(Browser* browser) {
+  auto iter = web_state_forwarders_.find(browser);
+  if (iter == web_state_forwarders_.end())
+    return;
+
+  WebStateList* web_state_list = browser->GetWebStateList();
+  for (int index = 0; index < web_state_list->count(); ++index)
+    open_tabs_index_.Remove(web_state_list->GetWebStateAt(index));
+  web_state_list_observations_.RemoveObservation(web_state_list);
+  web_state_forwarders_.erase(iter);
+}
+
+void TabsSearchService::IndexWebState(web::WebState* web_state) {
+  open_tabs_index_.Update(
+      web_state, base::SysNSStringToUTF16(tab_util::GetTabTitle(web_state)),
+      web_state->GetVisibleURL());
+}
+
+void TabsSearchService::IndexRecentlyClosedTabs(
+    sessions::TabRestoreService* restore_service) {
+  std::set<SessionID> stale_ids = recently_closed_index_.GetKeys();
+  for (const auto& entry : restore_service->entries()) {
+    if (entry->type != sessions::TabRestoreService::TAB)
+      continue;
+
+    const sessions::TabRestoreService::Tab* tab =
+        static_cast<const sessions::TabRestoreService::Tab*>(entry.get());
+    const sessions::SerializedNavigationEntry& navigationEntry =
+        tab->navigations[tab->current_navigation_index];
+    recently_closed_index_.Update(entry->id, navigationEntry.title(),
+                                  navigationEntry.virtual_url());
+    stale_ids.erase(entry->id);
+  }
+  for (const SessionID& id : stale_ids)
+    recently_closed_index_.Remove(id);
+}
+
+void TabsSearchService::IndexRemoteTabs(
+    const synced_sessions::SyncedSessions& synced_sessions) {
+  std::set<RemoteTabKey> stale_keys = remote_tabs_index_.GetKeys();
+  for (size_t s = 0; s < synced_sessions.GetSessionCount(); s++) {
+    const synced_sessions::DistantSession* session =
+        synced_sessions.GetSession(s);
+    for (auto&& distant_tab : session->tabs) {
+      RemoteTabKey key(distant_tab->session_tag, distant_tab->tab_id);
+      remote_tabs_index_.Update(key, distant_tab->title,
+                                distant_tab->virtual_url);
+      stale_keys.erase(key);
+    }
+  }
+  for (const RemoteTabKey& key : stale_keys)
+    remote_tabs_index_.Remove(key);
+}
+
+void TabsSearchService::OnForeignSessionsChanged() {
+  remote_tabs_index_outdated_ = true;
+}
+
+#pragma mark BrowserListObserver
+
+void TabsSearchService::OnBrowserAdded(const BrowserList* browser_list,
+                                       Browser* browser) {
+  if (!browser_state_->IsOffTheRecord())
+    StartIndexingBrowser(browser);
+}
+
+void TabsSearchService::OnIncognitoBrowserAdded(
+    const BrowserList* browser_list,
+    Browser* browser) {
+  if (browser_state_->IsOffTheRecord())
+    StartIndexingBrowser(browser);
+}
+
+void TabsSearchService::OnBrowserRemoved(const BrowserList* browser_list,
+                                         Browser* browser) {
+  StopIndexingBrowser(browser);
+}
+
+void TabsSearchService::OnIncognitoBrowserRemoved(
+    const BrowserList* browser_list,
+    Browser* browser) {
+  StopIndexingBrowser(browser);
+}
+
+void TabsSearchService::OnBrowserListShutdown(BrowserList* browser_list) {
+  while (!web_state_forwarders_.empty())
+    StopIndexingBrowser(web_state_forwarders_.begin()->first);
+  browser_list_observation_.Reset();
+}
+
+#pragma mark WebStateListObserver
+
+void TabsSearchService::WebStateInsertedAt(WebStateList* web_state_list,
+                                           web::WebState* web_state,
+                                           int index,
+                                           bool activating) {
+  IndexWebState(web_state);
+}
+
+void TabsSearchService::WebStateReplacedAt(WebStateList* web_state_list,
+                                           web::WebState* old_web_state,
+                                           web::WebState* new_web_state,
+                                           int index) {
+  open_tabs_index_.Remove(old_web_state);
+  IndexWebState(new_web_state);
+}
+
+void TabsSearchService::WebStateDetachedAt(WebStateList* web_state_list,
+                                           web::WebState* web_state,
+                                           int index) {
+  open_tabs_index_.Remove(web_state);
+}
+
+#pragma mark web::WebStateObserver
+
+void TabsSearchService::DidStartNavigation(
+    web::WebState* web_state,
+    web::NavigationContext* navigation_context) {
+  IndexWebState(web_state);
+}
+
+void TabsSearchService::DidRedirectNavigation(
+    web::WebState* web_state,
+    web::NavigationContext* navigation_context) {
+  IndexWebState(web_state);
+}
+
+void TabsSearchService::DidFinishNavigation(
+    web::WebState* web_state,
+    web::NavigationContext* navigation_context) {
+  IndexWebState(web_state);
+}
+
+void TabsSearchService::TitleWasSet(web::WebState* web_state) {
+  IndexWebState(web_state);
+}
+
+void TabsSearchService::WebStateRealized(web::WebState* web_state) {
+  IndexWebState(web_state);
+}
+
+void TabsSearchService::WebStateDestroyed(web::WebState* web_state) {
+  open_tabs_index_.Remove(web_state);
+}
+
+#pragma mark sessions::TabRestoreServiceObserver
+
+void TabsSearchService::TabRestoreServiceChanged(
+    sessions::TabRestoreService* service) {
+  IndexRecentlyClosedTabs(service);
+}
+
+void TabsSearchService::TabRestoreServiceDestroyed(
+    sessions::TabRestoreService* service) {
+  tab_restore_service_observation_.Reset();
+  recently_closed_index_.Clear();
+}
+
 #pragma mark history::BrowsingHistoryDriver
 
 void TabsSearchService::HistoryQueryCompleted(
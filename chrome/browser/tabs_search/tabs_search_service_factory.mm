@@ -7,6 +7,9 @@
 #include "components/keyed_service/ios/browser_state_dependency_manager.h"
 #include "ios/chrome/browser/browser_state/browser_state_otr_helper.h"
 #include "ios/chrome/browser/browser_state/chrome_browser_state.h"
+#import "ios/chrome/browser/main/browser_list_factory.h"
+#include "ios/chrome/browser/sessions/ios_chrome_tab_restore_service_factory.h"
+#include "ios/chrome/browser/sync/session_sync_service_factory.h"
 #import "ios/chrome/browser/tabs_search/tabs_search_service.h"
 
 #if !defined(__has_feature) || !__has_feature(objc_arc)
@@ -27,7 +30,11 @@ TabsSearchServiceFactory* TabsSearchServiceFactory::GetInstance() {
 TabsSearchServiceFactory::TabsSearchServiceFactory()
     : BrowserStateKeyedServiceFactory(
           "TabsSearchService",
-          BrowserStateDependencyManager::GetInstance()) {}
+          BrowserStateDependencyManager::GetInstance()) {
+  DependsOn(BrowserListFactory::GetInstance());
+  DependsOn(IOSChromeTabRestoreServiceFactory::GetInstance());
+  DependsOn(SessionSyncServiceFactory::GetInstance());
+}
 
 TabsSearchServiceFactory::~TabsSearchServiceFactory() = default;
 
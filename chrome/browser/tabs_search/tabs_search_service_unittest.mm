@@ -22,6 +22,7 @@
 #import "ios/chrome/browser/web_state_list/web_state_list.h"
 #import "ios/chrome/browser/web_state_list/web_state_opener.h"
 #include "ios/chrome/test/ios_chrome_scoped_testing_chrome_browser_state_manager.h"
+#import "ios/web/public/test/fakes/fake_navigation_context.h"
 #import "ios/web/public/test/fakes/fake_navigation_manager.h"
 #import "ios/web/public/test/fakes/fake_web_state.h"
 #include "ios/web/public/test/web_task_environment.h"
@@ -453,6 +454,58 @@ TEST_F(TabsSearchServiceTest, CaseInsensitiveURLSearch) {
   ASSERT_TRUE(results_received);
 }
 
+// Tests that the tabs changed or inserted after a search are found by the
+// following searches.
+TEST_F(TabsSearchServiceTest, MatchAfterTabChanges) {
+  web::FakeWebState* web_state = static_cast<web::FakeWebState*>(
+      AppendNewWebState(browser_.get(), kWebState1Title, GURL(kWebState1Url)));
+
+  __block bool results_received = false;
+  search_service()->Search(
+      kWebState2Title,
+      base::BindOnce(
+          ^(std::vector<TabsSearchService::TabsSearchBrowserResults> results) {
+            EXPECT_TRUE(results.empty());
+            results_received = true;
+          }));
+  ASSERT_TRUE(results_received);
+
+  web_state->SetTitle(kWebState2Title);
+  web::FakeNavigationContext navigation_context;
+  web_state->OnNavigationFinished(&navigation_context);
+  web::WebState* other_web_state = AppendNewWebState(
+      other_browser_.get(), kWebState2Title, GURL(kWebState2Url));
+
+  results_received = false;
+  search_service()->Search(
+      kWebState2Title,
+      base::BindOnce(
+          ^(std::vector<TabsSearchService::TabsSearchBrowserResults> results) {
+            ASSERT_EQ(2ul, results.size());
+            for (const auto& browser_results : results) {
+              ASSERT_EQ(1ul, browser_results.web_states.size());
+              EXPECT_EQ(browser_results.browser == browser_.get()
+                            ? web_state
+                            : other_web_state,
+                        browser_results.web_states.front());
+            }
+            results_received = true;
+          }));
+  ASSERT_TRUE(results_received);
+
+  browser_->GetWebStateList()->CloseAllWebStates(WebStateList::CLOSE_NO_FLAGS);
+  results_received = false;
+  search_service()->Search(
+      kWebState2Title,
+      base::BindOnce(
+          ^(std::vector<TabsSearchService::TabsSearchBrowserResults> results) {
+            ASSERT_EQ(1ul, results.size());
+            EXPECT_EQ(other_browser_.get(), results.front().browser);
+            results_received = true;
+          }));
+  ASSERT_TRUE(results_received);
+}
+
 // Tests that no recently closed tabs are returned before any tabs are closed.
 TEST_F(TabsSearchServiceTest, RecentlyClosedNoResults) {
   AppendNewWebState(browser_.get(), kWebState1Title, GURL(kWebState1Url));
@@ -791,7 +791,7 @@ Browser* GetBrowserForTabWithId(BrowserList* browser_list,
   }
   web::WebState* webState = GetWebStateWithId(self.browserState, identifier);
   if (webState) {
-    SnapshotTabHelper::FromWebState(webState)->RetrieveColorSnapshot(
+    SnapshotTabHelper::FromWebState(webState)->RetrieveThumbnailSnapshot(
         ^(UIImage* image) {
           completion(image);
         });
@@ -37,9 +37,25 @@ extern const base::FilePath::CharType kWebSessionCacheDirectoryName[];
                     forWebState:(const web::WebState*)webState;
 
 // Retrieves the persisted session state based on |webState|'s tab id.  Returns
-// nil if file does not exist.
+// nil if file does not exist. Returns the prefetched data without accessing the
+// disk if it was prefetched, and drops it from the prefetch buffer.
 - (NSData*)sessionStateDataForWebState:(const web::WebState*)webState;
 
+// Reads the persisted session state of |webState| in a background thread and
+// keeps it in a memory-bounded buffer, so that it can be retrieved without
+// blocking on I/O. The least recently prefetched data is evicted first.
+- (void)prefetchSessionStateDataForWebState:(const web::WebState*)webState;
+
+// Returns whether the prefetched session state of |webState| is in the
+// prefetch buffer.
+- (BOOL)hasPrefetchedSessionStateDataForWebState:
+    (const web::WebState*)webState;
+
+// Drops the prefetched session state of |webState| from the prefetch buffer,
+// and cancels its pending prefetch.
+- (void)dropPrefetchedSessionStateDataForWebState:
+    (const web::WebState*)webState;
+
 // Deletes the persisted session state based on |webState|'s tab id in a
 // background thread.  If |_delayRemove| is set, purge is instead called on a
 // short delay.
@@ -41,6 +41,17 @@ namespace {
 // true.
 const int kRemoveSessionStateDataDelay = 10;
 
+// The maximum number of bytes of prefetched session state data kept in memory.
+const NSUInteger kMaxPrefetchedSessionStateBytes = 10 * 1024 * 1024;
+
+// Returns the content of the file at |filePath|, or nil.
+NSData* ReadSessionData(const base::FilePath& filePath) {
+  base::ScopedBlockingCall scoped_blocking_call(FROM_HERE,
+                                                base::BlockingType::MAY_BLOCK);
+  return [NSData
+      dataWithContentsOfFile:base::SysUTF8ToNSString(filePath.AsUTF8Unsafe())];
+}
+
 // Writes |sessionData| to |cacheDirectory|.  If -writeToFile fails, deletes
 // the old (now stale) data.
 void WriteSessionData(NSData* sessionData,
@@ -114,6 +125,17 @@ void PurgeCacheOnBackgroundSequenceExcept(
   // a single -purgeCache call.
   BOOL _delayRemove;
 
+  // Prefetched session state data by session ID, the session IDs in prefetch
+  // order and the total size of the prefetched data.
+  NSMutableDictionary<NSString*, NSData*>* _prefetchedData;
+  NSMutableArray<NSString*>* _prefetchOrder;
+  NSUInteger _prefetchedBytes;
+
+  // Session IDs whose data is being prefetched. A session ID is removed when
+  // its data is written or removed, so that the stale data read by the
+  // prefetch is ignored.
+  NSMutableSet<NSString*>* _pendingPrefetches;
+
   // Check that public API is called from the correct sequence.
   SEQUENCE_CHECKER(_sequenceChecker);
 }
@@ -127,6 +149,9 @@ void PurgeCacheOnBackgroundSequenceExcept(
     _taskRunner = base::ThreadPool::CreateSequencedTaskRunner(
         {base::MayBlock(), base::TaskPriority::BEST_EFFORT,
          base::TaskShutdownBehavior::BLOCK_SHUTDOWN});
+    _prefetchedData = [[NSMutableDictionary alloc] init];
+    _prefetchOrder = [[NSMutableArray alloc] init];
+    _pendingPrefetches = [[NSMutableSet alloc] init];
   }
   return self;
 }
@@ -142,6 +167,9 @@ void PurgeCacheOnBackgroundSequenceExcept(
   if (!data || !sessionID || !_taskRunner)
     return;
 
+  // The written data replaces any prefetched data.
+  [self dropPrefetchedDataForSessionID:sessionID];
+
   // Copy ivars used by the block so that it does not reference |self|.
   const base::FilePath cacheDirectory = _cacheDirectory;
 
@@ -152,13 +180,50 @@ void PurgeCacheOnBackgroundSequenceExcept(
 }
 
 - (NSData*)sessionStateDataForWebState:(const web::WebState*)webState {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(_sequenceChecker);
   NSString* sessionID = webState->GetStableIdentifier();
+  NSData* prefetchedData = [self takePrefetchedDataForSessionID:sessionID];
+  if (prefetchedData)
+    return prefetchedData;
+
   base::FilePath filePath =
       _cacheDirectory.Append(base::SysNSStringToUTF8(sessionID));
   NSString* filePathString = base::SysUTF8ToNSString(filePath.AsUTF8Unsafe());
   return [NSData dataWithContentsOfFile:filePathString];
 }
 
+- (void)prefetchSessionStateDataForWebState:(const web::WebState*)webState {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(_sequenceChecker);
+  NSString* sessionID = webState->GetStableIdentifier();
+  if (!sessionID || !_taskRunner || _prefetchedData[sessionID] ||
+      [_pendingPrefetches containsObject:sessionID]) {
+    return;
+  }
+
+  [_pendingPrefetches addObject:sessionID];
+  const base::FilePath filePath =
+      _cacheDirectory.Append(base::SysNSStringToUTF8(sessionID));
+  __weak WebSessionStateCache* weakSelf = self;
+  _taskRunner->PostTaskAndReplyWithResult(
+      FROM_HERE, base::BindOnce(&ReadSessionData, filePath),
+      base::BindOnce(^(NSData* data) {
+        [weakSelf didPrefetchSessionStateData:data forSessionID:sessionID];
+      }));
+}
+
+- (BOOL)hasPrefetchedSessionStateDataForWebState:
+    (const web::WebState*)webState {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(_sequenceChecker);
+  NSString* sessionID = webState->GetStableIdentifier();
+  return sessionID && _prefetchedData[sessionID] != nil;
+}
+
+- (void)dropPrefetchedSessionStateDataForWebState:
+    (const web::WebState*)webState {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(_sequenceChecker);
+  [self dropPrefetchedDataForSessionID:webState->GetStableIdentifier()];
+}
+
 - (void)purgeUnassociatedData {
   if (!_taskRunner)
     return;
@@ -180,6 +245,7 @@ void PurgeCacheOnBackgroundSequenceExcept(
   }
 
   NSString* sessionID = webState->GetStableIdentifier();
+  [self dropPrefetchedDataForSessionID:sessionID];
 
   base::FilePath filePath =
       _cacheDirectory.Append(base::SysNSStringToUTF8(sessionID));
@@ -195,10 +261,57 @@ void PurgeCacheOnBackgroundSequenceExcept(
 - (void)shutdown {
   _taskRunner = nullptr;
   _browserState = nullptr;
+  [_prefetchedData removeAllObjects];
+  [_prefetchOrder removeAllObjects];
+  [_pendingPrefetches removeAllObjects];
+  _prefetchedBytes = 0;
 }
 
 #pragma mark - Private
 
+// Stores |data| read for |sessionID| in the prefetch buffer, unless the data
+// of |sessionID| changed since the prefetch started, evicting the least
+// recently prefetched data to stay within the memory budget.
+- (void)didPrefetchSessionStateData:(NSData*)data
+                       forSessionID:(NSString*)sessionID {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(_sequenceChecker);
+  if (![_pendingPrefetches containsObject:sessionID])
+    return;
+  [_pendingPrefetches removeObject:sessionID];
+  if (!data.length || data.length > kMaxPrefetchedSessionStateBytes)
+    return;
+
+  while (_prefetchedBytes + data.length > kMaxPrefetchedSessionStateBytes) {
+    [self dropPrefetchedDataForSessionID:_prefetchOrder.firstObject];
+  }
+  _prefetchedData[sessionID] = data;
+  [_prefetchOrder addObject:sessionID];
+  _prefetchedBytes += data.length;
+}
+
+// Returns the prefetched data of |sessionID|, or nil. The data is only needed
+// once, to restore the WebState, so it is dropped from the prefetch buffer and
+// any pending prefetch is cancelled.
+- (NSData*)takePrefetchedDataForSessionID:(NSString*)sessionID {
+  NSData* data = sessionID ? _prefetchedData[sessionID] : nil;
+  [self dropPrefetchedDataForSessionID:sessionID];
+  return data;
+}
+
+// Drops the prefetched data of |sessionID| and cancels its pending prefetch.
+- (void)dropPrefetchedDataForSessionID:(NSString*)sessionID {
+  if (!sessionID)
+    return;
+  [_pendingPrefetches removeObject:sessionID];
+  NSData* data = _prefetchedData[sessionID];
+  if (!data)
+    return;
+  DCHECK_GE(_prefetchedBytes, data.length);
+  _prefetchedBytes -= data.length;
+  [_prefetchedData removeObjectForKey:sessionID];
+  [_prefetchOrder removeObject:sessionID];
+}
+
 // Returns a set of all known tab ids.
 - (NSSet*)liveSessionIDs {
   DCHECK(_browserState) << "-liveSessionIDs called after -shutdown";
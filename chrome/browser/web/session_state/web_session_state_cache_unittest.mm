@@ -9,11 +9,13 @@
 #include "base/files/file_util.h"
 #include "base/path_service.h"
 #include "base/strings/sys_string_conversions.h"
+#include "base/run_loop.h"
 #include "base/task/thread_pool/thread_pool_instance.h"
 #import "base/test/ios/wait_util.h"
 #include "ios/chrome/browser/browser_state/test_chrome_browser_state.h"
 #include "ios/web/public/test/web_task_environment.h"
 #import "ios/web/public/web_state.h"
+#include "testing/gtest_mac.h"
 #include "testing/platform_test.h"
 
 #if !defined(__has_feature) || !__has_feature(objc_arc)
@@ -109,4 +111,65 @@ TEST_F(WebSessionStateCacheTest, CacheDelayRemove) {
   }));
 }
 
+// Tests that prefetched data is returned without accessing the disk.
+TEST_F(WebSessionStateCacheTest, PrefetchedData) {
+  WebSessionStateCache* cache = GetSessionCache();
+  const char data_str[] = "foo";
+  NSData* data = [NSData dataWithBytes:data_str length:strlen(data_str)];
+  [cache persistSessionStateData:data forWebState:web_state_.get()];
+  FlushRunLoops();
+  ASSERT_TRUE(StorageExists());
+
+  [cache prefetchSessionStateDataForWebState:web_state_.get()];
+  FlushRunLoops();
+
+  // Delete the file behind the cache's back.
+  NSString* sessionID = web_state_.get()->GetStableIdentifier();
+  ASSERT_TRUE(base::DeleteFile(
+      session_cache_directory_.Append(base::SysNSStringToUTF8(sessionID))));
+  NSData* data_back = [cache sessionStateDataForWebState:web_state_.get()];
+  EXPECT_NSEQ(data, data_back);
+
+  // The prefetched data is only returned once.
+  EXPECT_FALSE([cache sessionStateDataForWebState:web_state_.get()]);
+}
+
+// Tests that dropped prefetched data is read from the disk again.
+TEST_F(WebSessionStateCacheTest, DropPrefetchedData) {
+  WebSessionStateCache* cache = GetSessionCache();
+  const char data_str[] = "foo";
+  NSData* data = [NSData dataWithBytes:data_str length:strlen(data_str)];
+  [cache persistSessionStateData:data forWebState:web_state_.get()];
+  FlushRunLoops();
+
+  [cache prefetchSessionStateDataForWebState:web_state_.get()];
+  FlushRunLoops();
+  EXPECT_TRUE(
+      [cache hasPrefetchedSessionStateDataForWebState:web_state_.get()]);
+
+  [cache dropPrefetchedSessionStateDataForWebState:web_state_.get()];
+  EXPECT_FALSE(
+      [cache hasPrefetchedSessionStateDataForWebState:web_state_.get()]);
+  EXPECT_NSEQ(data, [cache sessionStateDataForWebState:web_state_.get()]);
+}
+
+// Tests that the data is read synchronously while it is being prefetched, and
+// that the prefetched data is then ignored.
+TEST_F(WebSessionStateCacheTest, PendingPrefetch) {
+  WebSessionStateCache* cache = GetSessionCache();
+  const char data_str[] = "foo";
+  NSData* data = [NSData dataWithBytes:data_str length:strlen(data_str)];
+  [cache persistSessionStateData:data forWebState:web_state_.get()];
+  FlushRunLoops();
+
+  [cache prefetchSessionStateDataForWebState:web_state_.get()];
+  EXPECT_FALSE(
+      [cache hasPrefetchedSessionStateDataForWebState:web_state_.get()]);
+  EXPECT_NSEQ(data, [cache sessionStateDataForWebState:web_state_.get()]);
+
+  FlushRunLoops();
+  EXPECT_FALSE(
+      [cache hasPrefetchedSessionStateDataForWebState:web_state_.get()]);
+}
+
 }  // namespace
@@ -10,7 +10,8 @@
 @class WebSessionStateCache;
 
 // Updates the WebSessionStateCache when the active tab changes or when
-// batch operations occur.
+// batch operations occur, and prefetches the session state of the unrealized
+// tabs adjacent to the active one.
 class WebSessionStateCacheWebStateListObserver : public WebStateListObserver {
  public:
   explicit WebSessionStateCacheWebStateListObserver(
@@ -33,6 +34,11 @@ class WebSessionStateCacheWebStateListObserver : public WebStateListObserver {
                           web::WebState* old_web_state,
                           web::WebState* new_web_state,
                           int index) override;
+  void WebStateActivatedAt(WebStateList* web_state_list,
+                           web::WebState* old_web_state,
+                           web::WebState* new_web_state,
+                           int active_index,
+                           ActiveWebStateChangeReason reason) override;
   void WillBeginBatchOperation(WebStateList* web_state_list) override;
   void BatchOperationEnded(WebStateList* web_state_list) override;
   WebSessionStateCache* web_session_state_cache_;
@@ -8,6 +8,7 @@
 #import "ios/chrome/browser/web/session_state/web_session_state_cache.h"
 #import "ios/chrome/browser/web/session_state/web_session_state_tab_helper.h"
 #import "ios/chrome/browser/web_state_list/web_state_list.h"
+#import "ios/web/public/web_state.h"
 
 #if !defined(__has_feature) || !__has_feature(objc_arc)
 #error "This file requires ARC support."
@@ -30,6 +31,7 @@ void WebSessionStateCacheWebStateListObserver::WillCloseWebStateAt(
     bool user_action) {
   [web_session_state_cache_ removeSessionStateDataForWebState:web_state];
 }
+
 void WebSessionStateCacheWebStateListObserver::WebStateReplacedAt(
     WebStateList* web_state_list,
     web::WebState* old_web_state,
@@ -38,6 +40,27 @@ void WebSessionStateCacheWebStateListObserver::WebStateReplacedAt(
   WebSessionStateTabHelper::FromWebState(new_web_state)->SaveSessionState();
 }
 
+void WebSessionStateCacheWebStateListObserver::WebStateActivatedAt(
+    WebStateList* web_state_list,
+    web::WebState* old_web_state,
+    web::WebState* new_web_state,
+    int active_index,
+    ActiveWebStateChangeReason reason) {
+  if (!new_web_state)
+    return;
+
+  // The adjacent tabs are the most likely to be switched to next.
+  for (int index : {active_index - 1, active_index + 1}) {
+    if (!web_state_list->ContainsIndex(index))
+      continue;
+    web::WebState* web_state = web_state_list->GetWebStateAt(index);
+    if (!web_state->IsRealized()) {
+      [web_session_state_cache_
+          prefetchSessionStateDataForWebState:web_state];
+    }
+  }
+}
+
 void WebSessionStateCacheWebStateListObserver::WillBeginBatchOperation(
     WebStateList* web_state_list) {
   [web_session_state_cache_ setDelayRemove:TRUE];
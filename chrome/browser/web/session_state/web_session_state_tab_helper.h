@@ -7,6 +7,7 @@
 
 #import <Foundation/Foundation.h>
 
+#include "base/timer/timer.h"
 #include "ios/web/public/web_state_observer.h"
 #import "ios/web/public/web_state_user_data.h"
 
@@ -33,10 +34,19 @@ class WebSessionStateTabHelper
   static bool IsEnabled();
 
   // If kRestoreSessionFromCache is enabled restore |web_state|'s WKWebView
-  // using the previously saved sessionState data via the WebSessionStateCache.
-  // Returns true if the session could be restored.
+  // using the previously saved sessionState data. The data prefetched by
+  // LoadSessionStateData() is used if it is loaded, otherwise the data is read
+  // synchronously, so that whether the native restore is used doesn't depend
+  // on the timing of the prefetch. Returns true if the session could be
+  // restored.
   bool RestoreSessionFromCache();
 
+  // Prefetches the sessionState data in the WebSessionStateCache, for use by
+  // RestoreSessionFromCache(). The prefetched data is dropped on the first
+  // committed navigation or after a timeout if it isn't used. Called when
+  // |web_state| is realized.
+  void LoadSessionStateData();
+
   // Calls SaveSessionState if the tab helper is stale.
   void SaveSessionStateIfStale();
 
@@ -49,6 +59,7 @@ class WebSessionStateTabHelper
   explicit WebSessionStateTabHelper(web::WebState* web_state);
 
   // web::WebStateObserver overrides:
+  void WebStateRealized(web::WebState* web_state) override;
   void WebStateDestroyed(web::WebState* web_state) override;
   void DidFinishNavigation(web::WebState* web_state,
                            web::NavigationContext* navigation_context) override;
@@ -57,6 +68,10 @@ class WebSessionStateTabHelper
 
   ChromeBrowserState* GetBrowserState();
 
+  // Drops the sessionState data prefetched by LoadSessionStateData() if it
+  // wasn't used by RestoreSessionFromCache().
+  void DropSessionStateData();
+
   // Mark the tab helper as stale.  Future calls to SaveSessionStateIfStale()
   // will result in calls to SaveSessionState().
   void MarkStale();
@@ -70,6 +85,12 @@ class WebSessionStateTabHelper
   int item_count_ = 0;
   int last_committed_item_index_ = 0;
 
+  // Whether the data prefetched by LoadSessionStateData() may still be held
+  // by the WebSessionStateCache, and the timer dropping it if it isn't used in
+  // time.
+  bool session_state_data_prefetched_ = false;
+  base::OneShotTimer drop_session_state_data_timer_;
+
   // The WebState with which this object is associated.
   web::WebState* web_state_ = nullptr;
 
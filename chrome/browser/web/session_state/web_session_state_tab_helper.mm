@@ -4,6 +4,7 @@
 
 #import "ios/chrome/browser/web/session_state/web_session_state_tab_helper.h"
 
+#include "base/bind.h"
 #include "base/feature_list.h"
 #include "base/files/file_path.h"
 #include "base/files/file_util.h"
@@ -15,6 +16,7 @@
 #include "base/strings/string_util.h"
 #include "base/task/sequenced_task_runner.h"
 #include "base/threading/thread_restrictions.h"
+#include "base/time/time.h"
 #import "build/branding_buildflags.h"
 #include "components/strings/grit/components_strings.h"
 #include "ios/chrome/browser/browser_state/chrome_browser_state.h"
@@ -40,6 +42,10 @@ namespace {
 // Maximum size of session state NSData object in kilobyes.
 const int64_t kMaxSessionState = 1024 * 5;  // 5MB
 
+// Delay after which the prefetched session state data is dropped if it wasn't
+// used to restore the session.
+constexpr base::TimeDelta kDropSessionStateDataDelay = base::Seconds(30);
+
 }  // anonymous namespace
 
 // static
@@ -68,6 +74,8 @@ bool WebSessionStateTabHelper::IsEnabled() {
 WebSessionStateTabHelper::WebSessionStateTabHelper(web::WebState* web_state)
     : web_state_(web_state) {
   web_state_->AddObserver(this);
+  if (web_state_->IsRealized())
+    LoadSessionStateData();
 }
 
 WebSessionStateTabHelper::~WebSessionStateTabHelper() = default;
@@ -80,8 +88,16 @@ bool WebSessionStateTabHelper::RestoreSessionFromCache() {
   if (!IsEnabled())
     return false;
 
+  // The data prefetched by LoadSessionStateData() is only used once. If the
+  // prefetch hasn't completed yet, the cache reads the data synchronously and
+  // ignores the prefetch.
+  session_state_data_prefetched_ = false;
+  drop_session_state_data_timer_.Stop();
   WebSessionStateCache* cache =
       WebSessionStateCacheFactory::GetForBrowserState(GetBrowserState());
+  UMA_HISTOGRAM_BOOLEAN(
+      "Session.WebStates.NativeRestoreSessionDataPrefetched",
+      [cache hasPrefetchedSessionStateDataForWebState:web_state_]);
   NSData* data = [cache sessionStateDataForWebState:web_state_];
   if (!data.length)
     return false;
@@ -97,6 +113,22 @@ bool WebSessionStateTabHelper::RestoreSessionFromCache() {
   return true;
 }
 
+void WebSessionStateTabHelper::LoadSessionStateData() {
+  if (!IsEnabled())
+    return;
+
+  // The prefetched data is kept in the memory-bounded prefetch buffer of the
+  // cache, which evicts it if too much data is prefetched.
+  WebSessionStateCache* cache =
+      WebSessionStateCacheFactory::GetForBrowserState(GetBrowserState());
+  [cache prefetchSessionStateDataForWebState:web_state_];
+  session_state_data_prefetched_ = true;
+  drop_session_state_data_timer_.Start(
+      FROM_HERE, kDropSessionStateDataDelay,
+      base::BindOnce(&WebSessionStateTabHelper::DropSessionStateData,
+                     base::Unretained(this)));
+}
+
 void WebSessionStateTabHelper::SaveSessionStateIfStale() {
   if (!stale_)
     return;
@@ -131,8 +163,13 @@ void WebSessionStateTabHelper::SaveSessionState() {
 
 #pragma mark - WebStateObserver
 
+void WebSessionStateTabHelper::WebStateRealized(web::WebState* web_state) {
+  LoadSessionStateData();
+}
+
 void WebSessionStateTabHelper::WebStateDestroyed(web::WebState* web_state) {
   web_state->RemoveObserver(this);
+  DropSessionStateData();
   if (stale_) {
     SaveSessionState();
   }
@@ -141,6 +178,10 @@ void WebSessionStateTabHelper::WebStateDestroyed(web::WebState* web_state) {
 void WebSessionStateTabHelper::DidFinishNavigation(
     web::WebState* web_state,
     web::NavigationContext* navigation_context) {
+  // The session isn't restored after a navigation committed.
+  if (navigation_context->HasCommitted())
+    DropSessionStateData();
+
   // Don't record navigations that result in downloads, since these will be
   // discarded and there's no simple callback when discarded.
   if (navigation_context->IsDownload())
@@ -170,6 +211,16 @@ void WebSessionStateTabHelper::WebFrameDidBecomeAvailable(
 
 #pragma mark - Private
 
+void WebSessionStateTabHelper::DropSessionStateData() {
+  if (!session_state_data_prefetched_)
+    return;
+  session_state_data_prefetched_ = false;
+  drop_session_state_data_timer_.Stop();
+  WebSessionStateCache* cache =
+      WebSessionStateCacheFactory::GetForBrowserState(GetBrowserState());
+  [cache dropPrefetchedSessionStateDataForWebState:web_state_];
+}
+
 void WebSessionStateTabHelper::MarkStale() {
   if (!IsEnabled())
     return;
@@ -19,6 +19,7 @@
 #include "ios/chrome/browser/web/chrome_web_client.h"
 #include "ios/chrome/browser/web/features.h"
 #import "ios/chrome/browser/web/session_state/web_session_state_cache.h"
+#import "ios/chrome/browser/web/session_state/web_session_state_cache_factory.h"
 #include "ios/web/public/navigation/navigation_item.h"
 #include "ios/web/public/navigation/navigation_manager.h"
 #import "ios/web/public/session/serializable_user_data_manager.h"
@@ -161,12 +162,43 @@ TEST_F(WebSessionStateTabHelperTest, SessionStateRestore) {
       session_cache_directory_.Append(base::SysNSStringToUTF8(newSessionID));
   EXPECT_TRUE(base::CopyFile(filePath, newFilePath));
 
-  // Only restore for session restore URLs.
-  ASSERT_TRUE(WebSessionStateTabHelper::FromWebState(web_state.get())
-                  ->RestoreSessionFromCache());
+  // The session is restored even if the prefetch hasn't completed yet.
+  WebSessionStateTabHelper* new_helper =
+      WebSessionStateTabHelper::FromWebState(web_state.get());
+  new_helper->LoadSessionStateData();
+  ASSERT_TRUE(new_helper->RestoreSessionFromCache());
 
   // kChromeUIAboutNewTabURL should get rewritten to kChromeUINewTabURL.
   ASSERT_EQ(web_state->GetLastCommittedURL(), GURL(kChromeUINewTabURL));
 }
 
+// Tests that the prefetched session state data is dropped on the first
+// committed navigation.
+TEST_F(WebSessionStateTabHelperTest, DropPrefetchedDataOnNavigation) {
+  base::test::ScopedFeatureList scoped_feature_list;
+  scoped_feature_list.InitAndEnableFeature(web::kRestoreSessionFromCache);
+  WebSessionStateTabHelper* helper =
+      WebSessionStateTabHelper::FromWebState(web_state());
+  if (!helper->IsEnabled())
+    return;
+
+  WebSessionStateCache* cache =
+      WebSessionStateCacheFactory::GetForBrowserState(browser_state_.get());
+  const char data_str[] = "foo";
+  NSData* data = [NSData dataWithBytes:data_str length:strlen(data_str)];
+  [cache persistSessionStateData:data forWebState:web_state()];
+  FlushRunLoops();
+
+  helper->LoadSessionStateData();
+  FlushRunLoops();
+  ASSERT_TRUE([cache hasPrefetchedSessionStateDataForWebState:web_state()]);
+
+  web::NavigationManager::WebLoadParams params(GURL("about:blank"));
+  web_state()->GetNavigationManager()->LoadURLWithParams(params);
+  ASSERT_TRUE(WaitUntilConditionOrTimeout(kWaitForPageLoadTimeout, ^bool {
+    return !web_state()->IsLoading();
+  }));
+  EXPECT_FALSE([cache hasPrefetchedSessionStateDataForWebState:web_state()]);
+}
+
 }  // namespace
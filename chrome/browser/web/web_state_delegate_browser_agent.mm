@@ -309,9 +309,11 @@ void WebStateDelegateBrowserAgent::SetWebStateDelegate(
 void WebStateDelegateBrowserAgent::ClearWebStateDelegate(
     web::WebState* web_state) {
   DCHECK(web_state);
-  if (web_state->IsRealized()) {
-    web_state->SetDelegate(nullptr);
-  } else {
+  // A WebState unrealized after its delegate was set keeps its delegate and
+  // is not observed.
+  if (web_state_observations_.IsObservingSource(web_state)) {
     web_state_observations_.RemoveObservation(web_state);
+  } else {
+    web_state->SetDelegate(nullptr);
   }
 }
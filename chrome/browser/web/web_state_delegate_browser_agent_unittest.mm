@@ -204,3 +204,22 @@ TEST_F(WebStateDelegateBrowserAgentTest, GetJavaScriptDialogPresenter) {
   EXPECT_TRUE(request);
   EXPECT_TRUE(request->GetConfig<JavaScriptDialogRequest>());
 }
+
+// Tests that a WebState unrealized after its delegate was set keeps the agent
+// as its delegate once realized again, and that it is cleared on detach.
+TEST_F(WebStateDelegateBrowserAgentTest, UnrealizedWebStateKeepsDelegate) {
+  web::WebState* web_state = InsertNewWebState(GURL(kURL1));
+  ASSERT_EQ(delegate(), web_state->GetDelegate());
+
+  ASSERT_TRUE(web_state->Unrealize());
+  EXPECT_EQ(delegate(), web_state->GetDelegate());
+  web_state->ForceRealized();
+  EXPECT_EQ(delegate(), web_state->GetDelegate());
+
+  // Detaching the WebState while unrealized clears its delegate.
+  ASSERT_TRUE(web_state->Unrealize());
+  std::unique_ptr<web::WebState> detached_web_state =
+      browser_->GetWebStateList()->DetachWebStateAt(0);
+  EXPECT_FALSE(detached_web_state->IsRealized());
+  EXPECT_FALSE(detached_web_state->GetDelegate());
+}
@@ -0,0 +1,97 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef IOS_CHROME_BROWSER_WEB_STATE_LIST_TAB_DISCARD_BROWSER_AGENT_H_
+#define IOS_CHROME_BROWSER_WEB_STATE_LIST_TAB_DISCARD_BROWSER_AGENT_H_
+
+#include <stdint.h>
+
+#include <memory>
+
+#include "base/callback.h"
+#include "base/feature_list.h"
+#include "base/memory/memory_pressure_listener.h"
+#include "base/scoped_observation.h"
+#import "ios/chrome/browser/main/browser.h"
+#import "ios/chrome/browser/main/browser_observer.h"
+#import "ios/chrome/browser/main/browser_user_data.h"
+
+namespace web {
+class WebState;
+}
+
+// Feature controlling whether the background tabs are discarded on memory
+// pressure.
+extern const base::Feature kTabDiscardOnMemoryPressure;
+
+// Browser agent discarding the background tabs of the Browser's WebStateList
+// on memory pressure, so that the app degrades gracefully instead of being
+// killed by the system. Discarded tabs are brought back to the "unrealized"
+// state (see web::WebState::Unrealize()) and are realized again when they are
+// activated.
+//
+// On moderate memory pressure, the least recently activated half of the
+// eligible tabs is discarded. On critical memory pressure (which is what
+// MemoryWarningHelper reports on a system memory warning), all of them are.
+// The active tab and the tabs that are visible or loading are never
+// discarded.
+class TabDiscardBrowserAgent : public BrowserUserData<TabDiscardBrowserAgent>,
+                               public BrowserObserver {
+ public:
+  // Returns the memory used by the process, in bytes.
+  using MemoryUsageCallback = base::RepeatingCallback<uint64_t()>;
+
+  // Not copyable or moveable.
+  TabDiscardBrowserAgent(const TabDiscardBrowserAgent&) = delete;
+  TabDiscardBrowserAgent& operator=(const TabDiscardBrowserAgent&) = delete;
+
+  ~TabDiscardBrowserAgent() override;
+
+  // Discards the eligible tabs for |level|. Returns the number of discarded
+  // tabs.
+  int DiscardTabs(base::MemoryPressureListener::MemoryPressureLevel level);
+
+  // Returns the number of tabs discarded since the agent was created.
+  int discard_count() const { return discard_count_; }
+
+  // Returns the memory released by discarding tabs since the agent was
+  // created, in bytes.
+  uint64_t bytes_saved() const { return bytes_saved_; }
+
+  // Replaces the callback used to measure the memory released by each
+  // discard.
+  void SetMemoryUsageCallbackForTesting(MemoryUsageCallback callback);
+
+ private:
+  friend class BrowserUserData<TabDiscardBrowserAgent>;
+  BROWSER_USER_DATA_KEY_DECL();
+
+  explicit TabDiscardBrowserAgent(Browser* browser);
+
+  // Called by |memory_pressure_listener_|.
+  void OnMemoryPressure(
+      base::MemoryPressureListener::MemoryPressureLevel level);
+
+  // Returns whether |web_state| can be discarded.
+  bool CanDiscard(web::WebState* web_state) const;
+
+  // Discards |web_state| and accounts for the memory released. Returns
+  // whether it was discarded.
+  bool Discard(web::WebState* web_state);
+
+  // BrowserObserver:
+  void BrowserDestroyed(Browser* browser) override;
+
+  Browser* browser_ = nullptr;
+  base::ScopedObservation<Browser, BrowserObserver> browser_observation_{
+      this};
+  std::unique_ptr<base::MemoryPressureListener> memory_pressure_listener_;
+  MemoryUsageCallback memory_usage_callback_;
+
+  // Accounting of the discards since the agent was created.
+  int discard_count_ = 0;
+  uint64_t bytes_saved_ = 0;
+};
+
+#endif  // IOS_CHROME_BROWSER_WEB_STATE_LIST_TAB_DISCARD_BROWSER_AGENT_H_
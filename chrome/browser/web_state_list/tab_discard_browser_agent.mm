@@ -0,0 +1,111 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#import "ios/chrome/browser/web_state_list/tab_discard_browser_agent.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/metrics/histogram_macros.h"
+#include "ios/chrome/browser/memory/memory_metrics.h"
+#import "ios/chrome/browser/web_state_list/web_state_list.h"
+#import "ios/web/public/web_state.h"
+
+#if !defined(__has_feature) || !__has_feature(objc_arc)
+#error "This file requires ARC support."
+#endif
+
+const base::Feature kTabDiscardOnMemoryPressure{
+    "TabDiscardOnMemoryPressure", base::FEATURE_DISABLED_BY_DEFAULT};
+
+BROWSER_USER_DATA_KEY_IMPL(TabDiscardBrowserAgent)
+
+TabDiscardBrowserAgent::TabDiscardBrowserAgent(Browser* browser)
+    : browser_(browser),
+      memory_pressure_listener_(std::make_unique<base::MemoryPressureListener>(
+          FROM_HERE,
+          base::BindRepeating(&TabDiscardBrowserAgent::OnMemoryPressure,
+                              base::Unretained(this)))),
+      memory_usage_callback_(
+          base::BindRepeating(&memory_util::GetRealMemoryUsedInBytes)) {
+  browser_observation_.Observe(browser_);
+}
+
+TabDiscardBrowserAgent::~TabDiscardBrowserAgent() = default;
+
+int TabDiscardBrowserAgent::DiscardTabs(
+    base::MemoryPressureListener::MemoryPressureLevel level) {
+  if (level == base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_NONE)
+    return 0;
+
+  WebStateList* web_state_list = browser_->GetWebStateList();
+  std::vector<web::WebState*> candidates;
+  for (int index = 0; index < web_state_list->count(); ++index) {
+    web::WebState* web_state = web_state_list->GetWebStateAt(index);
+    if (CanDiscard(web_state))
+      candidates.push_back(web_state);
+  }
+
+  // Discard the least recently activated tabs first.
+  std::sort(candidates.begin(), candidates.end(),
+            [](web::WebState* lhs, web::WebState* rhs) {
+              return lhs->GetLastActiveTime() < rhs->GetLastActiveTime();
+            });
+  if (level == base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_MODERATE)
+    candidates.resize((candidates.size() + 1) / 2);
+
+  int discarded = 0;
+  for (web::WebState* web_state : candidates) {
+    if (Discard(web_state))
+      ++discarded;
+  }
+
+  if (discarded)
+    UMA_HISTOGRAM_COUNTS_100("IOS.TabDiscard.DiscardedTabCount", discarded);
+  return discarded;
+}
+
+void TabDiscardBrowserAgent::SetMemoryUsageCallbackForTesting(
+    MemoryUsageCallback callback) {
+  memory_usage_callback_ = std::move(callback);
+}
+
+void TabDiscardBrowserAgent::OnMemoryPressure(
+    base::MemoryPressureListener::MemoryPressureLevel level) {
+  DiscardTabs(level);
+}
+
+bool TabDiscardBrowserAgent::CanDiscard(web::WebState* web_state) const {
+  if (!web_state->IsRealized())
+    return false;
+  if (web_state == browser_->GetWebStateList()->GetActiveWebState())
+    return false;
+  return !web_state->IsVisible() && !web_state->IsLoading();
+}
+
+bool TabDiscardBrowserAgent::Discard(web::WebState* web_state) {
+  const uint64_t memory_before = memory_usage_callback_.Run();
+  if (!web_state->Unrealize())
+    return false;
+
+  // Only the memory released by this process is accounted for. The memory of
+  // the WebKit processes is released asynchronously and can't be attributed
+  // to a single tab.
+  const uint64_t memory_after = memory_usage_callback_.Run();
+  const uint64_t bytes_saved =
+      memory_before > memory_after ? memory_before - memory_after : 0;
+
+  ++discard_count_;
+  bytes_saved_ += bytes_saved;
+  UMA_HISTOGRAM_MEMORY_KB("IOS.TabDiscard.MemorySavedPerTab",
+                          static_cast<int>(bytes_saved / 1024));
+  return true;
+}
+
+void TabDiscardBrowserAgent::BrowserDestroyed(Browser* browser) {
+  DCHECK_EQ(browser, browser_);
+  memory_pressure_listener_.reset();
+  browser_observation_.Reset();
+}
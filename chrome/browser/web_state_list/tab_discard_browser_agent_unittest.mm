@@ -0,0 +1,122 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#import "ios/chrome/browser/web_state_list/tab_discard_browser_agent.h"
+
+#include "base/bind.h"
+#include "base/time/time.h"
+#include "ios/chrome/browser/browser_state/test_chrome_browser_state.h"
+#import "ios/chrome/browser/main/test_browser.h"
+#import "ios/chrome/browser/web_state_list/web_state_list.h"
+#import "ios/chrome/browser/web_state_list/web_state_opener.h"
+#import "ios/web/public/test/fakes/fake_web_state.h"
+#include "ios/web/public/test/web_task_environment.h"
+#include "testing/platform_test.h"
+
+#if !defined(__has_feature) || !__has_feature(objc_arc)
+#error "This file requires ARC support."
+#endif
+
+namespace {
+
+// Memory reported as released by each discard.
+const uint64_t kBytesPerDiscard = 1024 * 1024;
+
+const base::MemoryPressureListener::MemoryPressureLevel kModerate =
+    base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_MODERATE;
+const base::MemoryPressureListener::MemoryPressureLevel kCritical =
+    base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL;
+
+class TabDiscardBrowserAgentTest : public PlatformTest {
+ public:
+  TabDiscardBrowserAgentTest() {
+    browser_state_ = TestChromeBrowserState::Builder().Build();
+    browser_ = std::make_unique<TestBrowser>(browser_state_.get());
+    TabDiscardBrowserAgent::CreateForBrowser(browser_.get());
+    agent_ = TabDiscardBrowserAgent::FromBrowser(browser_.get());
+
+    // Each measure reports kBytesPerDiscard bytes less than the previous one.
+    agent_->SetMemoryUsageCallbackForTesting(base::BindRepeating(
+        [](uint64_t* memory_usage) {
+          *memory_usage -= kBytesPerDiscard;
+          return *memory_usage;
+        },
+        base::Unretained(&memory_usage_)));
+  }
+
+  // Appends a WebState last activated |age| ago, and returns it.
+  web::FakeWebState* AppendWebState(base::TimeDelta age) {
+    auto web_state = std::make_unique<web::FakeWebState>();
+    web_state->SetLastActiveTime(base::Time::Now() - age);
+    web::FakeWebState* web_state_ptr = web_state.get();
+    browser_->GetWebStateList()->InsertWebState(
+        WebStateList::kInvalidIndex, std::move(web_state),
+        WebStateList::INSERT_NO_FLAGS, WebStateOpener());
+    return web_state_ptr;
+  }
+
+ protected:
+  web::WebTaskEnvironment task_environment_;
+  std::unique_ptr<TestChromeBrowserState> browser_state_;
+  std::unique_ptr<TestBrowser> browser_;
+  TabDiscardBrowserAgent* agent_;
+  uint64_t memory_usage_ = 1024 * kBytesPerDiscard;
+};
+
+}  // namespace
+
+// Tests that critical memory pressure discards all the background tabs, but
+// not the active, visible or loading ones.
+TEST_F(TabDiscardBrowserAgentTest, CriticalPressure) {
+  web::FakeWebState* background = AppendWebState(base::Minutes(3));
+  web::FakeWebState* loading = AppendWebState(base::Minutes(2));
+  loading->SetLoading(true);
+  web::FakeWebState* visible = AppendWebState(base::Minutes(1));
+  visible->WasShown();
+  web::FakeWebState* active = AppendWebState(base::Minutes(0));
+  browser_->GetWebStateList()->ActivateWebStateAt(3);
+
+  EXPECT_EQ(1, agent_->DiscardTabs(kCritical));
+  EXPECT_FALSE(background->IsRealized());
+  EXPECT_TRUE(loading->IsRealized());
+  EXPECT_TRUE(visible->IsRealized());
+  EXPECT_TRUE(active->IsRealized());
+  EXPECT_EQ(1, agent_->discard_count());
+  EXPECT_EQ(kBytesPerDiscard, agent_->bytes_saved());
+}
+
+// Tests that moderate memory pressure discards the least recently activated
+// half of the background tabs.
+TEST_F(TabDiscardBrowserAgentTest, ModeratePressure) {
+  web::FakeWebState* newest = AppendWebState(base::Minutes(1));
+  web::FakeWebState* oldest = AppendWebState(base::Minutes(4));
+  web::FakeWebState* newer = AppendWebState(base::Minutes(2));
+  web::FakeWebState* older = AppendWebState(base::Minutes(3));
+  AppendWebState(base::Minutes(0));
+  browser_->GetWebStateList()->ActivateWebStateAt(4);
+
+  EXPECT_EQ(2, agent_->DiscardTabs(kModerate));
+  EXPECT_FALSE(oldest->IsRealized());
+  EXPECT_FALSE(older->IsRealized());
+  EXPECT_TRUE(newer->IsRealized());
+  EXPECT_TRUE(newest->IsRealized());
+  EXPECT_EQ(2 * kBytesPerDiscard, agent_->bytes_saved());
+}
+
+// Tests that a discarded tab is realized again when activated.
+TEST_F(TabDiscardBrowserAgentTest, RealizedOnActivation) {
+  web::FakeWebState* background = AppendWebState(base::Minutes(1));
+  AppendWebState(base::Minutes(0));
+  browser_->GetWebStateList()->ActivateWebStateAt(1);
+
+  ASSERT_EQ(1, agent_->DiscardTabs(kCritical));
+  ASSERT_FALSE(background->IsRealized());
+
+  browser_->GetWebStateList()->ActivateWebStateAt(0);
+  EXPECT_TRUE(background->IsRealized());
+
+  // The previously active tab can now be discarded.
+  EXPECT_EQ(1, agent_->DiscardTabs(kCritical));
+  EXPECT_EQ(2, agent_->discard_count());
+}
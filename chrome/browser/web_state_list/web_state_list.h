@@ -6,6 +6,7 @@
 #define IOS_CHROME_BROWSER_WEB_STATE_LIST_WEB_STATE_LIST_H_
 
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 #include "base/auto_reset.h"
@@ -13,6 +14,7 @@
 #include "base/compiler_specific.h"
 #include "base/observer_list.h"
 #include "base/sequence_checker.h"
+#include "ios/chrome/browser/web_state_list/web_state_list_removing_indexes.h"
 #include "url/gurl.h"
 
 class WebStateListDelegate;
@@ -104,12 +106,14 @@ class WebStateList {
   int GetIndexOfWebState(const web::WebState* web_state) const;
 
   // Returns the index of the first WebState in the model whose visible URL is
-  // |url| or kInvalidIndex if no WebState with that URL exists.
+  // |url| or kInvalidIndex if no WebState with that URL exists. This uses an
+  // index of the visible URLs and does not iterate over the WebStates.
   int GetIndexOfWebStateWithURL(const GURL& url) const;
 
   // Returns the index of the first WebState, ignoring the currently active
   // WebState, in the model whose visible URL is |url| or kInvalidIndex if no
-  // non-active WebState with that URL exists.
+  // non-active WebState with that URL exists. This uses an index of the
+  // visible URLs and does not iterate over the WebStates.
   int GetIndexOfInactiveWebStateWithURL(const GURL& url) const;
 
   // Returns information about the opener of the WebState at the specified
@@ -164,8 +168,28 @@ class WebStateList {
   // is a bitwise combination of ClosingFlags values.
   void CloseWebStateAt(int index, int close_flags);
 
-  // Closes and destroys all WebStates. The |close_flags| is a bitwise
-  // combination of ClosingFlags values.
+  // Detaches the WebStates at the specified indices in a single pass, and
+  // notifies the observers once for all of them. Returns the detached
+  // WebStates sorted by increasing index to the caller (abandon ownership of
+  // the returned WebStates).
+  std::vector<std::unique_ptr<web::WebState>> DetachWebStatesAtIndices(
+      WebStateListRemovingIndexes removing_indexes);
+
+  // Closes and destroys the WebStates at the specified indices in a single
+  // pass, and notifies the observers once for all of them. The |close_flags|
+  // is a bitwise combination of ClosingFlags values.
+  void CloseWebStatesAtIndices(int close_flags,
+                               WebStateListRemovingIndexes removing_indexes);
+
+  // Closes and destroys the WebStates for which |predicate| returns true, as
+  // CloseWebStatesAtIndices() does. |predicate| must not mutate the list.
+  void CloseWebStatesMatching(
+      int close_flags,
+      base::RepeatingCallback<bool(const web::WebState*)> predicate);
+
+  // Closes and destroys all WebStates, one at a time from the last one, in a
+  // batch operation. The |close_flags| is a bitwise combination of
+  // ClosingFlags values.
   void CloseAllWebStates(int close_flags);
 
   // Makes the WebState at the specified index the active WebState.
@@ -189,6 +213,11 @@ class WebStateList {
  private:
   class WebStateWrapper;
 
+  // Hashes a GURL by its spec, without copying it.
+  struct URLHash {
+    size_t operator()(const GURL& url) const;
+  };
+
   // Locks the WebStateList for mutation. This methods checks that the list is
   // not currently mutated (as the class is not re-entrant it would lead to
   // corruption of the internal state and ultimately to indefined behaviour).
@@ -231,6 +260,24 @@ class WebStateList {
   // Assumes that the WebStateList is locked.
   void CloseWebStateAtImpl(int index, int close_flags);
 
+  // Detaches the WebStates at the specified indices in a single pass. Returns
+  // the detached WebStates sorted by increasing index to the caller (abandon
+  // ownership of the returned WebStates) and their former indices in
+  // |detached_indices|.
+  //
+  // Assumes that the WebStateList is locked.
+  std::vector<std::unique_ptr<web::WebState>> DetachWebStatesAtIndicesImpl(
+      const WebStateListRemovingIndexes& removing_indexes,
+      std::vector<int>* detached_indices);
+
+  // Closes and destroys the WebStates at the specified indices in a single
+  // pass. The |close_flags| is a bitwise combination of ClosingFlags values.
+  //
+  // Assumes that the WebStateList is locked.
+  void CloseWebStatesAtIndicesImpl(
+      int close_flags,
+      const WebStateListRemovingIndexes& removing_indexes);
+
   // Closes and destroys all WebStates. The |close_flags| is a bitwise
   // combination of ClosingFlags values.
   //
@@ -262,6 +309,29 @@ class WebStateList {
                                     bool use_group,
                                     int n) const;
 
+  // Returns the index of the first WebState whose visible URL is |url|,
+  // ignoring the WebState at |ignored_index|, or kInvalidIndex if there is
+  // none. Only the WebStates indexed under |url| are considered, so a WebState
+  // whose visible URL changed to |url| without any notification is missed
+  // until it sends one.
+  int GetIndexOfWebStateWithURLIgnoring(const GURL& url,
+                                        int ignored_index) const;
+
+  // Adds |wrapper| to |wrappers_by_url_| under the current visible URL of its
+  // WebState.
+  void AddToURLIndex(WebStateWrapper* wrapper);
+
+  // Removes |wrapper| from |wrappers_by_url_|.
+  void RemoveFromURLIndex(WebStateWrapper* wrapper);
+
+  // Stores in the wrappers from |first_index| to |last_index| (inclusive)
+  // their index in |web_state_wrappers_|.
+  void UpdateWrapperIndices(int first_index, int last_index);
+
+  // Invoked by |wrapper| when the visible URL of its WebState may have
+  // changed, to update |wrappers_by_url_|.
+  void OnVisibleURLMayHaveChanged(WebStateWrapper* wrapper);
+
   // Returns the wrapper of the currently active WebState or null if there
   // is none.
   WebStateWrapper* GetActiveWebStateWrapper() const;
@@ -286,6 +356,13 @@ class WebStateList {
   // Index of the currently active WebState, kInvalidIndex if no such WebState.
   int active_index_ = kInvalidIndex;
 
+  // Wrappers of the WebStates, keyed by visible URL, in no particular order.
+  // It is updated when WebStates are inserted, replaced or detached, and when
+  // the visible URL of a WebState changes. The wrappers hold their index, so
+  // it is not updated when the WebStates move.
+  std::unordered_map<GURL, std::vector<WebStateWrapper*>, URLHash>
+      wrappers_by_url_;
+
   // Lock to prevent observers from mutating or deleting the list while it is
   // mutating. The lock is managed by LockForMutation() method (and released
   // by the returned base::AutoReset<bool>).
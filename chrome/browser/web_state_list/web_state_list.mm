@@ -9,6 +9,9 @@
 
 #include "base/auto_reset.h"
 #include "base/check_op.h"
+#include "base/containers/flat_set.h"
+#include "base/hash/hash.h"
+#include "base/scoped_observation.h"
 #import "ios/chrome/browser/web_state_list/web_state_list_delegate.h"
 #import "ios/chrome/browser/web_state_list/web_state_list_observer.h"
 #import "ios/chrome/browser/web_state_list/web_state_list_order_controller.h"
@@ -16,6 +19,7 @@
 #import "ios/chrome/browser/web_state_list/web_state_opener.h"
 #import "ios/web/public/navigation/navigation_manager.h"
 #import "ios/web/public/web_state.h"
+#import "ios/web/public/web_state_observer.h"
 
 #if !defined(__has_feature) || !__has_feature(objc_arc)
 #error "This file requires ARC support."
@@ -35,18 +39,32 @@ bool IsClosingFlagSet(int flagset, WebStateList::ClosingFlags flag) {
 
 }  // namespace
 
-// Wrapper around a WebState stored in a WebStateList.
-class WebStateList::WebStateWrapper {
+// Wrapper around a WebState stored in a WebStateList. Observes the WebState
+// to keep the visible URL index of the WebStateList up to date. There is no
+// notification of the changes of visible URL, so the index is updated on all
+// the notifications which may come with one, including the ones following the
+// changes of pending item (e.g. title or security state changes).
+class WebStateList::WebStateWrapper : public web::WebStateObserver {
  public:
-  explicit WebStateWrapper(std::unique_ptr<web::WebState> web_state);
+  WebStateWrapper(WebStateList* web_state_list,
+                  std::unique_ptr<web::WebState> web_state);
 
   WebStateWrapper(const WebStateWrapper&) = delete;
   WebStateWrapper& operator=(const WebStateWrapper&) = delete;
 
-  ~WebStateWrapper();
+  ~WebStateWrapper() override;
 
   web::WebState* web_state() const { return web_state_.get(); }
 
+  // Gets and sets the visible URL under which the wrapped WebState is stored
+  // in the visible URL index of the WebStateList.
+  const GURL& indexed_url() const { return indexed_url_; }
+  void set_indexed_url(const GURL& url) { indexed_url_ = url; }
+
+  // Gets and sets the index of the wrapper in the WebStateList.
+  int index() const { return index_; }
+  void set_index(int index) { index_ = index; }
+
   // Returns ownership of the wrapped WebState.
   std::unique_ptr<web::WebState> ReleaseWebState();
 
@@ -72,22 +90,53 @@ class WebStateList::WebStateWrapper {
                    int opener_navigation_index,
                    bool use_group) const;
 
+  // web::WebStateObserver implementation.
+  void DidStartNavigation(web::WebState* web_state,
+                          web::NavigationContext* navigation_context) override;
+  void DidRedirectNavigation(
+      web::WebState* web_state,
+      web::NavigationContext* navigation_context) override;
+  void DidFinishNavigation(web::WebState* web_state,
+                           web::NavigationContext* navigation_context) override;
+  void DidStartLoading(web::WebState* web_state) override;
+  void DidStopLoading(web::WebState* web_state) override;
+  void PageLoaded(
+      web::WebState* web_state,
+      web::PageLoadCompletionStatus load_completion_status) override;
+  void LoadProgressChanged(web::WebState* web_state, double progress) override;
+  void DidChangeBackForwardState(web::WebState* web_state) override;
+  void TitleWasSet(web::WebState* web_state) override;
+  void DidChangeVisibleSecurityState(web::WebState* web_state) override;
+  void WebStateRealized(web::WebState* web_state) override;
+  void WebStateUnrealized(web::WebState* web_state) override;
+
  private:
+  WebStateList* web_state_list_ = nullptr;
   std::unique_ptr<web::WebState> web_state_;
   WebStateOpener opener_;
   bool should_reset_opener_ = false;
+  GURL indexed_url_;
+  int index_ = WebStateList::kInvalidIndex;
+  base::ScopedObservation<web::WebState, web::WebStateObserver>
+      web_state_observation_{this};
 };
 
 WebStateList::WebStateWrapper::WebStateWrapper(
+    WebStateList* web_state_list,
     std::unique_ptr<web::WebState> web_state)
-    : web_state_(std::move(web_state)), opener_(nullptr) {
+    : web_state_list_(web_state_list),
+      web_state_(std::move(web_state)),
+      opener_(nullptr) {
+  DCHECK(web_state_list_);
   DCHECK(web_state_);
+  web_state_observation_.Observe(web_state_.get());
 }
 
 WebStateList::WebStateWrapper::~WebStateWrapper() = default;
 
 std::unique_ptr<web::WebState>
 WebStateList::WebStateWrapper::ReleaseWebState() {
+  web_state_observation_.Reset();
   std::unique_ptr<web::WebState> web_state;
   std::swap(web_state, web_state_);
   opener_ = WebStateOpener();
@@ -98,7 +147,9 @@ std::unique_ptr<web::WebState> WebStateList::WebStateWrapper::ReplaceWebState(
     std::unique_ptr<web::WebState> web_state) {
   DCHECK_NE(web_state.get(), web_state_.get());
   DCHECK_NE(web_state.get(), nullptr);
+  web_state_observation_.Reset();
   std::swap(web_state, web_state_);
+  web_state_observation_.Observe(web_state_.get());
   opener_ = WebStateOpener();
   return web_state;
 }
@@ -132,6 +183,71 @@ void WebStateList::WebStateWrapper::SetShouldResetOpenerOnActiveWebStateChange(
   should_reset_opener_ = should_reset_opener;
 }
 
+void WebStateList::WebStateWrapper::DidStartNavigation(
+    web::WebState* web_state,
+    web::NavigationContext* navigation_context) {
+  web_state_list_->OnVisibleURLMayHaveChanged(this);
+}
+
+void WebStateList::WebStateWrapper::DidRedirectNavigation(
+    web::WebState* web_state,
+    web::NavigationContext* navigation_context) {
+  web_state_list_->OnVisibleURLMayHaveChanged(this);
+}
+
+void WebStateList::WebStateWrapper::DidFinishNavigation(
+    web::WebState* web_state,
+    web::NavigationContext* navigation_context) {
+  web_state_list_->OnVisibleURLMayHaveChanged(this);
+}
+
+void WebStateList::WebStateWrapper::DidStartLoading(web::WebState* web_state) {
+  web_state_list_->OnVisibleURLMayHaveChanged(this);
+}
+
+void WebStateList::WebStateWrapper::DidStopLoading(web::WebState* web_state) {
+  web_state_list_->OnVisibleURLMayHaveChanged(this);
+}
+
+void WebStateList::WebStateWrapper::PageLoaded(
+    web::WebState* web_state,
+    web::PageLoadCompletionStatus load_completion_status) {
+  web_state_list_->OnVisibleURLMayHaveChanged(this);
+}
+
+void WebStateList::WebStateWrapper::LoadProgressChanged(
+    web::WebState* web_state,
+    double progress) {
+  web_state_list_->OnVisibleURLMayHaveChanged(this);
+}
+
+void WebStateList::WebStateWrapper::DidChangeBackForwardState(
+    web::WebState* web_state) {
+  web_state_list_->OnVisibleURLMayHaveChanged(this);
+}
+
+void WebStateList::WebStateWrapper::TitleWasSet(web::WebState* web_state) {
+  web_state_list_->OnVisibleURLMayHaveChanged(this);
+}
+
+void WebStateList::WebStateWrapper::DidChangeVisibleSecurityState(
+    web::WebState* web_state) {
+  web_state_list_->OnVisibleURLMayHaveChanged(this);
+}
+
+void WebStateList::WebStateWrapper::WebStateRealized(web::WebState* web_state) {
+  web_state_list_->OnVisibleURLMayHaveChanged(this);
+}
+
+void WebStateList::WebStateWrapper::WebStateUnrealized(
+    web::WebState* web_state) {
+  web_state_list_->OnVisibleURLMayHaveChanged(this);
+}
+
+size_t WebStateList::URLHash::operator()(const GURL& url) const {
+  return base::FastHash(url.possibly_invalid_spec());
+}
+
 WebStateList::WebStateList(WebStateListDelegate* delegate)
     : delegate_(delegate) {
   DCHECK(delegate_);
@@ -178,22 +294,12 @@ int WebStateList::GetIndexOfWebState(const web::WebState* web_state) const {
 
 int WebStateList::GetIndexOfWebStateWithURL(const GURL& url) const {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
-  for (int index = 0; index < count(); ++index) {
-    if (web_state_wrappers_[index]->web_state()->GetVisibleURL() == url)
-      return index;
-  }
-  return kInvalidIndex;
+  return GetIndexOfWebStateWithURLIgnoring(url, kInvalidIndex);
 }
 
 int WebStateList::GetIndexOfInactiveWebStateWithURL(const GURL& url) const {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
-  for (int index = 0; index < count(); ++index) {
-    if (index == active_index_)
-      continue;
-    if (web_state_wrappers_[index]->web_state()->GetVisibleURL() == url)
-      return index;
-  }
-  return kInvalidIndex;
+  return GetIndexOfWebStateWithURLIgnoring(url, active_index_);
 }
 
 WebStateOpener WebStateList::GetOpenerOfWebStateAt(int index) const {
@@ -260,6 +366,37 @@ void WebStateList::CloseWebStateAt(int index, int close_flags) {
   return CloseWebStateAtImpl(index, close_flags);
 }
 
+std::vector<std::unique_ptr<web::WebState>>
+WebStateList::DetachWebStatesAtIndices(
+    WebStateListRemovingIndexes removing_indexes) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  auto lock = LockForMutation();
+  std::vector<int> detached_indices;
+  return DetachWebStatesAtIndicesImpl(removing_indexes, &detached_indices);
+}
+
+void WebStateList::CloseWebStatesAtIndices(
+    int close_flags,
+    WebStateListRemovingIndexes removing_indexes) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  auto lock = LockForMutation();
+  return CloseWebStatesAtIndicesImpl(close_flags, removing_indexes);
+}
+
+void WebStateList::CloseWebStatesMatching(
+    int close_flags,
+    base::RepeatingCallback<bool(const web::WebState*)> predicate) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  auto lock = LockForMutation();
+  std::vector<int> indices;
+  for (int index = 0; index < count(); ++index) {
+    if (predicate.Run(web_state_wrappers_[index]->web_state()))
+      indices.push_back(index);
+  }
+  return CloseWebStatesAtIndicesImpl(
+      close_flags, WebStateListRemovingIndexes(std::move(indices)));
+}
+
 void WebStateList::CloseAllWebStates(int close_flags) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
   auto lock = LockForMutation();
@@ -310,7 +447,9 @@ int WebStateList::InsertWebStateImpl(int index,
   web::WebState* web_state_ptr = web_state.get();
   web_state_wrappers_.insert(
       web_state_wrappers_.begin() + index,
-      std::make_unique<WebStateWrapper>(std::move(web_state)));
+      std::make_unique<WebStateWrapper>(this, std::move(web_state)));
+  UpdateWrapperIndices(index, count() - 1);
+  AddToURLIndex(web_state_wrappers_[index].get());
 
   if (active_index_ >= index)
     ++active_index_;
@@ -346,6 +485,8 @@ void WebStateList::MoveWebStateAtImpl(int from_index, int to_index) {
   web_state_wrappers_.erase(web_state_wrappers_.begin() + from_index);
   web_state_wrappers_.insert(web_state_wrappers_.begin() + to_index,
                              std::move(web_state_wrapper));
+  UpdateWrapperIndices(std::min(from_index, to_index),
+                       std::max(from_index, to_index));
 
   if (active_index_ == from_index) {
     active_index_ = to_index;
@@ -373,8 +514,11 @@ std::unique_ptr<web::WebState> WebStateList::ReplaceWebStateAtImpl(
   ClearOpenersReferencing(index);
 
   web::WebState* web_state_ptr = web_state.get();
+  WebStateWrapper* wrapper = web_state_wrappers_[index].get();
+  RemoveFromURLIndex(wrapper);
   std::unique_ptr<web::WebState> old_web_state =
-      web_state_wrappers_[index]->ReplaceWebState(std::move(web_state));
+      wrapper->ReplaceWebState(std::move(web_state));
+  AddToURLIndex(wrapper);
 
   for (auto& observer : observers_) {
     observer.WebStateReplacedAt(this, old_web_state.get(), web_state_ptr,
@@ -407,9 +551,11 @@ std::unique_ptr<web::WebState> WebStateList::DetachWebStateAtImpl(int index) {
       order_controller.DetermineNewActiveIndex(active_index_, {index});
 
   ClearOpenersReferencing(index);
+  RemoveFromURLIndex(web_state_wrappers_[index].get());
   std::unique_ptr<web::WebState> detached_web_state =
       web_state_wrappers_[index]->ReleaseWebState();
   web_state_wrappers_.erase(web_state_wrappers_.begin() + index);
+  UpdateWrapperIndices(index, count() - 1);
 
   // Check that the active element (if there is one) is valid.
   DCHECK(active_index_ == kInvalidIndex || ContainsIndex(active_index_));
@@ -440,6 +586,106 @@ void WebStateList::CloseWebStateAtImpl(int index, int close_flags) {
   // Dropping detached_web_state will destroy it.
 }
 
+std::vector<std::unique_ptr<web::WebState>>
+WebStateList::DetachWebStatesAtIndicesImpl(
+    const WebStateListRemovingIndexes& removing_indexes,
+    std::vector<int>* detached_indices) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  DCHECK(locked_);
+  DCHECK(detached_indices);
+  std::vector<web::WebState*> web_states;
+  detached_indices->clear();
+  for (int index = 0; index < count(); ++index) {
+    if (!removing_indexes.Contains(index))
+      continue;
+    detached_indices->push_back(index);
+    web_states.push_back(web_state_wrappers_[index]->web_state());
+  }
+  DCHECK_EQ(static_cast<int>(web_states.size()), removing_indexes.count());
+  if (web_states.empty())
+    return {};
+
+  for (auto& observer : observers_)
+    observer.WillDetachWebStatesAt(this, web_states, *detached_indices);
+
+  // Update the active index to prevent observer from seeing an invalid WebState
+  // as the active one but only send the WebStateActivatedAt notification after
+  // the WebStatesDetachedAt one. The order controller needs the openers of the
+  // WebStates, so this is done before clearing them.
+  web::WebState* old_active_web_state = GetActiveWebState();
+  const bool active_web_state_was_closed =
+      removing_indexes.Contains(active_index_);
+  WebStateListOrderController order_controller(*this);
+  active_index_ =
+      order_controller.DetermineNewActiveIndex(active_index_, removing_indexes);
+
+  // Remove the wrappers and clear the openers referencing the detached
+  // WebStates in a single pass, updating the indices of the kept wrappers.
+  const base::flat_set<const web::WebState*> detached_web_states(
+      web_states.begin(), web_states.end());
+  std::vector<std::unique_ptr<web::WebState>> detached;
+  detached.reserve(web_states.size());
+  size_t kept_count = 0;
+  for (size_t index = 0; index < web_state_wrappers_.size(); ++index) {
+    std::unique_ptr<WebStateWrapper>& wrapper = web_state_wrappers_[index];
+    if (detached_web_states.contains(wrapper->web_state())) {
+      RemoveFromURLIndex(wrapper.get());
+      detached.push_back(wrapper->ReleaseWebState());
+      continue;
+    }
+    if (detached_web_states.contains(wrapper->opener().opener))
+      wrapper->SetOpener(WebStateOpener());
+    wrapper->set_index(static_cast<int>(kept_count));
+    if (kept_count != index)
+      web_state_wrappers_[kept_count] = std::move(wrapper);
+    ++kept_count;
+  }
+  web_state_wrappers_.resize(kept_count);
+
+  // Check that the active element (if there is one) is valid.
+  DCHECK(active_index_ == kInvalidIndex || ContainsIndex(active_index_));
+
+  for (auto& observer : observers_)
+    observer.WebStatesDetachedAt(this, web_states, *detached_indices);
+
+  if (active_web_state_was_closed) {
+    NotifyIfActiveWebStateChanged(old_active_web_state,
+                                  ActiveWebStateChangeReason::Closed);
+  }
+
+  for (web::WebState* web_state : web_states)
+    delegate_->WebStateDetached(web_state);
+  return detached;
+}
+
+void WebStateList::CloseWebStatesAtIndicesImpl(
+    int close_flags,
+    const WebStateListRemovingIndexes& removing_indexes) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  DCHECK(locked_);
+  std::vector<int> detached_indices;
+  std::vector<std::unique_ptr<web::WebState>> detached_web_states =
+      DetachWebStatesAtIndicesImpl(removing_indexes, &detached_indices);
+  if (detached_web_states.empty())
+    return;
+
+  std::vector<web::WebState*> web_states;
+  web_states.reserve(detached_web_states.size());
+  for (const auto& web_state : detached_web_states)
+    web_states.push_back(web_state.get());
+
+  const bool user_action = IsClosingFlagSet(close_flags, CLOSE_USER_ACTION);
+  for (auto& observer : observers_) {
+    observer.WillCloseWebStatesAt(this, web_states, detached_indices,
+                                  user_action);
+  }
+
+  // Dropping detached_web_states will destroy them, from the last one to
+  // match the order of the notifications.
+  while (!detached_web_states.empty())
+    detached_web_states.pop_back();
+}
+
 void WebStateList::CloseAllWebStatesImpl(int close_flags) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
   DCHECK(locked_);
@@ -453,7 +699,9 @@ void WebStateList::CloseAllWebStatesImpl(int close_flags) {
         web_state_list->ActivateWebStateAtImpl(
             kInvalidIndex, ActiveWebStateChangeReason::Closed);
 
-        // Close the WebStates from last to first.
+        // Close the WebStates from last to first. This is not done with
+        // CloseWebStatesAtIndicesImpl() as most observers only handle the
+        // WebStates detached one at a time.
         while (!web_state_list->empty())
           web_state_list->CloseWebStateAtImpl(web_state_list->count() - 1,
                                               close_flags);
@@ -565,6 +813,65 @@ int WebStateList::GetIndexOfNthWebStateOpenedBy(const web::WebState* opener,
   return found_index;
 }
 
+int WebStateList::GetIndexOfWebStateWithURLIgnoring(const GURL& url,
+                                                    int ignored_index) const {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  int found_index = kInvalidIndex;
+  auto iter = wrappers_by_url_.find(url);
+  if (iter != wrappers_by_url_.end()) {
+    // There is usually a single WebState with a given URL.
+    for (const WebStateWrapper* wrapper : iter->second) {
+      const int index = wrapper->index();
+      DCHECK_EQ(wrapper, GetWebStateWrapperAt(index));
+      if (index == ignored_index ||
+          (found_index != kInvalidIndex && index > found_index)) {
+        continue;
+      }
+      // The visible URL may have changed since the last notification, in
+      // which case the WebState is no longer a match.
+      if (wrapper->web_state()->GetVisibleURL() == url)
+        found_index = index;
+    }
+  }
+  return found_index;
+}
+
+void WebStateList::AddToURLIndex(WebStateWrapper* wrapper) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  wrapper->set_indexed_url(wrapper->web_state()->GetVisibleURL());
+  wrappers_by_url_[wrapper->indexed_url()].push_back(wrapper);
+}
+
+void WebStateList::RemoveFromURLIndex(WebStateWrapper* wrapper) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  auto iter = wrappers_by_url_.find(wrapper->indexed_url());
+  DCHECK(iter != wrappers_by_url_.end());
+  std::vector<WebStateWrapper*>& wrappers = iter->second;
+  auto position = std::find(wrappers.begin(), wrappers.end(), wrapper);
+  DCHECK(position != wrappers.end());
+  wrappers.erase(position);
+  if (wrappers.empty())
+    wrappers_by_url_.erase(iter);
+}
+
+void WebStateList::UpdateWrapperIndices(int first_index, int last_index) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  // This is linear in the number of updated wrappers, like the insertion or
+  // removal of elements of |web_state_wrappers_| which requires it.
+  for (int index = first_index; index <= last_index; ++index)
+    GetWebStateWrapperAt(index)->set_index(index);
+}
+
+void WebStateList::OnVisibleURLMayHaveChanged(WebStateWrapper* wrapper) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (wrapper->web_state()->GetVisibleURL() == wrapper->indexed_url())
+    return;
+
+  DCHECK_EQ(wrapper, GetWebStateWrapperAt(wrapper->index()));
+  RemoveFromURLIndex(wrapper);
+  AddToURLIndex(wrapper);
+}
+
 WebStateList::WebStateWrapper* WebStateList::GetActiveWebStateWrapper() const {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
   if (active_index_ != kInvalidIndex)
@@ -5,6 +5,8 @@
 #ifndef IOS_CHROME_BROWSER_WEB_STATE_LIST_WEB_STATE_LIST_OBSERVER_H_
 #define IOS_CHROME_BROWSER_WEB_STATE_LIST_WEB_STATE_LIST_OBSERVER_H_
 
+#include <vector>
+
 #include "base/observer_list_types.h"
 
 class WebStateList;
@@ -83,6 +85,41 @@ class WebStateListObserver : public base::CheckedObserver {
                                    int index,
                                    bool user_action);
 
+  // Invoked before the WebStates at the specified indices are detached from
+  // the WebStateList at once (e.g. by WebStateList::CloseWebStatesAtIndices()).
+  // |web_states| and |indices| are sorted by increasing index. The WebStates
+  // are still valid and still in the WebStateList. The default implementation
+  // invokes WillDetachWebStateAt() for each WebState, from the last one, while
+  // all of them are still in the WebStateList.
+  virtual void WillDetachWebStatesAt(
+      WebStateList* web_state_list,
+      const std::vector<web::WebState*>& web_states,
+      const std::vector<int>& indices);
+
+  // Invoked after the WebStates at the specified indices have been detached
+  // at once. |web_states| and |indices| are sorted by increasing index. The
+  // WebStates are still valid but are no longer in the WebStateList. The
+  // default implementation invokes WebStateDetachedAt() for each WebState,
+  // from the last one, after all of them were removed and the new active
+  // WebState was selected. Observers that look at the WebStateList should
+  // override this method.
+  virtual void WebStatesDetachedAt(
+      WebStateList* web_state_list,
+      const std::vector<web::WebState*>& web_states,
+      const std::vector<int>& indices);
+
+  // Invoked before the WebStates detached at once from the specified indices
+  // are destroyed via the WebStateList. |web_states| and |indices| are sorted
+  // by increasing index. If the WebStates are closed due to user action,
+  // |user_action| will be true. The default implementation invokes
+  // WillCloseWebStateAt() for each WebState, from the last one, after all of
+  // them were removed.
+  virtual void WillCloseWebStatesAt(
+      WebStateList* web_state_list,
+      const std::vector<web::WebState*>& web_states,
+      const std::vector<int>& indices,
+      bool user_action);
+
   // Invoked after |new_web_state| was activated at the specified index. Both
   // WebState are either valid or null (if there was no selection or there is
   // no selection). See ChangeReason enum for possible values for |reason|.
@@ -7,6 +7,7 @@
 #include <ostream>
 
 #import "base/check.h"
+#import "base/check_op.h"
 
 #if !defined(__has_feature) || !__has_feature(objc_arc)
 #error "This file requires ARC support."
@@ -48,6 +49,44 @@ void WebStateListObserver::WillCloseWebStateAt(WebStateList* web_state_list,
                                                int index,
                                                bool user_action) {}
 
+void WebStateListObserver::WillDetachWebStatesAt(
+    WebStateList* web_state_list,
+    const std::vector<web::WebState*>& web_states,
+    const std::vector<int>& indices) {
+  DCHECK_EQ(web_states.size(), indices.size());
+  // Unlike when the WebStates are detached one at a time, the WebStates that
+  // follow |web_states[i - 1]| are still in |web_state_list|, at their index.
+  for (size_t i = web_states.size(); i > 0; --i)
+    WillDetachWebStateAt(web_state_list, web_states[i - 1], indices[i - 1]);
+}
+
+void WebStateListObserver::WebStatesDetachedAt(
+    WebStateList* web_state_list,
+    const std::vector<web::WebState*>& web_states,
+    const std::vector<int>& indices) {
+  DCHECK_EQ(web_states.size(), indices.size());
+  // Unlike when the WebStates are detached one at a time, all |web_states| are
+  // already removed from |web_state_list|, so |indices[i - 1]| is the index
+  // of |web_states[i - 1]| before the removal, and the active index is the
+  // final one.
+  for (size_t i = web_states.size(); i > 0; --i)
+    WebStateDetachedAt(web_state_list, web_states[i - 1], indices[i - 1]);
+}
+
+void WebStateListObserver::WillCloseWebStatesAt(
+    WebStateList* web_state_list,
+    const std::vector<web::WebState*>& web_states,
+    const std::vector<int>& indices,
+    bool user_action) {
+  DCHECK_EQ(web_states.size(), indices.size());
+  // All |web_states| are already removed from |web_state_list|, and
+  // |indices| are their indices before the removal.
+  for (size_t i = web_states.size(); i > 0; --i) {
+    WillCloseWebStateAt(web_state_list, web_states[i - 1], indices[i - 1],
+                        user_action);
+  }
+}
+
 void WebStateListObserver::WebStateActivatedAt(
     WebStateList* web_state_list,
     web::WebState* old_web_state,
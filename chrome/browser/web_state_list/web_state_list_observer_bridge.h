@@ -7,6 +7,8 @@
 
 #import <Foundation/Foundation.h>
 
+#include <vector>
+
 #import "ios/chrome/browser/web_state_list/web_state_list_observer.h"
 
 // Protocol that correspond to WebStateListObserver API. Allows registering
@@ -56,6 +58,31 @@
               atIndex:(int)atIndex
            userAction:(BOOL)userAction;
 
+// Invoked before the WebStates at the specified indices are detached from the
+// WebStateList at once. |webStates| and |indices| are sorted by increasing
+// index. If not implemented, -webStateList:willDetachWebState:atIndex: is
+// invoked for each WebState instead.
+- (void)webStateList:(WebStateList*)webStateList
+    willDetachWebStates:(const std::vector<web::WebState*>&)webStates
+              atIndices:(const std::vector<int>&)indices;
+
+// Invoked after the WebStates at the specified indices have been detached at
+// once. |webStates| and |indices| are sorted by increasing index. If not
+// implemented, -webStateList:didDetachWebState:atIndex: is invoked for each
+// WebState instead.
+- (void)webStateList:(WebStateList*)webStateList
+    didDetachWebStates:(const std::vector<web::WebState*>&)webStates
+             atIndices:(const std::vector<int>&)indices;
+
+// Invoked before the WebStates detached at once from the specified indices are
+// destroyed via the WebStateList. If not implemented,
+// -webStateList:willCloseWebState:atIndex:userAction: is invoked for each
+// WebState instead.
+- (void)webStateList:(WebStateList*)webStateList
+    willCloseWebStates:(const std::vector<web::WebState*>&)webStates
+             atIndices:(const std::vector<int>&)indices
+            userAction:(BOOL)userAction;
+
 // Invoked after |newWebState| was activated at the specified index. Both
 // WebState are either valid or null (if there was no selection or there is
 // no selection). See ChangeReason enum for possible values for |reason|.
@@ -115,6 +142,16 @@ class WebStateListObserverBridge final : public WebStateListObserver {
                            web::WebState* web_state,
                            int index,
                            bool user_action) final;
+  void WillDetachWebStatesAt(WebStateList* web_state_list,
+                             const std::vector<web::WebState*>& web_states,
+                             const std::vector<int>& indices) final;
+  void WebStatesDetachedAt(WebStateList* web_state_list,
+                           const std::vector<web::WebState*>& web_states,
+                           const std::vector<int>& indices) final;
+  void WillCloseWebStatesAt(WebStateList* web_state_list,
+                            const std::vector<web::WebState*>& web_states,
+                            const std::vector<int>& indices,
+                            bool user_action) final;
   void WebStateActivatedAt(WebStateList* web_state_list,
                            web::WebState* old_web_state,
                            web::WebState* new_web_state,
@@ -103,6 +103,57 @@ void WebStateListObserverBridge::WillCloseWebStateAt(
                userAction:(user_action ? YES : NO)];
 }
 
+void WebStateListObserverBridge::WillDetachWebStatesAt(
+    WebStateList* web_state_list,
+    const std::vector<web::WebState*>& web_states,
+    const std::vector<int>& indices) {
+  const SEL selector = @selector(webStateList:willDetachWebStates:atIndices:);
+  if (![observer_ respondsToSelector:selector]) {
+    WebStateListObserver::WillDetachWebStatesAt(web_state_list, web_states,
+                                                indices);
+    return;
+  }
+
+  [observer_ webStateList:web_state_list
+      willDetachWebStates:web_states
+                atIndices:indices];
+}
+
+void WebStateListObserverBridge::WebStatesDetachedAt(
+    WebStateList* web_state_list,
+    const std::vector<web::WebState*>& web_states,
+    const std::vector<int>& indices) {
+  const SEL selector = @selector(webStateList:didDetachWebStates:atIndices:);
+  if (![observer_ respondsToSelector:selector]) {
+    WebStateListObserver::WebStatesDetachedAt(web_state_list, web_states,
+                                              indices);
+    return;
+  }
+
+  [observer_ webStateList:web_state_list
+       didDetachWebStates:web_states
+                atIndices:indices];
+}
+
+void WebStateListObserverBridge::WillCloseWebStatesAt(
+    WebStateList* web_state_list,
+    const std::vector<web::WebState*>& web_states,
+    const std::vector<int>& indices,
+    bool user_action) {
+  const SEL selector =
+      @selector(webStateList:willCloseWebStates:atIndices:userAction:);
+  if (![observer_ respondsToSelector:selector]) {
+    WebStateListObserver::WillCloseWebStatesAt(web_state_list, web_states,
+                                               indices, user_action);
+    return;
+  }
+
+  [observer_ webStateList:web_state_list
+       willCloseWebStates:web_states
+                atIndices:indices
+               userAction:(user_action ? YES : NO)];
+}
+
 void WebStateListObserverBridge::WebStateActivatedAt(
     WebStateList* web_state_list,
     web::WebState* old_web_state,
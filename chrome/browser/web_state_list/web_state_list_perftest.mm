@@ -0,0 +1,128 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#import "ios/chrome/browser/web_state_list/web_state_list.h"
+
+#include <memory>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/strings/string_number_conversions.h"
+#import "ios/chrome/browser/web_state_list/fake_web_state_list_delegate.h"
+#import "ios/chrome/browser/web_state_list/web_state_list_observer.h"
+#import "ios/chrome/browser/web_state_list/web_state_opener.h"
+#include "ios/testing/perf_test_util.h"
+#import "ios/web/public/test/fakes/fake_web_state.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/platform_test.h"
+#include "url/gurl.h"
+
+#if !defined(__has_feature) || !__has_feature(objc_arc)
+#error "This file requires ARC support."
+#endif
+
+namespace {
+
+// Number of WebStates in the WebStateList.
+const int kWebStateCount = 100;
+// Number of times the mutations are performed per measure.
+const size_t kIterations = 20;
+
+// WebStateListObserver counting the notifications it receives.
+class CountingWebStateListObserver : public WebStateListObserver {
+ public:
+  CountingWebStateListObserver() = default;
+
+  CountingWebStateListObserver(const CountingWebStateListObserver&) = delete;
+  CountingWebStateListObserver& operator=(
+      const CountingWebStateListObserver&) = delete;
+
+  int notification_count() const { return notification_count_; }
+
+  // WebStateListObserver:
+  void WebStateInsertedAt(WebStateList* web_state_list,
+                          web::WebState* web_state,
+                          int index,
+                          bool activating) override {
+    ++notification_count_;
+  }
+
+  void WebStateMoved(WebStateList* web_state_list,
+                     web::WebState* web_state,
+                     int from_index,
+                     int to_index) override {
+    ++notification_count_;
+  }
+
+  void WebStateDetachedAt(WebStateList* web_state_list,
+                          web::WebState* web_state,
+                          int index) override {
+    ++notification_count_;
+  }
+
+  void WebStateActivatedAt(WebStateList* web_state_list,
+                           web::WebState* old_web_state,
+                           web::WebState* new_web_state,
+                           int active_index,
+                           ActiveWebStateChangeReason reason) override {
+    ++notification_count_;
+  }
+
+ private:
+  int notification_count_ = 0;
+};
+
+// Inserts kWebStateCount WebStates in |web_state_list|, activates and moves
+// each of them, then closes them all.
+void MutateWebStateList(WebStateList* web_state_list) {
+  for (int i = 0; i < kWebStateCount; ++i) {
+    auto web_state = std::make_unique<web::FakeWebState>();
+    web_state->SetVisibleURL(
+        GURL("https://www.example.com/" + base::NumberToString(i)));
+    web_state_list->InsertWebState(WebStateList::kInvalidIndex,
+                                   std::move(web_state),
+                                   WebStateList::INSERT_NO_FLAGS,
+                                   WebStateOpener());
+  }
+  for (int i = 0; i < kWebStateCount; ++i)
+    web_state_list->ActivateWebStateAt(i);
+  for (int i = 0; i < kWebStateCount; ++i)
+    web_state_list->MoveWebStateAt(0, kWebStateCount - 1);
+  web_state_list->CloseAllWebStates(WebStateList::CLOSE_NO_FLAGS);
+}
+
+}  // namespace
+
+class WebStateListPerfTest : public PlatformTest {
+ protected:
+  WebStateListPerfTest() : web_state_list_(&web_state_list_delegate_) {}
+
+  FakeWebStateListDelegate web_state_list_delegate_;
+  WebStateList web_state_list_;
+};
+
+// Measures the mutations of a WebStateList with an increasing number of
+// observers, to track the cost of the notifications fan-out.
+TEST_F(WebStateListPerfTest, MutationsAndObservers) {
+  for (int observer_count : {0, 10, 50}) {
+    std::vector<std::unique_ptr<CountingWebStateListObserver>> observers;
+    for (int i = 0; i < observer_count; ++i) {
+      observers.push_back(std::make_unique<CountingWebStateListObserver>());
+      web_state_list_.AddObserver(observers.back().get());
+    }
+
+    const double time = testing::MeasureMicroseconds(
+        kIterations,
+        base::BindRepeating(&MutateWebStateList, &web_state_list_));
+    EXPECT_TRUE(web_state_list_.empty());
+    for (const auto& observer : observers) {
+      EXPECT_LT(0, observer->notification_count());
+      web_state_list_.RemoveObserver(observer.get());
+    }
+
+    testing::ReportPerfResult(
+        "WebStateList",
+        base::NumberToString(observer_count) + " observers", time, "us");
+  }
+}
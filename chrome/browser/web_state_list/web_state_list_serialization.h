@@ -43,6 +43,19 @@ SessionWindowIOS* SerializeWebStateList(WebStateList* web_state_list,
 // Returns an array of serialised sessions.
 SessionWindowIOS* SerializeWebStateList(WebStateList* web_state_list);
 
+// Serializes the part of |web_state_list| that changed, for a session journal.
+// Sets |identifiers| to the stable identifiers of the WebStates that
+// SerializeWebStateList() would save, in order, and |selected_index| to the
+// index of the selected one in |identifiers| (or NSNotFound). Returns the
+// session storage of the saved WebStates whose stable identifier is in
+// |web_states_to_serialize| or whose opener index changed since they were last
+// serialized, keyed by stable identifier.
+NSDictionary<NSString*, CRWSessionStorage*>* SerializeWebStateListIncrementally(
+    WebStateList* web_state_list,
+    NSSet<NSString*>* web_states_to_serialize,
+    NSArray<NSString*>** identifiers,
+    NSUInteger* selected_index);
+
 // Restores a |web_state_list| from |session_window| using |web_state_factory|
 // to create the restored WebStates.
 void DeserializeWebStateList(WebStateList* web_state_list,
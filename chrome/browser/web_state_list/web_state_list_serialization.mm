@@ -55,6 +55,64 @@ WebStateListRemovingIndexes GetIndexOfWebStatesToDrop(
   }
   return WebStateListRemovingIndexes(std::move(web_state_to_skip_indexes));
 }
+
+// Stores the opener of the WebState at |index| in |web_state_list| in its
+// serializable user data, using the indexes the WebStates will have once the
+// ones in |removing_indexes| are dropped. Returns whether the stored values
+// changed.
+bool UpdateOpenerUserData(WebStateList* web_state_list,
+                          int index,
+                          const WebStateListRemovingIndexes& removing_indexes) {
+  web::WebState* web_state = web_state_list->GetWebStateAt(index);
+  WebStateOpener opener = web_state_list->GetOpenerOfWebStateAt(index);
+
+  web::SerializableUserDataManager* user_data_manager =
+      web::SerializableUserDataManager::FromWebState(web_state);
+
+  int opener_index = WebStateList::kInvalidIndex;
+  if (opener.opener) {
+    opener_index = web_state_list->GetIndexOfWebState(opener.opener);
+    DCHECK_NE(opener_index, WebStateList::kInvalidIndex);
+
+    opener_index = removing_indexes.IndexAfterRemoval(opener_index);
+  }
+
+  id<NSCoding> opener_index_value = [NSNull null];
+  id<NSCoding> opener_navigation_index_value = [NSNull null];
+  if (opener_index != WebStateList::kInvalidIndex) {
+    opener_index_value = @(opener_index);
+    opener_navigation_index_value = @(opener.navigation_index);
+  }
+
+  NSObject* old_opener_index_value = base::mac::ObjCCast<NSObject>(
+      user_data_manager->GetValueForSerializationKey(kOpenerIndexKey));
+  NSObject* old_opener_navigation_index_value = base::mac::ObjCCast<NSObject>(
+      user_data_manager->GetValueForSerializationKey(
+          kOpenerNavigationIndexKey));
+  const bool changed =
+      ![old_opener_index_value isEqual:opener_index_value] ||
+      ![old_opener_navigation_index_value
+          isEqual:opener_navigation_index_value];
+
+  user_data_manager->AddSerializableData(opener_index_value, kOpenerIndexKey);
+  user_data_manager->AddSerializableData(opener_navigation_index_value,
+                                         kOpenerNavigationIndexKey);
+  return changed;
+}
+
+// Returns the index of the selected WebState once the ones in
+// |removing_indexes| are dropped, or NSNotFound if there is none.
+NSUInteger SelectedIndexAfterRemoval(
+    WebStateList* web_state_list,
+    WebStateListRemovingIndexes removing_indexes) {
+  WebStateListOrderController order_controller(*web_state_list);
+  const int active_index = order_controller.DetermineNewActiveIndex(
+      web_state_list->active_index(), std::move(removing_indexes));
+
+  return active_index != WebStateList::kInvalidIndex
+             ? static_cast<NSUInteger>(active_index)
+             : static_cast<NSUInteger>(NSNotFound);
+}
 }  // namespace
 
 SessionWindowIOS* SerializeWebStateList(WebStateList* web_state_list,
@@ -82,28 +140,7 @@ SessionWindowIOS* SerializeWebStateList(WebStateList* web_state_list,
     }
 
     web::WebState* web_state = web_state_list->GetWebStateAt(index);
-    WebStateOpener opener = web_state_list->GetOpenerOfWebStateAt(index);
-
-    web::SerializableUserDataManager* user_data_manager =
-        web::SerializableUserDataManager::FromWebState(web_state);
-
-    int opener_index = WebStateList::kInvalidIndex;
-    if (opener.opener) {
-      opener_index = web_state_list->GetIndexOfWebState(opener.opener);
-      DCHECK_NE(opener_index, WebStateList::kInvalidIndex);
-
-      opener_index = removing_indexes.IndexAfterRemoval(opener_index);
-    }
-
-    if (opener_index != WebStateList::kInvalidIndex) {
-      user_data_manager->AddSerializableData(@(opener_index), kOpenerIndexKey);
-      user_data_manager->AddSerializableData(@(opener.navigation_index),
-                                             kOpenerNavigationIndexKey);
-    } else {
-      user_data_manager->AddSerializableData([NSNull null], kOpenerIndexKey);
-      user_data_manager->AddSerializableData([NSNull null],
-                                             kOpenerNavigationIndexKey);
-    }
+    UpdateOpenerUserData(web_state_list, index, removing_indexes);
 
     CRWSessionStorage* session_storage = web_state->BuildSessionStorage();
     [serialized_session addObject:session_storage];
@@ -139,13 +176,8 @@ SessionWindowIOS* SerializeWebStateList(WebStateList* web_state_list,
     }
   }
 
-  WebStateListOrderController order_controller(*web_state_list);
-  const int active_index = order_controller.DetermineNewActiveIndex(
-      web_state_list->active_index(), std::move(removing_indexes));
-
-  NSUInteger selectedIndex = active_index != WebStateList::kInvalidIndex
-                                 ? static_cast<NSUInteger>(active_index)
-                                 : static_cast<NSUInteger>(NSNotFound);
+  NSUInteger selectedIndex =
+      SelectedIndexAfterRemoval(web_state_list, std::move(removing_indexes));
 
   return [[SessionWindowIOS alloc]
       initWithSessions:[serialized_session copy]
@@ -158,6 +190,42 @@ SessionWindowIOS* SerializeWebStateList(WebStateList* web_state_list) {
   return SerializeWebStateList(web_state_list, nil);
 }
 
+NSDictionary<NSString*, CRWSessionStorage*>* SerializeWebStateListIncrementally(
+    WebStateList* web_state_list,
+    NSSet<NSString*>* web_states_to_serialize,
+    NSArray<NSString*>** identifiers,
+    NSUInteger* selected_index) {
+  DCHECK(identifiers);
+  DCHECK(selected_index);
+  const WebStateListRemovingIndexes removing_indexes =
+      GetIndexOfWebStatesToDrop(web_state_list);
+
+  NSMutableArray<NSString*>* saved_identifiers = [NSMutableArray
+      arrayWithCapacity:web_state_list->count() - removing_indexes.count()];
+  NSMutableDictionary<NSString*, CRWSessionStorage*>* serialized_sessions =
+      [NSMutableDictionary dictionary];
+  for (int index = 0; index < web_state_list->count(); ++index) {
+    if (removing_indexes.Contains(index))
+      continue;
+
+    web::WebState* web_state = web_state_list->GetWebStateAt(index);
+    NSString* web_state_id = web_state->GetStableIdentifier();
+    [saved_identifiers addObject:web_state_id];
+
+    // The opener is stored as an index in the WebState session storage, so
+    // the storage is stale whenever that index changes.
+    const bool opener_changed =
+        UpdateOpenerUserData(web_state_list, index, removing_indexes);
+    if (opener_changed || [web_states_to_serialize containsObject:web_state_id])
+      serialized_sessions[web_state_id] = web_state->BuildSessionStorage();
+  }
+
+  *identifiers = [saved_identifiers copy];
+  *selected_index =
+      SelectedIndexAfterRemoval(web_state_list, std::move(removing_indexes));
+  return [serialized_sessions copy];
+}
+
 void DeserializeWebStateList(WebStateList* web_state_list,
                              SessionWindowIOS* session_window,
                              const WebStateFactory& web_state_factory) {
@@ -4,10 +4,12 @@
 
 #import "ios/chrome/browser/web_state_list/web_state_list.h"
 
+#include "base/bind.h"
 #include "base/supports_user_data.h"
 #import "ios/chrome/browser/web_state_list/fake_web_state_list_delegate.h"
 #import "ios/chrome/browser/web_state_list/web_state_list_observer.h"
 #import "ios/chrome/browser/web_state_list/web_state_opener.h"
+#import "ios/web/public/test/fakes/fake_navigation_context.h"
 #import "ios/web/public/test/fakes/fake_navigation_manager.h"
 #import "ios/web/public/test/fakes/fake_web_state.h"
 #include "testing/gtest/include/gtest/gtest.h"
@@ -42,6 +44,8 @@ class WebStateListTestObserver : public WebStateListObserver {
     web_state_activated_called_ = false;
     batch_operation_started_ = false;
     batch_operation_ended_ = false;
+    web_states_detached_count_ = 0;
+    detached_indices_.clear();
   }
 
   // Returns whether WebStateInsertedAt was invoked.
@@ -56,6 +60,11 @@ class WebStateListTestObserver : public WebStateListObserver {
   // Returns whether WebStateDetachedAt was invoked.
   bool web_state_detached_called() const { return web_state_detached_called_; }
 
+  // Returns the number of times WebStatesDetachedAt was invoked, and the
+  // indices it was last invoked with.
+  int web_states_detached_count() const { return web_states_detached_count_; }
+  const std::vector<int>& detached_indices() const { return detached_indices_; }
+
   // Returns whether WebStateActivatedAt was invoked.
   bool web_state_activated_called() const {
     return web_state_activated_called_;
@@ -98,6 +107,16 @@ class WebStateListTestObserver : public WebStateListObserver {
     web_state_detached_called_ = true;
   }
 
+  void WebStatesDetachedAt(WebStateList* web_state_list,
+                           const std::vector<web::WebState*>& web_states,
+                           const std::vector<int>& indices) override {
+    EXPECT_TRUE(web_state_list->IsMutating());
+    ++web_states_detached_count_;
+    detached_indices_ = indices;
+    WebStateListObserver::WebStatesDetachedAt(web_state_list, web_states,
+                                              indices);
+  }
+
   void WebStateActivatedAt(WebStateList* web_state_list,
                            web::WebState* old_web_state,
                            web::WebState* new_web_state,
@@ -122,6 +141,8 @@ class WebStateListTestObserver : public WebStateListObserver {
   bool web_state_activated_called_ = false;
   bool batch_operation_started_ = false;
   bool batch_operation_ended_ = false;
+  int web_states_detached_count_ = 0;
+  std::vector<int> detached_indices_;
 };
 
 // A fake NavigationManager used to test opener-opened relationship in the
@@ -357,6 +378,97 @@ TEST_F(WebStateListTest, GetIndexOfInactiveWebStateWithURL) {
   EXPECT_EQ(2, web_state_list_.GetIndexOfInactiveWebStateWithURL(GURL(kURL0)));
 }
 
+// Tests that finding a webstate by URL is correct after the list is mutated.
+TEST_F(WebStateListTest, GetIndexOfWebStateWithURLAfterMutations) {
+  AppendNewWebState(kURL0);
+  AppendNewWebState(kURL1);
+  AppendNewWebState(kURL2);
+  AppendNewWebState(kURL1);
+
+  // Moving shifts the indices of the webstates in between.
+  web_state_list_.MoveWebStateAt(0, 3);
+  EXPECT_EQ(0, web_state_list_.GetIndexOfWebStateWithURL(GURL(kURL1)));
+  EXPECT_EQ(1, web_state_list_.GetIndexOfWebStateWithURL(GURL(kURL2)));
+  EXPECT_EQ(3, web_state_list_.GetIndexOfWebStateWithURL(GURL(kURL0)));
+
+  // Replacing updates the URL at the index.
+  web_state_list_.ReplaceWebStateAt(0, CreateWebState(kURL3));
+  EXPECT_EQ(3, web_state_list_.GetIndexOfWebStateWithURL(GURL(kURL0)));
+  EXPECT_EQ(0, web_state_list_.GetIndexOfWebStateWithURL(GURL(kURL3)));
+  EXPECT_EQ(2, web_state_list_.GetIndexOfWebStateWithURL(GURL(kURL1)));
+
+  // Inserting shifts the following indices.
+  web_state_list_.InsertWebState(0, CreateWebState(kURL1),
+                                 WebStateList::INSERT_FORCE_INDEX,
+                                 WebStateOpener());
+  EXPECT_EQ(0, web_state_list_.GetIndexOfWebStateWithURL(GURL(kURL1)));
+  EXPECT_EQ(1, web_state_list_.GetIndexOfWebStateWithURL(GURL(kURL3)));
+  EXPECT_EQ(4, web_state_list_.GetIndexOfWebStateWithURL(GURL(kURL0)));
+
+  // Detaching removes the URL and shifts the following indices.
+  web_state_list_.DetachWebStateAt(0);
+  web_state_list_.DetachWebStateAt(0);
+  EXPECT_EQ(WebStateList::kInvalidIndex,
+            web_state_list_.GetIndexOfWebStateWithURL(GURL(kURL3)));
+  EXPECT_EQ(0, web_state_list_.GetIndexOfWebStateWithURL(GURL(kURL2)));
+  EXPECT_EQ(1, web_state_list_.GetIndexOfWebStateWithURL(GURL(kURL1)));
+  EXPECT_EQ(2, web_state_list_.GetIndexOfWebStateWithURL(GURL(kURL0)));
+
+  web_state_list_.CloseAllWebStates(WebStateList::CLOSE_NO_FLAGS);
+  EXPECT_EQ(WebStateList::kInvalidIndex,
+            web_state_list_.GetIndexOfWebStateWithURL(GURL(kURL0)));
+}
+
+// Tests that finding a webstate by URL follows the changes of visible URL.
+TEST_F(WebStateListTest, GetIndexOfWebStateWithURLAfterNavigation) {
+  AppendNewWebState(kURL0);
+  AppendNewWebState(kURL1);
+  web::FakeWebState* web_state =
+      static_cast<web::FakeWebState*>(web_state_list_.GetWebStateAt(0));
+
+  web_state->SetVisibleURL(GURL(kURL2));
+  web::FakeNavigationContext context;
+  web_state->OnNavigationFinished(&context);
+  EXPECT_EQ(WebStateList::kInvalidIndex,
+            web_state_list_.GetIndexOfWebStateWithURL(GURL(kURL0)));
+  EXPECT_EQ(0, web_state_list_.GetIndexOfWebStateWithURL(GURL(kURL2)));
+
+  // Detached webstates are no longer observed.
+  std::unique_ptr<web::WebState> detached_web_state =
+      web_state_list_.DetachWebStateAt(0);
+  web_state->SetVisibleURL(GURL(kURL1));
+  web_state->OnNavigationFinished(&context);
+  EXPECT_EQ(0, web_state_list_.GetIndexOfWebStateWithURL(GURL(kURL1)));
+  EXPECT_EQ(WebStateList::kInvalidIndex,
+            web_state_list_.GetIndexOfWebStateWithURL(GURL(kURL2)));
+}
+
+// Tests that finding a webstate by URL follows the changes of visible URL
+// which are not notified with a navigation.
+TEST_F(WebStateListTest, GetIndexOfWebStateWithURLWithoutNavigation) {
+  AppendNewWebState(kURL0);
+  AppendNewWebState(kURL1);
+  web::FakeWebState* web_state =
+      static_cast<web::FakeWebState*>(web_state_list_.GetWebStateAt(0));
+
+  // A WebState whose visible URL changed is no longer found under its
+  // previous URL, even before any notification.
+  web_state->SetVisibleURL(GURL(kURL2));
+  EXPECT_EQ(WebStateList::kInvalidIndex,
+            web_state_list_.GetIndexOfWebStateWithURL(GURL(kURL0)));
+
+  // It is found under its new URL after a notification other than a
+  // navigation one.
+  web_state->OnVisibleSecurityStateChanged();
+  EXPECT_EQ(0, web_state_list_.GetIndexOfWebStateWithURL(GURL(kURL2)));
+
+  web_state->SetVisibleURL(GURL(kURL0));
+  web_state->SetLoading(true);
+  EXPECT_EQ(0, web_state_list_.GetIndexOfWebStateWithURL(GURL(kURL0)));
+  EXPECT_EQ(WebStateList::kInvalidIndex,
+            web_state_list_.GetIndexOfWebStateWithURL(GURL(kURL2)));
+}
+
 // Tests that inserted webstates correctly inherit openers.
 TEST_F(WebStateListTest, InsertInheritOpener) {
   AppendNewWebState(kURL0);
@@ -700,7 +812,9 @@ TEST_F(WebStateListTest, CloseAllWebStates) {
 
   EXPECT_EQ(0, web_state_list_.count());
 
+  // The WebStates are detached one at a time, as most observers expect.
   EXPECT_TRUE(observer_.web_state_detached_called());
+  EXPECT_EQ(0, observer_.web_states_detached_count());
   EXPECT_TRUE(observer_.batch_operation_started());
   EXPECT_TRUE(observer_.batch_operation_ended());
 }
@@ -723,6 +837,92 @@ TEST_F(WebStateListTest, CloseWebState) {
   EXPECT_FALSE(observer_.batch_operation_ended());
 }
 
+// Tests closing several webstates at once.
+TEST_F(WebStateListTest, CloseWebStatesAtIndices) {
+  AppendNewWebState(kURL0);
+  AppendNewWebState(kURL1);
+  AppendNewWebState(kURL2);
+  AppendNewWebState(kURL3);
+  AppendNewWebState(kURL1);
+  web_state_list_.ActivateWebStateAt(3);
+
+  observer_.ResetStatistics();
+  web_state_list_.CloseWebStatesAtIndices(WebStateList::CLOSE_USER_ACTION,
+                                          {3, 1, 0});
+
+  EXPECT_EQ(1, observer_.web_states_detached_count());
+  EXPECT_EQ(std::vector<int>({0, 1, 3}), observer_.detached_indices());
+  EXPECT_TRUE(observer_.web_state_detached_called());
+  EXPECT_TRUE(observer_.web_state_activated_called());
+  EXPECT_FALSE(observer_.batch_operation_started());
+
+  ASSERT_EQ(2, web_state_list_.count());
+  EXPECT_EQ(kURL2, web_state_list_.GetWebStateAt(0)->GetVisibleURL().spec());
+  EXPECT_EQ(kURL1, web_state_list_.GetWebStateAt(1)->GetVisibleURL().spec());
+  EXPECT_TRUE(web_state_list_.ContainsIndex(web_state_list_.active_index()));
+
+  // The visible URL index is shifted.
+  EXPECT_EQ(WebStateList::kInvalidIndex,
+            web_state_list_.GetIndexOfWebStateWithURL(GURL(kURL0)));
+  EXPECT_EQ(1, web_state_list_.GetIndexOfWebStateWithURL(GURL(kURL1)));
+  EXPECT_EQ(0, web_state_list_.GetIndexOfWebStateWithURL(GURL(kURL2)));
+  EXPECT_EQ(WebStateList::kInvalidIndex,
+            web_state_list_.GetIndexOfWebStateWithURL(GURL(kURL3)));
+}
+
+// Tests that closing several webstates at once clears the openers referencing
+// them.
+TEST_F(WebStateListTest, CloseWebStatesAtIndicesClearsOpeners) {
+  AppendNewWebState(kURL0);
+  web::WebState* opener = web_state_list_.GetWebStateAt(0);
+  AppendNewWebState(kURL1, WebStateOpener(opener));
+  AppendNewWebState(kURL2, WebStateOpener(opener));
+
+  web_state_list_.CloseWebStatesAtIndices(WebStateList::CLOSE_NO_FLAGS,
+                                          {0, 2});
+
+  ASSERT_EQ(1, web_state_list_.count());
+  EXPECT_EQ(nullptr, web_state_list_.GetOpenerOfWebStateAt(0).opener);
+}
+
+// Tests closing the webstates matching a predicate.
+TEST_F(WebStateListTest, CloseWebStatesMatching) {
+  AppendNewWebState(kURL0);
+  AppendNewWebState(kURL1);
+  AppendNewWebState(kURL0);
+
+  observer_.ResetStatistics();
+  web_state_list_.CloseWebStatesMatching(
+      WebStateList::CLOSE_NO_FLAGS,
+      base::BindRepeating([](const web::WebState* web_state) {
+        return web_state->GetVisibleURL() == GURL(kURL0);
+      }));
+
+  EXPECT_EQ(1, observer_.web_states_detached_count());
+  ASSERT_EQ(1, web_state_list_.count());
+  EXPECT_EQ(kURL1, web_state_list_.GetWebStateAt(0)->GetVisibleURL().spec());
+  EXPECT_EQ(WebStateList::kInvalidIndex,
+            web_state_list_.GetIndexOfWebStateWithURL(GURL(kURL0)));
+}
+
+// Tests detaching several webstates at once.
+TEST_F(WebStateListTest, DetachWebStatesAtIndices) {
+  AppendNewWebState(kURL0);
+  AppendNewWebState(kURL1);
+  AppendNewWebState(kURL2);
+  web::WebState* web_state_0 = web_state_list_.GetWebStateAt(0);
+  web::WebState* web_state_2 = web_state_list_.GetWebStateAt(2);
+
+  std::vector<std::unique_ptr<web::WebState>> detached_web_states =
+      web_state_list_.DetachWebStatesAtIndices({2, 0});
+
+  ASSERT_EQ(2u, detached_web_states.size());
+  EXPECT_EQ(web_state_0, detached_web_states[0].get());
+  EXPECT_EQ(web_state_2, detached_web_states[1].get());
+  ASSERT_EQ(1, web_state_list_.count());
+  EXPECT_EQ(kURL1, web_state_list_.GetWebStateAt(0)->GetVisibleURL().spec());
+}
+
 // Tests that batch operation can be empty.
 TEST_F(WebStateListTest, PerformBatchOperation_EmptyCallback) {
   observer_.ResetStatistics();
@@ -50,13 +50,16 @@ void WebUsageEnablerBrowserAgent::UpdateWebUsageForAllWebStates() {
 void WebUsageEnablerBrowserAgent::UpdateWebUsageForAddedWebState(
     web::WebState* web_state,
     bool triggers_initial_load) {
+  // The WebStates are observed as long as they are in the list, as they may
+  // be unrealized and realized again, which resets their web usage.
+  if (!web_state_observations_.IsObservingSource(web_state))
+    web_state_observations_.AddObservation(web_state);
+
   if (web_state->IsRealized()) {
     web_state->SetWebUsageEnabled(web_usage_enabled_);
     if (web_usage_enabled_ && triggers_initial_load) {
       web_state->GetNavigationManager()->LoadIfNecessary();
     }
-  } else if (!web_state_observations_.IsObservingSource(web_state)) {
-    web_state_observations_.AddObservation(web_state);
   }
 }
 
@@ -98,7 +101,6 @@ void WebUsageEnablerBrowserAgent::WebStateDetachedAt(
 
 void WebUsageEnablerBrowserAgent::WebStateRealized(web::WebState* web_state) {
   UpdateWebUsageForAddedWebState(web_state, /*triggers_initial_load=*/false);
-  web_state_observations_.RemoveObservation(web_state);
 }
 
 void WebUsageEnablerBrowserAgent::WebStateDestroyed(web::WebState* web_state) {
@@ -118,3 +118,23 @@ TEST_F(WebUsageEnablerBrowserAgentTest, DisableInitialLoad) {
       0, CreateWebState(kURL), WebStateList::INSERT_ACTIVATE, WebStateOpener());
   EXPECT_TRUE(InitialLoadTriggeredForLastWebState());
 }
+
+// Tests that the web usage of a WebState is set again each time it is
+// realized after being unrealized, which resets it.
+TEST_F(WebUsageEnablerBrowserAgentTest, UnrealizeAndRealize) {
+  AppendNewWebState(kURL);
+  web::WebState* web_state = web_state_list_->GetWebStateAt(0);
+  ASSERT_FALSE(web_state->IsWebUsageEnabled());
+
+  for (int cycle = 0; cycle < 2; ++cycle) {
+    ASSERT_TRUE(web_state->Unrealize());
+    web_state->ForceRealized();
+    EXPECT_FALSE(web_state->IsWebUsageEnabled());
+  }
+
+  // The current value is used when the WebState is realized.
+  ASSERT_TRUE(web_state->Unrealize());
+  enabler_->SetWebUsageEnabled(true);
+  web_state->ForceRealized();
+  EXPECT_TRUE(web_state->IsWebUsageEnabled());
+}
@@ -18,6 +18,11 @@ extern NSString* const kPendingLogFileSuffix;
 // upload.
 extern NSString* const kPendingLogFileDirectory;
 
+// Name of the PendingLogSegment in |kPendingLogFileDirectory|, in which the
+// extensions append their logs. Logs which don't fit in it are written to
+// files.
+extern NSString* const kPendingLogSegmentFileName;
+
 // An app_group key to the number of times Search Extension was displayed since
 // last Chrome launch.
 extern NSString* const kSearchExtensionDisplayCount;
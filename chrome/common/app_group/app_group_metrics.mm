@@ -16,6 +16,8 @@ NSString* const kPendingLogFileSuffix = @"_PendingLog";
 
 NSString* const kPendingLogFileDirectory = @"ExtensionLogs";
 
+NSString* const kPendingLogSegmentFileName = @"PendingLogs.segment";
+
 NSString* const kSearchExtensionDisplayCount = @"SearchExtensionDisplayCount";
 
 NSString* const kContentExtensionDisplayCount = @"ContentExtensionDisplayCount";
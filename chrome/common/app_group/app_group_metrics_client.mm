@@ -4,8 +4,12 @@
 
 #include "ios/chrome/common/app_group/app_group_metrics_client.h"
 
+#include <memory>
+
+#import "base/mac/foundation_util.h"
 #include "ios/chrome/common/app_group/app_group_constants.h"
 #include "ios/chrome/common/app_group/app_group_metrics.h"
+#include "ios/chrome/common/app_group/app_group_pending_log_segment.h"
 
 #if !defined(__has_feature) || !__has_feature(objc_arc)
 #error "This file requires ARC support."
@@ -35,6 +39,16 @@ void AddPendingLog(NSData* log, AppGroupApplications application) {
                           attributes:nil
                                error:nil];
 
+  // Append the log to the segment if there is room for it, to avoid creating
+  // a file per log.
+  NSURL* segment_url =
+      [log_dir_url URLByAppendingPathComponent:kPendingLogSegmentFileName
+                                   isDirectory:NO];
+  std::unique_ptr<PendingLogSegment> segment = PendingLogSegment::Open(
+      base::mac::NSStringToFilePath([segment_url path]));
+  if (segment && segment->Append(log))
+    return;
+
   // File name are formated using creationtimestamp_extensionname_PendingLog
   // (e.g: 123456789_TodayExtension_PendingLog).
   NSString* file_name = [NSString
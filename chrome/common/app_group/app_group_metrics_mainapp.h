@@ -17,7 +17,8 @@ typedef void (^ProceduralBlockWithData)(NSData*);
 // These methods must be called from the Chrome app.
 namespace main_app {
 
-// Iterates through the extensions pending logs and deletes them.
+// Iterates through the extensions pending logs and deletes them, starting with
+// the ones of the PendingLogSegment then the ones written to files.
 // Calls |callback| on each log before deleting.
 // TODO(crbug.com/782685): remove function.
 void ProcessPendingLogs(ProceduralBlockWithData callback);
@@ -6,10 +6,14 @@
 
 #include <stdint.h>
 
+#include <memory>
+
+#import "base/mac/foundation_util.h"
 #include "base/metrics/histogram_functions.h"
 #include "base/threading/scoped_blocking_call.h"
 #include "ios/chrome/common/app_group/app_group_constants.h"
 #include "ios/chrome/common/app_group/app_group_metrics.h"
+#include "ios/chrome/common/app_group/app_group_pending_log_segment.h"
 
 #if !defined(__has_feature) || !__has_feature(objc_arc)
 #error "This file requires ARC support."
@@ -33,6 +37,23 @@ void ProcessPendingLogs(ProceduralBlockWithData callback) {
       [file_manager contentsOfDirectoryAtPath:[log_dir_url path] error:nil];
   if (!pending_logs)
     return;
+
+  // The segment is only opened if it exists, i.e. if the directory contains
+  // at least its file.
+  if ([pending_logs containsObject:kPendingLogSegmentFileName]) {
+    NSURL* segment_url =
+        [log_dir_url URLByAppendingPathComponent:kPendingLogSegmentFileName
+                                     isDirectory:NO];
+    std::unique_ptr<PendingLogSegment> segment = PendingLogSegment::Open(
+        base::mac::NSStringToFilePath([segment_url path]));
+    if (segment) {
+      segment->Drain(^(NSData* log_content) {
+        if (callback)
+          callback(log_content);
+      });
+    }
+  }
+
   for (NSString* pending_log : pending_logs) {
     if ([pending_log hasSuffix:app_group::kPendingLogFileSuffix]) {
       NSURL* file_url =
@@ -0,0 +1,83 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef IOS_CHROME_COMMON_APP_GROUP_APP_GROUP_PENDING_LOG_SEGMENT_H_
+#define IOS_CHROME_COMMON_APP_GROUP_APP_GROUP_PENDING_LOG_SEGMENT_H_
+
+#import <Foundation/Foundation.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+
+#include "base/files/file.h"
+#include "base/files/memory_mapped_file.h"
+
+namespace base {
+class FilePath;
+}
+
+namespace app_group {
+
+// A memory-mapped file of the app group in which the extensions append their
+// logs and from which the main app drains them, instead of using one file per
+// log.
+//
+// The file starts with a header holding the end offset of the records,
+// followed by the records. Each record is the size of the log and the log,
+// padded to 8 bytes. Appending and draining hold a process-wide lock, then an
+// exclusive flock() lock on the open file description of the segment, which
+// blocks the other processes and the other instances of this process. A
+// writer copies its record past the end offset, then advances it, so a writer
+// killed while appending (which releases the flock() lock) leaves no partial
+// record behind. The reader copies all the records and resets the end offset
+// to the start of the segment in one step; the records are not drained
+// incrementally while the writers append.
+//
+// Several processes may append to and drain the segment concurrently, with
+// any number of instances, used from any thread.
+class PendingLogSegment {
+ public:
+  // Size of the segment file.
+  static const size_t kSegmentSize;
+
+  // Maps the segment at |path|, creating it if needed. Returns null if it
+  // can't be mapped or has an unknown version.
+  static std::unique_ptr<PendingLogSegment> Open(const base::FilePath& path);
+
+  PendingLogSegment(const PendingLogSegment&) = delete;
+  PendingLogSegment& operator=(const PendingLogSegment&) = delete;
+
+  ~PendingLogSegment();
+
+  // Appends |log| to the segment. Returns false if |log| is empty or if the
+  // segment doesn't have room for it.
+  bool Append(NSData* log);
+
+  // Removes the logs from the segment, then calls |callback| on each of them,
+  // in order. Returns the number of logs read.
+  size_t Drain(void (^callback)(NSData*));
+
+ private:
+  struct Header;
+  struct RecordHeader;
+
+  PendingLogSegment(base::File lock_file,
+                    std::unique_ptr<base::MemoryMappedFile> file);
+
+  Header* header() const;
+  RecordHeader* record_at(uint64_t offset) const;
+
+  // Size of the records area.
+  uint64_t capacity() const;
+
+  // Duplicate of the mapped descriptor, on which the flock() lock is taken. It
+  // shares the open file description of |file_|, and thus its lock.
+  base::File lock_file_;
+  std::unique_ptr<base::MemoryMappedFile> file_;
+};
+
+}  // namespace app_group
+
+#endif  // IOS_CHROME_COMMON_APP_GROUP_APP_GROUP_PENDING_LOG_SEGMENT_H_
@@ -0,0 +1,229 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ios/chrome/common/app_group/app_group_pending_log_segment.h"
+
+#include <string.h>
+#include <sys/file.h>
+
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+
+#include "base/check_op.h"
+#include "base/files/file.h"
+#include "base/files/file_path.h"
+#include "base/memory/ptr_util.h"
+#include "base/no_destructor.h"
+#include "base/posix/eintr_wrapper.h"
+#include "base/synchronization/lock.h"
+
+#if !defined(__has_feature) || !__has_feature(objc_arc)
+#error "This file requires ARC support."
+#endif
+
+namespace app_group {
+
+// Header of the segment. A new segment is zero-filled, which is a valid empty
+// header once its version is set. Only accessed with the lock held.
+struct PendingLogSegment::Header {
+  // Version of the format, 0 if the segment was never used.
+  uint32_t version;
+  uint32_t padding;
+  // Offset of the end of the records, in the records area.
+  uint64_t write_offset;
+};
+
+// Header of a record, followed by the log.
+struct PendingLogSegment::RecordHeader {
+  // Size of the log.
+  uint32_t size;
+  uint32_t padding;
+};
+
+namespace {
+
+// Version of the segment format.
+const uint32_t kSegmentVersion = 1;
+
+// Alignment of the records.
+const uint64_t kRecordAlignment = 8;
+
+// Size of the header of a record.
+const uint64_t kRecordHeaderSize = 8;
+
+// Returns the size of the record holding a log of |log_size| bytes.
+uint64_t GetRecordSize(uint64_t log_size) {
+  const uint64_t size = kRecordHeaderSize + log_size;
+  return (size + kRecordAlignment - 1) / kRecordAlignment * kRecordAlignment;
+}
+
+// Returns the lock serializing the accesses of this process to the segments.
+// flock() doesn't exclude the threads using the same open file description.
+base::Lock& GetProcessLock() {
+  static base::NoDestructor<base::Lock> lock;
+  return *lock;
+}
+
+// Holds the process-wide lock, then the exclusive flock() lock of a file,
+// while in scope. Unlike fcntl() locks, flock() locks belong to the open file
+// description: they block until the other descriptions release them, exclude
+// the other descriptions of the same process, and are only released when the
+// last descriptor of the description is closed, e.g. if the process is
+// killed.
+class ScopedFileLock {
+ public:
+  explicit ScopedFileLock(base::File* file)
+      : process_lock_(GetProcessLock()),
+        file_(file),
+        locked_(HANDLE_EINTR(flock(file_->GetPlatformFile(), LOCK_EX)) == 0) {
+  }
+
+  ScopedFileLock(const ScopedFileLock&) = delete;
+  ScopedFileLock& operator=(const ScopedFileLock&) = delete;
+
+  ~ScopedFileLock() {
+    if (locked_)
+      flock(file_->GetPlatformFile(), LOCK_UN);
+  }
+
+  bool locked() const { return locked_; }
+
+ private:
+  base::AutoLock process_lock_;
+  base::File* file_;
+  const bool locked_;
+};
+
+}  // namespace
+
+const size_t PendingLogSegment::kSegmentSize = 1024 * 1024;
+
+// static
+std::unique_ptr<PendingLogSegment> PendingLogSegment::Open(
+    const base::FilePath& path) {
+  base::File file(path, base::File::FLAG_OPEN_ALWAYS | base::File::FLAG_READ |
+                            base::File::FLAG_WRITE);
+  if (!file.IsValid())
+    return nullptr;
+
+  // The lock is taken on a duplicate of the mapped descriptor, as the mapped
+  // file keeps its descriptor. Both share the same open file description. The
+  // lock also serializes the processes creating the segment, as extending a
+  // new file writes to it.
+  base::File lock_file = file.Duplicate();
+  if (!lock_file.IsValid())
+    return nullptr;
+
+  auto mapped_file = std::make_unique<base::MemoryMappedFile>();
+  {
+    ScopedFileLock lock(&lock_file);
+    if (!lock.locked())
+      return nullptr;
+
+    if (!mapped_file->Initialize(std::move(file), {0, kSegmentSize},
+                                 base::MemoryMappedFile::READ_WRITE_EXTEND)) {
+      return nullptr;
+    }
+
+    Header* header = reinterpret_cast<Header*>(mapped_file->data());
+    if (!header->version)
+      header->version = kSegmentVersion;
+    if (header->version != kSegmentVersion)
+      return nullptr;
+  }
+
+  return base::WrapUnique(
+      new PendingLogSegment(std::move(lock_file), std::move(mapped_file)));
+}
+
+PendingLogSegment::PendingLogSegment(
+    base::File lock_file,
+    std::unique_ptr<base::MemoryMappedFile> file)
+    : lock_file_(std::move(lock_file)), file_(std::move(file)) {
+  static_assert(std::is_standard_layout<Header>::value,
+                "The segment header must have a stable layout.");
+  static_assert(sizeof(Header) % kRecordAlignment == 0 &&
+                    sizeof(RecordHeader) == kRecordHeaderSize &&
+                    kRecordHeaderSize % kRecordAlignment == 0,
+                "Records must be aligned.");
+  DCHECK(lock_file_.IsValid());
+  DCHECK_EQ(kSegmentSize, file_->length());
+}
+
+PendingLogSegment::~PendingLogSegment() = default;
+
+bool PendingLogSegment::Append(NSData* log) {
+  const uint64_t log_size = log.length;
+  const uint64_t record_size = GetRecordSize(log_size);
+  if (!log_size || record_size > capacity())
+    return false;
+
+  ScopedFileLock lock(&lock_file_);
+  if (!lock.locked())
+    return false;
+
+  Header* header = this->header();
+  const uint64_t offset = header->write_offset;
+  if (offset > capacity() || record_size > capacity() - offset)
+    return false;
+
+  // The record is only added to the segment once it is written, so that a
+  // writer killed in the meantime leaves no partial record.
+  RecordHeader* record = record_at(offset);
+  record->size = static_cast<uint32_t>(log_size);
+  record->padding = 0;
+  memcpy(record + 1, log.bytes, log_size);
+  header->write_offset = offset + record_size;
+  return true;
+}
+
+size_t PendingLogSegment::Drain(void (^callback)(NSData*)) {
+  DCHECK(callback);
+  NSMutableArray<NSData*>* logs = [NSMutableArray array];
+  {
+    ScopedFileLock lock(&lock_file_);
+    if (!lock.locked())
+      return 0;
+
+    Header* header = this->header();
+    const uint64_t write_offset = std::min(header->write_offset, capacity());
+    uint64_t offset = 0;
+    while (offset < write_offset) {
+      const RecordHeader* record = record_at(offset);
+      const uint64_t record_size = GetRecordSize(record->size);
+      if (!record->size || record_size > write_offset - offset) {
+        // The segment is corrupted, so the next records can't be found.
+        break;
+      }
+      [logs addObject:[NSData dataWithBytes:record + 1 length:record->size]];
+      offset += record_size;
+    }
+    header->write_offset = 0;
+  }
+
+  // The lock is released before calling |callback|, so that the writers are
+  // not blocked while the logs are processed.
+  for (NSData* log in logs)
+    callback(log);
+  return logs.count;
+}
+
+PendingLogSegment::Header* PendingLogSegment::header() const {
+  return reinterpret_cast<Header*>(file_->data());
+}
+
+PendingLogSegment::RecordHeader* PendingLogSegment::record_at(
+    uint64_t offset) const {
+  DCHECK_EQ(0u, offset % kRecordAlignment);
+  DCHECK_LE(offset + sizeof(RecordHeader), capacity());
+  return reinterpret_cast<RecordHeader*>(file_->data() + sizeof(Header) +
+                                         offset);
+}
+
+uint64_t PendingLogSegment::capacity() const {
+  return kSegmentSize - sizeof(Header);
+}
+
+}  // namespace app_group
@@ -0,0 +1,226 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ios/chrome/common/app_group/app_group_pending_log_segment.h"
+
+#include <stdint.h>
+#include <sys/file.h>
+
+#include <vector>
+
+#include "base/bind.h"
+#include "base/containers/span.h"
+#include "base/files/file.h"
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/posix/eintr_wrapper.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/threading/thread.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/gtest_mac.h"
+#include "testing/platform_test.h"
+
+#if !defined(__has_feature) || !__has_feature(objc_arc)
+#error "This file requires ARC support."
+#endif
+
+namespace app_group {
+
+namespace {
+
+// Returns a log of |size| bytes, filled with |value|.
+NSData* CreateLog(size_t size, uint8_t value) {
+  std::vector<uint8_t> bytes(size, value);
+  return [NSData dataWithBytes:bytes.data() length:bytes.size()];
+}
+
+}  // namespace
+
+class PendingLogSegmentTest : public PlatformTest {
+ protected:
+  void SetUp() override {
+    PlatformTest::SetUp();
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    path_ = temp_dir_.GetPath().Append("PendingLogs.segment");
+  }
+
+  // Drains |segment| and returns the logs read.
+  NSArray<NSData*>* Drain(PendingLogSegment* segment) {
+    NSMutableArray<NSData*>* logs = [NSMutableArray array];
+    const size_t count = segment->Drain(^(NSData* log) {
+      [logs addObject:log];
+    });
+    EXPECT_EQ(logs.count, count);
+    return logs;
+  }
+
+  base::ScopedTempDir temp_dir_;
+  base::FilePath path_;
+};
+
+// Tests that the logs appended by a writer are read in order by the reader,
+// and only once.
+TEST_F(PendingLogSegmentTest, AppendAndDrain) {
+  std::unique_ptr<PendingLogSegment> writer = PendingLogSegment::Open(path_);
+  ASSERT_TRUE(writer);
+  int64_t file_size = 0;
+  ASSERT_TRUE(base::GetFileSize(path_, &file_size));
+  EXPECT_EQ(static_cast<int64_t>(PendingLogSegment::kSegmentSize), file_size);
+
+  NSData* log1 = CreateLog(13, 1);
+  NSData* log2 = CreateLog(64, 2);
+  EXPECT_TRUE(writer->Append(log1));
+  EXPECT_TRUE(writer->Append(log2));
+  EXPECT_FALSE(writer->Append([NSData data]));
+
+  std::unique_ptr<PendingLogSegment> reader = PendingLogSegment::Open(path_);
+  ASSERT_TRUE(reader);
+  NSArray<NSData*>* logs = Drain(reader.get());
+  ASSERT_EQ(2u, logs.count);
+  EXPECT_NSEQ(log1, logs[0]);
+  EXPECT_NSEQ(log2, logs[1]);
+  EXPECT_EQ(0u, Drain(reader.get()).count);
+
+  // Logs appended after the segment was rewound are read.
+  NSData* log3 = CreateLog(7, 3);
+  EXPECT_TRUE(writer->Append(log3));
+  logs = Drain(reader.get());
+  ASSERT_EQ(1u, logs.count);
+  EXPECT_NSEQ(log3, logs[0]);
+}
+
+// Tests that logs which don't fit in the segment are rejected, and that the
+// segment can be filled again once drained.
+TEST_F(PendingLogSegmentTest, Full) {
+  std::unique_ptr<PendingLogSegment> segment = PendingLogSegment::Open(path_);
+  ASSERT_TRUE(segment);
+  EXPECT_FALSE(
+      segment->Append(CreateLog(PendingLogSegment::kSegmentSize, 1)));
+
+  const size_t log_size = PendingLogSegment::kSegmentSize / 4;
+  size_t appended_count = 0;
+  while (segment->Append(CreateLog(log_size, 1)))
+    ++appended_count;
+  EXPECT_EQ(3u, appended_count);
+  EXPECT_EQ(appended_count, Drain(segment.get()).count);
+
+  EXPECT_TRUE(segment->Append(CreateLog(log_size, 2)));
+}
+
+// Tests that the data written past the records, e.g. by a writer killed while
+// appending a log, is ignored and then overwritten.
+TEST_F(PendingLogSegmentTest, UncommittedRecord) {
+  std::unique_ptr<PendingLogSegment> writer = PendingLogSegment::Open(path_);
+  ASSERT_TRUE(writer);
+  NSData* log1 = CreateLog(13, 1);
+  EXPECT_TRUE(writer->Append(log1));
+
+  // Fill the second half of the segment, which is past the record of |log1|,
+  // with invalid records.
+  const size_t garbage_size = PendingLogSegment::kSegmentSize / 2;
+  std::vector<uint8_t> garbage(garbage_size, 0xff);
+  base::File file(path_, base::File::FLAG_OPEN | base::File::FLAG_WRITE);
+  ASSERT_TRUE(file.WriteAndCheck(garbage_size, garbage));
+  file.Close();
+
+  std::unique_ptr<PendingLogSegment> reader = PendingLogSegment::Open(path_);
+  ASSERT_TRUE(reader);
+  NSArray<NSData*>* logs = Drain(reader.get());
+  ASSERT_EQ(1u, logs.count);
+  EXPECT_NSEQ(log1, logs[0]);
+
+  // The logs appended next are read.
+  NSData* log2 = CreateLog(garbage_size, 2);
+  EXPECT_TRUE(writer->Append(log2));
+  logs = Drain(reader.get());
+  ASSERT_EQ(1u, logs.count);
+  EXPECT_NSEQ(log2, logs[0]);
+}
+
+// Tests that the lock of the segment is held on its open file description:
+// another description of the file, like the one of another process, excludes
+// the segment until it is closed, e.g. because its process was killed.
+TEST_F(PendingLogSegmentTest, LockOfAnotherDescription) {
+  std::unique_ptr<PendingLogSegment> reader = PendingLogSegment::Open(path_);
+  ASSERT_TRUE(reader);
+  std::unique_ptr<PendingLogSegment> writer = PendingLogSegment::Open(path_);
+  ASSERT_TRUE(writer);
+
+  base::File file(path_, base::File::FLAG_OPEN | base::File::FLAG_READ |
+                             base::File::FLAG_WRITE);
+  ASSERT_TRUE(file.IsValid());
+  ASSERT_EQ(0, HANDLE_EINTR(flock(file.GetPlatformFile(), LOCK_EX)));
+
+  // The segment waits for the lock of |file| to be released.
+  base::WaitableEvent appended;
+  base::Thread writer_thread("Writer");
+  ASSERT_TRUE(writer_thread.Start());
+  NSData* log = CreateLog(7, 1);
+  writer_thread.task_runner()->PostTask(
+      FROM_HERE, base::BindOnce(
+                     [](PendingLogSegment* writer, NSData* log,
+                        base::WaitableEvent* appended) {
+                       EXPECT_TRUE(writer->Append(log));
+                       appended->Signal();
+                     },
+                     writer.get(), log, &appended));
+  EXPECT_FALSE(appended.TimedWait(base::Milliseconds(100)));
+
+  file.Close();
+  appended.Wait();
+  writer_thread.Stop();
+  NSArray<NSData*>* logs = Drain(reader.get());
+  ASSERT_EQ(1u, logs.count);
+  EXPECT_NSEQ(log, logs[0]);
+}
+
+// Tests that instances of the same process appending concurrently, and
+// destroyed meanwhile, don't overwrite each other's records.
+TEST_F(PendingLogSegmentTest, ConcurrentAppends) {
+  const size_t kLogCount = 1000;
+  const size_t kLogSize = 100;
+
+  base::Thread writer_thread("Writer");
+  ASSERT_TRUE(writer_thread.Start());
+  writer_thread.task_runner()->PostTask(
+      FROM_HERE, base::BindOnce(
+                     [](const base::FilePath& path) {
+                       for (size_t i = 0; i < kLogCount; ++i) {
+                         std::unique_ptr<PendingLogSegment> writer =
+                             PendingLogSegment::Open(path);
+                         ASSERT_TRUE(writer);
+                         EXPECT_TRUE(writer->Append(CreateLog(kLogSize, 1)));
+                       }
+                     },
+                     path_));
+  std::unique_ptr<PendingLogSegment> writer = PendingLogSegment::Open(path_);
+  ASSERT_TRUE(writer);
+  for (size_t i = 0; i < kLogCount; ++i)
+    EXPECT_TRUE(writer->Append(CreateLog(kLogSize, 2)));
+  writer_thread.Stop();
+
+  NSArray<NSData*>* logs = Drain(writer.get());
+  ASSERT_EQ(2 * kLogCount, logs.count);
+  size_t first_writer_count = 0;
+  for (NSData* log in logs) {
+    ASSERT_EQ(kLogSize, log.length);
+    const uint8_t value = static_cast<const uint8_t*>(log.bytes)[0];
+    EXPECT_NSEQ(CreateLog(kLogSize, value), log);
+    if (value == 1)
+      ++first_writer_count;
+  }
+  EXPECT_EQ(kLogCount, first_writer_count);
+}
+
+// Tests that a segment with an unknown version is not used.
+TEST_F(PendingLogSegmentTest, UnknownVersion) {
+  const uint32_t kUnknownVersion = 42;
+  ASSERT_TRUE(base::WriteFile(
+      path_, base::as_bytes(base::make_span(&kUnknownVersion, 1u))));
+  EXPECT_FALSE(PendingLogSegment::Open(path_));
+}
+
+}  // namespace app_group
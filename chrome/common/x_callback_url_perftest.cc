@@ -0,0 +1,50 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ios/chrome/common/x_callback_url.h"
+
+#include <map>
+#include <string>
+
+#include "base/bind.h"
+#include "ios/testing/perf_test_util.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/platform_test.h"
+
+namespace {
+
+// Number of x-callback-url parsed per measure.
+const size_t kIterations = 10000;
+
+// Parses |url| and expects it to have |parameter_count| parameters.
+void ParseXCallbackURL(const GURL& url, size_t parameter_count) {
+  EXPECT_TRUE(IsXCallbackURL(url));
+  EXPECT_EQ(parameter_count,
+            ExtractQueryParametersFromXCallbackURL(url).size());
+}
+
+using XCallbackURLPerfTest = PlatformTest;
+
+// Measures the parsing of an x-callback-url, as received from another app.
+TEST_F(XCallbackURLPerfTest, Parse) {
+  const std::map<std::string, std::string> parameters = {
+      {"url", "https://www.example.com/path?query=value#ref"},
+      {"text", "Some text with spaces & special characters"},
+      {"source", "OtherApp"},
+  };
+  const GURL url = CreateXCallbackURLWithParameters(
+      "googlechrome", "open", GURL("otherapp://x-callback-url/success"),
+      GURL("otherapp://x-callback-url/error"),
+      GURL("otherapp://x-callback-url/cancel"), parameters);
+
+  // The success, error and cancel URLs are parameters too.
+  testing::ReportPerfResult(
+      "XCallbackURL", "Parse",
+      testing::MeasureMicroseconds(
+          kIterations, base::BindRepeating(&ParseXCallbackURL, url,
+                                           parameters.size() + 3)),
+      "us");
+}
+
+}  // namespace
@@ -4,15 +4,28 @@
 
 #include "ios/net/chunked_data_stream_uploader.h"
 
+#include <string.h>
+
+#include <algorithm>
+#include <utility>
+
+#include "base/bind.h"
 #include "base/check_op.h"
+#include "base/location.h"
+#include "base/threading/sequenced_task_runner_handle.h"
 #include "net/base/io_buffer.h"
 #include "net/base/net_errors.h"
 
 namespace net {
 
 ChunkedDataStreamUploader::ChunkedDataStreamUploader(Delegate* delegate)
+    : ChunkedDataStreamUploader(delegate, 0) {}
+
+ChunkedDataStreamUploader::ChunkedDataStreamUploader(Delegate* delegate,
+                                                     int max_read_ahead_bytes)
     : UploadDataStream(true, 0),
       delegate_(delegate),
+      max_read_ahead_bytes_(max_read_ahead_bytes),
       pending_read_buffer_(nullptr),
       pending_read_buffer_length_(0),
       pending_internal_read_(false),
@@ -20,6 +33,7 @@ ChunkedDataStreamUploader::ChunkedDataStreamUploader(Delegate* delegate)
       is_front_of_stream_(true),
       weak_factory_(this) {
   DCHECK(delegate_);
+  DCHECK_GE(max_read_ahead_bytes_, 0);
 }
 
 ChunkedDataStreamUploader::~ChunkedDataStreamUploader() {}
@@ -61,13 +75,59 @@ void ChunkedDataStreamUploader::UploadWhenReady(bool is_final_chunk) {
   }
 }
 
+void ChunkedDataStreamUploader::AppendChunk(scoped_refptr<IOBuffer> chunk,
+                                            int length) {
+  DCHECK(chunk);
+  DCHECK_GT(length, 0);
+  DCHECK(!is_final_chunk_);
+  chunks_.push_back(
+      base::MakeRefCounted<DrainableIOBuffer>(std::move(chunk), length));
+  chunks_size_ += length;
+
+  // Put the data if internal read comes first.
+  if (pending_internal_read_)
+    Upload();
+}
+
+bool ChunkedDataStreamUploader::HasReadAheadCapacity() const {
+  return chunks_size_ < max_read_ahead_bytes_;
+}
+
+bool ChunkedDataStreamUploader::HasPendingRead() const {
+  return pending_internal_read_;
+}
+
+int ChunkedDataStreamUploader::ConsumeChunks(char* buffer, int buffer_length) {
+  int bytes_read = 0;
+  while (!chunks_.empty() && bytes_read < buffer_length) {
+    DrainableIOBuffer* chunk = chunks_.front().get();
+    const int size =
+        std::min(chunk->BytesRemaining(), buffer_length - bytes_read);
+    memcpy(buffer + bytes_read, chunk->data(), size);
+    bytes_read += size;
+    chunk->DidConsume(size);
+    if (!chunk->BytesRemaining())
+      chunks_.pop_front();
+  }
+  chunks_size_ -= bytes_read;
+  return bytes_read;
+}
+
 int ChunkedDataStreamUploader::Upload() {
   DCHECK(pending_read_buffer_);
 
   is_front_of_stream_ = false;
   int bytes_read = 0;
-
-  if (is_final_chunk_) {
+  bool consumed_chunks = false;
+
+  if (!chunks_.empty()) {
+    // The lent chunks are uploaded first, without involving the delegate.
+    bytes_read = ConsumeChunks(pending_read_buffer_->data(),
+                               pending_read_buffer_length_);
+    consumed_chunks = true;
+    if (chunks_.empty() && is_final_chunk_)
+      SetIsFinalChunk();
+  } else if (is_final_chunk_) {
     SetIsFinalChunk();
   } else {
     bytes_read = delegate_->OnRead(pending_read_buffer_->data(),
@@ -86,14 +146,29 @@ int ChunkedDataStreamUploader::Upload() {
 
   pending_read_buffer_ = nullptr;
   pending_read_buffer_length_ = 0;
+  const bool was_pending_internal_read = pending_internal_read_;
+  pending_internal_read_ = false;
+
+  // Let the delegate read ahead more data. It is notified asynchronously as
+  // it may fail the request, which destroys this uploader.
+  if (consumed_chunks && !chunks_consumed_notification_pending_) {
+    chunks_consumed_notification_pending_ = true;
+    base::SequencedTaskRunnerHandle::Get()->PostTask(
+        FROM_HERE,
+        base::BindOnce(&ChunkedDataStreamUploader::NotifyChunksConsumed,
+                       weak_factory_.GetWeakPtr()));
+  }
 
   // When there is a Read() pending, call OnReadCompleted to notify read
   // completed.
-  if (pending_internal_read_) {
-    pending_internal_read_ = false;
+  if (was_pending_internal_read)
     OnReadCompleted(bytes_read);
-  }
   return bytes_read;
 }
 
+void ChunkedDataStreamUploader::NotifyChunksConsumed() {
+  chunks_consumed_notification_pending_ = false;
+  delegate_->OnChunksConsumed();
+}
+
 }  // namespace net
@@ -7,10 +7,13 @@
 
 #include <stdint.h>
 
+#include "base/containers/circular_deque.h"
+#include "base/memory/scoped_refptr.h"
 #include "base/memory/weak_ptr.h"
 #include "net/base/upload_data_stream.h"
 
 namespace net {
+class DrainableIOBuffer;
 class IOBuffer;
 
 // The ChunkedDataStreamUploader is used to support chunked data post for iOS
@@ -30,10 +33,19 @@ class ChunkedDataStreamUploader : public net::UploadDataStream {
     // bytes read. UploadDataStream::Read() currently does not support to return
     // failure, so need to handle the stream errors in the callback.
     virtual int OnRead(char* buffer, int buffer_length) = 0;
+
+    // Called asynchronously when chunks lent with AppendChunk() have been
+    // consumed by the network layer, so that more data can be read ahead. The
+    // uploader may be destroyed from this callback.
+    virtual void OnChunksConsumed() {}
   };
 
   ChunkedDataStreamUploader(Delegate* delegate);
 
+  // Creates an uploader accepting up to |max_read_ahead_bytes| of data lent
+  // with AppendChunk() ahead of the network layer reads.
+  ChunkedDataStreamUploader(Delegate* delegate, int max_read_ahead_bytes);
+
   ChunkedDataStreamUploader(const ChunkedDataStreamUploader&) = delete;
   ChunkedDataStreamUploader& operator=(const ChunkedDataStreamUploader&) =
       delete;
@@ -47,6 +59,24 @@ class ChunkedDataStreamUploader : public net::UploadDataStream {
   // data, the OnRead() callback will be called.
   void UploadWhenReady(bool is_final_chunk);
 
+  // Lends the first |length| bytes of |chunk| to the uploader, which keeps a
+  // reference to it until they are consumed by the network layer instead of
+  // calling Delegate::OnRead(). Chunks are uploaded in the order they are
+  // appended, before the final chunk set by UploadWhenReady(). If a network
+  // layer read is pending, it is completed immediately.
+  void AppendChunk(scoped_refptr<IOBuffer> chunk, int length);
+
+  // Returns whether less than |max_read_ahead_bytes| are waiting to be
+  // consumed, i.e. whether AppendChunk() should be called for the data
+  // available.
+  bool HasReadAheadCapacity() const;
+
+  // Returns whether a network layer read is waiting for data. It should then
+  // be completed with UploadWhenReady(), which lets Delegate::OnRead() write
+  // to the network layer buffer directly, rather than with AppendChunk(),
+  // which copies the chunk to it.
+  bool HasPendingRead() const;
+
   // The uploader interface for iOS layer to use.
   base::WeakPtr<ChunkedDataStreamUploader> GetWeakPtr() {
     return weak_factory_.GetWeakPtr();
@@ -56,6 +86,13 @@ class ChunkedDataStreamUploader : public net::UploadDataStream {
   // Internal function to implement data upload to network layer.
   int Upload();
 
+  // Copies the lent chunks to |buffer|, up to |buffer_length| bytes. Returns
+  // the number of bytes copied.
+  int ConsumeChunks(char* buffer, int buffer_length);
+
+  // Calls Delegate::OnChunksConsumed().
+  void NotifyChunksConsumed();
+
   // net::UploadDataStream implementation:
   int InitInternal(const NetLogWithSource& net_log) override;
   int ReadInternal(IOBuffer* buffer, int buffer_length) override;
@@ -63,6 +100,15 @@ class ChunkedDataStreamUploader : public net::UploadDataStream {
 
   Delegate* const delegate_;
 
+  // The maximum number of bytes lent with AppendChunk() waiting to be
+  // consumed, and the chunks lent.
+  const int max_read_ahead_bytes_;
+  base::circular_deque<scoped_refptr<DrainableIOBuffer>> chunks_;
+  int chunks_size_ = 0;
+
+  // Whether a call to Delegate::OnChunksConsumed() is posted.
+  bool chunks_consumed_notification_pending_ = false;
+
   // The pointer to the network layer buffer to send and the length of the
   // buffer.
   net::IOBuffer* pending_read_buffer_;
@@ -8,6 +8,8 @@
 #include <memory>
 
 #include "base/bind.h"
+#include "base/run_loop.h"
+#include "base/test/task_environment.h"
 #include "net/base/io_buffer.h"
 #include "net/base/net_errors.h"
 #include "testing/gtest/include/gtest/gtest.h"
@@ -23,7 +25,8 @@ const int kDefaultIOBufferSize = 1024;
 class MockChunkedDataStreamUploaderDelegate
     : public ChunkedDataStreamUploader::Delegate {
  public:
-  MockChunkedDataStreamUploaderDelegate() : data_length_(0) {}
+  MockChunkedDataStreamUploaderDelegate()
+      : data_length_(0), chunks_consumed_count_(0) {}
   ~MockChunkedDataStreamUploaderDelegate() override {}
 
   int OnRead(char* buffer, int buffer_length) override {
@@ -37,6 +40,19 @@ class MockChunkedDataStreamUploaderDelegate
     return bytes_read;
   }
 
+  void OnChunksConsumed() override {
+    ++chunks_consumed_count_;
+    if (on_chunks_consumed_)
+      std::move(on_chunks_consumed_).Run();
+  }
+
+  // Sets a closure run by the next OnChunksConsumed() call.
+  void SetOnChunksConsumed(base::OnceClosure closure) {
+    on_chunks_consumed_ = std::move(closure);
+  }
+
+  int chunks_consumed_count() const { return chunks_consumed_count_; }
+
   void SetReadData(const char* data, int data_length) {
     CHECK_GE(sizeof(data_), static_cast<size_t>(data_length));
     memcpy(data_, data, data_length);
@@ -47,6 +63,8 @@ class MockChunkedDataStreamUploaderDelegate
  private:
   char data_[kDefaultIOBufferSize];
   int data_length_;
+  int chunks_consumed_count_;
+  base::OnceClosure on_chunks_consumed_;
 };
 
 class ChunkedDataStreamUploaderTest : public PlatformTest {
@@ -64,6 +82,7 @@ class ChunkedDataStreamUploaderTest : public PlatformTest {
   void CompletionCallback(int result) { ++callback_count; }
 
  protected:
+  base::test::TaskEnvironment task_environment_;
   std::unique_ptr<MockChunkedDataStreamUploaderDelegate> delegate_;
 
   std::unique_ptr<ChunkedDataStreamUploader> uploader_owner_;
@@ -228,4 +247,127 @@ TEST_F(ChunkedDataStreamUploaderTest, MixedScenarioTest) {
   EXPECT_EQ(2, callback_count);
 }
 
+// Tests that lent chunks are read ahead of the network layer, up to the
+// read-ahead capacity, and are uploaded before the final chunk.
+TEST_F(ChunkedDataStreamUploaderTest, LentChunksReadAhead) {
+  const char kTestData[] = "Hello world!";
+  ChunkedDataStreamUploader uploader(delegate_.get(), 8);
+  uploader.Init(base::BindRepeating([](int) {}), net::NetLogWithSource());
+  EXPECT_TRUE(uploader.HasReadAheadCapacity());
+
+  uploader.AppendChunk(base::MakeRefCounted<net::StringIOBuffer>("Hello "), 6);
+  EXPECT_TRUE(uploader.HasReadAheadCapacity());
+  uploader.AppendChunk(base::MakeRefCounted<net::StringIOBuffer>("world!"), 6);
+  EXPECT_FALSE(uploader.HasReadAheadCapacity());
+  uploader.UploadWhenReady(true);
+
+  // The first read spans both chunks.
+  auto buffer = base::MakeRefCounted<net::IOBuffer>(kDefaultIOBufferSize);
+  int bytes_read = uploader.Read(
+      buffer.get(), 8,
+      base::BindRepeating(&ChunkedDataStreamUploaderTest::CompletionCallback,
+                          base::Unretained(this)));
+  EXPECT_EQ(8, bytes_read);
+  EXPECT_FALSE(memcmp(kTestData, buffer->data(), 8));
+  EXPECT_TRUE(uploader.HasReadAheadCapacity());
+  EXPECT_EQ(0, delegate_->chunks_consumed_count());
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ(1, delegate_->chunks_consumed_count());
+  EXPECT_FALSE(uploader.IsEOF());
+
+  // The remaining data is uploaded with the final chunk.
+  bytes_read = uploader.Read(
+      buffer.get(), kDefaultIOBufferSize,
+      base::BindRepeating(&ChunkedDataStreamUploaderTest::CompletionCallback,
+                          base::Unretained(this)));
+  EXPECT_EQ(4, bytes_read);
+  EXPECT_FALSE(memcmp(kTestData + 8, buffer->data(), 4));
+  EXPECT_TRUE(uploader.IsEOF());
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ(2, delegate_->chunks_consumed_count());
+  EXPECT_EQ(0, callback_count);
+}
+
+// Tests that a lent chunk completes a pending network layer read.
+TEST_F(ChunkedDataStreamUploaderTest, LentChunkCompletesPendingRead) {
+  ChunkedDataStreamUploader uploader(delegate_.get(), kDefaultIOBufferSize);
+  uploader.Init(base::BindRepeating([](int) {}), net::NetLogWithSource());
+
+  auto buffer = base::MakeRefCounted<net::IOBuffer>(kDefaultIOBufferSize);
+  int ret = uploader.Read(
+      buffer.get(), kDefaultIOBufferSize,
+      base::BindRepeating(&ChunkedDataStreamUploaderTest::CompletionCallback,
+                          base::Unretained(this)));
+  EXPECT_EQ(ERR_IO_PENDING, ret);
+
+  const char kTestData[] = "Hello world!";
+  uploader.AppendChunk(base::MakeRefCounted<net::StringIOBuffer>(kTestData),
+                       sizeof(kTestData) - 1);
+  EXPECT_FALSE(memcmp(kTestData, buffer->data(), sizeof(kTestData) - 1));
+  EXPECT_EQ(1, callback_count);
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ(1, delegate_->chunks_consumed_count());
+}
+
+// Tests that a pending network layer read is reported, so that it can be
+// completed by the delegate without lending a chunk.
+TEST_F(ChunkedDataStreamUploaderTest, PendingReadCompletedByDelegate) {
+  ChunkedDataStreamUploader uploader(delegate_.get(), kDefaultIOBufferSize);
+  uploader.Init(base::BindRepeating([](int) {}), net::NetLogWithSource());
+  EXPECT_FALSE(uploader.HasPendingRead());
+
+  auto buffer = base::MakeRefCounted<net::IOBuffer>(kDefaultIOBufferSize);
+  int ret = uploader.Read(
+      buffer.get(), kDefaultIOBufferSize,
+      base::BindRepeating(&ChunkedDataStreamUploaderTest::CompletionCallback,
+                          base::Unretained(this)));
+  EXPECT_EQ(ERR_IO_PENDING, ret);
+  EXPECT_TRUE(uploader.HasPendingRead());
+
+  const char kTestData[] = "Hello world!";
+  delegate_->SetReadData(kTestData, sizeof(kTestData) - 1);
+  uploader.UploadWhenReady(false);
+  EXPECT_FALSE(uploader.HasPendingRead());
+  EXPECT_FALSE(memcmp(kTestData, buffer->data(), sizeof(kTestData) - 1));
+  EXPECT_EQ(1, callback_count);
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ(0, delegate_->chunks_consumed_count());
+}
+
+// Tests that the delegate can destroy the uploader when it fails to read
+// ahead more data, as the protocol handler does on a stream read error.
+TEST_F(ChunkedDataStreamUploaderTest, ReadAheadFailureDestroysUploader) {
+  auto uploader = std::make_unique<ChunkedDataStreamUploader>(
+      delegate_.get(), kDefaultIOBufferSize);
+  uploader->Init(base::BindRepeating([](int) {}), net::NetLogWithSource());
+  base::WeakPtr<ChunkedDataStreamUploader> weak_uploader =
+      uploader->GetWeakPtr();
+
+  auto buffer = base::MakeRefCounted<net::IOBuffer>(kDefaultIOBufferSize);
+  int ret = uploader->Read(
+      buffer.get(), kDefaultIOBufferSize,
+      base::BindRepeating(&ChunkedDataStreamUploaderTest::CompletionCallback,
+                          base::Unretained(this)));
+  EXPECT_EQ(ERR_IO_PENDING, ret);
+
+  // The read ahead after the chunk is consumed fails the request.
+  delegate_->SetOnChunksConsumed(base::BindOnce(
+      [](std::unique_ptr<ChunkedDataStreamUploader> uploader) {},
+      std::move(uploader)));
+  const char kTestData[] = "Hello world!";
+  weak_uploader->AppendChunk(
+      base::MakeRefCounted<net::StringIOBuffer>(kTestData),
+      sizeof(kTestData) - 1);
+
+  // The pending read is completed before the delegate is notified.
+  EXPECT_EQ(1, callback_count);
+  EXPECT_FALSE(memcmp(kTestData, buffer->data(), sizeof(kTestData) - 1));
+  EXPECT_TRUE(weak_uploader);
+  EXPECT_EQ(0, delegate_->chunks_consumed_count());
+
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ(1, delegate_->chunks_consumed_count());
+  EXPECT_FALSE(weak_uploader);
+}
+
 }  // namespace net
@@ -6,10 +6,32 @@
 
 #include <algorithm>
 
+#include "base/hash/hash.h"
 #include "net/cookies/cookie_options.h"
 
 namespace net {
 
+CookieCache::CachedCookie::CachedCookie(const net::CanonicalCookie& cookie)
+    : identity_hash(IdentityHash(cookie)),
+      fingerprint(Fingerprint(cookie)),
+      cookie(cookie) {}
+
+CookieCache::CachedCookie::CachedCookie(const CachedCookie& other) = default;
+
+CookieCache::CachedCookie& CookieCache::CachedCookie::operator=(
+    const CachedCookie& other) = default;
+
+CookieCache::CachedCookie::~CachedCookie() = default;
+
+CookieCache::Entry::Entry(const GURL& url, const std::string& name)
+    : url(url), name(name) {}
+
+CookieCache::Entry::Entry(Entry&& other) = default;
+
+CookieCache::Entry& CookieCache::Entry::operator=(Entry&& other) = default;
+
+CookieCache::Entry::~Entry() = default;
+
 CookieCache::CookieCache() {
 }
 
@@ -21,61 +43,160 @@ bool CookieCache::Update(const GURL& url,
                          const std::vector<net::CanonicalCookie>& new_cookies,
                          std::vector<net::CanonicalCookie>* out_removed_cookies,
                          std::vector<net::CanonicalCookie>* out_added_cookies) {
-  CookieKey key(url, name);
-  CookieSet old_set = cache_[key];
-  CookieSet new_set(new_cookies.begin(), new_cookies.end());
-
-  // Compute the changes and the removals.
-  CookieSet added_cookies;
-  CookieSet removed_cookies;
-  std::set_difference(new_set.begin(), new_set.end(), old_set.begin(),
-                      old_set.end(),
-                      std::inserter(added_cookies, added_cookies.begin()),
-                      CookieCache::CookieAndValueComparator());
-  std::set_difference(old_set.begin(), old_set.end(), new_set.begin(),
-                      new_set.end(),
-                      std::inserter(removed_cookies, removed_cookies.begin()),
-                      CookieCache::CookieAndValueComparator());
-
-  if (added_cookies.empty() && removed_cookies.empty())
+  const size_t key_hash =
+      base::HashInts(base::FastHash(url.spec()), base::FastHash(name));
+  Entry* entry = FindEntry(key_hash, url, name);
+
+  // Fast path: nothing changed, which is by far the most common case when
+  // cookie change notifications are fanned out to every subscription.
+  if (entry ? IsUnchanged(entry, new_cookies) : new_cookies.empty())
+    return false;
+
+  // Deduplicate |new_cookies| by (domain, path, name), keeping the first
+  // occurrence.
+  std::vector<CachedCookie> new_set;
+  new_set.reserve(new_cookies.size());
+  for (const net::CanonicalCookie& cookie : new_cookies) {
+    CachedCookie cached_cookie(cookie);
+    bool duplicate = std::any_of(
+        new_set.begin(), new_set.end(), [&](const CachedCookie& other) {
+          return other.identity_hash == cached_cookie.identity_hash &&
+                 HaveSameIdentity(other.cookie, cookie);
+        });
+    if (!duplicate)
+      new_set.push_back(std::move(cached_cookie));
+  }
+
+  // Compute the changes and the removals. They are reported sorted by
+  // (domain, path, name), like the cached sets used to be, so only the cookies
+  // appended by this call are sorted.
+  const size_t removed_offset =
+      out_removed_cookies ? out_removed_cookies->size() : 0;
+  const size_t added_offset = out_added_cookies ? out_added_cookies->size() : 0;
+  bool changes = false;
+  for (const CachedCookie& cached_cookie : new_set) {
+    if (entry && FindCookieAndValue(entry->cookies, cached_cookie.cookie,
+                                    cached_cookie.fingerprint) !=
+                     entry->cookies.size()) {
+      continue;
+    }
+    changes = true;
+    if (out_added_cookies)
+      out_added_cookies->push_back(cached_cookie.cookie);
+  }
+  std::sort(new_set.begin(), new_set.end(),
+            [](const CachedCookie& lhs, const CachedCookie& rhs) {
+              return lhs.fingerprint < rhs.fingerprint;
+            });
+  if (entry) {
+    for (const CachedCookie& cached_cookie : entry->cookies) {
+      if (FindCookieAndValue(new_set, cached_cookie.cookie,
+                             cached_cookie.fingerprint) != new_set.size()) {
+        continue;
+      }
+      changes = true;
+      if (out_removed_cookies)
+        out_removed_cookies->push_back(cached_cookie.cookie);
+    }
+  }
+
+  if (!changes)
     return false;
 
-  cache_[key] = new_set;
   if (out_removed_cookies) {
-    out_removed_cookies->insert(out_removed_cookies->end(),
-                                removed_cookies.begin(), removed_cookies.end());
+    std::sort(out_removed_cookies->begin() + removed_offset,
+              out_removed_cookies->end(), &IdentityLessThan);
   }
   if (out_added_cookies) {
-    out_added_cookies->insert(out_added_cookies->end(), added_cookies.begin(),
-                              added_cookies.end());
+    std::sort(out_added_cookies->begin() + added_offset,
+              out_added_cookies->end(), &IdentityLessThan);
   }
+
+  if (!entry)
+    entry = &cache_.emplace(key_hash, Entry(url, name))->second;
+  entry->cookies = std::move(new_set);
   return true;
 }
 
-bool CookieCache::CookieComparator::operator()(
-    const net::CanonicalCookie& lhs,
-    const net::CanonicalCookie& rhs) const {
-  if (lhs.Domain() != rhs.Domain())
-    return lhs.Domain() < rhs.Domain();
-  if (lhs.Path() != rhs.Path())
-    return lhs.Path() < rhs.Path();
-  if (lhs.Name() != rhs.Name())
-    return lhs.Name() < rhs.Name();
-  return false;
+// static
+size_t CookieCache::IdentityHash(const net::CanonicalCookie& cookie) {
+  return base::HashInts(
+      base::HashInts(base::FastHash(cookie.Domain()),
+                     base::FastHash(cookie.Path())),
+      base::FastHash(cookie.Name()));
+}
+
+// static
+size_t CookieCache::Fingerprint(const net::CanonicalCookie& cookie) {
+  return base::HashInts(IdentityHash(cookie), base::FastHash(cookie.Value()));
 }
 
-bool CookieCache::CookieAndValueComparator::operator()(
-    const net::CanonicalCookie& lhs,
-    const net::CanonicalCookie& rhs) const {
+// static
+bool CookieCache::IdentityLessThan(const net::CanonicalCookie& lhs,
+                                   const net::CanonicalCookie& rhs) {
   if (lhs.Domain() != rhs.Domain())
     return lhs.Domain() < rhs.Domain();
   if (lhs.Path() != rhs.Path())
     return lhs.Path() < rhs.Path();
-  if (lhs.Name() != rhs.Name())
-    return lhs.Name() < rhs.Name();
-  if (lhs.Value() != rhs.Value())
-    return lhs.Value() < rhs.Value();
-  return false;
+  return lhs.Name() < rhs.Name();
+}
+
+// static
+bool CookieCache::HaveSameIdentity(const net::CanonicalCookie& lhs,
+                                   const net::CanonicalCookie& rhs) {
+  return lhs.Domain() == rhs.Domain() && lhs.Path() == rhs.Path() &&
+         lhs.Name() == rhs.Name();
+}
+
+// static
+size_t CookieCache::FindCookieAndValue(const std::vector<CachedCookie>& cookies,
+                                       const net::CanonicalCookie& cookie,
+                                       size_t fingerprint) {
+  auto it = std::lower_bound(
+      cookies.begin(), cookies.end(), fingerprint,
+      [](const CachedCookie& cached_cookie, size_t value) {
+        return cached_cookie.fingerprint < value;
+      });
+  for (; it != cookies.end() && it->fingerprint == fingerprint; ++it) {
+    if (HaveSameIdentity(it->cookie, cookie) &&
+        it->cookie.Value() == cookie.Value()) {
+      return it - cookies.begin();
+    }
+  }
+  return cookies.size();
+}
+
+bool CookieCache::IsUnchanged(
+    Entry* entry,
+    const std::vector<net::CanonicalCookie>& new_cookies) {
+  if (entry->cookies.size() != new_cookies.size())
+    return false;
+  // The sets are equal if each cookie of |new_cookies| matches a distinct
+  // cached cookie. The matched cookies are marked with the generation of this
+  // call, so that duplicates in |new_cookies| are detected without allocating.
+  const uint64_t generation = ++match_generation_;
+  for (const net::CanonicalCookie& cookie : new_cookies) {
+    const size_t index =
+        FindCookieAndValue(entry->cookies, cookie, Fingerprint(cookie));
+    if (index == entry->cookies.size())
+      return false;
+    CachedCookie& cached_cookie = entry->cookies[index];
+    if (cached_cookie.match_generation == generation)
+      return false;
+    cached_cookie.match_generation = generation;
+  }
+  return true;
+}
+
+CookieCache::Entry* CookieCache::FindEntry(size_t key_hash,
+                                           const GURL& url,
+                                           const std::string& name) {
+  auto range = cache_.equal_range(key_hash);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (it->second.name == name && it->second.url == url)
+      return &it->second;
+  }
+  return nullptr;
 }
 
 }  // namespace net
@@ -5,10 +5,12 @@
 #ifndef IOS_NET_COOKIES_COOKIE_CACHE_H_
 #define IOS_NET_COOKIES_COOKIE_CACHE_H_
 
-#include <map>
-#include <set>
+#include <stddef.h>
+#include <stdint.h>
+
 #include <string>
-#include <utility>
+#include <unordered_map>
+#include <vector>
 
 #include "net/cookies/canonical_cookie.h"
 #include "url/gurl.h"
@@ -20,6 +22,13 @@ namespace net {
 // provides one operation, Update(), which updates the set of cookies for a
 // (url, name) pair and returns whether the new set for that (url, name) pair is
 // different from the old set.
+//
+// Entries are looked up by a hash of the (url, name) pair and each cached
+// cookie carries a fingerprint of its (domain, path, name, value) tuple. The
+// cached cookies are sorted by fingerprint, so that an Update() call that does
+// not change the cached set takes O(n log n) and does not allocate any memory.
+// When the set changes, the cached cookies of the entry are replaced by the new
+// set.
 class CookieCache {
  public:
   CookieCache();
@@ -43,6 +52,7 @@ class CookieCache {
   // were removed.
   // |out_changed_cookies|, if not NULL, will be populated with the cookies that
   // were added.
+  // The cookies appended to both vectors are sorted by (domain, path, name).
   bool Update(const GURL& url,
               const std::string& name,
               const std::vector<net::CanonicalCookie>& new_cookies,
@@ -50,28 +60,74 @@ class CookieCache {
               std::vector<net::CanonicalCookie>* out_added_cookies);
 
  private:
-  // Compares two cookies, returning true if |lhs| comes before |rhs| in the
-  // partial ordering defined for CookieSet. This effectively does a
-  // lexicographic comparison of (domain, path, name) tuples for two cookies.
-  struct CookieComparator {
-    bool operator()(const net::CanonicalCookie& lhs,
-                    const net::CanonicalCookie& rhs) const;
+  // A cached cookie along with the hashes used to compare it.
+  struct CachedCookie {
+    explicit CachedCookie(const net::CanonicalCookie& cookie);
+    CachedCookie(const CachedCookie& other);
+    CachedCookie& operator=(const CachedCookie& other);
+    ~CachedCookie();
+
+    // Hash of the (domain, path, name) tuple identifying the cookie.
+    size_t identity_hash;
+    // Hash of the (domain, path, name, value) tuple.
+    size_t fingerprint;
+    // Generation of the last IsUnchanged() call that matched the cookie.
+    uint64_t match_generation = 0;
+    net::CanonicalCookie cookie;
   };
 
-  // Compares two cookies, returning true if |lhs| comes before |rhs| in the
-  // partial ordering defined for CookieSet. This effectively does a
-  // lexicographic comparison of (domain, path, name, value) tuples for two
-  // cookies.
-  struct CookieAndValueComparator {
-    bool operator()(const net::CanonicalCookie& lhs,
-                    const net::CanonicalCookie& rhs) const;
+  // The cookies cached for a (url, name) pair.
+  struct Entry {
+    Entry(const GURL& url, const std::string& name);
+    Entry(Entry&& other);
+    Entry& operator=(Entry&& other);
+    ~Entry();
+
+    GURL url;
+    std::string name;
+    // Unique by (domain, path, name), sorted by fingerprint.
+    std::vector<CachedCookie> cookies;
   };
 
-  typedef std::set<net::CanonicalCookie, CookieComparator> CookieSet;
-  typedef std::pair<GURL, std::string> CookieKey;
-  typedef std::map<CookieKey, CookieSet> CookieKeyPathMap;
+  // Entries keyed by the hash of their (url, name) pair. Colliding pairs share
+  // a bucket and are told apart by comparing |url| and |name|.
+  typedef std::unordered_multimap<size_t, Entry> EntryMap;
+
+  // Returns the hash of the (domain, path, name) tuple of |cookie|.
+  static size_t IdentityHash(const net::CanonicalCookie& cookie);
+
+  // Returns the hash of the (domain, path, name, value) tuple of |cookie|.
+  static size_t Fingerprint(const net::CanonicalCookie& cookie);
+
+  // Returns whether the (domain, path, name) tuple of |lhs| is
+  // lexicographically lower than the one of |rhs|.
+  static bool IdentityLessThan(const net::CanonicalCookie& lhs,
+                               const net::CanonicalCookie& rhs);
+
+  // Returns whether |lhs| and |rhs| have the same (domain, path, name) tuple.
+  static bool HaveSameIdentity(const net::CanonicalCookie& lhs,
+                               const net::CanonicalCookie& rhs);
+
+  // Returns the index in |cookies|, which is sorted by fingerprint, of the
+  // cookie with the same fingerprint and (domain, path, name, value) tuple as
+  // |cookie|, or |cookies.size()| if there is none. Does not allocate.
+  static size_t FindCookieAndValue(const std::vector<CachedCookie>& cookies,
+                                   const net::CanonicalCookie& cookie,
+                                   size_t fingerprint);
+
+  // Returns whether |entry| holds exactly the cookies of |new_cookies|. May
+  // return false for some unchanged sets (e.g. when |new_cookies| contains
+  // duplicates), but never returns true for a changed set. Does not allocate.
+  bool IsUnchanged(Entry* entry,
+                   const std::vector<net::CanonicalCookie>& new_cookies);
+
+  // Returns the entry for (url, name), or null if there is none.
+  Entry* FindEntry(size_t key_hash, const GURL& url, const std::string& name);
+
+  EntryMap cache_;
 
-  CookieKeyPathMap cache_;
+  // Generation of the last IsUnchanged() call.
+  uint64_t match_generation_ = 0;
 };
 
 }  // namespace net
@@ -0,0 +1,126 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ios/net/cookies/cookie_cache.h"
+
+#include <string>
+#include <vector>
+
+#include "base/strings/string_number_conversions.h"
+#include "base/time/time.h"
+#include "ios/testing/perf_test_util.h"
+#include "net/cookies/canonical_cookie.h"
+#include "net/cookies/cookie_constants.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/platform_test.h"
+
+namespace net {
+
+namespace {
+
+// Number of (url, name) subscriptions in the cache.
+const size_t kSubscriptionCount = 300;
+// Number of times every subscription is updated.
+const size_t kUpdateRounds = 100;
+
+CanonicalCookie MakeCookie(const GURL& url,
+                           const std::string& name,
+                           const std::string& value) {
+  return *CanonicalCookie::CreateUnsafeCookieForTesting(
+      name, value, url.host(), url.path(), base::Time(), base::Time(),
+      base::Time(), base::Time(), false, false,
+      net::CookieSameSite::NO_RESTRICTION, net::COOKIE_PRIORITY_DEFAULT, false);
+}
+
+}  // namespace
+
+// Measures the cost of updating every subscription of a CookieCache, the way
+// CookieStoreIOS does on each system cookie change notification.
+class CookieCachePerfTest : public PlatformTest {
+ protected:
+  CookieCachePerfTest() {
+    for (size_t i = 0; i < kSubscriptionCount; ++i) {
+      GURL url("https://www" + base::NumberToString(i) + ".example.com/path");
+      std::string name = "cookie" + base::NumberToString(i % 10);
+      urls_.push_back(url);
+      names_.push_back(name);
+      cookies_.push_back({MakeCookie(url, name, "value"),
+                          MakeCookie(GURL("https://example.com/"), name, "v")});
+    }
+  }
+
+  // Updates every subscription |kUpdateRounds| times, changing the value of a
+  // cookie on each round if |change_values| is true, and reports the duration
+  // of an update and the number of blocks it leaves allocated for |story|.
+  void RunUpdates(CookieCache* cache,
+                  bool change_values,
+                  const std::string& story) {
+    // The cookies of every round are created beforehand, so that only the
+    // updates are measured.
+    std::vector<std::vector<std::vector<CanonicalCookie>>> rounds(
+        kUpdateRounds, cookies_);
+    if (change_values) {
+      for (size_t round = 0; round < kUpdateRounds; ++round) {
+        for (size_t i = 0; i < kSubscriptionCount; ++i) {
+          rounds[round][i][0] = MakeCookie(
+              urls_[i], names_[i], "value" + base::NumberToString(round));
+        }
+      }
+    }
+
+    size_t changes = 0;
+    const size_t block_count = testing::GetAllocatedBlockCount();
+    const base::TimeTicks start = base::TimeTicks::Now();
+    for (size_t round = 0; round < kUpdateRounds; ++round) {
+      for (size_t i = 0; i < kSubscriptionCount; ++i) {
+        if (cache->Update(urls_[i], names_[i], rounds[round][i], nullptr,
+                          nullptr)) {
+          ++changes;
+        }
+      }
+    }
+    const base::TimeDelta elapsed = base::TimeTicks::Now() - start;
+    const size_t allocated_blocks =
+        testing::GetAllocatedBlockCount() - block_count;
+    EXPECT_EQ(change_values ? kUpdateRounds * kSubscriptionCount : 0U, changes);
+    if (!change_values)
+      EXPECT_EQ(0u, allocated_blocks);
+
+    const size_t update_count = kUpdateRounds * kSubscriptionCount;
+    testing::ReportPerfResult("CookieCache", story,
+                              elapsed.InMicrosecondsF() / update_count, "us");
+    testing::ReportPerfResult(
+        "CookieCache", story + " allocations",
+        static_cast<double>(allocated_blocks) / update_count, "allocations");
+  }
+
+  std::vector<GURL> urls_;
+  std::vector<std::string> names_;
+  std::vector<std::vector<CanonicalCookie>> cookies_;
+};
+
+// Measures updates that don't change the cached cookies. These don't allocate,
+// so they leave no block allocated.
+TEST_F(CookieCachePerfTest, UnchangedUpdates) {
+  CookieCache cache;
+  for (size_t i = 0; i < kSubscriptionCount; ++i) {
+    EXPECT_TRUE(
+        cache.Update(urls_[i], names_[i], cookies_[i], nullptr, nullptr));
+  }
+
+  RunUpdates(&cache, /*change_values=*/false, "Update unchanged");
+}
+
+// Measures updates that change the value of one cookie per subscription.
+TEST_F(CookieCachePerfTest, ChangedUpdates) {
+  CookieCache cache;
+  for (size_t i = 0; i < kSubscriptionCount; ++i) {
+    EXPECT_TRUE(
+        cache.Update(urls_[i], names_[i], cookies_[i], nullptr, nullptr));
+  }
+
+  RunUpdates(&cache, /*change_values=*/true, "Update changed");
+}
+
+}  // namespace net
@@ -4,6 +4,8 @@
 
 #include "ios/net/cookies/cookie_cache.h"
 
+#include <utility>
+
 #include "net/cookies/canonical_cookie.h"
 #include "net/cookies/cookie_constants.h"
 #include "testing/gtest/include/gtest/gtest.h"
@@ -169,4 +171,87 @@ TEST_F(CookieCacheTest, MultipleNames) {
   EXPECT_FALSE(cache.Update(cookieurl, "abc", cookies, nullptr, nullptr));
 }
 
+TEST_F(CookieCacheTest, UpdateWithDuplicates) {
+  CookieCache cache;
+  const GURL test_url("http://www.google.com");
+  std::vector<CanonicalCookie> cookies;
+  cookies.push_back(MakeCookie(test_url, "abc", "def"));
+  cookies.push_back(MakeCookie(test_url, "abc", "ghi"));
+  std::vector<net::CanonicalCookie> removed;
+  std::vector<net::CanonicalCookie> changed;
+
+  // Only the first of the duplicated cookies is kept.
+  EXPECT_TRUE(cache.Update(test_url, "abc", cookies, &removed, &changed));
+  EXPECT_TRUE(removed.empty());
+  ASSERT_EQ(1U, changed.size());
+  EXPECT_EQ("def", changed[0].Value());
+
+  EXPECT_FALSE(cache.Update(test_url, "abc", cookies, nullptr, nullptr));
+  cookies.pop_back();
+  EXPECT_FALSE(cache.Update(test_url, "abc", cookies, nullptr, nullptr));
+}
+
+// Tests that the order of the cookies doesn't matter, and that duplicates
+// hiding a removed cookie are not taken for an unchanged set.
+TEST_F(CookieCacheTest, UpdateReordered) {
+  CookieCache cache;
+  const GURL test_url("http://www.google.com");
+  const GURL test_url_path("http://www.google.com/foo");
+  std::vector<CanonicalCookie> cookies;
+  cookies.push_back(MakeCookie(test_url, "abc", "def"));
+  cookies.push_back(MakeCookie(test_url_path, "abc", "ghi"));
+  EXPECT_TRUE(cache.Update(test_url, "abc", cookies, nullptr, nullptr));
+
+  std::swap(cookies[0], cookies[1]);
+  EXPECT_FALSE(cache.Update(test_url, "abc", cookies, nullptr, nullptr));
+
+  std::vector<net::CanonicalCookie> removed;
+  std::vector<net::CanonicalCookie> changed;
+  cookies[1] = cookies[0];
+  EXPECT_TRUE(cache.Update(test_url, "abc", cookies, &removed, &changed));
+  ASSERT_EQ(1U, removed.size());
+  EXPECT_EQ("def", removed[0].Value());
+  EXPECT_TRUE(changed.empty());
+}
+
+// Tests that the added and removed cookies are reported sorted by (domain,
+// path, name), whatever the order of the cookies passed to Update().
+TEST_F(CookieCacheTest, UpdateReportsSortedCookies) {
+  CookieCache cache;
+  const GURL test_url("http://www.google.com");
+  const GURL test_url_path("http://www.google.com/foo");
+  const GURL test_url_path_long("http://www.google.com/foo/bar");
+  std::vector<CanonicalCookie> cookies;
+  cookies.push_back(MakeCookie(test_url_path_long, "abc", "def"));
+  cookies.push_back(MakeCookie(test_url, "abc", "def"));
+  cookies.push_back(MakeCookie(test_url_path, "abc", "def"));
+  std::vector<net::CanonicalCookie> removed;
+  std::vector<net::CanonicalCookie> changed;
+
+  EXPECT_TRUE(cache.Update(test_url, "abc", cookies, &removed, &changed));
+  EXPECT_TRUE(removed.empty());
+  ASSERT_EQ(3U, changed.size());
+  EXPECT_EQ("/", changed[0].Path());
+  EXPECT_EQ("/foo", changed[1].Path());
+  EXPECT_EQ("/foo/bar", changed[2].Path());
+  changed.clear();
+
+  cookies.clear();
+  EXPECT_TRUE(cache.Update(test_url, "abc", cookies, &removed, &changed));
+  EXPECT_TRUE(changed.empty());
+  ASSERT_EQ(3U, removed.size());
+  EXPECT_EQ("/", removed[0].Path());
+  EXPECT_EQ("/foo", removed[1].Path());
+  EXPECT_EQ("/foo/bar", removed[2].Path());
+}
+
+TEST_F(CookieCacheTest, UpdateEmptyDoesNotChange) {
+  CookieCache cache;
+  const GURL test_url("http://www.google.com");
+  std::vector<CanonicalCookie> cookies;
+  EXPECT_FALSE(cache.Update(test_url, "abc", cookies, nullptr, nullptr));
+  cookies.push_back(MakeCookie(test_url, "abc", "def"));
+  EXPECT_TRUE(cache.Update(test_url, "abc", cookies, nullptr, nullptr));
+}
+
 }  // namespace net
@@ -14,8 +14,14 @@
 #include "net/http/http_response_info.h"
 
 namespace net {
+class ReadBufferPool;
 class URLRequestContextGetter;
 
+// Returns the pool of the buffers used to read the responses of the requests
+// handled by CRNHTTPProtocolHandler. Its stats report the pool hit rate and
+// the peak memory retained by the pool.
+ReadBufferPool* GetHTTPProtocolHandlerReadBufferPool();
+
 class HTTPProtocolHandlerDelegate {
  public:
   // Sets the global instance of the HTTPProtocolHandlerDelegate.
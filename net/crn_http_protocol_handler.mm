@@ -15,7 +15,9 @@
 #include "base/command_line.h"
 #include "base/logging.h"
 #include "base/mac/foundation_util.h"
+#include "base/memory/memory_pressure_listener.h"
 #include "base/memory/ref_counted.h"
+#include "base/no_destructor.h"
 #include "base/strings/string_util.h"
 #include "base/strings/sys_string_conversions.h"
 #include "base/strings/utf_string_conversions.h"
@@ -26,6 +28,7 @@
 #import "ios/net/http_protocol_logging.h"
 #include "ios/net/nsurlrequest_util.h"
 #import "ios/net/protocol_handler_util.h"
+#include "ios/net/read_buffer_pool.h"
 #include "net/base/auth.h"
 #include "net/base/elements_upload_data_stream.h"
 #include "net/base/io_buffer.h"
@@ -55,14 +58,57 @@ const int kIOBufferMinSize = 64 * 1024;
 // Maximum size of the buffer used to read the net::URLRequest.
 const int kIOBufferMaxSize = 16 * kIOBufferMinSize;  // 1MB
 
+// Maximum number of free read buffers retained by the pool for each size.
+const size_t kMaxPooledBuffersPerSize = 2;
+
+// Maximum number of chunks of the HTTPBodyStream read ahead of the network
+// layer for chunked uploads.
+const int kMaxUploadReadAheadChunks = 4;
+
 // Global instance of the HTTPProtocolHandlerDelegate.
 net::HTTPProtocolHandlerDelegate* g_protocol_handler_delegate = nullptr;
 
 // Global instance of the MetricsDelegate.
 net::MetricsDelegate* g_metrics_delegate = nullptr;
 
+// IOBuffer over a buffer of the read buffer pool, returned to the pool when
+// the IOBuffer is destroyed.
+class PooledIOBuffer : public net::WrappedIOBuffer {
+ public:
+  explicit PooledIOBuffer(int size)
+      : net::WrappedIOBuffer(
+            net::GetHTTPProtocolHandlerReadBufferPool()->Acquire(size)),
+        size_(size) {}
+
+  PooledIOBuffer(const PooledIOBuffer&) = delete;
+  PooledIOBuffer& operator=(const PooledIOBuffer&) = delete;
+
+ private:
+  ~PooledIOBuffer() override {
+    net::GetHTTPProtocolHandlerReadBufferPool()->Release(data_, size_);
+  }
+
+  const int size_;
+};
+
+// Purges the read buffer pool on critical memory pressure.
+void OnMemoryPressure(base::MemoryPressureListener::MemoryPressureLevel level) {
+  if (level == base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL)
+    net::GetHTTPProtocolHandlerReadBufferPool()->Purge();
+}
+
 }  // namespace
 
+namespace net {
+
+ReadBufferPool* GetHTTPProtocolHandlerReadBufferPool() {
+  static base::NoDestructor<ReadBufferPool> pool(
+      kIOBufferMinSize, kIOBufferMaxSize, kMaxPooledBuffersPerSize);
+  return pool.get();
+}
+
+}  // namespace net
+
 // Bridge class to forward NSStream events to the HttpProtocolHandlerCore.
 // Lives on the IO thread.
 @interface CRWHTTPStreamDelegate : NSObject<NSStreamDelegate> {
@@ -174,8 +220,9 @@ class HttpProtocolHandlerCore
   void OnResponseStarted(URLRequest* request, int net_error) override;
   void OnReadCompleted(URLRequest* request, int bytes_read) override;
 
-  // ChunkedDataStreamUploader::Delegate method:
+  // ChunkedDataStreamUploader::Delegate methods:
   int OnRead(char* buffer, int buffer_length) override;
+  void OnChunksConsumed() override;
 
  private:
   friend class base::RefCountedThreadSafe<HttpProtocolHandlerCore,
@@ -196,12 +243,19 @@ class HttpProtocolHandlerCore
   void CancelAfterSSLError();
   void StartReading();
   void AllocateReadBuffer(int last_read_data_size);
+  // Returns |read_buffer_| to the pool, if any.
+  void ReleaseReadBuffer();
+  // Reads the available data of the HTTPBodyStream into the buffer of the
+  // pending network read of |chunked_uploader_|, if any, and lends the rest
+  // to it up to its read-ahead capacity.
+  void ReadAheadChunks();
 
   base::ThreadChecker thread_checker_;
 
   // The NSURLProtocol client.
   id<CRNNetworkClientProtocol> client_ = nil;
-  std::unique_ptr<char, base::FreeDeleter> read_buffer_;
+  // Buffer acquired from GetHTTPProtocolHandlerReadBufferPool().
+  char* read_buffer_ = nullptr;
   int read_buffer_size_ = kIOBufferMinSize;
   scoped_refptr<WrappedIOBuffer> read_buffer_wrapper_;
   NSMutableURLRequest* request_ = nil;
@@ -273,7 +327,7 @@ void HttpProtocolHandlerCore::HandleStreamEvent(NSStream* stream,
       break;
     case NSStreamEventHasBytesAvailable: {
       if (chunked_uploader_) {
-        chunked_uploader_->UploadWhenReady(false);
+        ReadAheadChunks();
         break;
       }
 
@@ -282,11 +336,10 @@ void HttpProtocolHandlerCore::HandleStreamEvent(NSStream* stream,
       // to improve the read (POST) performance, see AllocateReadBuffer(), &
       // avoid unnecessary data copy.
       length = [base::mac::ObjCCastStrict<NSInputStream>(stream)
-               read:reinterpret_cast<unsigned char*>(read_buffer_.get())
+               read:reinterpret_cast<unsigned char*>(read_buffer_)
           maxLength:read_buffer_size_];
       if (length > 0) {
-        std::vector<char> owned_data(read_buffer_.get(),
-                                     read_buffer_.get() + length);
+        std::vector<char> owned_data(read_buffer_, read_buffer_ + length);
         post_data_readers_.push_back(
             std::make_unique<UploadOwnedBytesElementReader>(&owned_data));
       } else if (length < 0) {  // Error
@@ -478,9 +531,17 @@ void HttpProtocolHandlerCore::OnReadCompleted(URLRequest* request,
 
   // Read data from the socket until no bytes left to read.
   while (bytes_read > 0) {
-    // The NSData will take the ownership of |read_buffer_|.
-    NSData* data =
-        [NSData dataWithBytesNoCopy:read_buffer_.release() length:bytes_read];
+    // The NSData takes the ownership of |read_buffer_| and returns it to the
+    // pool when deallocated, possibly on another thread.
+    const size_t buffer_size = read_buffer_size_;
+    NSData* data = [[NSData alloc]
+        initWithBytesNoCopy:read_buffer_
+                     length:bytes_read
+                deallocator:^(void* bytes, NSUInteger length) {
+                  net::GetHTTPProtocolHandlerReadBufferPool()->Release(
+                      static_cast<char*>(bytes), buffer_size);
+                }];
+    read_buffer_ = nullptr;
     // If the data is not encoded in UTF8, the NSString is nil.
     DVLOG(3) << "To client:" << std::endl
              << base::SysNSStringToUTF8([[NSString alloc]
@@ -506,6 +567,7 @@ void HttpProtocolHandlerCore::OnReadCompleted(URLRequest* request,
 }
 
 void HttpProtocolHandlerCore::AllocateReadBuffer(int last_read_data_size) {
+  ReleaseReadBuffer();
   if (last_read_data_size == read_buffer_size_) {
     // If the whole buffer was filled with data then increase the buffer size
     // for the next read but don't exceed |kIOBufferMaxSize|.
@@ -516,15 +578,25 @@ void HttpProtocolHandlerCore::AllocateReadBuffer(int last_read_data_size) {
     // |kIOBufferMinSize|.
     read_buffer_size_ = std::max(read_buffer_size_ / 2, kIOBufferMinSize);
   }
-  read_buffer_.reset(static_cast<char*>(malloc(read_buffer_size_)));
+  read_buffer_ = GetHTTPProtocolHandlerReadBufferPool()->Acquire(
+      read_buffer_size_);
   read_buffer_wrapper_ = base::MakeRefCounted<WrappedIOBuffer>(
-      static_cast<const char*>(read_buffer_.get()));
+      static_cast<const char*>(read_buffer_));
+}
+
+void HttpProtocolHandlerCore::ReleaseReadBuffer() {
+  if (!read_buffer_)
+    return;
+  GetHTTPProtocolHandlerReadBufferPool()->Release(read_buffer_,
+                                                  read_buffer_size_);
+  read_buffer_ = nullptr;
 }
 
 HttpProtocolHandlerCore::~HttpProtocolHandlerCore() {
   DCHECK(thread_checker_.CalledOnValidThread());
   DCHECK(!net_request_);
   DCHECK(!http_body_stream_delegate_);
+  ReleaseReadBuffer();
 }
 
 // static
@@ -572,6 +644,12 @@ void HttpProtocolHandlerCore::Start(id<CRNNetworkClientProtocol> base_client) {
   client_ = base_client;
   GURL url = GURLWithNSURL([request_ URL]);
 
+  // The read buffers are recycled across requests. Listen to memory pressure
+  // on the IO thread to release them.
+  static base::NoDestructor<base::MemoryPressureListener>
+      memory_pressure_listener(FROM_HERE,
+                               base::BindRepeating(&OnMemoryPressure));
+
   // Now that all of the network clients are set up, if there was an error with
   // the URL, it can be raised and all of the clients will have a chance to
   // handle it.
@@ -628,7 +706,8 @@ void HttpProtocolHandlerCore::Start(id<CRNNetworkClientProtocol> base_client) {
     }
 
     std::unique_ptr<ChunkedDataStreamUploader> uploader =
-        std::make_unique<ChunkedDataStreamUploader>(this);
+        std::make_unique<ChunkedDataStreamUploader>(
+            this, kMaxUploadReadAheadChunks * kIOBufferMinSize);
     chunked_uploader_ = uploader->GetWeakPtr();
     net_request_->set_upload(std::move(uploader));
   } else if ([request_ HTTPBody]) {
@@ -780,6 +859,51 @@ int HttpProtocolHandlerCore::OnRead(char* buffer, int buffer_length) {
   return bytes_read;
 }
 
+void HttpProtocolHandlerCore::OnChunksConsumed() {
+  DCHECK(thread_checker_.CalledOnValidThread());
+  ReadAheadChunks();
+}
+
+void HttpProtocolHandlerCore::ReadAheadChunks() {
+  DCHECK(thread_checker_.CalledOnValidThread());
+  // NSInputStream read() blocks the thread until there is at least one byte
+  // available, so check the status before each read().
+  while (http_body_stream_ && chunked_uploader_ &&
+         [http_body_stream_ hasBytesAvailable]) {
+    if (chunked_uploader_->HasPendingRead()) {
+      // A pending network read is served by reading the stream directly into
+      // its buffer, see OnRead(). The data is only copied through a chunk
+      // when it is read ahead.
+      chunked_uploader_->UploadWhenReady(false);
+      // NSInputStream can read 0 byte when hasBytesAvailable is true, wait
+      // for the next stream event.
+      if (chunked_uploader_ && chunked_uploader_->HasPendingRead())
+        return;
+      continue;
+    }
+    if (!chunked_uploader_->HasReadAheadCapacity())
+      return;
+
+    auto chunk = base::MakeRefCounted<PooledIOBuffer>(kIOBufferMinSize);
+    const NSInteger length =
+        [http_body_stream_ read:reinterpret_cast<unsigned char*>(chunk->data())
+                      maxLength:kIOBufferMinSize];
+    if (length < 0) {
+      DLOG(ERROR) << "Failed to read POST data: "
+                  << base::SysNSStringToUTF8(
+                         [[http_body_stream_ streamError] description]);
+      StopListeningStream(http_body_stream_);
+      StopRequestWithError(NSURLErrorUnknown, ERR_UNEXPECTED);
+      return;
+    }
+    // NSInputStream can read 0 byte when hasBytesAvailable is true, wait for
+    // the next stream event.
+    if (length == 0)
+      return;
+    chunked_uploader_->AppendChunk(std::move(chunk), length);
+  }
+}
+
 }  // namespace net
 
 #pragma mark -
@@ -0,0 +1,108 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ios/net/read_buffer_pool.h"
+
+#include <stdlib.h>
+
+#include <algorithm>
+
+#include "base/bits.h"
+#include "base/check.h"
+#include "base/check_op.h"
+
+namespace net {
+
+namespace {
+
+// Returns the number of powers of two between |min_size| and |max_size|.
+size_t SizeClassCount(size_t min_size, size_t max_size) {
+  size_t count = 1;
+  for (size_t size = min_size; size < max_size; size *= 2)
+    ++count;
+  return count;
+}
+
+}  // namespace
+
+ReadBufferPool::ReadBufferPool(size_t min_buffer_size,
+                               size_t max_buffer_size,
+                               size_t max_buffers_per_size)
+    : min_buffer_size_(min_buffer_size),
+      size_class_count_(SizeClassCount(min_buffer_size, max_buffer_size)),
+      max_buffers_per_size_(max_buffers_per_size) {
+  DCHECK(base::bits::IsPowerOfTwo(min_buffer_size));
+  DCHECK(base::bits::IsPowerOfTwo(max_buffer_size));
+  DCHECK_LE(min_buffer_size, max_buffer_size);
+  free_buffers_.resize(size_class_count_);
+}
+
+ReadBufferPool::~ReadBufferPool() {
+  Purge();
+}
+
+char* ReadBufferPool::Acquire(size_t size) {
+  const int index = SizeClassIndex(size);
+  {
+    base::AutoLock auto_lock(lock_);
+    ++stats_.acquire_count;
+    if (index >= 0 && !free_buffers_[index].empty()) {
+      char* buffer = free_buffers_[index].back();
+      free_buffers_[index].pop_back();
+      ++stats_.hit_count;
+      stats_.retained_bytes -= size;
+      return buffer;
+    }
+  }
+  char* buffer = static_cast<char*>(malloc(size));
+  CHECK(buffer);
+  return buffer;
+}
+
+void ReadBufferPool::Release(char* buffer, size_t size) {
+  DCHECK(buffer);
+  const int index = SizeClassIndex(size);
+  if (index >= 0) {
+    base::AutoLock auto_lock(lock_);
+    if (free_buffers_[index].size() < max_buffers_per_size_) {
+      free_buffers_[index].push_back(buffer);
+      stats_.retained_bytes += size;
+      stats_.peak_retained_bytes =
+          std::max(stats_.peak_retained_bytes, stats_.retained_bytes);
+      return;
+    }
+  }
+  free(buffer);
+}
+
+void ReadBufferPool::Purge() {
+  std::vector<std::vector<char*>> free_buffers(size_class_count_);
+  {
+    base::AutoLock auto_lock(lock_);
+    free_buffers.swap(free_buffers_);
+    stats_.retained_bytes = 0;
+  }
+  for (const std::vector<char*>& buffers : free_buffers) {
+    for (char* buffer : buffers)
+      free(buffer);
+  }
+}
+
+ReadBufferPool::Stats ReadBufferPool::GetStats() const {
+  base::AutoLock auto_lock(lock_);
+  return stats_;
+}
+
+int ReadBufferPool::SizeClassIndex(size_t size) const {
+  if (size < min_buffer_size_ || !base::bits::IsPowerOfTwo(size))
+    return -1;
+  int index = 0;
+  for (size_t class_size = min_buffer_size_; class_size < size;
+       class_size *= 2) {
+    ++index;
+  }
+  return index < static_cast<int>(size_class_count_) ? index : -1;
+}
+
+}  // namespace net
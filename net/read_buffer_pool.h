@@ -0,0 +1,78 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef IOS_NET_READ_BUFFER_POOL_H_
+#define IOS_NET_READ_BUFFER_POOL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "base/synchronization/lock.h"
+#include "base/thread_annotations.h"
+
+namespace net {
+
+// Pool of the malloc-ed buffers used to read the net::URLRequests of the
+// protocol handler. The buffers are handed to NSData objects without copy, so
+// they are returned to the pool from the NSData deallocator, which may run on
+// any thread. Buffers are pooled by size class: each power of two between
+// |min_buffer_size| and |max_buffer_size|. Other sizes are not pooled.
+class ReadBufferPool {
+ public:
+  // Counters of the pool activity since its creation.
+  struct Stats {
+    // Number of calls to Acquire().
+    uint64_t acquire_count = 0;
+    // Number of calls to Acquire() served with a recycled buffer.
+    uint64_t hit_count = 0;
+    // Bytes currently retained by the pool, and their maximum.
+    size_t retained_bytes = 0;
+    size_t peak_retained_bytes = 0;
+  };
+
+  // Creates a pool retaining at most |max_buffers_per_size| buffers of each
+  // size class. |min_buffer_size| and |max_buffer_size| must be powers of two.
+  ReadBufferPool(size_t min_buffer_size,
+                 size_t max_buffer_size,
+                 size_t max_buffers_per_size);
+
+  ReadBufferPool(const ReadBufferPool&) = delete;
+  ReadBufferPool& operator=(const ReadBufferPool&) = delete;
+
+  ~ReadBufferPool();
+
+  // Returns a buffer of |size| bytes, to be returned with Release(). Never
+  // returns null.
+  char* Acquire(size_t size);
+
+  // Returns |buffer|, of |size| bytes, to the pool. Frees it if the pool
+  // already retains enough buffers of that size. Can be called on any thread.
+  void Release(char* buffer, size_t size);
+
+  // Frees all the retained buffers.
+  void Purge();
+
+  // Returns the counters of the pool activity.
+  Stats GetStats() const;
+
+ private:
+  // Returns the index of the size class of |size| in |free_buffers_|, or -1 if
+  // |size| is not pooled.
+  int SizeClassIndex(size_t size) const;
+
+  const size_t min_buffer_size_;
+  const size_t size_class_count_;
+  const size_t max_buffers_per_size_;
+
+  mutable base::Lock lock_;
+  // The free buffers, by size class.
+  std::vector<std::vector<char*>> free_buffers_ GUARDED_BY(lock_);
+  Stats stats_ GUARDED_BY(lock_);
+};
+
+}  // namespace net
+
+#endif  // IOS_NET_READ_BUFFER_POOL_H_
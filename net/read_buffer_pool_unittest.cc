@@ -0,0 +1,70 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ios/net/read_buffer_pool.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/platform_test.h"
+
+namespace net {
+
+namespace {
+
+const size_t kMinSize = 64 * 1024;
+const size_t kMaxSize = 4 * kMinSize;
+
+}  // namespace
+
+using ReadBufferPoolTest = PlatformTest;
+
+// Tests that released buffers are recycled for the same size class only.
+TEST_F(ReadBufferPoolTest, RecycleBySize) {
+  ReadBufferPool pool(kMinSize, kMaxSize, 2);
+  char* buffer = pool.Acquire(kMinSize);
+  pool.Release(buffer, kMinSize);
+
+  char* other_buffer = pool.Acquire(2 * kMinSize);
+  EXPECT_NE(buffer, other_buffer);
+  EXPECT_EQ(buffer, pool.Acquire(kMinSize));
+  pool.Release(buffer, kMinSize);
+  pool.Release(other_buffer, 2 * kMinSize);
+
+  ReadBufferPool::Stats stats = pool.GetStats();
+  EXPECT_EQ(3u, stats.acquire_count);
+  EXPECT_EQ(1u, stats.hit_count);
+  EXPECT_EQ(3 * kMinSize, stats.retained_bytes);
+  EXPECT_EQ(3 * kMinSize, stats.peak_retained_bytes);
+}
+
+// Tests that the pool retains at most the given number of buffers per size,
+// and no buffer outside of the size classes.
+TEST_F(ReadBufferPoolTest, RetainedBuffersLimit) {
+  ReadBufferPool pool(kMinSize, kMaxSize, 2);
+  char* buffers[] = {pool.Acquire(kMaxSize), pool.Acquire(kMaxSize),
+                     pool.Acquire(kMaxSize)};
+  for (char* buffer : buffers)
+    pool.Release(buffer, kMaxSize);
+  EXPECT_EQ(2 * kMaxSize, pool.GetStats().retained_bytes);
+
+  pool.Release(pool.Acquire(2 * kMaxSize), 2 * kMaxSize);
+  pool.Release(pool.Acquire(kMinSize + 1), kMinSize + 1);
+  pool.Release(pool.Acquire(kMinSize / 2), kMinSize / 2);
+  EXPECT_EQ(2 * kMaxSize, pool.GetStats().retained_bytes);
+}
+
+// Tests that purging frees the retained buffers but keeps the peak.
+TEST_F(ReadBufferPoolTest, Purge) {
+  ReadBufferPool pool(kMinSize, kMaxSize, 2);
+  pool.Release(pool.Acquire(kMinSize), kMinSize);
+  pool.Purge();
+
+  ReadBufferPool::Stats stats = pool.GetStats();
+  EXPECT_EQ(0u, stats.retained_bytes);
+  EXPECT_EQ(kMinSize, stats.peak_retained_bytes);
+
+  pool.Release(pool.Acquire(kMinSize), kMinSize);
+  EXPECT_EQ(0u, pool.GetStats().hit_count);
+}
+
+}  // namespace net
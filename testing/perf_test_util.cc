@@ -0,0 +1,71 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ios/testing/perf_test_util.h"
+
+#include <malloc/malloc.h>
+
+#include "base/callback.h"
+#include "base/command_line.h"
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/json/json_writer.h"
+#include "base/logging.h"
+#include "base/threading/thread_restrictions.h"
+#include "base/time/time.h"
+#include "base/values.h"
+#include "testing/perf/perf_test.h"
+
+namespace testing {
+
+const char kPerfResultsFileSwitch[] = "perf-results-file";
+
+size_t GetAllocatedBlockCount() {
+  malloc_statistics_t statistics;
+  malloc_zone_statistics(nullptr, &statistics);
+  return statistics.blocks_in_use;
+}
+
+double MeasureMicroseconds(size_t iterations,
+                           const base::RepeatingClosure& closure) {
+  DCHECK_GT(iterations, 0u);
+  const base::TimeTicks start = base::TimeTicks::Now();
+  for (size_t i = 0; i < iterations; ++i)
+    closure.Run();
+  return (base::TimeTicks::Now() - start).InMicrosecondsF() / iterations;
+}
+
+void ReportPerfResult(const std::string& measurement,
+                      const std::string& story,
+                      double value,
+                      const std::string& units) {
+  perf_test::PrintResult(measurement, "", story, value, units,
+                         /*important=*/true);
+
+  const base::FilePath path =
+      base::CommandLine::ForCurrentProcess()->GetSwitchValuePath(
+          kPerfResultsFileSwitch);
+  if (path.empty())
+    return;
+
+  base::Value result(base::Value::Type::DICTIONARY);
+  result.SetStringKey("measurement", measurement);
+  result.SetStringKey("story", story);
+  result.SetDoubleKey("value", value);
+  result.SetStringKey("units", units);
+  std::string line;
+  if (!base::JSONWriter::Write(result, &line))
+    return;
+  line.push_back('\n');
+
+  // The results of the previous runs are dropped by the first result.
+  static bool file_truncated = false;
+  base::ScopedAllowBlockingForTesting allow_blocking;
+  const bool success = file_truncated ? base::AppendToFile(path, line)
+                                      : base::WriteFile(path, line);
+  file_truncated = true;
+  LOG_IF(ERROR, !success) << "Could not write perf result to " << path;
+}
+
+}  // namespace testing
@@ -0,0 +1,40 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef IOS_TESTING_PERF_TEST_UTIL_H_
+#define IOS_TESTING_PERF_TEST_UTIL_H_
+
+#include <stddef.h>
+
+#include <string>
+
+#include "base/callback_forward.h"
+
+namespace testing {
+
+// Name of the command line switch giving the path of the file where the perf
+// tests write their results, in addition to the standard output. The file is
+// truncated by the first result and contains one JSON object per line, with
+// the "measurement", "story", "value" and "units" keys.
+extern const char kPerfResultsFileSwitch[];
+
+// Returns the number of blocks currently allocated in all the malloc zones.
+size_t GetAllocatedBlockCount();
+
+// Runs |closure| |iterations| times and returns the mean duration of a run,
+// in microseconds.
+double MeasureMicroseconds(size_t iterations,
+                           const base::RepeatingClosure& closure);
+
+// Reports |value|, in |units|, for the |story| of |measurement|. The result is
+// printed in the format understood by the perf dashboard and appended to the
+// file given with kPerfResultsFileSwitch, if any.
+void ReportPerfResult(const std::string& measurement,
+                      const std::string& story,
+                      double value,
+                      const std::string& units);
+
+}  // namespace testing
+
+#endif  // IOS_TESTING_PERF_TEST_UTIL_H_
@@ -72,6 +72,20 @@ extern const base::Feature kEnableFullscreenAPI;
 // should be used instead of directly checking this feature.
 extern const base::Feature kUseLoadSimulatedRequestForOfflinePage;
 
+// When enabled, the JavaScript function calls made on a web frame during the
+// same run loop turn are executed by a single script evaluation, and their
+// timeouts share a single timer.
+extern const base::Feature kBatchJavaScriptFunctionCalls;
+
+// When enabled, the session history is encoded in restore_session.html URLs
+// with a compact binary format instead of JSON.
+extern const base::Feature kCompactRestoreSessionUrl;
+
+// When enabled, large downloads of GET requests are split in byte ranges
+// fetched in parallel, and interrupted downloads resume from the ranges
+// already written to disk when restarted.
+extern const base::Feature kParallelRangedDownloads;
+
 // When true, the native context menu for the web content are used.
 bool UseWebViewNativeContextMenuWeb();
 
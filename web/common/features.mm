@@ -59,6 +59,15 @@ extern const base::Feature kUseLoadSimulatedRequestForOfflinePage{
     "UseLoadSimulatedRequestForErrorPageNavigation",
     base::FEATURE_DISABLED_BY_DEFAULT};
 
+const base::Feature kBatchJavaScriptFunctionCalls{
+    "BatchJavaScriptFunctionCalls", base::FEATURE_DISABLED_BY_DEFAULT};
+
+const base::Feature kCompactRestoreSessionUrl{
+    "CompactRestoreSessionUrl", base::FEATURE_DISABLED_BY_DEFAULT};
+
+const base::Feature kParallelRangedDownloads{
+    "ParallelRangedDownloads", base::FEATURE_DISABLED_BY_DEFAULT};
+
 bool UseWebViewNativeContextMenuWeb() {
   return base::FeatureList::IsEnabled(kDefaultWebViewContextMenu);
 }
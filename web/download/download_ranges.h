@@ -0,0 +1,76 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef IOS_WEB_DOWNLOAD_DOWNLOAD_RANGES_H_
+#define IOS_WEB_DOWNLOAD_DOWNLOAD_RANGES_H_
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "third_party/abseil-cpp/absl/types/optional.h"
+#include "url/gurl.h"
+
+namespace web {
+namespace download {
+
+// A range of bytes of a download, fetched by a single ranged request.
+struct DownloadRange {
+  // Offset of the first byte of the range.
+  int64_t start = 0;
+  // Offset following the last byte of the range, or -1 if unknown (i.e. the
+  // range extends to the end of the response).
+  int64_t end = -1;
+  // Number of bytes of the range received so far.
+  int64_t received = 0;
+
+  // Returns the offset of the next byte to receive.
+  int64_t offset() const { return start + received; }
+
+  // Returns whether all the bytes of the range have been received.
+  bool IsComplete() const { return end != -1 && offset() >= end; }
+};
+
+// State of a ranged download persisted on disk, allowing to resume it.
+struct DownloadCheckpoint {
+  DownloadCheckpoint();
+  DownloadCheckpoint(DownloadCheckpoint&& other);
+  DownloadCheckpoint& operator=(DownloadCheckpoint&& other);
+  ~DownloadCheckpoint();
+
+  GURL url;
+  int64_t total_bytes = -1;
+  // Strong ETag, or else Last-Modified date, of the resource. Sent as the
+  // If-Range header of the requests resuming the download, so that they
+  // fetch the whole resource again if it has changed.
+  std::string validator;
+  std::vector<DownloadRange> ranges;
+};
+
+// Splits a download of |total_bytes| in |count| ranges of equal size, except
+// the last one which may be smaller.
+std::vector<DownloadRange> SplitDownloadRanges(int64_t total_bytes, int count);
+
+// Returns the value of the Range header requesting the bytes of |range| not
+// received yet.
+std::string GetRangeHeaderValue(const DownloadRange& range);
+
+// Returns the path of the checkpoint of the download to |path|.
+base::FilePath GetDownloadCheckpointPath(const base::FilePath& path);
+
+// Serializes |checkpoint|.
+std::string SerializeDownloadCheckpoint(const DownloadCheckpoint& checkpoint);
+
+// Returns the checkpoint serialized in |data|, or absl::nullopt if |data| is
+// not a valid checkpoint: it must have a validator, and ranges must be
+// sorted, disjoint and cover exactly [0, total_bytes).
+absl::optional<DownloadCheckpoint> ParseDownloadCheckpoint(
+    const std::string& data);
+
+}  // namespace download
+}  // namespace web
+
+#endif  // IOS_WEB_DOWNLOAD_DOWNLOAD_RANGES_H_
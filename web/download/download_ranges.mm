@@ -0,0 +1,147 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#import "ios/web/download/download_ranges.h"
+
+#import <algorithm>
+
+#import "base/check_op.h"
+#import "base/json/json_reader.h"
+#import "base/json/json_writer.h"
+#import "base/strings/string_number_conversions.h"
+#import "base/strings/strcat.h"
+#import "base/values.h"
+
+#if !defined(__has_feature) || !__has_feature(objc_arc)
+#error "This file requires ARC support."
+#endif
+
+namespace web {
+namespace download {
+
+namespace {
+
+// Keys of the serialized checkpoint. The 64-bit offsets are serialized as
+// strings as base::Value does not support them.
+const char kUrlKey[] = "url";
+const char kTotalBytesKey[] = "total";
+const char kValidatorKey[] = "validator";
+const char kRangesKey[] = "ranges";
+const char kStartKey[] = "start";
+const char kEndKey[] = "end";
+const char kReceivedKey[] = "received";
+
+// Extension of the checkpoint file, appended to the download file path.
+const base::FilePath::CharType kCheckpointExtension[] =
+    FILE_PATH_LITERAL(".ranges");
+
+// Returns the 64-bit integer serialized at |key| in |dict|.
+absl::optional<int64_t> FindInt64(const base::Value& dict, const char* key) {
+  const std::string* value = dict.FindStringKey(key);
+  int64_t result = 0;
+  if (!value || !base::StringToInt64(*value, &result))
+    return absl::nullopt;
+  return result;
+}
+
+}  // namespace
+
+DownloadCheckpoint::DownloadCheckpoint() = default;
+DownloadCheckpoint::DownloadCheckpoint(DownloadCheckpoint&& other) = default;
+DownloadCheckpoint& DownloadCheckpoint::operator=(DownloadCheckpoint&& other) =
+    default;
+DownloadCheckpoint::~DownloadCheckpoint() = default;
+
+std::vector<DownloadRange> SplitDownloadRanges(int64_t total_bytes, int count) {
+  DCHECK_GT(total_bytes, 0);
+  DCHECK_GT(count, 0);
+  const int64_t range_size = (total_bytes + count - 1) / count;
+  std::vector<DownloadRange> ranges;
+  for (int64_t start = 0; start < total_bytes; start += range_size) {
+    DownloadRange range;
+    range.start = start;
+    range.end = std::min(start + range_size, total_bytes);
+    ranges.push_back(range);
+  }
+  return ranges;
+}
+
+std::string GetRangeHeaderValue(const DownloadRange& range) {
+  if (range.end == -1)
+    return base::StrCat({"bytes=", base::NumberToString(range.offset()), "-"});
+  DCHECK_LT(range.offset(), range.end);
+  return base::StrCat({"bytes=", base::NumberToString(range.offset()), "-",
+                       base::NumberToString(range.end - 1)});
+}
+
+base::FilePath GetDownloadCheckpointPath(const base::FilePath& path) {
+  return path.AddExtension(kCheckpointExtension);
+}
+
+std::string SerializeDownloadCheckpoint(const DownloadCheckpoint& checkpoint) {
+  base::Value ranges(base::Value::Type::LIST);
+  for (const DownloadRange& range : checkpoint.ranges) {
+    base::Value value(base::Value::Type::DICTIONARY);
+    value.SetStringKey(kStartKey, base::NumberToString(range.start));
+    value.SetStringKey(kEndKey, base::NumberToString(range.end));
+    value.SetStringKey(kReceivedKey, base::NumberToString(range.received));
+    ranges.Append(std::move(value));
+  }
+
+  base::Value dict(base::Value::Type::DICTIONARY);
+  dict.SetStringKey(kUrlKey, checkpoint.url.spec());
+  dict.SetStringKey(kTotalBytesKey,
+                    base::NumberToString(checkpoint.total_bytes));
+  dict.SetStringKey(kValidatorKey, checkpoint.validator);
+  dict.SetKey(kRangesKey, std::move(ranges));
+
+  std::string data;
+  base::JSONWriter::Write(dict, &data);
+  return data;
+}
+
+absl::optional<DownloadCheckpoint> ParseDownloadCheckpoint(
+    const std::string& data) {
+  absl::optional<base::Value> dict = base::JSONReader::Read(data);
+  if (!dict || !dict->is_dict())
+    return absl::nullopt;
+
+  DownloadCheckpoint checkpoint;
+  const std::string* url = dict->FindStringKey(kUrlKey);
+  absl::optional<int64_t> total_bytes = FindInt64(*dict, kTotalBytesKey);
+  const std::string* validator = dict->FindStringKey(kValidatorKey);
+  const base::Value* ranges = dict->FindListKey(kRangesKey);
+  if (!url || !total_bytes || *total_bytes <= 0 || !validator ||
+      validator->empty() || !ranges) {
+    return absl::nullopt;
+  }
+  checkpoint.url = GURL(*url);
+  checkpoint.total_bytes = *total_bytes;
+  checkpoint.validator = *validator;
+
+  int64_t expected_start = 0;
+  for (const base::Value& value : ranges->GetListDeprecated()) {
+    if (!value.is_dict())
+      return absl::nullopt;
+    absl::optional<int64_t> start = FindInt64(value, kStartKey);
+    absl::optional<int64_t> end = FindInt64(value, kEndKey);
+    absl::optional<int64_t> received = FindInt64(value, kReceivedKey);
+    if (!start || !end || !received || *start != expected_start ||
+        *end <= *start || *received < 0 || *received > *end - *start) {
+      return absl::nullopt;
+    }
+    DownloadRange range;
+    range.start = *start;
+    range.end = *end;
+    range.received = *received;
+    checkpoint.ranges.push_back(range);
+    expected_start = *end;
+  }
+  if (expected_start != checkpoint.total_bytes)
+    return absl::nullopt;
+  return checkpoint;
+}
+
+}  // namespace download
+}  // namespace web
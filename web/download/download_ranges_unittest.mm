@@ -0,0 +1,115 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#import "ios/web/download/download_ranges.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/platform_test.h"
+
+#if !defined(__has_feature) || !__has_feature(objc_arc)
+#error "This file requires ARC support."
+#endif
+
+namespace web {
+namespace download {
+
+using DownloadRangesTest = PlatformTest;
+
+// Tests that a download is split in contiguous ranges covering all of it.
+TEST_F(DownloadRangesTest, SplitDownloadRanges) {
+  std::vector<DownloadRange> ranges = SplitDownloadRanges(10, 4);
+  ASSERT_EQ(4u, ranges.size());
+  EXPECT_EQ(0, ranges[0].start);
+  EXPECT_EQ(3, ranges[0].end);
+  EXPECT_EQ(3, ranges[1].start);
+  EXPECT_EQ(6, ranges[1].end);
+  EXPECT_EQ(6, ranges[2].start);
+  EXPECT_EQ(9, ranges[2].end);
+  EXPECT_EQ(9, ranges[3].start);
+  EXPECT_EQ(10, ranges[3].end);
+
+  // A download smaller than the number of ranges is not split further.
+  ranges = SplitDownloadRanges(2, 4);
+  ASSERT_EQ(2u, ranges.size());
+  EXPECT_EQ(1, ranges[0].end);
+  EXPECT_EQ(2, ranges[1].end);
+}
+
+// Tests the Range header requesting the bytes not received yet.
+TEST_F(DownloadRangesTest, GetRangeHeaderValue) {
+  DownloadRange range;
+  EXPECT_EQ("bytes=0-", GetRangeHeaderValue(range));
+
+  range.start = 100;
+  range.end = 200;
+  EXPECT_EQ("bytes=100-199", GetRangeHeaderValue(range));
+
+  range.received = 50;
+  EXPECT_EQ("bytes=150-199", GetRangeHeaderValue(range));
+  EXPECT_FALSE(range.IsComplete());
+
+  range.received = 100;
+  EXPECT_TRUE(range.IsComplete());
+}
+
+// Tests that a checkpoint can be parsed back once serialized.
+TEST_F(DownloadRangesTest, SerializeAndParseCheckpoint) {
+  DownloadCheckpoint checkpoint;
+  checkpoint.url = GURL("https://example.test/file.zip");
+  checkpoint.total_bytes = 5'000'000'000;
+  checkpoint.validator = "\"etag\"";
+  checkpoint.ranges = SplitDownloadRanges(checkpoint.total_bytes, 2);
+  checkpoint.ranges[0].received = 2'500'000'000;
+  checkpoint.ranges[1].received = 42;
+
+  absl::optional<DownloadCheckpoint> parsed =
+      ParseDownloadCheckpoint(SerializeDownloadCheckpoint(checkpoint));
+  ASSERT_TRUE(parsed.has_value());
+  EXPECT_EQ(checkpoint.url, parsed->url);
+  EXPECT_EQ(checkpoint.total_bytes, parsed->total_bytes);
+  EXPECT_EQ(checkpoint.validator, parsed->validator);
+  ASSERT_EQ(2u, parsed->ranges.size());
+  for (size_t i = 0; i < parsed->ranges.size(); ++i) {
+    EXPECT_EQ(checkpoint.ranges[i].start, parsed->ranges[i].start);
+    EXPECT_EQ(checkpoint.ranges[i].end, parsed->ranges[i].end);
+    EXPECT_EQ(checkpoint.ranges[i].received, parsed->ranges[i].received);
+  }
+}
+
+// Tests that checkpoints without a validator, or whose ranges do not cover
+// the download or claim more bytes than their size, are rejected.
+TEST_F(DownloadRangesTest, ParseInvalidCheckpoint) {
+  EXPECT_FALSE(ParseDownloadCheckpoint("").has_value());
+  EXPECT_FALSE(ParseDownloadCheckpoint("[]").has_value());
+
+  DownloadCheckpoint checkpoint;
+  checkpoint.url = GURL("https://example.test/file.zip");
+  checkpoint.total_bytes = 100;
+  checkpoint.ranges = SplitDownloadRanges(100, 4);
+  EXPECT_FALSE(
+      ParseDownloadCheckpoint(SerializeDownloadCheckpoint(checkpoint)));
+  checkpoint.validator = "Wed, 21 Oct 2015 07:28:00 GMT";
+  ASSERT_TRUE(
+      ParseDownloadCheckpoint(SerializeDownloadCheckpoint(checkpoint)));
+
+  // Gap between two ranges.
+  checkpoint.ranges[1].start += 1;
+  EXPECT_FALSE(
+      ParseDownloadCheckpoint(SerializeDownloadCheckpoint(checkpoint)));
+  checkpoint.ranges[1].start -= 1;
+
+  // Range received past its end.
+  checkpoint.ranges[2].received = 26;
+  EXPECT_FALSE(
+      ParseDownloadCheckpoint(SerializeDownloadCheckpoint(checkpoint)));
+  checkpoint.ranges[2].received = 0;
+
+  // Ranges not covering the whole download.
+  checkpoint.ranges.pop_back();
+  EXPECT_FALSE(
+      ParseDownloadCheckpoint(SerializeDownloadCheckpoint(checkpoint)));
+}
+
+}  // namespace download
+}  // namespace web
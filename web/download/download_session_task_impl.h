@@ -12,8 +12,10 @@
 namespace web {
 namespace download {
 namespace internal {
+class RangedSession;
 class Session;
 class TaskInfo;
+struct DownloadFile;
 }  // namespace internal
 }  // namespace download
 
@@ -48,16 +50,23 @@ class DownloadSessionTaskImpl final : public DownloadTaskImpl {
 
   // DownloadTaskImpl overrides:
   void StartInternal(const base::FilePath& path) final;
+  bool ShouldKeepExistingFile() const final;
   void CancelInternal() final;
 
  private:
+  friend class download::internal::RangedSession;
   friend class download::internal::Session;
 
-  // Called when the file has been created.
-  void OnFileCreated(base::File file);
+  // Returns whether the download is performed as ranged requests.
+  bool ShouldUseRanges() const;
+
+  // Called when the file has been created, or opened to resume a ranged
+  // download.
+  void OnFileCreated(download::internal::DownloadFile download_file);
 
   // Called when the cookies has been fetched.
-  void OnCookiesFetched(base::File file, NSArray<NSHTTPCookie*>* cookies);
+  void OnCookiesFetched(download::internal::DownloadFile download_file,
+                        NSArray<NSHTTPCookie*>* cookies);
 
   // Called when information about the download is received from the
   // background NSURLSessionTask.
@@ -71,6 +80,11 @@ class DownloadSessionTaskImpl final : public DownloadTaskImpl {
 
   SessionFactory session_factory_;
   std::unique_ptr<download::internal::Session> session_;
+  std::unique_ptr<download::internal::RangedSession> ranged_session_;
+
+  // Whether the download is performed by `ranged_session_`, as parallel
+  // ranged requests, instead of `session_`.
+  bool use_ranges_ = false;
 
   base::WeakPtrFactory<DownloadSessionTaskImpl> weak_factory_{this};
 };
@@ -4,15 +4,28 @@
 
 #import "ios/web/download/download_session_task_impl.h"
 
+#import <algorithm>
+#import <utility>
+
+#import "base/bind.h"
 #import "base/check.h"
+#import "base/feature_list.h"
+#import "base/files/file_util.h"
+#import "base/files/important_file_writer.h"
 #import "base/mac/foundation_util.h"
+#import "base/numerics/safe_conversions.h"
 #import "base/sequence_checker.h"
+#import "base/strings/string_util.h"
 #import "base/strings/sys_string_conversions.h"
 #import "base/task/bind_post_task.h"
 #import "base/task/sequenced_task_runner.h"
 #import "base/threading/sequenced_task_runner_handle.h"
+#import "base/time/time.h"
 #import "ios/net/cookies/system_cookie_util.h"
+#import "ios/net/http_response_headers_util.h"
+#import "ios/web/common/features.h"
 #import "ios/web/common/user_agent.h"
+#import "ios/web/download/download_ranges.h"
 #import "ios/web/download/download_result.h"
 #import "ios/web/download/download_session_cookie_storage.h"
 #import "ios/web/public/browser_state.h"
@@ -22,7 +35,9 @@
 #import "ios/web/public/web_state.h"
 #import "ios/web/web_view/error_translation_util.h"
 #import "net/base/mac/url_conversions.h"
+#import "net/base/net_errors.h"
 #import "net/cookies/cookie_store.h"
+#import "net/http/http_response_headers.h"
 #import "net/url_request/url_request_context.h"
 #import "net/url_request/url_request_context_getter.h"
 
@@ -38,10 +53,14 @@ namespace internal {
 // to the DownloadSessionTaskImpl from the background sequence.
 class TaskInfo {
  public:
-  TaskInfo(int64_t total_bytes, int http_error_code, NSString* mime_type)
+  TaskInfo(int64_t total_bytes,
+           int http_error_code,
+           NSString* mime_type,
+           NSURLSessionTask* task)
       : total_bytes_(total_bytes),
         http_error_code_(http_error_code),
-        mime_type_(mime_type) {
+        mime_type_(mime_type),
+        task_(task) {
     DCHECK(total_bytes_ == -1 || total_bytes >= 0);
     DCHECK(http_error_code_ == -1 || http_error_code_ > 0);
     DCHECK(!mime_type || mime_type.length != 0);
@@ -62,17 +81,27 @@ class TaskInfo {
 
     return TaskInfo(
         task.countOfBytesExpectedToReceive, http_code,
-        task.response.MIMEType.length != 0 ? task.response.MIMEType : nil);
+        task.response.MIMEType.length != 0 ? task.response.MIMEType : nil,
+        task);
   }
 
   int64_t total_bytes() const { return total_bytes_; }
   int http_error_code() const { return http_error_code_; }
   NSString* mime_type() const { return mime_type_; }
+  NSURLSessionTask* task() const { return task_; }
 
  private:
   int64_t total_bytes_ = -1;
   int http_error_code_ = -1;
   NSString* mime_type_ = nil;
+  NSURLSessionTask* task_ = nil;
+};
+
+// The file a download is written to, and the checkpoint of the ranged
+// download to resume, if any.
+struct DownloadFile {
+  base::File file;
+  absl::optional<DownloadCheckpoint> checkpoint;
 };
 
 }  // namespace internal
@@ -199,12 +228,67 @@ base::File CreateFile(base::FilePath path) {
                     base::File::FLAG_CREATE_ALWAYS | base::File::FLAG_WRITE);
 }
 
+// Opens the file at `path` for the download of `url`. If `use_ranges` is true
+// and a valid checkpoint of a ranged download of `url` exists, the partially
+// downloaded file is opened and returned with the checkpoint so that the
+// download can resume. Otherwise, the file is created as by CreateFile().
+DownloadFile OpenDownloadFile(base::FilePath path, GURL url, bool use_ranges) {
+  DCHECK(!path.empty());
+  const base::FilePath checkpoint_path = GetDownloadCheckpointPath(path);
+  if (use_ranges) {
+    std::string data;
+    absl::optional<DownloadCheckpoint> checkpoint;
+    if (base::ReadFileToString(checkpoint_path, &data))
+      checkpoint = ParseDownloadCheckpoint(data);
+
+    int64_t file_size = 0;
+    if (checkpoint && checkpoint->url == url &&
+        base::GetFileSize(path, &file_size) &&
+        file_size == checkpoint->total_bytes) {
+      base::File file(path, base::File::FLAG_OPEN | base::File::FLAG_WRITE);
+      if (file.IsValid())
+        return DownloadFile{std::move(file), std::move(checkpoint)};
+    }
+  }
+
+  base::DeleteFile(checkpoint_path);
+  return DownloadFile{CreateFile(path), absl::nullopt};
+}
+
 // Closes `file`. This function helps closing the file on the background
 // sequence.
 void CloseFile(base::File file) {
   file.Close();
 }
 
+// Flushes `file` and saves `checkpoint`, which accounts for the data written
+// to `file`, to `checkpoint_path`. The checkpoint is not saved if the data
+// can't be flushed, as it could then claim data missing from the file after a
+// crash. Returns whether the checkpoint was saved.
+bool SaveCheckpoint(base::File& file,
+                    const base::FilePath& checkpoint_path,
+                    const std::string& checkpoint) {
+  DCHECK(!checkpoint.empty());
+  if (!file.Flush())
+    return false;
+  return base::ImportantFileWriter::WriteFileAtomically(checkpoint_path,
+                                                        checkpoint);
+}
+
+// Closes `file` and deletes the checkpoint at `checkpoint_path` if
+// `delete_checkpoint` is true. Otherwise, saves `checkpoint` first unless it
+// is empty.
+void CloseRangedFile(base::File file,
+                     base::FilePath checkpoint_path,
+                     bool delete_checkpoint,
+                     std::string checkpoint) {
+  if (!delete_checkpoint && !checkpoint.empty())
+    SaveCheckpoint(file, checkpoint_path, checkpoint);
+  file.Close();
+  if (delete_checkpoint)
+    base::DeleteFile(checkpoint_path);
+}
+
 // This structure is used to pass the result of WriteDataHelper function back
 // to the caller. In case of error, the file will be closed and `bytes_written`
 // will be -1 (the error code can be found via `base::File::error_details()`).
@@ -233,6 +317,133 @@ WriteDataResult WriteDataHelper(base::File file, NSArray<NSData*>* array) {
   return WriteDataResult{std::move(file), bytes_written};
 }
 
+// Minimum size of a ranged download for it to be split in several ranges.
+const int64_t kMinRangedDownloadSize = 4 * 1024 * 1024;
+
+// Number of ranges a ranged download is split in.
+const int kRangedDownloadRangeCount = 4;
+
+// Number of times the request of a range is restarted after a network error.
+const int kMaxRangeRetryCount = 3;
+
+// The checkpoint of a resumable download is saved with a batch of writes once
+// that much data or time has passed since it was last saved, as saving it
+// flushes the file and writes the checkpoint atomically, which both sync to
+// the disk.
+const int64_t kCheckpointIntervalBytes = 1024 * 1024;
+constexpr base::TimeDelta kCheckpointInterval = base::Seconds(1);
+
+// Returns whether the request of a range which failed with `error_code` can
+// be restarted.
+bool IsRetryableRangeError(int error_code) {
+  switch (error_code) {
+    case net::ERR_CONNECTION_CLOSED:
+    case net::ERR_CONNECTION_RESET:
+    case net::ERR_CONTENT_LENGTH_MISMATCH:
+    case net::ERR_NETWORK_CHANGED:
+    case net::ERR_TIMED_OUT:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// A write of `data` at `offset` in the file of a ranged download.
+struct RangeWrite {
+  int64_t offset = 0;
+  NSData* data = nil;
+};
+
+// Sets the length of `file` to `file_length` unless it is -1, writes `writes`
+// and then saves `checkpoint` to `checkpoint_path` unless it is empty. The
+// checkpoint is saved after the data it accounts for is flushed, so that it
+// never claims more data than present in the file.
+WriteDataResult WriteRangesHelper(base::File file,
+                                  std::vector<RangeWrite> writes,
+                                  int64_t file_length,
+                                  base::FilePath checkpoint_path,
+                                  std::string checkpoint) {
+  // See WriteDataHelper() for the error handling.
+  if (file_length != -1 && !file.SetLength(file_length)) {
+    base::File error_file(base::File::GetLastFileError());
+    return WriteDataResult{std::move(error_file), -1};
+  }
+
+  int64_t bytes_written = 0;
+  for (const RangeWrite& write : writes) {
+    const int length = base::checked_cast<int>(write.data.length);
+    if (file.Write(write.offset, static_cast<const char*>(write.data.bytes),
+                   length) != length) {
+      base::File error_file(base::File::GetLastFileError());
+      return WriteDataResult{std::move(error_file), -1};
+    }
+    bytes_written += length;
+  }
+
+  // A checkpoint which can't be saved is not an error, as the previous one
+  // remains valid.
+  if (!checkpoint.empty())
+    SaveCheckpoint(file, checkpoint_path, checkpoint);
+
+  return WriteDataResult{std::move(file), bytes_written};
+}
+
+// Returns the validator of the version of the resource described by
+// `headers`, to send as If-Range: its ETag unless it is weak (as those can't
+// be used in If-Range), or else its Last-Modified date. Returns an empty
+// string if the resource has neither.
+std::string GetRangeValidator(const net::HttpResponseHeaders& headers) {
+  std::string etag;
+  if (headers.EnumerateHeader(nullptr, "ETag", &etag) && !etag.empty() &&
+      !base::StartsWith(etag, "W/")) {
+    return etag;
+  }
+
+  std::string last_modified;
+  headers.EnumerateHeader(nullptr, "Last-Modified", &last_modified);
+  return last_modified;
+}
+
+// Returns the NSURLSession used to download with `delegate`, configured with
+// `identifier` and `cookies`, created by `session_factory` if not null.
+NSURLSession* CreateURLSession(
+    NSString* identifier,
+    NSArray<NSHTTPCookie*>* cookies,
+    const DownloadSessionTaskImpl::SessionFactory& session_factory,
+    CRWURLSessionDelegate* delegate) {
+  NSURLSessionConfiguration* configuration = [NSURLSessionConfiguration
+      backgroundSessionConfigurationWithIdentifier:identifier];
+
+  const NSHTTPCookieAcceptPolicy policy =
+      NSHTTPCookieStorage.sharedHTTPCookieStorage.cookieAcceptPolicy;
+
+  // Cookies have to be set in the session configuration before the session
+  // is created (as once the session is created, the configuration object
+  // can't be edited and configuration properties will return a copy of the
+  // originally used configuration). The cookies are copied from the internal
+  // WebSiteDataStore cookie store, so they should not have duplicates nor
+  // invalid cookies.
+  configuration.HTTPCookieStorage =
+      [[DownloadSessionCookieStorage alloc] initWithCookies:cookies
+                                         cookieAcceptPolicy:policy];
+
+  const std::string user_agent =
+      GetWebClient()->GetUserAgent(UserAgentType::MOBILE);
+  configuration.HTTPAdditionalHeaders = @{
+    base::SysUTF8ToNSString(net::HttpRequestHeaders::kUserAgent) :
+        base::SysUTF8ToNSString(user_agent),
+  };
+
+  if (!session_factory.is_null()) {
+    NSURLSession* session = session_factory.Run(configuration, delegate);
+    DCHECK(session) << "session_factory must not return nil!";
+    return session;
+  }
+  return [NSURLSession sessionWithConfiguration:configuration
+                                       delegate:delegate
+                                  delegateQueue:nil];
+}
+
 // Move the `base::File` out of `optional` and reset the `optional` to have
 // no value (i.e. to be equal to `absl::nullopt`).
 base::File take(absl::optional<base::File>& optional) {
@@ -398,29 +609,6 @@ Session::Session(base::File file,
   DCHECK(owner_);
   DCHECK(file_.has_value() && file_.value().IsValid());
 
-  NSURLSessionConfiguration* configuration = [NSURLSessionConfiguration
-      backgroundSessionConfigurationWithIdentifier:identifier];
-
-  const NSHTTPCookieAcceptPolicy policy =
-      NSHTTPCookieStorage.sharedHTTPCookieStorage.cookieAcceptPolicy;
-
-  // Cookies have to be set in the session configuration before the session
-  // is created (as once the session is created, the configuration object
-  // can't be edited and configuration properties will return a copy of the
-  // originally used configuration). The cookies are copied from the internal
-  // WebSiteDataStore cookie store, so they should not have duplicates nor
-  // invalid cookies.
-  configuration.HTTPCookieStorage =
-      [[DownloadSessionCookieStorage alloc] initWithCookies:cookies
-                                         cookieAcceptPolicy:policy];
-
-  const std::string user_agent =
-      GetWebClient()->GetUserAgent(UserAgentType::MOBILE);
-  configuration.HTTPAdditionalHeaders = @{
-    base::SysUTF8ToNSString(net::HttpRequestHeaders::kUserAgent) :
-        base::SysUTF8ToNSString(user_agent),
-  };
-
   // Invoked when data is received from NSURLSessionTask.
   DataReceivedHandler data_received = base::BindPostTask(
       base::SequencedTaskRunnerHandle::Get(),
@@ -441,14 +629,7 @@ Session::Session(base::File file,
       initWithDataReceivedHandler:std::move(data_received)
               taskFinishedHandler:std::move(task_finished)];
 
-  if (!session_factory.is_null()) {
-    session_ = session_factory.Run(configuration, delegate_);
-    DCHECK(session_) << "session_factory must not return nil!";
-  } else {
-    session_ = [NSURLSession sessionWithConfiguration:configuration
-                                             delegate:delegate_
-                                        delegateQueue:nil];
-  }
+  session_ = CreateURLSession(identifier, cookies, session_factory, delegate_);
 
   NSMutableURLRequest* request =
       [[NSMutableURLRequest alloc] initWithURL:net::NSURLWithGURL(url)];
@@ -571,6 +752,617 @@ void Session::CancelSession() {
   task_ = nil;
 }
 
+// Helper class that performs the download of a GET request as several ranged
+// requests fetched in parallel. It interacts with the same three sequences
+// as Session (see above), with the following differences:
+//
+//   - The first request asks for "bytes=0-". If the server answers with a
+//     206 covering the whole resource and identifies its version with an
+//     ETag or a Last-Modified date, the download is resumable and, if it is
+//     large enough, the remaining ranges are requested in parallel. Any
+//     other answer continues as a sequential download, as with Session.
+//
+//   - The following requests send the version of the resource as If-Range,
+//     so that the server answers with the whole resource if it has changed,
+//     in which case the download restarts sequentially from that response.
+//
+//   - The data is written at the offset of its range. When the download is
+//     resumable, the file is preallocated and a checkpoint recording the
+//     bytes written for each range is saved next to it with the batches of
+//     writes, at most every kCheckpointIntervalBytes or kCheckpointInterval,
+//     and once more when the download fails with unsaved progress. The file
+//     is flushed before each checkpoint. If the download fails, both are
+//     kept so that restarting the
+//     DownloadTask resumes from the checkpoint. The checkpoint is deleted
+//     with the DownloadSessionTaskImpl, but is left behind if the app is
+//     killed, so that a new download to the same path resumes from it.
+//
+//   - The request of a range which fails with a transient network error is
+//     restarted from the first byte not received yet.
+//
+// The progress of all the ranges is aggregated before being reported to the
+// DownloadSessionTaskImpl.
+class RangedSession {
+ public:
+  RangedSession(DownloadFile download_file,
+                const base::FilePath& path,
+                const GURL& url,
+                NSString* identifier,
+                NSArray<NSHTTPCookie*>* cookies,
+                DownloadSessionTaskImpl::SessionFactory session_factory,
+                const scoped_refptr<base::SequencedTaskRunner>& task_runner,
+                DownloadSessionTaskImpl* owner);
+
+  RangedSession(const RangedSession&) = delete;
+  RangedSession& operator=(const RangedSession&) = delete;
+
+  ~RangedSession();
+
+ private:
+  // State of a range of the download.
+  struct RangeState {
+    DownloadRange range;
+    // The task fetching the range, or nil if the range is not being fetched.
+    __strong NSURLSessionTask* task = nil;
+    // Whether the response of `task` has been validated.
+    bool response_checked = false;
+    // Number of times the request of the range has been restarted.
+    int retry_count = 0;
+  };
+
+  // Starts the request of the bytes of the range at `index` not received yet.
+  void StartRange(size_t index);
+
+  // Returns the index of the range fetched by `task`, if any.
+  absl::optional<size_t> FindRange(NSURLSessionTask* task) const;
+
+  // Returns whether the response of `task`, fetching the range at `index`,
+  // can be written. The first response decides whether the download is
+  // resumable, and splits it in ranges if it is large enough.
+  bool CheckResponse(size_t index, NSURLSessionTask* task);
+
+  // Splits the download in ranges and starts fetching all but the first one,
+  // which is fetched by the initial request.
+  void SplitRanges();
+
+  // Restarts the download as a sequential download from the response of
+  // the range at `index`, which is the whole resource as it has changed.
+  void RestartFromFullResponse(size_t index);
+
+  // Forwards `task_info` to `owner_`, replacing the values describing a range
+  // by the ones of the whole download.
+  void ApplyTaskInfo(const TaskInfo& task_info);
+
+  // Invoked when data is received from one of the NSURLSessionTasks.
+  void DataReceived(NSData* data, TaskInfo task_info);
+
+  // Invoked when one of the NSURLSessionTasks is complete with `error_code`.
+  void TaskFinished(int error_code, TaskInfo task_info);
+
+  // Invoked when a batch of writes posted with `write_generation` has been
+  // performed. The `result` object will contains the base::File object
+  // (possibly in error).
+  void DataWritten(int write_generation, WriteDataResult result);
+
+  // Posts the pending writes to the background sequence, unless a write is
+  // already in progress.
+  void WritePendingData();
+
+  // Stops the download with `error_code`. The data already received is still
+  // written before `owner_` is notified.
+  void Fail(int error_code);
+
+  // Notifies `owner_` that the download is finished if all the ranges have
+  // been written, or if it failed and no write is in progress.
+  void MaybeFinish();
+
+  // Returns the checkpoint of the download for the data received so far.
+  DownloadCheckpoint GetCheckpoint() const;
+
+  // Cancels the NSURLSession and cleanup related objects.
+  void CancelSession();
+
+  SEQUENCE_CHECKER(sequence_checker_);
+
+  // Used to manage the write requests, as in Session. The length the file
+  // must be set to before the pending writes is `pending_file_length_`,
+  // unless it is -1.
+  scoped_refptr<base::SequencedTaskRunner> task_runner_;
+  absl::optional<base::File> file_;
+  std::vector<RangeWrite> pending_;
+  int64_t pending_file_length_ = -1;
+
+  // Incremented when the download restarts, so that the writes of the data
+  // received before are not counted in `reported_bytes_`, the number of
+  // bytes written reported to `owner_`.
+  int write_generation_ = 0;
+  int64_t reported_bytes_ = 0;
+
+  const GURL url_;
+  const base::FilePath checkpoint_path_;
+  std::vector<RangeState> ranges_;
+
+  // The number of bytes received since the checkpoint was last saved, and
+  // when it was.
+  int64_t unsaved_checkpoint_bytes_ = 0;
+  base::TimeTicks last_checkpoint_time_;
+
+  // Whether the server supports ranges, in which case the checkpoint is
+  // saved, `total_bytes_` is the size of the resource and `validator_`
+  // identifies its version (see GetRangeValidator()).
+  bool resumable_ = false;
+  int64_t total_bytes_ = -1;
+  std::string validator_;
+
+  // Stores the error which stopped the download, if any.
+  absl::optional<int> error_code_;
+
+  // Whether the end of the download has been reported to `owner_`.
+  bool finished_ = false;
+
+  __strong NSURLSession* session_ = nil;
+  __strong CRWURLSessionDelegate* delegate_ = nil;
+
+  // Pointer to the DownloadSessionTaskImpl that owns the RangedSession
+  // instance, which it never outlives.
+  DownloadSessionTaskImpl* owner_ = nullptr;
+
+  base::WeakPtrFactory<RangedSession> weak_factory_{this};
+};
+
+RangedSession::RangedSession(
+    DownloadFile download_file,
+    const base::FilePath& path,
+    const GURL& url,
+    NSString* identifier,
+    NSArray<NSHTTPCookie*>* cookies,
+    DownloadSessionTaskImpl::SessionFactory session_factory,
+    const scoped_refptr<base::SequencedTaskRunner>& task_runner,
+    DownloadSessionTaskImpl* owner)
+    : task_runner_(task_runner),
+      file_(std::move(download_file.file)),
+      url_(url),
+      checkpoint_path_(GetDownloadCheckpointPath(path)),
+      owner_(owner) {
+  DCHECK(owner_);
+  DCHECK(file_.has_value() && file_.value().IsValid());
+
+  DataReceivedHandler data_received =
+      base::BindPostTask(base::SequencedTaskRunnerHandle::Get(),
+                         base::BindRepeating(&RangedSession::DataReceived,
+                                             weak_factory_.GetWeakPtr()));
+
+  TaskFinishedHandler task_finished =
+      base::BindPostTask(base::SequencedTaskRunnerHandle::Get(),
+                         base::BindRepeating(&RangedSession::TaskFinished,
+                                             weak_factory_.GetWeakPtr()));
+
+  // The delegate is shared by the tasks of all the ranges, which are told
+  // apart with TaskInfo::task(). See Session for why the NSURLSession is not
+  // re-used.
+  delegate_ = [[CRWURLSessionDelegate alloc]
+      initWithDataReceivedHandler:std::move(data_received)
+              taskFinishedHandler:std::move(task_finished)];
+
+  session_ = CreateURLSession(identifier, cookies, session_factory, delegate_);
+
+  if (!download_file.checkpoint.has_value()) {
+    ranges_.emplace_back();
+    StartRange(0);
+    return;
+  }
+
+  // Resume the download from the ranges already written to the file.
+  const DownloadCheckpoint& checkpoint = download_file.checkpoint.value();
+  DCHECK_EQ(url_, checkpoint.url);
+  resumable_ = true;
+  total_bytes_ = checkpoint.total_bytes;
+  validator_ = checkpoint.validator;
+
+  int64_t received_bytes = 0;
+  for (const DownloadRange& range : checkpoint.ranges) {
+    RangeState state;
+    state.range = range;
+    ranges_.push_back(std::move(state));
+    received_bytes += range.received;
+  }
+
+  owner_->ApplyTaskInfo(TaskInfo(total_bytes_, -1, nil, nil));
+  owner_->OnDataWritten(received_bytes);
+  reported_bytes_ = received_bytes;
+
+  for (size_t index = 0; index < ranges_.size(); ++index) {
+    if (!ranges_[index].range.IsComplete())
+      StartRange(index);
+  }
+
+  MaybeFinish();
+}
+
+RangedSession::~RangedSession() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  CancelSession();
+
+  // Close the file on the background sequence if it is still open. This
+  // is a best effort.
+  if (file_.has_value()) {
+    base::File file = take(file_);
+    task_runner_->PostTask(FROM_HERE,
+                           base::BindOnce(&CloseFile, std::move(file)));
+  }
+}
+
+void RangedSession::StartRange(size_t index) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  DCHECK(session_);
+
+  RangeState& state = ranges_[index];
+  DCHECK(!state.range.IsComplete());
+
+  NSMutableURLRequest* request =
+      [[NSMutableURLRequest alloc] initWithURL:net::NSURLWithGURL(url_)];
+  request.HTTPMethod = @"GET";
+
+  NSString* header = base::SysUTF8ToNSString(net::HttpRequestHeaders::kRange);
+  NSString* value = base::SysUTF8ToNSString(GetRangeHeaderValue(state.range));
+  [request setValue:value forHTTPHeaderField:header];
+
+  if (!validator_.empty()) {
+    [request setValue:base::SysUTF8ToNSString(validator_)
+        forHTTPHeaderField:base::SysUTF8ToNSString(
+                               net::HttpRequestHeaders::kIfRange)];
+  }
+
+  state.response_checked = false;
+  state.task = [session_ dataTaskWithRequest:request];
+  [state.task resume];
+}
+
+absl::optional<size_t> RangedSession::FindRange(NSURLSessionTask* task) const {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (!task)
+    return absl::nullopt;
+
+  for (size_t index = 0; index < ranges_.size(); ++index) {
+    if (ranges_[index].task == task)
+      return index;
+  }
+  return absl::nullopt;
+}
+
+bool RangedSession::CheckResponse(size_t index, NSURLSessionTask* task) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  NSHTTPURLResponse* response =
+      base::mac::ObjCCast<NSHTTPURLResponse>(task.response);
+
+  const bool is_partial = response.statusCode == 206;
+  scoped_refptr<net::HttpResponseHeaders> headers;
+  int64_t first_byte = -1;
+  int64_t last_byte = -1;
+  int64_t length = -1;
+  if (is_partial) {
+    headers = net::CreateHeadersFromNSHTTPURLResponse(response);
+    if (!headers->GetContentRangeFor206(&first_byte, &last_byte, &length) ||
+        first_byte != ranges_[index].range.offset() || length <= 0) {
+      return false;
+    }
+  }
+
+  // Once the download is resumable, all the responses must be ranges of the
+  // same resource. The server answers with the whole resource if it no
+  // longer matches the If-Range validator.
+  if (resumable_) {
+    if (response.statusCode == 200) {
+      RestartFromFullResponse(index);
+      return true;
+    }
+    return is_partial && length == total_bytes_;
+  }
+
+  // The server ignored the Range header, continue as a sequential download.
+  DCHECK_EQ(0u, index);
+  if (!is_partial)
+    return true;
+
+  // Without a validator, the other requests may fetch another version of the
+  // resource, so the download stays sequential.
+  validator_ = GetRangeValidator(*headers);
+  if (validator_.empty())
+    return true;
+
+  resumable_ = true;
+  total_bytes_ = length;
+  ranges_[index].range.end = length;
+
+  // Preallocate the file, so that the ranges can be written at their offset
+  // and that its size identifies a resumable download.
+  pending_file_length_ = total_bytes_;
+
+  if (total_bytes_ >= kMinRangedDownloadSize)
+    SplitRanges();
+
+  return true;
+}
+
+void RangedSession::SplitRanges() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  DCHECK_EQ(1u, ranges_.size());
+  DCHECK_EQ(0, ranges_[0].range.received);
+
+  std::vector<DownloadRange> ranges =
+      SplitDownloadRanges(total_bytes_, kRangedDownloadRangeCount);
+  ranges_[0].range.end = ranges[0].end;
+  for (size_t index = 1; index < ranges.size(); ++index) {
+    RangeState state;
+    state.range = ranges[index];
+    ranges_.push_back(std::move(state));
+    StartRange(index);
+  }
+}
+
+void RangedSession::ApplyTaskInfo(const TaskInfo& task_info) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+  // The responses of the ranges are partial responses of the same resource,
+  // which the DownloadTask reports as a single complete response.
+  const int http_code =
+      task_info.http_error_code() == 206 ? 200 : task_info.http_error_code();
+  if (!resumable_) {
+    owner_->ApplyTaskInfo(TaskInfo(task_info.total_bytes(), http_code,
+                                   task_info.mime_type(), nil));
+    return;
+  }
+
+  owner_->ApplyTaskInfo(
+      TaskInfo(total_bytes_, http_code, task_info.mime_type(), nil));
+}
+
+void RangedSession::DataReceived(NSData* data, TaskInfo task_info) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  DCHECK(data);
+
+  // Ignore the data of the tasks which have been cancelled or restarted.
+  absl::optional<size_t> index = FindRange(task_info.task());
+  if (!index.has_value() || error_code_.has_value())
+    return;
+
+  if (!ranges_[*index].response_checked) {
+    if (!CheckResponse(*index, task_info.task())) {
+      // The resource has changed, so the data written can't be resumed.
+      resumable_ = false;
+      Fail(net::ERR_FAILED);
+      return;
+    }
+
+    // The download may have restarted from the response.
+    index = FindRange(task_info.task());
+    DCHECK(index.has_value());
+    ranges_[*index].response_checked = true;
+  }
+
+  // The request of the first range may extend past its end.
+  RangeState& state = ranges_[*index];
+  NSUInteger length = data.length;
+  if (state.range.end != -1) {
+    length = base::checked_cast<NSUInteger>(std::min<int64_t>(
+        length, state.range.end - state.range.offset()));
+  }
+  if (length != 0) {
+    if (length != data.length)
+      data = [data subdataWithRange:NSMakeRange(0, length)];
+    pending_.push_back(RangeWrite{state.range.offset(), data});
+    state.range.received += length;
+  }
+
+  if (state.range.IsComplete()) {
+    [state.task cancel];
+    state.task = nil;
+  }
+
+  ApplyTaskInfo(task_info);
+  WritePendingData();
+}
+
+void RangedSession::TaskFinished(int error_code, TaskInfo task_info) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+  absl::optional<size_t> index = FindRange(task_info.task());
+  if (!index.has_value() || error_code_.has_value())
+    return;
+
+  ApplyTaskInfo(task_info);
+
+  RangeState& state = ranges_[*index];
+  state.task = nil;
+
+  if (error_code == net::OK) {
+    if (!resumable_) {
+      // The size of a sequential download is known once it is complete.
+      state.range.end = state.range.offset();
+    } else if (!state.range.IsComplete()) {
+      error_code = net::ERR_CONTENT_LENGTH_MISMATCH;
+    }
+  }
+
+  if (error_code != net::OK) {
+    if (resumable_ && IsRetryableRangeError(error_code) &&
+        state.retry_count < kMaxRangeRetryCount) {
+      ++state.retry_count;
+      StartRange(*index);
+      return;
+    }
+
+    Fail(error_code);
+    return;
+  }
+
+  MaybeFinish();
+}
+
+void RangedSession::RestartFromFullResponse(size_t index) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  DCHECK(resumable_);
+
+  RangeState state;
+  state.task = ranges_[index].task;
+  ranges_[index].task = nil;
+  for (RangeState& other : ranges_)
+    [other.task cancel];
+  ranges_.clear();
+  ranges_.push_back(std::move(state));
+
+  resumable_ = false;
+  total_bytes_ = -1;
+  validator_.clear();
+
+  // Drop the data of the previous version of the resource: the file is
+  // truncated before the next writes, the writes in progress are not
+  // counted, and the checkpoint is deleted once they are done.
+  pending_.clear();
+  pending_file_length_ = 0;
+  ++write_generation_;
+  owner_->OnDataWritten(-reported_bytes_);
+  reported_bytes_ = 0;
+  task_runner_->PostTask(
+      FROM_HERE, base::BindOnce(base::IgnoreResult(&base::DeleteFile),
+                                checkpoint_path_));
+}
+
+void RangedSession::DataWritten(int write_generation,
+                                WriteDataResult result) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  DCHECK(!file_.has_value());
+
+  if (!result.file.IsValid()) {
+    // The checkpoint saved with the previous writes is kept, so that the
+    // download can resume once the error (e.g. lack of disk space) is fixed.
+    CancelSession();
+    finished_ = true;
+
+    int error_code = net::FileErrorToNetError(result.file.error_details());
+    owner_->OnDownloadFinished(DownloadResult(error_code));
+    return;
+  }
+
+  file_ = std::move(result.file);
+  WritePendingData();
+
+  // See Session::DataWritten() for why this is done before notifying the
+  // DownloadSessionTaskImpl of the progress.
+  MaybeFinish();
+
+  if (write_generation == write_generation_) {
+    reported_bytes_ += result.bytes_written;
+    owner_->OnDataWritten(result.bytes_written);
+  }
+  owner_->OnDownloadUpdated();
+}
+
+void RangedSession::WritePendingData() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (!file_.has_value() || (pending_.empty() && pending_file_length_ == -1))
+    return;
+
+  std::vector<RangeWrite> writes;
+  std::swap(writes, pending_);
+
+  // The checkpoint accounts for all the data received, which is either
+  // already written or part of this batch. It is only saved periodically, as
+  // saving it syncs to the disk.
+  std::string checkpoint;
+  if (resumable_) {
+    for (const RangeWrite& write : writes)
+      unsaved_checkpoint_bytes_ += write.data.length;
+    const base::TimeTicks now = base::TimeTicks::Now();
+    if (unsaved_checkpoint_bytes_ >= kCheckpointIntervalBytes ||
+        now - last_checkpoint_time_ >= kCheckpointInterval) {
+      checkpoint = SerializeDownloadCheckpoint(GetCheckpoint());
+      unsaved_checkpoint_bytes_ = 0;
+      last_checkpoint_time_ = now;
+    }
+  }
+
+  const int64_t file_length = std::exchange(pending_file_length_, -1);
+
+  task_runner_->PostTaskAndReplyWithResult(
+      FROM_HERE,
+      base::BindOnce(&WriteRangesHelper, take(file_), std::move(writes),
+                     file_length, checkpoint_path_, std::move(checkpoint)),
+      base::BindOnce(&RangedSession::DataWritten, weak_factory_.GetWeakPtr(),
+                     write_generation_));
+}
+
+void RangedSession::Fail(int error_code) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  DCHECK_NE(net::OK, error_code);
+  DCHECK(!error_code_.has_value());
+
+  error_code_ = error_code;
+  CancelSession();
+  MaybeFinish();
+}
+
+void RangedSession::MaybeFinish() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (finished_ || !file_.has_value() || !pending_.empty() ||
+      pending_file_length_ != -1) {
+    return;
+  }
+
+  if (!error_code_.has_value()) {
+    for (const RangeState& state : ranges_) {
+      if (!state.range.IsComplete())
+        return;
+    }
+  }
+
+  finished_ = true;
+  CancelSession();
+
+  // The checkpoint is only kept if the download can be resumed, in which case
+  // it is saved with all the data written if it wasn't already.
+  const int error_code = error_code_.value_or(net::OK);
+  const bool delete_checkpoint = error_code == net::OK || !resumable_;
+  std::string checkpoint;
+  if (!delete_checkpoint && unsaved_checkpoint_bytes_ != 0)
+    checkpoint = SerializeDownloadCheckpoint(GetCheckpoint());
+  unsaved_checkpoint_bytes_ = 0;
+  task_runner_->PostTaskAndReply(
+      FROM_HERE,
+      base::BindOnce(&CloseRangedFile, take(file_), checkpoint_path_,
+                     delete_checkpoint, std::move(checkpoint)),
+      base::BindOnce(&DownloadSessionTaskImpl::OnDownloadFinished,
+                     owner_->weak_factory_.GetWeakPtr(),
+                     DownloadResult(error_code)));
+}
+
+DownloadCheckpoint RangedSession::GetCheckpoint() const {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  DCHECK(resumable_);
+
+  DownloadCheckpoint checkpoint;
+  checkpoint.url = url_;
+  checkpoint.total_bytes = total_bytes_;
+  checkpoint.validator = validator_;
+  for (const RangeState& state : ranges_)
+    checkpoint.ranges.push_back(state.range);
+  return checkpoint;
+}
+
+void RangedSession::CancelSession() {
+  // See Session::CancelSession() for the order of the calls.
+  [delegate_ stop];
+  delegate_ = nil;
+
+  [session_ invalidateAndCancel];
+  session_ = nil;
+
+  for (RangeState& state : ranges_) {
+    [state.task cancel];
+    state.task = nil;
+  }
+}
+
 }  // namespace internal
 }  // namespace download
 
@@ -599,6 +1391,15 @@ DownloadSessionTaskImpl::DownloadSessionTaskImpl(
 DownloadSessionTaskImpl::~DownloadSessionTaskImpl() {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
   CancelInternal();
+
+  // The download can no longer be resumed, as the partially downloaded file
+  // is deleted by DownloadTaskImpl, so delete its checkpoint if any (it is
+  // not an error to delete a non-existent file).
+  if (use_ranges_ && !path_.empty()) {
+    task_runner_->PostTask(
+        FROM_HERE, base::BindOnce(base::IgnoreResult(&base::DeleteFile),
+                                  download::GetDownloadCheckpointPath(path_)));
+  }
 }
 
 void DownloadSessionTaskImpl::StartInternal(const base::FilePath& path) {
@@ -608,27 +1409,46 @@ void DownloadSessionTaskImpl::StartInternal(const base::FilePath& path) {
   // Ensure that any previous session has been invalidated.
   CancelInternal();
 
-  using download::internal::CreateFile;
+  use_ranges_ = ShouldUseRanges();
+
+  using download::internal::OpenDownloadFile;
   task_runner_->PostTaskAndReplyWithResult(
-      FROM_HERE, base::BindOnce(&CreateFile, path),
+      FROM_HERE,
+      base::BindOnce(&OpenDownloadFile, path, GetOriginalUrl(), use_ranges_),
       base::BindOnce(&DownloadSessionTaskImpl::OnFileCreated,
                      weak_factory_.GetWeakPtr()));
 }
 
+bool DownloadSessionTaskImpl::ShouldKeepExistingFile() const {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  // The file is kept so that OpenDownloadFile() can resume the download from
+  // its checkpoint, or else overwrites it.
+  return ShouldUseRanges();
+}
+
 void DownloadSessionTaskImpl::CancelInternal() {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
   weak_factory_.InvalidateWeakPtrs();
   session_.reset();
+  ranged_session_.reset();
+}
+
+bool DownloadSessionTaskImpl::ShouldUseRanges() const {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  // Splitting the request in ranges is only safe for idempotent requests.
+  return base::FeatureList::IsEnabled(features::kParallelRangedDownloads) &&
+         [GetHttpMethod() isEqualToString:@"GET"];
 }
 
-void DownloadSessionTaskImpl::OnFileCreated(base::File file) {
+void DownloadSessionTaskImpl::OnFileCreated(
+    download::internal::DownloadFile download_file) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
 
-  if (!file.IsValid()) {
+  if (!download_file.file.IsValid()) {
     // Calling `OnDownloadFinished()` may cause the task to be deleted,
     // so this must no longer be accessed after that point.
-    OnDownloadFinished(
-        DownloadResult(net::FileErrorToNetError(file.error_details())));
+    OnDownloadFinished(DownloadResult(
+        net::FileErrorToNetError(download_file.file.error_details())));
 
     return;
   }
@@ -645,20 +1465,29 @@ void DownloadSessionTaskImpl::OnFileCreated(base::File file) {
           base::BindPostTask(
               base::SequencedTaskRunnerHandle::Get(),
               base::BindOnce(&DownloadSessionTaskImpl::OnCookiesFetched,
-                             weak_factory_.GetWeakPtr(), std::move(file)))));
+                             weak_factory_.GetWeakPtr(),
+                             std::move(download_file)))));
 }
 
 void DownloadSessionTaskImpl::OnCookiesFetched(
-    base::File file,
+    download::internal::DownloadFile download_file,
     NSArray<NSHTTPCookie*>* cookies) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
-  DCHECK(file.IsValid());
-
-  // Creating the Session object automatically starts the download.
-  using download::internal::Session;
-  session_ = std::make_unique<Session>(
-      std::move(file), GetOriginalUrl(), GetIdentifier(), GetHttpMethod(),
-      cookies, session_factory_, task_runner_, this);
+  DCHECK(download_file.file.IsValid());
+
+  // Creating the Session or RangedSession object automatically starts the
+  // download.
+  if (use_ranges_) {
+    using download::internal::RangedSession;
+    ranged_session_ = std::make_unique<RangedSession>(
+        std::move(download_file), path_, GetOriginalUrl(), GetIdentifier(),
+        cookies, session_factory_, task_runner_, this);
+  } else {
+    using download::internal::Session;
+    session_ = std::make_unique<Session>(
+        std::move(download_file.file), GetOriginalUrl(), GetIdentifier(),
+        GetHttpMethod(), cookies, session_factory_, task_runner_, this);
+  }
 
   OnDownloadUpdated();
 }
@@ -8,12 +8,19 @@
 #import <WebKit/WebKit.h>
 
 #import <memory>
+#import <string>
 
 #import "base/bind.h"
 #import "base/files/file_util.h"
 #import "base/files/scoped_temp_dir.h"
+#import "base/run_loop.h"
+#import "base/strings/sys_string_conversions.h"
 #import "base/task/task_traits.h"
 #import "base/task/thread_pool.h"
+#import "base/test/ios/wait_util.h"
+#import "base/test/scoped_feature_list.h"
+#import "ios/web/common/features.h"
+#import "ios/web/download/download_ranges.h"
 #import "ios/web/net/cookies/wk_cookie_util.h"
 #import "ios/web/public/test/download_task_test_util.h"
 #import "ios/web/public/test/fakes/fake_browser_state.h"
@@ -44,6 +51,25 @@ const char kMimeType[] = "application/pdf";
 const base::FilePath::CharType kTestFileName[] = FILE_PATH_LITERAL("file.test");
 NSString* const kHttpMethod = @"POST";
 
+// Size of a ranged download large enough to be split in ranges, and size of
+// each of its ranges.
+const int64_t kSplitDownloadSize = 4 * 1024 * 1024;
+const int64_t kSplitRangeSize = kSplitDownloadSize / 4;
+
+// Validator of the resource of the ranged downloads.
+NSString* const kETag = @"\"v1\"";
+
+// Returns `size` bytes of `value`.
+NSData* CreateData(int64_t size, char value) {
+  const std::string data(size, value);
+  return [NSData dataWithBytes:data.data() length:data.size()];
+}
+
+// Returns the UTF-8 bytes of `string`.
+NSData* CreateData(NSString* string) {
+  return [string dataUsingEncoding:NSUTF8StringEncoding];
+}
+
 }  //  namespace
 
 // Test fixture for testing DownloadTaskImplTest class.
@@ -496,4 +522,308 @@ TEST_F(DownloadSessionTaskImplTest, DownloadTaskDestruction) {
   EXPECT_TRUE(session_task.state = NSURLSessionTaskStateCanceling);
 }
 
+// Test fixture for testing the ranged downloads of DownloadSessionTaskImpl.
+class DownloadSessionTaskImplRangesTest : public DownloadSessionTaskImplTest {
+ protected:
+  DownloadSessionTaskImplRangesTest() {
+    scoped_feature_list_.InitAndEnableFeature(
+        features::kParallelRangedDownloads);
+    task_ = std::make_unique<DownloadSessionTaskImpl>(
+        &web_state_, GURL(kUrl), @"GET", kContentDisposition,
+        /*total_bytes=*/-1, kMimeType, [[NSUUID UUID] UUIDString],
+        base::ThreadPool::CreateSequencedTaskRunner(
+            {base::MayBlock(), base::TaskPriority::USER_BLOCKING}),
+        base::BindRepeating(
+            &DownloadSessionTaskImplRangesTest::CreateRangedSession,
+            base::Unretained(this)));
+  }
+
+  void SetUp() override {
+    DownloadSessionTaskImplTest::SetUp();
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    path_ = temp_dir_.GetPath().Append(kTestFileName);
+  }
+
+  // Starts the download to `path_`.
+  void StartRanged() {
+    web::test::WaitDownloadTaskUpdated observer(task_.get());
+    task_->Start(path_);
+    observer.Wait();
+  }
+
+  // Returns the value of the header `name` of the request at `index`.
+  NSString* GetHeader(NSUInteger index, NSString* name) {
+    return [requests_[index] valueForHTTPHeaderField:name];
+  }
+
+  // Sets the response of `task` to a 206 with `content_range`.
+  void SetPartialResponse(CRWFakeNSURLSessionTask* task,
+                          NSString* content_range,
+                          int64_t length) {
+    task.countOfBytesExpectedToReceive = length;
+    task.response = [[NSHTTPURLResponse alloc]
+         initWithURL:[NSURL URLWithString:@(kUrl)]
+          statusCode:206
+         HTTPVersion:@"HTTP/1.1"
+        headerFields:@{@"Content-Range" : content_range, @"ETag" : kETag}];
+  }
+
+  // Calls URLSession:dataTask:didReceiveData: with `data` and waits for it
+  // to be written.
+  void SimulateRangeData(CRWFakeNSURLSessionTask* task, NSData* data) {
+    web::test::WaitDownloadTaskUpdated observer(task_.get());
+    dispatch_async(session_delegate_callbacks_queue_, ^{
+      [session_delegate() URLSession:session()
+                            dataTask:task
+                      didReceiveData:data];
+    });
+    observer.Wait();
+  }
+
+  // Fails `task` with a transient network error, and waits for the request
+  // to be restarted.
+  void SimulateConnectionLost(CRWFakeNSURLSessionTask* task) {
+    const NSUInteger count = tasks_.count;
+    NSError* error = [NSError errorWithDomain:NSURLErrorDomain
+                                         code:NSURLErrorNetworkConnectionLost
+                                     userInfo:nil];
+    dispatch_async(session_delegate_callbacks_queue_, ^{
+      [session_delegate() URLSession:session()
+                                task:task
+                didCompleteWithError:error];
+    });
+    ASSERT_TRUE(base::test::ios::WaitUntilConditionOrTimeout(
+        base::test::ios::kWaitForDownloadTimeout, ^bool {
+          base::RunLoop().RunUntilIdle();
+          return tasks_.count > count;
+        }));
+  }
+
+  // Waits until the download is done.
+  void WaitUntilDone() {
+    if (task_->IsDone())
+      return;
+    web::test::WaitDownloadTaskDone observer(task_.get());
+    observer.Wait();
+  }
+
+  // Saves the file and checkpoint of a download of "0123456789" interrupted
+  // after receiving "0123456".
+  void CreateCheckpoint() {
+    download::DownloadCheckpoint checkpoint;
+    checkpoint.url = GURL(kUrl);
+    checkpoint.total_bytes = 10;
+    checkpoint.validator = base::SysNSStringToUTF8(kETag);
+    checkpoint.ranges = download::SplitDownloadRanges(10, 2);
+    checkpoint.ranges[0].received = 5;
+    checkpoint.ranges[1].received = 2;
+    ASSERT_TRUE(base::WriteFile(path_, std::string("0123456\0\0\0", 10)));
+    ASSERT_TRUE(base::WriteFile(download::GetDownloadCheckpointPath(path_),
+                                download::SerializeDownloadCheckpoint(
+                                    checkpoint)));
+  }
+
+  // Returns the content of the download file.
+  std::string GetFileContent() {
+    std::string content;
+    EXPECT_TRUE(base::ReadFileToString(path_, &content));
+    return content;
+  }
+
+  NSURLSession* CreateRangedSession(NSURLSessionConfiguration* configuration,
+                                    id<NSURLSessionDataDelegate> delegate) {
+    session_ = OCMStrictClassMock([NSURLSession class]);
+    session_configuration_ = configuration;
+    session_delegate_ = delegate;
+
+    // Return a new fake NSURLSessionDataTask for each request.
+    NSMutableArray<NSURLRequest*>* requests = requests_;
+    NSMutableArray<CRWFakeNSURLSessionTask*>* tasks = tasks_;
+    OCMStub([session_ dataTaskWithRequest:[OCMArg any]])
+        .andDo(^(NSInvocation* invocation) {
+          __unsafe_unretained NSURLRequest* request = nil;
+          [invocation getArgument:&request atIndex:2];
+          CRWFakeNSURLSessionTask* task =
+              [[CRWFakeNSURLSessionTask alloc] initWithURL:request.URL];
+          [requests addObject:request];
+          [tasks addObject:task];
+
+          __unsafe_unretained CRWFakeNSURLSessionTask* result = task;
+          [invocation setReturnValue:&result];
+        });
+    OCMStub([session_ configuration]).andReturn(session_configuration_);
+    OCMStub([session_ invalidateAndCancel]);
+
+    return session_;
+  }
+
+  base::test::ScopedFeatureList scoped_feature_list_;
+  base::ScopedTempDir temp_dir_;
+  base::FilePath path_;
+  // Requests of the tasks returned by the NSURLSession, in order.
+  NSMutableArray<NSURLRequest*>* requests_ = [NSMutableArray array];
+  NSMutableArray<CRWFakeNSURLSessionTask*>* tasks_ = [NSMutableArray array];
+};
+
+// Tests that a large download is split in ranges fetched in parallel, which
+// are written at their offset.
+TEST_F(DownloadSessionTaskImplRangesTest, Split) {
+  StartRanged();
+  ASSERT_EQ(1u, tasks_.count);
+  EXPECT_NSEQ(@"bytes=0-", GetHeader(0, @"Range"));
+  EXPECT_FALSE(GetHeader(0, @"If-Range"));
+
+  // The first response splits the download.
+  SetPartialResponse(tasks_[0],
+                     [NSString stringWithFormat:@"bytes 0-%lld/%lld",
+                                                kSplitDownloadSize - 1,
+                                                kSplitDownloadSize],
+                     kSplitDownloadSize);
+  SimulateRangeData(tasks_[0], CreateData(kSplitRangeSize, 'a'));
+  ASSERT_EQ(4u, tasks_.count);
+  for (NSUInteger index = 1; index < tasks_.count; ++index) {
+    const int64_t start = index * kSplitRangeSize;
+    EXPECT_NSEQ([NSString stringWithFormat:@"bytes=%lld-%lld", start,
+                                           start + kSplitRangeSize - 1],
+                GetHeader(index, @"Range"));
+    EXPECT_NSEQ(kETag, GetHeader(index, @"If-Range"));
+  }
+  EXPECT_EQ(DownloadTask::State::kInProgress, task_->GetState());
+  EXPECT_EQ(kSplitDownloadSize, task_->GetTotalBytes());
+  EXPECT_EQ(kSplitRangeSize, task_->GetReceivedBytes());
+  EXPECT_EQ(25, task_->GetPercentComplete());
+  EXPECT_EQ(200, task_->GetHttpCode());
+  EXPECT_TRUE(base::PathExists(download::GetDownloadCheckpointPath(path_)));
+
+  // The first range is complete, so its request is cancelled.
+  EXPECT_EQ(NSURLSessionTaskStateCanceling, tasks_[0].state);
+
+  // Receive the other ranges in reverse order.
+  const char kValues[] = {'a', 'b', 'c', 'd'};
+  for (NSUInteger index = tasks_.count - 1; index > 0; --index) {
+    const int64_t start = index * kSplitRangeSize;
+    SetPartialResponse(
+        tasks_[index],
+        [NSString stringWithFormat:@"bytes %lld-%lld/%lld", start,
+                                   start + kSplitRangeSize - 1,
+                                   kSplitDownloadSize],
+        kSplitRangeSize);
+    SimulateRangeData(tasks_[index],
+                      CreateData(kSplitRangeSize, kValues[index]));
+  }
+  WaitUntilDone();
+
+  EXPECT_EQ(DownloadTask::State::kComplete, task_->GetState());
+  EXPECT_EQ(0, task_->GetErrorCode());
+  EXPECT_EQ(kSplitDownloadSize, task_->GetReceivedBytes());
+  EXPECT_EQ(100, task_->GetPercentComplete());
+  std::string expected_content;
+  for (char value : kValues)
+    expected_content += std::string(kSplitRangeSize, value);
+  EXPECT_EQ(expected_content, GetFileContent());
+  EXPECT_FALSE(base::PathExists(download::GetDownloadCheckpointPath(path_)));
+}
+
+// Tests that the request of a range failing with a transient network error
+// is restarted from the first byte not received.
+TEST_F(DownloadSessionTaskImplRangesTest, Retry) {
+  StartRanged();
+  ASSERT_EQ(1u, tasks_.count);
+  SetPartialResponse(tasks_[0], @"bytes 0-9/10", 10);
+  SimulateRangeData(tasks_[0], CreateData(@"01234"));
+
+  SimulateConnectionLost(tasks_[0]);
+  ASSERT_EQ(2u, tasks_.count);
+  EXPECT_NSEQ(@"bytes=5-9", GetHeader(1, @"Range"));
+  EXPECT_NSEQ(kETag, GetHeader(1, @"If-Range"));
+  EXPECT_EQ(DownloadTask::State::kInProgress, task_->GetState());
+  EXPECT_EQ(5, task_->GetReceivedBytes());
+
+  SetPartialResponse(tasks_[1], @"bytes 5-9/10", 5);
+  SimulateRangeData(tasks_[1], CreateData(@"56789"));
+  WaitUntilDone();
+
+  EXPECT_EQ(DownloadTask::State::kComplete, task_->GetState());
+  EXPECT_EQ(0, task_->GetErrorCode());
+  EXPECT_EQ(10, task_->GetReceivedBytes());
+  EXPECT_EQ("0123456789", GetFileContent());
+  EXPECT_FALSE(base::PathExists(download::GetDownloadCheckpointPath(path_)));
+}
+
+// Tests that a download resumes from its checkpoint, only requesting the
+// bytes not received yet.
+TEST_F(DownloadSessionTaskImplRangesTest, ResumeFromCheckpoint) {
+  CreateCheckpoint();
+  StartRanged();
+  ASSERT_EQ(1u, tasks_.count);
+  EXPECT_NSEQ(@"bytes=7-9", GetHeader(0, @"Range"));
+  EXPECT_NSEQ(kETag, GetHeader(0, @"If-Range"));
+  EXPECT_EQ(10, task_->GetTotalBytes());
+  EXPECT_EQ(7, task_->GetReceivedBytes());
+
+  SetPartialResponse(tasks_[0], @"bytes 7-9/10", 3);
+  SimulateRangeData(tasks_[0], CreateData(@"789"));
+  WaitUntilDone();
+
+  EXPECT_EQ(DownloadTask::State::kComplete, task_->GetState());
+  EXPECT_EQ(0, task_->GetErrorCode());
+  EXPECT_EQ(10, task_->GetReceivedBytes());
+  EXPECT_EQ("0123456789", GetFileContent());
+  EXPECT_FALSE(base::PathExists(download::GetDownloadCheckpointPath(path_)));
+}
+
+// Tests that the checkpoint saved when a download fails accounts for all the
+// data written, even if it was not saved with the last writes.
+TEST_F(DownloadSessionTaskImplRangesTest, CheckpointSavedOnFailure) {
+  StartRanged();
+  ASSERT_EQ(1u, tasks_.count);
+  SetPartialResponse(tasks_[0], @"bytes 0-9/10", 10);
+  SimulateRangeData(tasks_[0], CreateData(@"01234"));
+  SimulateRangeData(tasks_[0], CreateData(@"56"));
+
+  NSError* error = [NSError errorWithDomain:NSURLErrorDomain
+                                       code:NSURLErrorNotConnectedToInternet
+                                   userInfo:nil];
+  SimulateDownloadCompletion(tasks_[0], error);
+  WaitUntilDone();
+  EXPECT_NE(0, task_->GetErrorCode());
+
+  std::string data;
+  ASSERT_TRUE(base::ReadFileToString(download::GetDownloadCheckpointPath(path_),
+                                     &data));
+  absl::optional<download::DownloadCheckpoint> checkpoint =
+      download::ParseDownloadCheckpoint(data);
+  ASSERT_TRUE(checkpoint.has_value());
+  ASSERT_EQ(1u, checkpoint->ranges.size());
+  EXPECT_EQ(7, checkpoint->ranges[0].received);
+  EXPECT_EQ("0123456", GetFileContent().substr(0, 7));
+}
+
+// Tests that a resumed download restarts from scratch if the resource has
+// changed, i.e. if the server answers the If-Range request with a 200.
+TEST_F(DownloadSessionTaskImplRangesTest, RestartIfResourceChanged) {
+  CreateCheckpoint();
+  StartRanged();
+  ASSERT_EQ(1u, tasks_.count);
+
+  NSData* data = CreateData(@"abcdefghijkl");
+  tasks_[0].countOfBytesExpectedToReceive = data.length;
+  tasks_[0].response =
+      [[NSHTTPURLResponse alloc] initWithURL:[NSURL URLWithString:@(kUrl)]
+                                  statusCode:200
+                                 HTTPVersion:@"HTTP/1.1"
+                                headerFields:@{@"ETag" : @"\"v2\""}];
+  SimulateRangeData(tasks_[0], data);
+  EXPECT_EQ(12, task_->GetTotalBytes());
+  EXPECT_EQ(12, task_->GetReceivedBytes());
+
+  SimulateDownloadCompletion(tasks_[0]);
+  WaitUntilDone();
+
+  EXPECT_EQ(DownloadTask::State::kComplete, task_->GetState());
+  EXPECT_EQ(0, task_->GetErrorCode());
+  EXPECT_EQ("abcdefghijkl", GetFileContent());
+  EXPECT_FALSE(base::PathExists(download::GetDownloadCheckpointPath(path_)));
+}
+
 }  // namespace web
@@ -75,7 +75,8 @@ class DownloadTaskImpl : public DownloadTask {
  private:
   // Needs to be overridden by sub-classes to perform the download. When this
   // method is invoked, `path` is non-empty, its parent directory exists, the
-  // location is writable, but the file does not exist.
+  // location is writable, but the file does not exist (unless
+  // `ShouldKeepExistingFile()` returns true).
   virtual void StartInternal(const base::FilePath& path) = 0;
 
   // Needs to be overridden by sub-classes to clean themselves when the
@@ -87,6 +88,11 @@ class DownloadTaskImpl : public DownloadTask {
   // downloaded file. The default implementation returns an empty string.
   virtual std::string GetSuggestedName() const;
 
+  // Can be overridden by sub-classes to keep the file existing at the
+  // download path when the download starts, e.g. to resume it. The default
+  // implementation returns false, and the file is deleted.
+  virtual bool ShouldKeepExistingFile() const;
+
   // Invoked when UIApplicationWillResignActiveNotification is received.
   void OnAppWillResignActive();
 
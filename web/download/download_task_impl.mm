@@ -51,7 +51,8 @@ struct CreateFileResult {
 
 namespace {
 
-CreateFileResult CreateFileForDownload(base::FilePath path) {
+CreateFileResult CreateFileForDownload(base::FilePath path,
+                                       bool keep_existing_file) {
   if (path.empty()) {
     if (!base::CreateTemporaryFile(&path)) {
       return CreateFileResult(
@@ -71,6 +72,11 @@ CreateFileResult CreateFileForDownload(base::FilePath path) {
     return CreateFileResult(net::ERR_ACCESS_DENIED);
   }
 
+  // The sub-class overwrites or resumes the existing file, if any.
+  if (keep_existing_file) {
+    return CreateFileResult(std::move(path));
+  }
+
   // Try to delete any existing file at `path` (deleting a non-existent
   // file is not an error for `base::DeleteFile(...)`). This is needed
   // as some sub-classes of DownloadTaskImpl fail if the destination
@@ -179,7 +185,8 @@ void DownloadTaskImpl::Start(const base::FilePath& path) {
 
   using download::internal::CreateFileForDownload;
   task_runner_->PostTaskAndReplyWithResult(
-      FROM_HERE, base::BindOnce(&CreateFileForDownload, path),
+      FROM_HERE,
+      base::BindOnce(&CreateFileForDownload, path, ShouldKeepExistingFile()),
       base::BindOnce(&DownloadTaskImpl::OnDownloadFileCreated,
                      weak_factory_.GetWeakPtr()));
 }
@@ -305,6 +312,10 @@ std::string DownloadTaskImpl::GetSuggestedName() const {
   return std::string();
 }
 
+bool DownloadTaskImpl::ShouldKeepExistingFile() const {
+  return false;
+}
+
 void DownloadTaskImpl::OnAppWillResignActive() {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
   if (GetState() == DownloadTask::State::kInProgress) {
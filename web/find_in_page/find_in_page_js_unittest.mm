@@ -84,6 +84,28 @@ class FindInPageJsTest : public WebTestWithWebState {
     return main_frame->GetWebFrameInternal();
   }
 
+  // Searches |query| in the main frame and returns the number of matches, or
+  // -1 if the search failed.
+  double FindInMainFrame(const char* query) {
+    __block double match_count = -1;
+    __block bool message_received = false;
+    std::vector<base::Value> params;
+    params.push_back(base::Value(query));
+    params.push_back(base::Value(kPumpSearchTimeout));
+    main_web_frame()->CallJavaScriptFunctionInContentWorld(
+        kFindInPageSearch, params, content_world_,
+        base::BindOnce(^(const base::Value* result) {
+          if (result && result->is_double())
+            match_count = result->GetDouble();
+          message_received = true;
+        }),
+        base::Seconds(kWaitForJSCompletionTimeout));
+    EXPECT_TRUE(WaitUntilConditionOrTimeout(kWaitForJSCompletionTimeout, ^{
+      return message_received;
+    }));
+    return match_count;
+  }
+
   JavaScriptContentWorld* content_world_;
 };
 
@@ -739,4 +761,33 @@ TEST_F(FindInPageJsTest, MatchBecomesInvisible) {
   }));
 }
 
+// Tests that a query extending the previous one finds the matches among the
+// previous ones, and that the text of the page is collected again once the
+// page has changed.
+TEST_F(FindInPageJsTest, FindExtendedQueryAndMutatedPage) {
+  ASSERT_TRUE(LoadHtml("<p>fo foo fob</p><p id='p'>bar</p>"));
+  ASSERT_TRUE(WaitForWebFramesCount(1));
+
+  EXPECT_EQ(3.0, FindInMainFrame("fo"));
+  EXPECT_EQ(1.0, FindInMainFrame("foo"));
+  EXPECT_EQ(1.0, FindInMainFrame("FOO"));
+  EXPECT_EQ(0.0, FindInMainFrame("fooo"));
+
+  ExecuteJavaScript(@"document.getElementById('p').textContent = 'foo';");
+
+  EXPECT_EQ(2.0, FindInMainFrame("foo"));
+  EXPECT_EQ(4.0, FindInMainFrame("fo"));
+}
+
+// Tests that overlapping occurrences of the query are counted once, as they
+// are highlighted as a single match.
+TEST_F(FindInPageJsTest, FindOverlappingOccurrences) {
+  ASSERT_TRUE(LoadHtml("<span>aaaaa</span>"));
+  ASSERT_TRUE(WaitForWebFramesCount(1));
+
+  EXPECT_EQ(5.0, FindInMainFrame("a"));
+  EXPECT_EQ(2.0, FindInMainFrame("aa"));
+  EXPECT_EQ(1.0, FindInMainFrame("aaa"));
+}
+
 }  // namespace web
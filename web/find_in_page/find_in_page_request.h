@@ -8,6 +8,7 @@
 #include <list>
 #include <map>
 #include <string>
+#include <vector>
 
 #import <Foundation/Foundation.h>
 
@@ -64,15 +65,14 @@ class FindInPageRequest {
   // Returns the number of matches in |frame_id|. If |frame_id| is invalid,
   // then returns -1.
   int GetMatchCountForFrame(const std::string& frame_id);
-  // Sets |match_count| for |frame_id|.
+  // Sets |match_count| for |frame_id|. No-op if |frame_id| is invalid.
   void SetMatchCountForFrame(int match_count, const std::string& frame_id);
 
-  // Removes frame with Id |frame_id| from |frame_order| and
-  // |frame_match_count|. Resets |selected_frame_id| and
+  // Removes frame with Id |frame_id|. Resets |selected_frame_id| and
   // |selected_match_index_in_selected_frame| if the frame with |frame_id|
   // contains the currently selected match.
   void RemoveFrame(const std::string& frame_id);
-  // Adds new frame to |frame_order_| and |frame_match_count_|.
+  // Adds new frame with no matches.
   void AddFrame(WebFrame* web_frame);
 
   // After each frame's Find request has finished, call this method to
@@ -84,6 +84,29 @@ class FindInPageRequest {
   bool AreAllFindResponsesReturned();
 
  private:
+  // Number of matches found in a frame.
+  struct FrameMatches {
+    std::string frame_id;
+    int match_count = 0;
+    // Number of matches in the frames preceding this one in |frames_|.
+    // Computed by UpdateMatchingFrames().
+    int preceding_match_count = 0;
+    // Index in |matching_frames_| of the first frame with matches which is
+    // this one or follows it in |frames_|. Computed by UpdateMatchingFrames().
+    size_t matching_frame_index = 0;
+  };
+  using FrameList = std::list<FrameMatches>;
+
+  // Returns true if |frame_id| contains the currently selected match, false
+  // otherwise.
+  bool IsSelectedFrame(const std::string& frame_id);
+  // Sets |match_count| for |frame|, keeping |total_match_count_| up to date.
+  void SetMatchCount(FrameList::iterator frame, int match_count);
+  // Recomputes |matching_frames_| if match counts changed since the last call,
+  // so that GoToNextMatch() and GoToPreviousMatch() don't have to iterate over
+  // the frames without matches.
+  void UpdateMatchingFrames();
+
   // Unique identifier for each find used to check that it is the most recent
   // find. This ensures that an old find doesn't decrement
   // |pending_frame_calls_count| after it has been reset by the new find.
@@ -93,23 +116,26 @@ class FindInPageRequest {
   NSString* query_ = nil;
   // Counter to keep track of pending frame JavaScript calls.
   int pending_frame_call_count_ = 0;
-  // Holds number of matches found for each frame keyed by frame_id.
-  std::map<std::string, int> frame_match_count_;
-  // List of frame_ids used for sorting matches.
-  std::list<std::string> frame_order_;
-  // Id of frame which has the currently selected match. Set to
-  // frame_order.end() if there is no currently selected match. All matches
-  // from the last find will be highlighted. However, the match at
+  // Frames in the order used for sorting matches, the main frame first.
+  FrameList frames_;
+  // Iterators in |frames_| keyed by frame_id.
+  std::map<std::string, FrameList::iterator> frames_by_id_;
+  // Sum of the match counts of |frames_|.
+  int total_match_count_ = 0;
+  // Frames of |frames_| with matches, in the same order. Only valid if
+  // |matching_frames_need_update_| is false.
+  std::vector<FrameList::iterator> matching_frames_;
+  bool matching_frames_need_update_ = true;
+  // Frame which has the currently selected match. Set to frames_.end() if
+  // there is no currently selected match. All matches from the last find will
+  // be highlighted. However, the match at
   // |selected_match_index_in_selected_frame| will be highlighted in a
   // visually unique manner. This match is referred to as the "selected match"
   // and can be changed with the FindInPageNext and FindInPagePrevious
   // commands.
-  std::list<std::string>::iterator selected_frame_id_ = frame_order_.end();
+  FrameList::iterator selected_frame_ = frames_.end();
   // Index of the currently selected match or -1 if there is none.
   int selected_match_index_in_selected_frame_ = -1;
-  // Returns true if |frame_id| contains the currently selected match, false
-  // otherwise.
-  bool IsSelectedFrame(const std::string& frame_id);
 };
 
 }  // namespace web
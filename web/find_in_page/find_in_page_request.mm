@@ -6,6 +6,7 @@
 
 #import <Foundation/Foundation.h>
 
+#import "base/check.h"
 #import "ios/web/public/js_messaging/web_frame.h"
 
 #if !defined(__has_feature) || !__has_feature(objc_arc)
@@ -21,21 +22,19 @@ FindInPageRequest::~FindInPageRequest() {}
 void FindInPageRequest::Reset(NSString* new_query_,
                               int new_pending_frame_call_count) {
   unique_id_++;
-  selected_frame_id_ = frame_order_.end();
+  selected_frame_ = frames_.end();
   selected_match_index_in_selected_frame_ = -1;
   query_ = [new_query_ copy];
   pending_frame_call_count_ = new_pending_frame_call_count;
-  for (auto& pair : frame_match_count_) {
-    pair.second = 0;
+  for (FrameMatches& frame : frames_) {
+    frame.match_count = 0;
   }
+  total_match_count_ = 0;
+  matching_frames_need_update_ = true;
 }
 
 int FindInPageRequest::GetTotalMatchCount() const {
-  int matches = 0;
-  for (auto pair : frame_match_count_) {
-    matches += pair.second;
-  }
-  return matches;
+  return total_match_count_;
 }
 
 int FindInPageRequest::GetRequestId() const {
@@ -46,125 +45,112 @@ NSString* FindInPageRequest::GetRequestQuery() const {
 }
 
 bool FindInPageRequest::GoToFirstMatch() {
-  for (auto frame_id = frame_order_.begin(); frame_id != frame_order_.end();
-       ++frame_id) {
-    if (frame_match_count_[*frame_id] > 0) {
-      selected_frame_id_ = frame_id;
-      selected_match_index_in_selected_frame_ = 0;
-      return true;
-    }
+  UpdateMatchingFrames();
+  if (matching_frames_.empty()) {
+    return false;
   }
-  return false;
+  selected_frame_ = matching_frames_.front();
+  selected_match_index_in_selected_frame_ = 0;
+  return true;
 }
 
 bool FindInPageRequest::GoToNextMatch() {
-  if (GetTotalMatchCount() == 0) {
+  UpdateMatchingFrames();
+  if (matching_frames_.empty()) {
     return false;
   }
-  // No currently selected match, but there are matches. Move iterator to
-  // beginning. This can happen if a frame containing the currently selected
-  // match is removed from the page.
-  if (selected_frame_id_ == frame_order_.end()) {
-    selected_frame_id_ = frame_order_.begin();
+  // No currently selected match, but there are matches. Select the first
+  // match. This can happen if a frame containing the currently selected match
+  // is removed from the page.
+  if (selected_frame_ == frames_.end()) {
+    return GoToFirstMatch();
   }
 
-  bool next_match_is_in_selected_frame =
-      selected_match_index_in_selected_frame_ + 1 <
-      frame_match_count_[*selected_frame_id_];
-  if (next_match_is_in_selected_frame) {
+  if (selected_match_index_in_selected_frame_ + 1 <
+      selected_frame_->match_count) {
     selected_match_index_in_selected_frame_++;
-  } else {
-    // Since the function returns early if there are no matches, an infinite
-    // loop should not be a risk.
-    do {
-      if (selected_frame_id_ == --frame_order_.end()) {
-        selected_frame_id_ = frame_order_.begin();
-      } else {
-        selected_frame_id_++;
-      }
-    } while (frame_match_count_[*selected_frame_id_] == 0);
-    // Should have found new frame.
-    selected_match_index_in_selected_frame_ = 0;
+    return true;
+  }
+  // The selected frame is at |matching_frame_index| in |matching_frames_| if
+  // it has matches, otherwise it precedes the frame at this index.
+  size_t next_index = selected_frame_->matching_frame_index;
+  if (selected_frame_->match_count > 0) {
+    next_index++;
   }
+  selected_frame_ = matching_frames_[next_index % matching_frames_.size()];
+  selected_match_index_in_selected_frame_ = 0;
   return true;
 }
 
 bool FindInPageRequest::GoToPreviousMatch() {
-  if (GetTotalMatchCount() == 0) {
+  UpdateMatchingFrames();
+  if (matching_frames_.empty()) {
     return false;
   }
-  // No currently selected match, but there are matches. Move iterator to
-  // beginning. This can happen if a frame containing the currently selected
-  // matchs is removed from the page.
-  if (selected_frame_id_ == frame_order_.end()) {
-    selected_frame_id_ = frame_order_.begin();
-  }
-
-  bool previous_match_is_in_selected_frame =
-      selected_match_index_in_selected_frame_ - 1 >= 0;
-  if (previous_match_is_in_selected_frame) {
-    selected_match_index_in_selected_frame_--;
-  } else {
-    // Since the function returns early if there are no matches, an infinite
-    // loop should not be a risk.
-    do {
-      if (selected_frame_id_ == frame_order_.begin()) {
-        selected_frame_id_ = --frame_order_.end();
-      } else {
-        selected_frame_id_--;
-      }
-    } while (frame_match_count_[*selected_frame_id_] == 0);
-    // Should have found new frame.
-    selected_match_index_in_selected_frame_ =
-        frame_match_count_[*selected_frame_id_] - 1;
+  // No currently selected match, but there are matches. Select the match
+  // preceding the first one, i.e. the last match. This can happen if a frame
+  // containing the currently selected match is removed from the page.
+  size_t previous_index = 0;
+  if (selected_frame_ != frames_.end()) {
+    if (selected_match_index_in_selected_frame_ - 1 >= 0) {
+      selected_match_index_in_selected_frame_--;
+      return true;
+    }
+    previous_index = selected_frame_->matching_frame_index;
   }
+  previous_index = (previous_index + matching_frames_.size() - 1) %
+                   matching_frames_.size();
+  selected_frame_ = matching_frames_[previous_index];
+  selected_match_index_in_selected_frame_ = selected_frame_->match_count - 1;
   return true;
 }
 
 int FindInPageRequest::GetMatchCountForFrame(const std::string& frame_id) {
-  if (frame_match_count_.find(frame_id) == frame_match_count_.end()) {
+  auto it = frames_by_id_.find(frame_id);
+  if (it == frames_by_id_.end()) {
     return -1;
   }
-  return frame_match_count_[frame_id];
+  return it->second->match_count;
 }
 
 void FindInPageRequest::SetMatchCountForFrame(int match_count,
                                               const std::string& frame_id) {
-  frame_match_count_[frame_id] = match_count;
+  auto it = frames_by_id_.find(frame_id);
+  if (it == frames_by_id_.end()) {
+    return;
+  }
+  SetMatchCount(it->second, match_count);
 }
 
 int FindInPageRequest::GetMatchCountForSelectedFrame() {
-  if (selected_frame_id_ == frame_order_.end()) {
+  if (selected_frame_ == frames_.end()) {
     return -1;
   }
-  return frame_match_count_[*selected_frame_id_];
+  return selected_frame_->match_count;
 }
 
 void FindInPageRequest::SetMatchCountForSelectedFrame(int match_count) {
-  if (selected_frame_id_ == frame_order_.end()) {
+  if (selected_frame_ == frames_.end()) {
     return;
   }
-  frame_match_count_[*selected_frame_id_] = match_count;
+  SetMatchCount(selected_frame_, match_count);
 }
 
 int FindInPageRequest::GetCurrentSelectedMatchPageIndex() {
   if (selected_match_index_in_selected_frame_ == -1) {
     return -1;
   }
-  // Count all matches in frames that come before frame with id
-  // |selected_frame_id|.
-  int total_match_index = selected_match_index_in_selected_frame_;
-  for (auto it = frame_order_.begin(); it != selected_frame_id_; ++it) {
-    total_match_index += frame_match_count_[*it];
-  }
-  return total_match_index;
+  UpdateMatchingFrames();
+  // Count all matches in frames that come before the selected frame.
+  return selected_frame_->preceding_match_count +
+         selected_match_index_in_selected_frame_;
 }
 
 std::string FindInPageRequest::GetSelectedFrameId() {
-  if (selected_frame_id_ == frame_order_.end()) {
+  if (selected_frame_ == frames_.end()) {
     return std::string();
   }
-  return *selected_frame_id_;
+  return selected_frame_->frame_id;
 }
 
 int FindInPageRequest::GetCurrentSelectedMatchFrameIndex() const {
@@ -176,26 +162,36 @@ void FindInPageRequest::SetCurrentSelectedMatchFrameIndex(int index) {
 }
 
 void FindInPageRequest::RemoveFrame(const std::string& frame_id) {
+  auto it = frames_by_id_.find(frame_id);
+  if (it == frames_by_id_.end()) {
+    return;
+  }
   if (IsSelectedFrame(frame_id)) {
     // If currently selecting match in frame that will become unavailable,
     // there will no longer be a selected match. Reset to unselected match
     // state.
-    selected_frame_id_ = frame_order_.end();
+    selected_frame_ = frames_.end();
     selected_match_index_in_selected_frame_ = -1;
   }
-  frame_order_.remove(frame_id);
-  frame_match_count_.erase(frame_id);
+  total_match_count_ -= it->second->match_count;
+  matching_frames_need_update_ = true;
+  frames_.erase(it->second);
+  frames_by_id_.erase(it);
 }
 
 void FindInPageRequest::AddFrame(WebFrame* web_frame) {
-  frame_match_count_[web_frame->GetFrameId()] = 0;
+  const std::string frame_id = web_frame->GetFrameId();
+  DCHECK(frames_by_id_.find(frame_id) == frames_by_id_.end());
+  FrameMatches frame;
+  frame.frame_id = frame_id;
   if (web_frame->IsMainFrame()) {
     // Main frame matches should show up first.
-    frame_order_.push_front(web_frame->GetFrameId());
+    frames_by_id_[frame_id] = frames_.insert(frames_.begin(), frame);
   } else {
     // The order of iframes is not important.
-    frame_order_.push_back(web_frame->GetFrameId());
+    frames_by_id_[frame_id] = frames_.insert(frames_.end(), frame);
   }
+  matching_frames_need_update_ = true;
 }
 
 void FindInPageRequest::DidReceiveFindResponseFromOneFrame() {
@@ -207,10 +203,37 @@ bool FindInPageRequest::AreAllFindResponsesReturned() {
 }
 
 bool FindInPageRequest::IsSelectedFrame(const std::string& frame_id) {
-  if (selected_frame_id_ == frame_order_.end()) {
+  if (selected_frame_ == frames_.end()) {
     return false;
   }
-  return *selected_frame_id_ == frame_id;
+  return selected_frame_->frame_id == frame_id;
+}
+
+void FindInPageRequest::SetMatchCount(FrameList::iterator frame,
+                                      int match_count) {
+  if (frame->match_count == match_count) {
+    return;
+  }
+  total_match_count_ += match_count - frame->match_count;
+  frame->match_count = match_count;
+  matching_frames_need_update_ = true;
+}
+
+void FindInPageRequest::UpdateMatchingFrames() {
+  if (!matching_frames_need_update_) {
+    return;
+  }
+  matching_frames_.clear();
+  int preceding_match_count = 0;
+  for (auto frame = frames_.begin(); frame != frames_.end(); ++frame) {
+    frame->preceding_match_count = preceding_match_count;
+    frame->matching_frame_index = matching_frames_.size();
+    if (frame->match_count > 0) {
+      matching_frames_.push_back(frame);
+      preceding_match_count += frame->match_count;
+    }
+  }
+  matching_frames_need_update_ = false;
 }
 
 }  // namespace web
@@ -179,4 +179,54 @@ TEST_F(FindInPageRequestTest, SetMatchCountForFrame) {
   EXPECT_EQ(1, request_.GetMatchCountForSelectedFrame());
 }
 
+// Tests that GoToNextMatch() and GoToPreviousMatch() skip the frames without
+// matches, and that the selected match index in the page takes them into
+// account.
+TEST_F(FindInPageRequestTest, SkipFramesWithoutMatches) {
+  auto frame_without_matches = FakeWebFrame::Create(
+      kChildFakeFrameId2, /*is_main_frame=*/false, GURL::EmptyGURL());
+  request_.AddFrame(frame_without_matches.get());
+  request_.SetMatchCountForFrame(0, kChildFakeFrameId2);
+  request_.SetMatchCountForFrame(0, kMainFakeFrameId);
+
+  EXPECT_EQ(2, request_.GetTotalMatchCount());
+  EXPECT_TRUE(request_.GoToFirstMatch());
+  EXPECT_EQ(kChildFakeFrameId, request_.GetSelectedFrameId());
+  EXPECT_EQ(0, request_.GetCurrentSelectedMatchPageIndex());
+
+  request_.GoToNextMatch();
+  request_.GoToNextMatch();
+
+  EXPECT_EQ(kChildFakeFrameId, request_.GetSelectedFrameId());
+  EXPECT_EQ(0, request_.GetCurrentSelectedMatchFrameIndex());
+  EXPECT_EQ(0, request_.GetCurrentSelectedMatchPageIndex());
+
+  // Matches appearing in the last frame are selected after the ones of the
+  // frames preceding it.
+  request_.SetMatchCountForFrame(3, kChildFakeFrameId2);
+  request_.GoToPreviousMatch();
+
+  EXPECT_EQ(kChildFakeFrameId2, request_.GetSelectedFrameId());
+  EXPECT_EQ(2, request_.GetCurrentSelectedMatchFrameIndex());
+  EXPECT_EQ(4, request_.GetCurrentSelectedMatchPageIndex());
+}
+
+// Tests that GoToPreviousMatch() selects the last match of the page if no
+// match is selected.
+TEST_F(FindInPageRequestTest, GoToPreviousWithoutSelectedMatch) {
+  EXPECT_TRUE(request_.GoToPreviousMatch());
+
+  EXPECT_EQ(kChildFakeFrameId, request_.GetSelectedFrameId());
+  EXPECT_EQ(1, request_.GetCurrentSelectedMatchFrameIndex());
+  EXPECT_EQ(2, request_.GetCurrentSelectedMatchPageIndex());
+}
+
+// Tests that match counts of unknown frames are ignored.
+TEST_F(FindInPageRequestTest, SetMatchCountForUnknownFrame) {
+  request_.SetMatchCountForFrame(5, kChildFakeFrameId2);
+
+  EXPECT_EQ(3, request_.GetTotalMatchCount());
+  EXPECT_EQ(-1, request_.GetMatchCountForFrame(kChildFakeFrameId2));
+}
+
 }  // namespace web
@@ -23,11 +23,96 @@ __gCrWeb['findInPage'] = __gCrWeb.findInPage;
 
 /**
  * A string made by concatenating textContent.toLowerCase() of all TEXT nodes
- * within current web page.
+ * within current web page. It is kept between searches, with |sections_|,
+ * until the DOM mutates.
  * @type {string}
  */
 let allText_ = '';
 
+/**
+ * Version of the DOM, incremented when a mutation of the page is observed by
+ * |mutationObserver_|. Mutations made by this file to highlight the matches
+ * are not counted.
+ * @type {number}
+ */
+let domVersion_ = 0;
+
+/**
+ * Version of the DOM |allText_| and |sections_| were built from, or -1 if they
+ * are incomplete.
+ * @type {number}
+ */
+let textVersion_ = -1;
+
+/**
+ * Version of the DOM when the current search started.
+ * @type {number}
+ */
+let searchDomVersion_ = 0;
+
+/**
+ * Observer of the mutations of the page, invalidating |allText_|.
+ * @type {MutationObserver}
+ */
+let mutationObserver_ = null;
+
+/**
+ * The lowercased query of the current search.
+ * @type {string}
+ */
+let query_ = '';
+
+/**
+ * Beginning indices in |allText_| of all the occurrences of |query_|,
+ * including overlapping ones, in increasing order.
+ * @type {Array<number>}
+ */
+let occurrences_ = [];
+
+/**
+ * Occurrences of the previous query, which contain all the occurrences of a
+ * query extending it, or null if the current search scans all of |allText_|.
+ * @type {Array<number>}
+ */
+let candidates_ = null;
+
+/**
+ * The index from which the search of occurrences continues when pumpSearch is
+ * called, in |candidates_| if not null or in |allText_| otherwise.
+ * @type {number}
+ */
+let occurrencesSearchIndex_ = 0;
+
+/**
+ * Whether |occurrences_| is complete.
+ * @type {boolean}
+ */
+let occurrencesFound_ = false;
+
+/**
+ * The index in |occurrences_| from which Matches are created when pumpSearch
+ * is called, and the end of the last Match created. Occurrences overlapping
+ * the last Match are skipped.
+ * @type {number}
+ */
+let occurrencesIndex_ = 0;
+let lastMatchEnd_ = 0;
+
+/**
+ * Whether all the Matches of the current search have been created.
+ * @type {boolean}
+ */
+let matchesCreated_ = false;
+
+/**
+ * The query and occurrences of the last completed search, and the version of
+ * the DOM they were found in. A search for a query extending |lastQuery_|
+ * only checks these occurrences instead of scanning |allText_|.
+ */
+let lastQuery_ = '';
+let lastOccurrences_ = [];
+let lastOccurrencesVersion_ = -1;
+
 /**
  * A Section contains the info of one TEXT node in the |allText_|. The node's
  * textContent is [begin, end) of |allText_|.
@@ -356,12 +441,6 @@ const CSS_STYLE_ID = '__gCrWeb.findInPageStyle';
  */
 const TIMEOUT = -1;
 
-/**
- * Regex to escape regex special characters in a string.
- * @type {RegExp}
- */
-const REGEX_ESCAPER = /([.?*+^$[\]\\(){}|-])/g;
-
 /**
  * @return {Match} The currently selected Match. Returns null if no
  * currently selected match.
@@ -373,16 +452,6 @@ function getCurrentSelectedMatch_() {
   return __gCrWeb.findInPage.matches[selectedMatchIndex_];
 };
 
-/**
- * Creates the regex needed to find the text.
- * @param {string} findText Phrase to look for.
- * @return {RegExp} regex needed to find the text.
- */
-function getRegex_(findText) {
-  let regexString = '(' + escapeRegex_(findText) + ')';
-  return new RegExp(regexString, 'ig');
-};
-
 /**
  * A timer that checks timeout for long tasks.
  */
@@ -411,6 +480,9 @@ class Timer {
   */
 __gCrWeb.findInPage.findString = function(string, timeout) {
   // Enable findInPage module if hasn't been done yet.
+  // Take into account the mutations of the page before the ones below.
+  flushMutations_();
+
   if (!__gCrWeb.findInPage.hasInitialized) {
     enable_();
     __gCrWeb.findInPage.hasInitialized = true;
@@ -425,8 +497,27 @@ __gCrWeb.findInPage.findString = function(string, timeout) {
     return 0;
   }
 
-  // Holds what nodes we have not processed yet.
-  __gCrWeb.findInPage.stack = [document.body];
+  query_ = string.toLowerCase();
+  searchDomVersion_ = domVersion_;
+
+  // Holds what nodes we have not processed yet. The text of the page is only
+  // collected again if it has changed since the previous search.
+  if (textVersion_ == domVersion_) {
+    __gCrWeb.findInPage.stack = [];
+  } else {
+    allText_ = '';
+    sections_ = [];
+    textVersion_ = -1;
+    __gCrWeb.findInPage.stack = [document.body];
+  }
+
+  // If the query extends the previous one, its occurrences are among the ones
+  // of the previous query, so only those need to be checked.
+  candidates_ = null;
+  if (lastOccurrencesVersion_ == domVersion_ && textVersion_ == domVersion_ &&
+      lastQuery_ && query_.startsWith(lastQuery_)) {
+    candidates_ = lastOccurrences_;
+  }
 
   // Number of visible matches found.
   visibleMatchCount_ = 0;
@@ -434,8 +525,6 @@ __gCrWeb.findInPage.findString = function(string, timeout) {
   // Index tracking variables so search can be broken up into multiple calls.
   visibleMatchesCountIndexIterator_ = 0;
 
-  __gCrWeb.findInPage.regex = getRegex_(string);
-
   searchInProgress_ = true;
 
   return __gCrWeb.findInPage.pumpSearch(timeout);
@@ -445,12 +534,14 @@ __gCrWeb.findInPage.findString = function(string, timeout) {
  * Do following steps:
  *   1. Do a DFS in the page, concatenate all TEXT Nodes' content into
  *      |allText_|, and create |sections_| to record which part of |allText_|
- *      belongs to which Node;
- *   2. Do regex match in |allText_| to find all matches, create |replacements_|
- *      for highlighting all results and |matches_| for
- *      highlighting selected result;
- *   3. Execute |replacements_| to highlight all results;
- *   4. Check the visibility of each Match;
+ *      belongs to which Node. This is skipped if the DOM has not changed
+ *      since the previous search;
+ *   2. Find all occurrences of the query in |allText_|, or only among the
+ *      occurrences of the previous query if the query extends it;
+ *   3. Create |replacements_| for highlighting all non-overlapping
+ *      occurrences and |matches_| for highlighting selected result;
+ *   4. Execute |replacements_| to highlight all results;
+ *   5. Check the visibility of each Match;
  *
  * If |timeout| has been reached, the function will return TIMEOUT, and the
  * caller need to call this function again to continue searching. This prevents
@@ -467,6 +558,9 @@ __gCrWeb.findInPage.pumpSearch = function(timeout) {
 
   searchStateIsClean_ = false;
 
+  // A mutation of the page during the search invalidates the text collected.
+  flushMutations_();
+
   let timer = new Timer(timeout);
 
   // Go through every node in DFS fashion.
@@ -496,61 +590,74 @@ __gCrWeb.findInPage.pumpSearch = function(timeout) {
     }
   }
 
-  // Do regex match in |allText_|, create |matches| and |replacements|. The
-  // regex is set on __gCrWeb, so its state is kept between continuous calls on
-  // pumpSearch.
-  let regex = __gCrWeb.findInPage.regex;
-  if (regex) {
-    for (let res; res = regex.exec(allText_);) {
-      // The range of current Match in |allText_| is [begin, end).
-      let begin = res.index;
-      let end = begin + res[0].length;
-      __gCrWeb.findInPage.matches.push(new Match());
-
-      // Find the Section where current Match starts.
-      let oldSectionIndex = sectionsIndex_;
-      let newSectionIndex = findFirstSectionEndsAfter_(begin);
-      // If current Match starts at a new Section, process current Section and
-      // move to the new Section.
-      if (newSectionIndex > oldSectionIndex) {
-        processPartialMatchesInCurrentSection();
-        sectionsIndex_ = newSectionIndex;
-      }
+  if (textVersion_ == -1) {
+    textVersion_ = searchDomVersion_;
+  }
 
-      // Create all PartialMatches of current Match.
-      while (true) {
-        let section = sections_[sectionsIndex_];
-        partialMatches_.push(new PartialMatch(matchId_, Math.max(
-            section.begin, begin), Math.min(section.end, end)));
-        // If current Match.end exceeds current Section.end, process current
-        // Section and move to next Section.
-        if (section.end < end) {
-          processPartialMatchesInCurrentSection();
-          ++sectionsIndex_;
-        } else {
-          // Current Match ends in current Section.
-          break;
-        }
-      }
-      ++matchId_;
+  if (!findOccurrences_(timer)) {
+    return TIMEOUT;
+  }
 
-      if (timer.overtime()) {
-        return TIMEOUT;
+  // Create |matches| and |replacements| for the non-overlapping occurrences,
+  // as a global regex search would find them.
+  while (!matchesCreated_ && occurrencesIndex_ < occurrences_.length) {
+    // The range of current Match in |allText_| is [begin, end).
+    let begin = occurrences_[occurrencesIndex_++];
+    if (begin < lastMatchEnd_) {
+      continue;
+    }
+    let end = begin + query_.length;
+    lastMatchEnd_ = end;
+    __gCrWeb.findInPage.matches.push(new Match());
+
+    // Find the Section where current Match starts.
+    let oldSectionIndex = sectionsIndex_;
+    let newSectionIndex = findFirstSectionEndsAfter_(begin);
+    // If current Match starts at a new Section, process current Section and
+    // move to the new Section.
+    if (newSectionIndex > oldSectionIndex) {
+      processPartialMatchesInCurrentSection();
+      sectionsIndex_ = newSectionIndex;
+    }
+
+    // Create all PartialMatches of current Match.
+    while (true) {
+      let section = sections_[sectionsIndex_];
+      partialMatches_.push(new PartialMatch(matchId_, Math.max(
+          section.begin, begin), Math.min(section.end, end)));
+      // If current Match.end exceeds current Section.end, process current
+      // Section and move to next Section.
+      if (section.end < end) {
+        processPartialMatchesInCurrentSection();
+        ++sectionsIndex_;
+      } else {
+        // Current Match ends in current Section.
+        break;
       }
     }
+    ++matchId_;
+
+    if (timer.overtime()) {
+      return TIMEOUT;
+    }
+  }
+  if (!matchesCreated_) {
     // Process remaining PartialMatches.
     processPartialMatchesInCurrentSection();
-    __gCrWeb.findInPage.regex = undefined;
+    matchesCreated_ = true;
   }
 
   // Execute replacements to highlight search results.
   for (let i = replacementsIndex_; i < replacements_.length; ++i) {
     if (timer.overtime()) {
       replacementsIndex_ = i;
+      discardOwnMutations_();
       return TIMEOUT;
     }
     replacements_[i].doSwap();
   }
+  replacementsIndex_ = replacements_.length;
+  discardOwnMutations_();
 
   let visibleMatchCount = countVisibleMatches_(timer);
 
@@ -559,6 +666,49 @@ __gCrWeb.findInPage.pumpSearch = function(timeout) {
   return visibleMatchCount;
 };
 
+/**
+ * Finds the occurrences of |query_| in |allText_|, among |candidates_| if not
+ * null, and records them for the next search once complete.
+ * @param {Timer} timer used to pause the search if it has taken too long.
+ * @return {boolean} Whether all the occurrences have been found.
+ */
+function findOccurrences_(timer) {
+  if (occurrencesFound_) {
+    return true;
+  }
+
+  if (candidates_) {
+    while (occurrencesSearchIndex_ < candidates_.length) {
+      if (timer.overtime()) {
+        return false;
+      }
+      let begin = candidates_[occurrencesSearchIndex_++];
+      if (allText_.startsWith(query_, begin)) {
+        occurrences_.push(begin);
+      }
+    }
+  } else {
+    while (occurrencesSearchIndex_ <= allText_.length) {
+      if (timer.overtime()) {
+        return false;
+      }
+      let begin = allText_.indexOf(query_, occurrencesSearchIndex_);
+      if (begin < 0) {
+        break;
+      }
+      occurrences_.push(begin);
+      occurrencesSearchIndex_ = begin + 1;
+    }
+  }
+
+  occurrencesFound_ = true;
+  candidates_ = null;
+  lastQuery_ = query_;
+  lastOccurrences_ = occurrences_;
+  lastOccurrencesVersion_ = textVersion_;
+  return true;
+};
+
 /**
  * Counts the total number of visible matches.
  * @param {Timer} used to pause the counting if overall search
@@ -598,11 +748,21 @@ function cleanUp_() {
   for (let i = 0; i < replacements_.length; ++i) {
     replacements_[i].undoSwap();
   }
+  discardOwnMutations_();
 
-  allText_ = '';
-  sections_ = [];
+  // |allText_| and |sections_| are kept, as undoing the replacements restored
+  // the TEXT Nodes they refer to.
   sectionsIndex_ = 0;
 
+  query_ = '';
+  occurrences_ = [];
+  candidates_ = null;
+  occurrencesSearchIndex_ = 0;
+  occurrencesFound_ = false;
+  occurrencesIndex_ = 0;
+  lastMatchEnd_ = 0;
+  matchesCreated_ = false;
+
   __gCrWeb.findInPage.matches = [];
   selectedMatchIndex_ = -1;
   selectedVisibleMatchIndex_ = -1;
@@ -729,6 +889,59 @@ function enable_() {
     return;
   }
   addDocumentStyle_(document);
+  observeMutations_();
+  discardOwnMutations_();
+};
+
+/**
+ * Starts observing the mutations of the page which may change its text.
+ */
+function observeMutations_() {
+  if (mutationObserver_) {
+    return;
+  }
+  mutationObserver_ = new MutationObserver(function() {
+    ++domVersion_;
+  });
+  mutationObserver_.observe(
+      document.body, {childList: true, characterData: true, subtree: true});
+};
+
+/**
+ * Takes into account the mutations of the page not delivered yet to
+ * |mutationObserver_|.
+ */
+function flushMutations_() {
+  if (mutationObserver_ && mutationObserver_.takeRecords().length) {
+    ++domVersion_;
+  }
+};
+
+/**
+ * Drops the mutations made by this file, so that they are not taken as
+ * mutations of the page by |mutationObserver_|.
+ */
+function discardOwnMutations_() {
+  if (mutationObserver_) {
+    mutationObserver_.takeRecords();
+  }
+};
+
+/**
+ * Stops observing the mutations of the page, and drops the text collected as
+ * it can no longer be kept up to date.
+ */
+function disconnectMutations_() {
+  if (mutationObserver_) {
+    mutationObserver_.disconnect();
+    mutationObserver_ = null;
+  }
+  allText_ = '';
+  sections_ = [];
+  textVersion_ = -1;
+  lastQuery_ = '';
+  lastOccurrences_ = [];
+  lastOccurrencesVersion_ = -1;
 };
 
 /**
@@ -775,6 +988,7 @@ __gCrWeb.findInPage.stop = function() {
   if (styleElement_) {
     removeStyle_();
     cleanUp_();
+    disconnectMutations_();
   }
   __gCrWeb.findInPage.hasInitialized = false;
 };
@@ -899,11 +1113,3 @@ function escapeHTML_(text) {
   return unusedDiv.innerHTML;
 };
 
-/**
- * Escapes regexp special characters.
- * @param {string} text Text to escape.
- * @return {string} escaped text.
- */
-function escapeRegex_(text) {
-  return text.replace(REGEX_ESCAPER, '\\$1');
-};
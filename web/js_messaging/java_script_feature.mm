@@ -80,34 +80,40 @@ JavaScriptFeature::FeatureScript::~FeatureScript() = default;
 
 NSString* JavaScriptFeature::FeatureScript::GetScriptString() const {
   NSString* script_filename = base::SysUTF8ToNSString(script_filename_);
+  return GetExpandedPageScript(script_filename, GetPlaceholderReplacements(),
+                               GetInjectionToken());
+}
+
+base::OnceClosure
+JavaScriptFeature::FeatureScript::CreateScriptStringPrewarmClosure() const {
+  return base::BindOnce(
+      [](NSString* script_filename, PlaceholderReplacements replacements,
+         NSString* injection_token) {
+        GetExpandedPageScript(script_filename, replacements, injection_token);
+      },
+      base::SysUTF8ToNSString(script_filename_), GetPlaceholderReplacements(),
+      GetInjectionToken());
+}
+
+JavaScriptFeature::FeatureScript::PlaceholderReplacements
+JavaScriptFeature::FeatureScript::GetPlaceholderReplacements() const {
+  if (replacements_callback_.is_null())
+    return nil;
+  // The replacements are copied as the callback may return a mutable
+  // dictionary.
+  return [replacements_callback_.Run() copy];
+}
+
+NSString* JavaScriptFeature::FeatureScript::GetInjectionToken() const {
   if (reinjection_behavior_ ==
       ReinjectionBehavior::kReinjectOnDocumentRecreation) {
-    return ReplacePlaceholders(GetPageScript(script_filename));
+    return nil;
   }
   // WKUserScript instances will automatically be re-injected by WebKit when the
   // document is re-created, even though the JavaScript context will not be
   // re-created. So the script needs to be wrapped in |MakeScriptInjectableOnce|
   // so that is is not re-injected.
-  return MakeScriptInjectableOnce(
-      InjectionTokenForScript(script_filename),
-      ReplacePlaceholders(GetPageScript(script_filename)));
-}
-
-NSString* JavaScriptFeature::FeatureScript::ReplacePlaceholders(
-    NSString* script) const {
-  if (replacements_callback_.is_null())
-    return script;
-
-  PlaceholderReplacements replacements = replacements_callback_.Run();
-  if (!replacements)
-    return script;
-
-  for (NSString* key in replacements) {
-    script = [script stringByReplacingOccurrencesOfString:key
-                                               withString:replacements[key]];
-  }
-
-  return script;
+  return InjectionTokenForScript(base::SysUTF8ToNSString(script_filename_));
 }
 
 #pragma mark - JavaScriptFeature
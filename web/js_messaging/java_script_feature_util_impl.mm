@@ -6,6 +6,11 @@
 
 #import <Foundation/Foundation.h>
 
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "base/callback.h"
 #include "base/ios/ios_util.h"
 #include "base/logging.h"
 #include "base/no_destructor.h"
@@ -15,6 +20,7 @@
 #include "ios/web/js_features/context_menu/context_menu_java_script_feature.h"
 #include "ios/web/js_features/scroll_helper/scroll_helper_java_script_feature.h"
 #import "ios/web/js_features/window_error/window_error_java_script_feature.h"
+#import "ios/web/js_messaging/page_script_util.h"
 #import "ios/web/js_messaging/script_command_java_script_feature.h"
 #import "ios/web/js_messaging/web_frames_manager_java_script_feature.h"
 #import "ios/web/navigation/navigation_java_script_feature.h"
@@ -116,6 +122,23 @@ JavaScriptFeature* GetShareWorkaroundJavaScriptFeature() {
   return share_workaround_feature.get();
 }
 
+// Adds the closures prewarming the scripts of |feature| and of the features it
+// depends on to |loaders|, skipping the features in |visited_features|.
+void AddScriptPrewarmClosures(
+    const JavaScriptFeature* feature,
+    std::set<const JavaScriptFeature*>* visited_features,
+    std::vector<base::OnceClosure>* loaders) {
+  if (!visited_features->insert(feature).second)
+    return;
+  // The dependencies are injected first.
+  for (const JavaScriptFeature* dependent_feature :
+       feature->GetDependentFeatures()) {
+    AddScriptPrewarmClosures(dependent_feature, visited_features, loaders);
+  }
+  for (const JavaScriptFeature::FeatureScript& script : feature->GetScripts())
+    loaders->push_back(script.CreateScriptStringPrewarmClosure());
+}
+
 }  // namespace
 
 namespace java_script_features {
@@ -190,5 +213,21 @@ JavaScriptFeature* GetMessageJavaScriptFeature() {
   return message_feature.get();
 }
 
+void PrewarmJavaScriptFeatureScripts(BrowserState* browser_state) {
+  DCHECK([NSThread isMainThread]);
+  std::vector<JavaScriptFeature*> features =
+      GetBuiltInJavaScriptFeatures(browser_state);
+  for (JavaScriptFeature* feature :
+       GetWebClient()->GetJavaScriptFeatures(browser_state)) {
+    features.push_back(feature);
+  }
+
+  std::set<const JavaScriptFeature*> visited_features;
+  std::vector<base::OnceClosure> loaders;
+  for (const JavaScriptFeature* feature : features)
+    AddScriptPrewarmClosures(feature, &visited_features, &loaders);
+  PrewarmPageScriptCache(std::move(loaders));
+}
+
 }  // namespace java_script_features
 }  // namespace web
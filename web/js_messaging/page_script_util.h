@@ -7,14 +7,37 @@
 
 #import <Foundation/Foundation.h>
 
+#include <vector>
+
+#include "base/callback.h"
+
 namespace web {
 
 class BrowserState;
 
 // Returns an autoreleased string containing the JavaScript loaded from a
-// bundled resource file with the given name (excluding extension).
+// bundled resource file with the given name (excluding extension). Scripts are
+// cached until the next memory pressure signal, so the file is only read the
+// first time unless it was loaded by a PrewarmPageScriptCache() loader. Thread
+// safe.
 NSString* GetPageScript(NSString* script_file_name);
 
+// Returns the script returned by GetPageScript(|script_file_name|) with each
+// key of |replacements| replaced by its value and, if |injection_token| is not
+// nil, wrapped with MakeScriptInjectableOnce(|injection_token|, ...). Results
+// are cached until the next memory pressure signal, keyed by the file name,
+// the replacements and the injection token. Thread safe.
+NSString* GetExpandedPageScript(
+    NSString* script_file_name,
+    NSDictionary<NSString*, NSString*>* replacements,
+    NSString* injection_token);
+
+// Runs |loaders| in order on a background thread. Each of them calls
+// GetExpandedPageScript() (or GetPageScript()), so that configuring a web view
+// finds the scripts in the cache instead of reading them from disk on the
+// main thread. Must be called on the main thread.
+void PrewarmPageScriptCache(std::vector<base::OnceClosure> loaders);
+
 // Make sure that script is injected only once. For example, content of
 // WKUserScript can be injected into the same page multiple times
 // without notifying WKNavigationDelegate (e.g. after window.document.write
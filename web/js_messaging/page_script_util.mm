@@ -4,10 +4,19 @@
 
 #import "ios/web/js_messaging/page_script_util.h"
 
+#include <utility>
+
+#include "base/bind.h"
+#include "base/callback_helpers.h"
 #include "base/files/file_path.h"
 #include "base/files/file_util.h"
 #include "base/mac/bundle_locations.h"
+#include "base/memory/memory_pressure_listener.h"
+#include "base/no_destructor.h"
 #include "base/strings/sys_string_conversions.h"
+#include "base/synchronization/lock.h"
+#include "base/task/thread_pool.h"
+#include "base/thread_annotations.h"
 #include "ios/web/public/browser_state.h"
 #import "ios/web/public/web_client.h"
 
@@ -17,13 +26,60 @@
 
 namespace web {
 
-NSString* GetPageScript(NSString* script_file_name) {
-  DCHECK(script_file_name);
-  NSString* path =
-      [base::mac::FrameworkBundle() pathForResource:script_file_name
-                                             ofType:@"js"];
-  DCHECK(path) << "Script file not found: "
-               << base::SysNSStringToUTF8(script_file_name) << ".js";
+namespace {
+
+// Process-wide cache of the page scripts, filled from the main thread and from
+// the background prewarming task. The scripts can be read again from the
+// bundle, so the cache is purged on memory pressure.
+class PageScriptCache {
+ public:
+  static PageScriptCache* GetInstance() {
+    static base::NoDestructor<PageScriptCache> instance;
+    return instance.get();
+  }
+
+  // The cache is thread safe, so it is purged synchronously on the thread
+  // signaling the memory pressure. The listener must still be created on a
+  // sequence, which is the main thread.
+  PageScriptCache()
+      : memory_pressure_listener_(
+            FROM_HERE,
+            base::DoNothing(),
+            base::BindRepeating(&PageScriptCache::OnMemoryPressure,
+                                base::Unretained(this))) {}
+  PageScriptCache(const PageScriptCache&) = delete;
+  PageScriptCache& operator=(const PageScriptCache&) = delete;
+
+  // Returns the script cached for |key|, or nil.
+  NSString* GetScript(NSString* key) {
+    base::AutoLock lock(lock_);
+    return scripts_[key];
+  }
+
+  // Caches |script| for |key|.
+  void SetScript(NSString* key, NSString* script) {
+    base::AutoLock lock(lock_);
+    scripts_[key] = script;
+  }
+
+ private:
+  void OnMemoryPressure(
+      base::MemoryPressureListener::MemoryPressureLevel level) {
+    if (level == base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_NONE)
+      return;
+    base::AutoLock lock(lock_);
+    [scripts_ removeAllObjects];
+  }
+
+  base::MemoryPressureListener memory_pressure_listener_;
+  base::Lock lock_;
+  // The loaded scripts by file name, and the expanded scripts by cache key.
+  NSMutableDictionary<NSString*, NSString*>* scripts_ GUARDED_BY(lock_) =
+      [[NSMutableDictionary alloc] init];
+};
+
+// Reads the script at |path|.
+NSString* ReadPageScript(NSString* path) {
   NSError* error = nil;
   NSString* content = [NSString stringWithContentsOfFile:path
                                                 encoding:NSUTF8StringEncoding
@@ -34,6 +90,89 @@ NSString* GetPageScript(NSString* script_file_name) {
   return content;
 }
 
+// Returns the key caching the expanded script with the given parameters.
+// Placeholders and values are prefixed by their length so that keys are not
+// ambiguous, and the keys of loaded scripts, which are file names, never
+// contain the separator.
+NSString* ExpandedPageScriptKey(
+    NSString* script_file_name,
+    NSDictionary<NSString*, NSString*>* replacements,
+    NSString* injection_token) {
+  NSMutableString* key = [NSMutableString stringWithString:script_file_name];
+  [key appendFormat:@"/%@", injection_token ?: @""];
+  NSArray<NSString*>* sorted_placeholders =
+      [replacements.allKeys sortedArrayUsingSelector:@selector(compare:)];
+  for (NSString* placeholder in sorted_placeholders) {
+    NSString* value = replacements[placeholder];
+    [key appendFormat:@"/%lu:%@%lu:%@",
+                      static_cast<unsigned long>(placeholder.length),
+                      placeholder, static_cast<unsigned long>(value.length),
+                      value];
+  }
+  return key;
+}
+
+// Runs the page script |loaders|.
+void RunPageScriptLoaders(std::vector<base::OnceClosure> loaders) {
+  for (base::OnceClosure& loader : loaders)
+    std::move(loader).Run();
+}
+
+}  // namespace
+
+NSString* GetPageScript(NSString* script_file_name) {
+  DCHECK(script_file_name);
+  PageScriptCache* cache = PageScriptCache::GetInstance();
+  NSString* content = cache->GetScript(script_file_name);
+  if (content)
+    return content;
+
+  NSString* path =
+      [base::mac::FrameworkBundle() pathForResource:script_file_name
+                                             ofType:@"js"];
+  DCHECK(path) << "Script file not found: "
+               << base::SysNSStringToUTF8(script_file_name) << ".js";
+  content = ReadPageScript(path);
+  if (content)
+    cache->SetScript(script_file_name, content);
+  return content;
+}
+
+NSString* GetExpandedPageScript(
+    NSString* script_file_name,
+    NSDictionary<NSString*, NSString*>* replacements,
+    NSString* injection_token) {
+  NSString* key =
+      ExpandedPageScriptKey(script_file_name, replacements, injection_token);
+  PageScriptCache* cache = PageScriptCache::GetInstance();
+  NSString* script = cache->GetScript(key);
+  if (script)
+    return script;
+
+  script = GetPageScript(script_file_name);
+  for (NSString* placeholder in replacements) {
+    script =
+        [script stringByReplacingOccurrencesOfString:placeholder
+                                          withString:replacements[placeholder]];
+  }
+  if (injection_token)
+    script = MakeScriptInjectableOnce(injection_token, script);
+  if (script)
+    cache->SetScript(key, script);
+  return script;
+}
+
+void PrewarmPageScriptCache(std::vector<base::OnceClosure> loaders) {
+  DCHECK([NSThread isMainThread]);
+  // Create the cache on the main thread, see PageScriptCache().
+  PageScriptCache::GetInstance();
+  base::ThreadPool::PostTask(
+      FROM_HERE,
+      {base::MayBlock(), base::TaskPriority::USER_VISIBLE,
+       base::TaskShutdownBehavior::CONTINUE_ON_SHUTDOWN},
+      base::BindOnce(&RunPageScriptLoaders, std::move(loaders)));
+}
+
 NSString* MakeScriptInjectableOnce(NSString* script_identifier,
                                    NSString* script) {
   NSString* kOnceWrapperTemplate =
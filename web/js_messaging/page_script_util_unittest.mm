@@ -8,6 +8,7 @@
 #import <WebKit/WebKit.h>
 #include <memory>
 
+#include "base/memory/memory_pressure_listener.h"
 #include "base/strings/sys_string_conversions.h"
 #import "base/test/ios/wait_util.h"
 #import "ios/web/common/web_view_creation_util.h"
@@ -69,6 +70,49 @@ TEST_F(PageScriptUtilTest, MakeScriptInjectableOnce) {
   EXPECT_NSEQ(@(1), test::ExecuteJavaScript(web_view, @"value"));
 }
 
+// Tests that page scripts are cached and that expanded scripts are cached by
+// replacements and injection token.
+TEST_F(PageScriptUtilTest, GetExpandedPageScript) {
+  NSString* script = GetPageScript(@"common");
+  ASSERT_TRUE(script.length);
+  EXPECT_EQ(script, GetPageScript(@"common"));
+
+  NSDictionary<NSString*, NSString*>* replacements =
+      @{@"__gCrWeb" : @"__replaced"};
+  NSString* expanded = GetExpandedPageScript(@"common", replacements, nil);
+  EXPECT_FALSE([expanded containsString:@"__gCrWeb"]);
+  EXPECT_TRUE([expanded containsString:@"__replaced"]);
+  EXPECT_EQ(expanded, GetExpandedPageScript(@"common", replacements, nil));
+
+  NSString* injectable_once =
+      GetExpandedPageScript(@"common", replacements, @"common");
+  EXPECT_NSEQ(MakeScriptInjectableOnce(@"common", expanded), injectable_once);
+
+  NSString* other_expanded =
+      GetExpandedPageScript(@"common", @{@"__gCrWeb" : @"__other"}, nil);
+  EXPECT_TRUE([other_expanded containsString:@"__other"]);
+  EXPECT_NSEQ(script, GetExpandedPageScript(@"common", nil, nil));
+}
+
+// Tests that the cached scripts are purged on memory pressure, and read again.
+TEST_F(PageScriptUtilTest, PurgeOnMemoryPressure) {
+  NSDictionary<NSString*, NSString*>* replacements =
+      @{@"__gCrWeb" : @"__replaced"};
+  NSString* script = GetPageScript(@"common");
+  NSString* expanded = GetExpandedPageScript(@"common", replacements, nil);
+
+  base::MemoryPressureListener::SimulatePressureNotification(
+      base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL);
+
+  NSString* reloaded_script = GetPageScript(@"common");
+  EXPECT_NE(script, reloaded_script);
+  EXPECT_NSEQ(script, reloaded_script);
+  NSString* reloaded_expanded =
+      GetExpandedPageScript(@"common", replacements, nil);
+  EXPECT_NE(expanded, reloaded_expanded);
+  EXPECT_NSEQ(expanded, reloaded_expanded);
+}
+
 // Tests that WKWebView early page script is a valid script that injects global
 // __gCrWeb object.
 TEST_F(PageScriptUtilTest, WKWebViewEarlyPageScript) {
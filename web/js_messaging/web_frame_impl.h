@@ -8,9 +8,12 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 #include "base/cancelable_callback.h"
 #include "base/memory/weak_ptr.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
 #include "base/values.h"
 #include "ios/web/js_messaging/web_frame_internal.h"
 #include "ios/web/public/js_messaging/web_frame.h"
@@ -97,6 +100,50 @@ class WebFrameImpl : public WebFrame,
   // Detaches the receiver from the associated  WebState.
   void DetachFromWebState();
 
+  // A JavaScript function call queued, when kBatchJavaScriptFunctionCalls is
+  // enabled, to be executed with the other calls made during the same run
+  // loop turn.
+  struct BatchedCall {
+    // The script calling the function.
+    NSString* function_call;
+    int message_id;
+    bool reply_with_result;
+  };
+  // Consecutive batched calls executed within the same content world.
+  struct CallBatch {
+    CallBatch(JavaScriptContentWorld* content_world);
+    CallBatch(CallBatch&& other);
+    CallBatch& operator=(CallBatch&& other);
+    ~CallBatch();
+
+    JavaScriptContentWorld* content_world;
+    std::vector<BatchedCall> calls;
+  };
+
+  // Queues the call of the function |name| in |content_world|, to be executed
+  // at the end of the current run loop turn.
+  void QueueJavaScriptFunctionCall(JavaScriptContentWorld* content_world,
+                                   const std::string& name,
+                                   const std::vector<base::Value>& parameters,
+                                   int message_id,
+                                   bool reply_with_result);
+  // Executes the calls queued by |QueueJavaScriptFunctionCall|.
+  void FlushQueuedJavaScriptFunctionCalls();
+  // Executes the calls of |batch| with a single script evaluation.
+  void ExecuteCallBatch(const CallBatch& batch);
+
+  // Schedules the cancellation of the request with id |message_id| after
+  // |timeout|, using |timeout_timer_|. Returns the deadline under which the
+  // request is stored in |request_timeouts_|.
+  base::TimeTicks ScheduleRequestTimeout(int message_id,
+                                         base::TimeDelta timeout);
+  // Removes the request with id |message_id| from |request_timeouts_|, in
+  // which it was stored under |deadline|, and stops |timeout_timer_| if no
+  // request is left.
+  void RemoveRequestTimeout(int message_id, base::TimeTicks deadline);
+  // Cancels the requests whose timeout expired and rearms |timeout_timer_|.
+  void OnRequestTimeoutTimerFired();
+
   // A structure to store the callbacks associated with the
   // |CallJavaScriptFunction| requests.
   typedef base::CancelableOnceCallback<void(void)> TimeoutCallback;
@@ -106,6 +153,9 @@ class WebFrameImpl : public WebFrame,
     ~RequestCallbacks();
     base::OnceCallback<void(const base::Value*)> completion;
     std::unique_ptr<TimeoutCallback> timeout_callback;
+    // The deadline of the request in |request_timeouts_|, null if the request
+    // is not batched.
+    base::TimeTicks timeout_deadline;
   };
 
   // Calls the JavaScript function |name| in the web state. If |content_world|
@@ -117,6 +167,11 @@ class WebFrameImpl : public WebFrame,
                                  const std::vector<base::Value>& parameters,
                                  int message_id,
                                  bool reply_with_result);
+  // Same as above, with the script calling the function already created.
+  bool ExecuteJavaScriptFunction(JavaScriptContentWorld* content_world,
+                                 NSString* script,
+                                 int message_id,
+                                 bool reply_with_result);
 
   // Converts the given callback into a |ExecuteJavaScriptCallbackWithError|
   // callback. This function improves code sharing by being a bridge
@@ -149,6 +204,16 @@ class WebFrameImpl : public WebFrame,
   std::map<uint32_t, std::unique_ptr<struct RequestCallbacks>>
       pending_requests_;
 
+  // Whether the JavaScript function calls are batched.
+  const bool batch_function_calls_;
+  // The function calls queued during the current run loop turn, in order.
+  std::vector<CallBatch> queued_call_batches_;
+  // The ids of the batched requests, by timeout deadline rounded up to the
+  // timer granularity. |timeout_timer_| fires for the earliest deadline, so
+  // there is a single timeout task for all the batched requests.
+  std::map<base::TimeTicks, std::vector<int>> request_timeouts_;
+  base::OneShotTimer timeout_timer_;
+
   // The frame info instance associated with this web frame.
   WKFrameInfo* frame_info_;
   // The frame identifier which uniquely identifies this frame across the
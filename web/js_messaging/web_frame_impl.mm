@@ -6,13 +6,18 @@
 
 #import <Foundation/Foundation.h>
 
+#include <algorithm>
+
 #include "base/bind.h"
+#include "base/feature_list.h"
 #include "base/ios/ios_util.h"
 #include "base/json/json_writer.h"
 #include "base/logging.h"
+#import "base/mac/foundation_util.h"
 #include "base/strings/string_util.h"
 #include "base/strings/sys_string_conversions.h"
 #include "base/values.h"
+#include "ios/web/common/features.h"
 #import "ios/web/js_messaging/java_script_content_world.h"
 #import "ios/web/js_messaging/java_script_feature_manager.h"
 #import "ios/web/js_messaging/web_view_js_utils.h"
@@ -42,6 +47,26 @@ NSString* CreateFunctionCallWithParamaters(
       stringWithFormat:@"__gCrWeb.%s(%@)", name.c_str(),
                        [parameter_strings componentsJoinedByString:@","]];
 }
+
+// Creates a JavaScript string executing |function_calls| and returning an
+// array with an entry for each call: an array containing the result of the
+// call, or an empty array if the call threw or returned undefined. Each call
+// is isolated so that an exception does not prevent the following ones.
+NSString* CreateBatchedFunctionCalls(NSArray<NSString*>* function_calls) {
+  NSMutableString* script =
+      [NSMutableString stringWithString:@"(function(){var r=[];"];
+  for (NSString* function_call in function_calls) {
+    [script appendFormat:@"try{var v=%@;r.push(v===undefined?[]:[v]);}"
+                         @"catch(e){r.push([]);}",
+                         function_call];
+  }
+  [script appendString:@"return r;})()"];
+  return script;
+}
+
+// The granularity of the deadlines of batched requests. Requests expiring
+// within the same interval are cancelled together.
+constexpr base::TimeDelta kRequestTimeoutGranularity = base::Milliseconds(10);
 }  // namespace
 
 namespace web {
@@ -58,6 +83,8 @@ WebFrameImpl::WebFrameImpl(WKFrameInfo* frame_info,
       is_main_frame_(is_main_frame),
       security_origin_(security_origin),
       web_state_(web_state),
+      batch_function_calls_(base::FeatureList::IsEnabled(
+          features::kBatchJavaScriptFunctionCalls)),
       weak_ptr_factory_(this) {
   DCHECK(frame_info_);
   DCHECK(web_state_);
@@ -107,6 +134,11 @@ bool WebFrameImpl::CallJavaScriptFunctionInContentWorld(
 
   if (CanCallJavaScriptFunction() && content_world &&
       content_world->GetWKContentWorld()) {
+    if (batch_function_calls_) {
+      QueueJavaScriptFunctionCall(content_world, name, parameters, message_id,
+                                  reply_with_result);
+      return true;
+    }
     return ExecuteJavaScriptFunction(content_world, name, parameters,
                                      message_id, reply_with_result);
   }
@@ -153,15 +185,23 @@ bool WebFrameImpl::CallJavaScriptFunctionInContentWorld(
     base::TimeDelta timeout) {
   int message_id = next_message_id_;
 
-  auto timeout_callback = std::make_unique<TimeoutCallback>(base::BindOnce(
-      &WebFrameImpl::CancelRequest, base::Unretained(this), message_id));
-  auto callbacks = std::make_unique<struct RequestCallbacks>(
-      std::move(callback), std::move(timeout_callback));
-  pending_requests_[message_id] = std::move(callbacks);
-
-  web::GetUIThreadTaskRunner({})->PostDelayedTask(
-      FROM_HERE, pending_requests_[message_id]->timeout_callback->callback(),
-      timeout);
+  if (batch_function_calls_) {
+    pending_requests_[message_id] =
+        std::make_unique<struct RequestCallbacks>(std::move(callback),
+                                                  /*timeout=*/nullptr);
+    pending_requests_[message_id]->timeout_deadline =
+        ScheduleRequestTimeout(message_id, timeout);
+  } else {
+    auto timeout_callback = std::make_unique<TimeoutCallback>(base::BindOnce(
+        &WebFrameImpl::CancelRequest, base::Unretained(this), message_id));
+    auto callbacks = std::make_unique<struct RequestCallbacks>(
+        std::move(callback), std::move(timeout_callback));
+    pending_requests_[message_id] = std::move(callbacks);
+
+    web::GetUIThreadTaskRunner({})->PostDelayedTask(
+        FROM_HERE, pending_requests_[message_id]->timeout_callback->callback(),
+        timeout);
+  }
   bool called =
       CallJavaScriptFunctionInContentWorld(name, parameters, content_world,
                                            /*reply_with_result=*/true);
@@ -169,7 +209,10 @@ bool WebFrameImpl::CallJavaScriptFunctionInContentWorld(
     // Remove callbacks if the call failed.
     auto request = pending_requests_.find(message_id);
     if (request != pending_requests_.end()) {
+      const base::TimeTicks deadline = request->second->timeout_deadline;
       pending_requests_.erase(request);
+      if (!deadline.is_null())
+        RemoveRequestTimeout(message_id, deadline);
     }
   }
   return called;
@@ -193,6 +236,8 @@ bool WebFrameImpl::ExecuteJavaScript(
     const std::u16string& script,
     ExecuteJavaScriptCallbackWithError callback) {
   DCHECK(frame_info_);
+  // Keep the order of execution with the queued function calls.
+  FlushQueuedJavaScriptFunctionCalls();
 
   NSString* ns_script = base::SysUTF16ToNSString(script);
   __block auto internal_callback = std::move(callback);
@@ -239,11 +284,19 @@ bool WebFrameImpl::ExecuteJavaScriptFunction(
     const std::vector<base::Value>& parameters,
     int message_id,
     bool reply_with_result) {
+  return ExecuteJavaScriptFunction(
+      content_world, CreateFunctionCallWithParamaters(name, parameters),
+      message_id, reply_with_result);
+}
+
+bool WebFrameImpl::ExecuteJavaScriptFunction(
+    JavaScriptContentWorld* content_world,
+    NSString* script,
+    int message_id,
+    bool reply_with_result) {
   DCHECK(content_world);
   DCHECK(frame_info_);
 
-  NSString* script = CreateFunctionCallWithParamaters(name, parameters);
-
   void (^completion_handler)(id, NSError*) = nil;
   if (reply_with_result) {
     base::WeakPtr<WebFrameImpl> weak_frame = weak_ptr_factory_.GetWeakPtr();
@@ -270,19 +323,163 @@ bool WebFrameImpl::ExecuteJavaScriptFunction(
   return true;
 }
 
+void WebFrameImpl::QueueJavaScriptFunctionCall(
+    JavaScriptContentWorld* content_world,
+    const std::string& name,
+    const std::vector<base::Value>& parameters,
+    int message_id,
+    bool reply_with_result) {
+  if (queued_call_batches_.empty()) {
+    web::GetUIThreadTaskRunner({})->PostTask(
+        FROM_HERE,
+        base::BindOnce(&WebFrameImpl::FlushQueuedJavaScriptFunctionCalls,
+                       weak_ptr_factory_.GetWeakPtr()));
+  }
+  if (queued_call_batches_.empty() ||
+      queued_call_batches_.back().content_world != content_world) {
+    queued_call_batches_.emplace_back(content_world);
+  }
+  queued_call_batches_.back().calls.push_back(
+      {CreateFunctionCallWithParamaters(name, parameters), message_id,
+       reply_with_result});
+}
+
+void WebFrameImpl::FlushQueuedJavaScriptFunctionCalls() {
+  std::vector<CallBatch> batches;
+  batches.swap(queued_call_batches_);
+  for (const CallBatch& batch : batches)
+    ExecuteCallBatch(batch);
+}
+
+void WebFrameImpl::ExecuteCallBatch(const CallBatch& batch) {
+  if (!CanCallJavaScriptFunction() ||
+      !batch.content_world->GetWKContentWorld()) {
+    for (const BatchedCall& call : batch.calls)
+      CompleteRequest(call.message_id, /*result=*/nullptr);
+    return;
+  }
+
+  if (batch.calls.size() == 1) {
+    const BatchedCall& call = batch.calls.front();
+    ExecuteJavaScriptFunction(batch.content_world, call.function_call,
+                              call.message_id, call.reply_with_result);
+    return;
+  }
+
+  NSMutableArray<NSString*>* function_calls =
+      [NSMutableArray arrayWithCapacity:batch.calls.size()];
+  bool reply_with_result = false;
+  for (const BatchedCall& call : batch.calls) {
+    [function_calls addObject:call.function_call];
+    reply_with_result |= call.reply_with_result;
+  }
+  NSString* script = CreateBatchedFunctionCalls(function_calls);
+
+  void (^completion_handler)(id, NSError*) = nil;
+  if (reply_with_result) {
+    std::vector<int> message_ids;
+    for (const BatchedCall& call : batch.calls)
+      message_ids.push_back(call.reply_with_result ? call.message_id : -1);
+    base::WeakPtr<WebFrameImpl> weak_frame = weak_ptr_factory_.GetWeakPtr();
+    completion_handler = ^void(id value, NSError* error) {
+      if (error) {
+        DLOG(WARNING) << "Script execution of:"
+                      << base::SysNSStringToUTF16(script)
+                      << "\nfailed with error: "
+                      << base::SysNSStringToUTF16(
+                             error.userInfo[NSLocalizedDescriptionKey]);
+      }
+      if (!weak_frame) {
+        return;
+      }
+      // Each result is wrapped in an array, which is converted separately so
+      // that results keep the maximum parsing depth.
+      NSArray* results = base::mac::ObjCCast<NSArray>(value);
+      for (size_t i = 0; i < message_ids.size(); ++i) {
+        if (message_ids[i] < 0)
+          continue;
+        NSArray* result = i < results.count
+                              ? base::mac::ObjCCast<NSArray>(results[i])
+                              : nil;
+        if (result.count) {
+          weak_frame->CompleteRequest(
+              message_ids[i], ValueResultFromWKResult(result[0]).get());
+        } else {
+          weak_frame->CompleteRequest(message_ids[i], /*result=*/nullptr);
+        }
+      }
+    };
+  }
+
+  WKContentWorld* world = batch.content_world->GetWKContentWorld();
+  web::ExecuteJavaScript(frame_info_.webView, world, frame_info_, script,
+                         completion_handler);
+}
+
+base::TimeTicks WebFrameImpl::ScheduleRequestTimeout(int message_id,
+                                                     base::TimeDelta timeout) {
+  const base::TimeTicks now = base::TimeTicks::Now();
+  const base::TimeTicks deadline = (now + timeout).SnappedToNextTick(
+      base::TimeTicks(), kRequestTimeoutGranularity);
+  request_timeouts_[deadline].push_back(message_id);
+  if (!timeout_timer_.IsRunning() ||
+      timeout_timer_.desired_run_time() > deadline) {
+    timeout_timer_.Start(FROM_HERE, deadline - now, this,
+                         &WebFrameImpl::OnRequestTimeoutTimerFired);
+  }
+  return deadline;
+}
+
+void WebFrameImpl::RemoveRequestTimeout(int message_id,
+                                        base::TimeTicks deadline) {
+  // The timeouts of the expired requests were already removed.
+  auto timeouts = request_timeouts_.find(deadline);
+  if (timeouts == request_timeouts_.end())
+    return;
+  std::vector<int>& message_ids = timeouts->second;
+  auto position =
+      std::find(message_ids.begin(), message_ids.end(), message_id);
+  if (position != message_ids.end())
+    message_ids.erase(position);
+  if (message_ids.empty())
+    request_timeouts_.erase(timeouts);
+  if (request_timeouts_.empty())
+    timeout_timer_.Stop();
+}
+
+void WebFrameImpl::OnRequestTimeoutTimerFired() {
+  const base::TimeTicks now = base::TimeTicks::Now();
+  while (!request_timeouts_.empty() &&
+         request_timeouts_.begin()->first <= now) {
+    std::vector<int> message_ids = std::move(request_timeouts_.begin()->second);
+    request_timeouts_.erase(request_timeouts_.begin());
+    for (int message_id : message_ids)
+      CancelRequest(message_id);
+  }
+  if (!request_timeouts_.empty()) {
+    timeout_timer_.Start(FROM_HERE, request_timeouts_.begin()->first - now,
+                         this, &WebFrameImpl::OnRequestTimeoutTimerFired);
+  }
+}
+
 void WebFrameImpl::CompleteRequest(int message_id, const base::Value* result) {
   auto request = pending_requests_.find(message_id);
   if (request == pending_requests_.end()) {
     return;
   }
-  CompleteRequest(std::move(request->second), result);
+  std::unique_ptr<RequestCallbacks> request_callbacks =
+      std::move(request->second);
   pending_requests_.erase(request);
+  if (!request_callbacks->timeout_deadline.is_null())
+    RemoveRequestTimeout(message_id, request_callbacks->timeout_deadline);
+  CompleteRequest(std::move(request_callbacks), result);
 }
 
 void WebFrameImpl::CompleteRequest(
     std::unique_ptr<RequestCallbacks> request_callbacks,
     const base::Value* result) {
-  request_callbacks->timeout_callback->Cancel();
+  if (request_callbacks->timeout_callback)
+    request_callbacks->timeout_callback->Cancel();
   std::move(request_callbacks->completion).Run(result);
 }
 
@@ -295,6 +492,8 @@ void WebFrameImpl::CancelPendingRequests() {
     CompleteRequest(std::move(it.second), /*result=*/nullptr);
   }
   pending_requests_.clear();
+  request_timeouts_.clear();
+  timeout_timer_.Stop();
 }
 
 void WebFrameImpl::DetachFromWebState() {
@@ -316,4 +515,14 @@ WebFrameImpl::RequestCallbacks::RequestCallbacks(
 
 WebFrameImpl::RequestCallbacks::~RequestCallbacks() {}
 
+WebFrameImpl::CallBatch::CallBatch(JavaScriptContentWorld* content_world)
+    : content_world(content_world) {}
+
+WebFrameImpl::CallBatch::CallBatch(CallBatch&& other) = default;
+
+WebFrameImpl::CallBatch& WebFrameImpl::CallBatch::operator=(
+    CallBatch&& other) = default;
+
+WebFrameImpl::CallBatch::~CallBatch() = default;
+
 }  // namespace web
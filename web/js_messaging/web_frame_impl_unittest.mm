@@ -13,7 +13,9 @@
 #include "base/strings/string_number_conversions.h"
 #import "base/strings/sys_string_conversions.h"
 #include "base/test/ios/wait_util.h"
+#include "base/test/scoped_feature_list.h"
 #include "base/values.h"
+#include "ios/web/common/features.h"
 #import "ios/web/js_messaging/java_script_feature_manager.h"
 #import "ios/web/public/test/fakes/fake_web_state.h"
 #include "ios/web/public/test/web_test.h"
@@ -46,6 +48,10 @@ class WebFrameImplTest : public web::WebTest {
         .andDo(^(NSInvocation* invocation) {
           [invocation retainArguments];
           [invocation getArgument:&last_received_script_ atIndex:2];
+          __unsafe_unretained void (^completion_handler)(id, NSError*) = nil;
+          [invocation getArgument:&completion_handler atIndex:5];
+          last_completion_handler_ = completion_handler;
+          received_script_count_++;
         });
     OCMStub([mock_frame_info_ webView]).andReturn(mock_web_view_);
   }
@@ -63,6 +69,8 @@ class WebFrameImplTest : public web::WebTest {
   id mock_frame_info_;
   id mock_web_view_;
   NSString* last_received_script_;
+  void (^last_completion_handler_)(id, NSError*);
+  int received_script_count_ = 0;
 
   FakeWebState fake_web_state_;
   GURL security_origin_;
@@ -178,4 +186,89 @@ TEST_F(WebFrameImplTest, ExecuteJavaScriptWithCallback) {
                                    })));
 }
 
+// Tests that the function calls made during the same run loop turn are
+// executed by a single script when batching is enabled, and that the results
+// are dispatched to each callback.
+TEST_F(WebFrameImplTest, BatchedJavaScriptFunctionCalls) {
+  base::test::ScopedFeatureList feature_list;
+  feature_list.InitAndEnableFeature(features::kBatchJavaScriptFunctionCalls);
+  WebFrameImpl web_frame(mock_frame_info_, kFrameId,
+                         /*is_main_frame=*/true, security_origin_,
+                         &fake_web_state_);
+
+  __block std::unique_ptr<base::Value> first_result;
+  __block bool first_called = false;
+  __block bool second_called = false;
+  std::vector<base::Value> function_params;
+  function_params.push_back(base::Value(1));
+  EXPECT_TRUE(web_frame.CallJavaScriptFunction(
+      "first", function_params, base::BindOnce(^(const base::Value* value) {
+        first_called = true;
+        first_result = value ? base::Value::ToUniquePtrValue(value->Clone())
+                             : nullptr;
+      }),
+      base::Seconds(kJavaScriptFunctionCallDefaultTimeout)));
+  EXPECT_TRUE(web_frame.CallJavaScriptFunction("noReply", {}));
+  EXPECT_TRUE(web_frame.CallJavaScriptFunction(
+      "second", {}, base::BindOnce(^(const base::Value* value) {
+        second_called = true;
+        EXPECT_FALSE(value);
+      }),
+      base::Seconds(kJavaScriptFunctionCallDefaultTimeout)));
+  EXPECT_EQ(0, received_script_count_);
+
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ(1, received_script_count_);
+  EXPECT_TRUE([last_received_script_ containsString:@"__gCrWeb.first(1)"]);
+  EXPECT_TRUE([last_received_script_ containsString:@"__gCrWeb.noReply()"]);
+  EXPECT_TRUE([last_received_script_ containsString:@"__gCrWeb.second()"]);
+  ASSERT_TRUE(last_completion_handler_);
+
+  last_completion_handler_(@[ @[ @"result" ], @[], @[] ], nil);
+  EXPECT_TRUE(first_called);
+  ASSERT_TRUE(first_result);
+  EXPECT_EQ("result", first_result->GetString());
+  EXPECT_TRUE(second_called);
+}
+
+// Tests that a single queued call is executed without the batching wrapper.
+TEST_F(WebFrameImplTest, SingleBatchedJavaScriptFunctionCall) {
+  base::test::ScopedFeatureList feature_list;
+  feature_list.InitAndEnableFeature(features::kBatchJavaScriptFunctionCalls);
+  WebFrameImpl web_frame(mock_frame_info_, kFrameId,
+                         /*is_main_frame=*/true, security_origin_,
+                         &fake_web_state_);
+
+  EXPECT_TRUE(web_frame.CallJavaScriptFunction("functionName", {}));
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ(1, received_script_count_);
+  EXPECT_NSEQ(@"__gCrWeb.functionName()", last_received_script_);
+}
+
+// Tests that batched requests which don't get a reply are cancelled after
+// their timeout.
+TEST_F(WebFrameImplTest, BatchedJavaScriptFunctionCallTimeout) {
+  base::test::ScopedFeatureList feature_list;
+  feature_list.InitAndEnableFeature(features::kBatchJavaScriptFunctionCalls);
+  WebFrameImpl web_frame(mock_frame_info_, kFrameId,
+                         /*is_main_frame=*/true, security_origin_,
+                         &fake_web_state_);
+
+  __block int called_count = 0;
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_TRUE(web_frame.CallJavaScriptFunction(
+        "functionName", {}, base::BindOnce(^(const base::Value* value) {
+          EXPECT_FALSE(value);
+          called_count++;
+        }),
+        base::Milliseconds(10)));
+  }
+
+  EXPECT_TRUE(base::test::ios::WaitUntilConditionOrTimeout(
+      base::test::ios::kWaitForJSCompletionTimeout, ^{
+        base::RunLoop().RunUntilIdle();
+        return called_count == 2;
+      }));
+}
+
 }  // namespace web
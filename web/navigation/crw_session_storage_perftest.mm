@@ -0,0 +1,98 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#import "ios/web/public/session/crw_session_storage.h"
+
+#import <Foundation/Foundation.h>
+
+#include "base/bind.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/utf_string_conversions.h"
+#include "base/time/time.h"
+#import "ios/web/public/session/crw_navigation_item_storage.h"
+#include "ios/testing/perf_test_util.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/platform_test.h"
+#include "url/gurl.h"
+
+#if !defined(__has_feature) || !__has_feature(objc_arc)
+#error "This file requires ARC support."
+#endif
+
+namespace {
+
+// Number of navigation items of the session.
+const int kItemCount = 50;
+// Number of times the session is serialized per measure.
+const size_t kIterations = 100;
+
+// Returns a session storage with kItemCount items.
+CRWSessionStorage* CreateSessionStorage() {
+  NSMutableArray<CRWNavigationItemStorage*>* item_storages =
+      [NSMutableArray array];
+  for (int i = 0; i < kItemCount; ++i) {
+    const std::string index = base::NumberToString(i);
+    CRWNavigationItemStorage* item_storage =
+        [[CRWNavigationItemStorage alloc] init];
+    item_storage.URL = GURL("https://www.example.com/path/" + index);
+    item_storage.virtualURL = item_storage.URL;
+    item_storage.title = base::UTF8ToUTF16("Title of the page " + index);
+    item_storage.timestamp = base::Time::Now();
+    [item_storages addObject:item_storage];
+  }
+
+  CRWSessionStorage* session_storage = [[CRWSessionStorage alloc] init];
+  session_storage.itemStorages = item_storages;
+  session_storage.lastCommittedItemIndex = kItemCount - 1;
+  session_storage.stableIdentifier = [[NSUUID UUID] UUIDString];
+  session_storage.lastActiveTime = base::Time::Now();
+  return session_storage;
+}
+
+// Returns the keyed archive of |session_storage|.
+NSData* ArchiveSessionStorage(CRWSessionStorage* session_storage) {
+  return [NSKeyedArchiver archivedDataWithRootObject:session_storage
+                               requiringSecureCoding:NO
+                                               error:nil];
+}
+
+// Returns the session storage decoded from |data|.
+CRWSessionStorage* UnarchiveSessionStorage(NSData* data) {
+  NSKeyedUnarchiver* unarchiver =
+      [[NSKeyedUnarchiver alloc] initForReadingFromData:data error:nil];
+  unarchiver.requiresSecureCoding = NO;
+  return [unarchiver decodeObjectForKey:NSKeyedArchiveRootObjectKey];
+}
+
+}  // namespace
+
+using CRWSessionStoragePerfTest = PlatformTest;
+
+// Measures the serialization of a session, as done when saving the tabs.
+TEST_F(CRWSessionStoragePerfTest, Archive) {
+  CRWSessionStorage* session_storage = CreateSessionStorage();
+  const double time = testing::MeasureMicroseconds(
+      kIterations, base::BindRepeating(^{
+        @autoreleasepool {
+          ArchiveSessionStorage(session_storage);
+        }
+      }));
+  EXPECT_TRUE(ArchiveSessionStorage(session_storage));
+  testing::ReportPerfResult("CRWSessionStorage", "Archive", time, "us");
+}
+
+// Measures the deserialization of a session, as done when restoring the tabs.
+TEST_F(CRWSessionStoragePerfTest, Unarchive) {
+  NSData* data = ArchiveSessionStorage(CreateSessionStorage());
+  ASSERT_TRUE(data);
+  const double time = testing::MeasureMicroseconds(
+      kIterations, base::BindRepeating(^{
+        @autoreleasepool {
+          UnarchiveSessionStorage(data);
+        }
+      }));
+  EXPECT_EQ(static_cast<NSUInteger>(kItemCount),
+            UnarchiveSessionStorage(data).itemStorages.count);
+  testing::ReportPerfResult("CRWSessionStorage", "Unarchive", time, "us");
+}
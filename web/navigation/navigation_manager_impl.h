@@ -19,6 +19,7 @@
 #include "ui/base/page_transition_types.h"
 #include "url/gurl.h"
 
+@class WKBackForwardList;
 @class WKBackForwardListItem;
 
 namespace base {
@@ -322,12 +323,31 @@ class NavigationManagerImpl : public NavigationManager {
     // IsAttachedToWebView() is true.
     WKBackForwardListItem* GetWKItemAtIndex(size_t index) const;
 
+    // Discards the snapshot of the WKBackForwardList. Must be called when the
+    // back-forward list may have changed, e.g. on navigation commit, history
+    // state change or restore.
+    void InvalidateBackForwardListSnapshot();
+
    private:
+    // Updates the snapshot of the WKBackForwardList if it was invalidated or
+    // if the current item of the list changed since it was taken. Must only
+    // be called when IsAttachedToWebView() is true.
+    void UpdateBackForwardListSnapshotIfNeeded() const;
+
     NavigationManagerImpl* navigation_manager_;
     bool attached_to_web_view_;
 
     std::vector<std::unique_ptr<NavigationItemImpl>> cached_items_;
     int cached_current_item_index_;
+
+    // Snapshot of the WKBackForwardList, as WKBackForwardList allocates a new
+    // array each time its back or forward list is queried. The snapshot is
+    // taken lazily, so it is mutable.
+    mutable bool snapshot_valid_ = false;
+    mutable WKBackForwardList* snapshot_list_ = nil;
+    mutable WKBackForwardListItem* snapshot_current_item_ = nil;
+    mutable std::vector<WKBackForwardListItem*> snapshot_items_;
+    mutable int snapshot_current_item_index_ = -1;
   };
 
   // Type of the list passed to restore items.
@@ -274,6 +274,7 @@ void NavigationManagerImpl::AddPendingItem(
 
 void NavigationManagerImpl::CommitPendingItem() {
   DCHECK(web_view_cache_.IsAttachedToWebView());
+  web_view_cache_.InvalidateBackForwardListSnapshot();
 
   // CommitPendingItem may be called multiple times. Do nothing if there is no
   // pending item.
@@ -332,6 +333,7 @@ void NavigationManagerImpl::CommitPendingItem(
   }
 
   DCHECK(web_view_cache_.IsAttachedToWebView());
+  web_view_cache_.InvalidateBackForwardListSnapshot();
 
   // CommitPendingItem may be called multiple times. Do nothing if there is no
   // pending item.
@@ -441,6 +443,7 @@ bool NavigationManagerImpl::RestoreNativeSession(const GURL& url) {
 
   // Native restore worked, abort unsafe restore.
   DiscardNonCommittedItems();
+  web_view_cache_.InvalidateBackForwardListSnapshot();
   last_committed_item_index_ = web_view_cache_.GetCurrentItemIndex();
   if (restored_visible_item_ &&
       restored_visible_item_->GetUserAgentType() != UserAgentType::NONE) {
@@ -507,6 +510,7 @@ NavigationItemImpl* NavigationManagerImpl::GetLastCommittedItemImpl() const {
 void NavigationManagerImpl::UpdateCurrentItemForReplaceState(
     const GURL& url,
     NSString* state_object) {
+  web_view_cache_.InvalidateBackForwardListSnapshot();
   NavigationItemImpl* current_item = GetCurrentItemImpl();
   current_item->SetURL(url);
   current_item->SetSerializedStateObject(state_object);
@@ -1078,6 +1082,7 @@ void NavigationManagerImpl::UnsafeRestore(
   // (restore_session.html) into the web view. The session history is encoded
   // in the query parameter. When loaded, restore_session.html parses the
   // session history and replays them into the web view using History API.
+  web_view_cache_.InvalidateBackForwardListSnapshot();
   for (size_t index = 0; index < items.size(); ++index) {
     RewriteItemURLIfNecessary(items[index].get());
   }
@@ -1308,12 +1313,14 @@ void NavigationManagerImpl::WKWebViewCache::DetachFromWebView() {
       }
     }
   }
+  InvalidateBackForwardListSnapshot();
   attached_to_web_view_ = false;
 }
 
 void NavigationManagerImpl::WKWebViewCache::ResetToAttached() {
   cached_items_.clear();
   cached_current_item_index_ = -1;
+  InvalidateBackForwardListSnapshot();
   attached_to_web_view_ = true;
 }
 
@@ -1333,16 +1340,10 @@ size_t NavigationManagerImpl::WKWebViewCache::GetBackForwardListItemCount()
   if (!IsAttachedToWebView())
     return cached_items_.size();
 
-  id<CRWWebViewNavigationProxy> proxy =
-      navigation_manager_->delegate_->GetWebViewNavigationProxy();
-  if (proxy) {
-    size_t count_current_page = proxy.backForwardList.currentItem ? 1 : 0;
-    return proxy.backForwardList.backList.count + count_current_page +
-           proxy.backForwardList.forwardList.count;
-  }
-
-  // If WebView has not been created, it's fair to say navigation has 0 item.
-  return 0;
+  // If WebView has not been created, the snapshot is empty and it's fair to
+  // say navigation has 0 item.
+  UpdateBackForwardListSnapshotIfNeeded();
+  return snapshot_items_.size();
 }
 
 GURL NavigationManagerImpl::WKWebViewCache::GetVisibleWebViewURL() const {
@@ -1360,12 +1361,8 @@ int NavigationManagerImpl::WKWebViewCache::GetCurrentItemIndex() const {
   if (!IsAttachedToWebView())
     return cached_current_item_index_;
 
-  id<CRWWebViewNavigationProxy> proxy =
-      navigation_manager_->delegate_->GetWebViewNavigationProxy();
-  if (proxy.backForwardList.currentItem) {
-    return static_cast<int>(proxy.backForwardList.backList.count);
-  }
-  return -1;
+  UpdateBackForwardListSnapshotIfNeeded();
+  return snapshot_current_item_index_;
 }
 
 NavigationItemImpl*
@@ -1427,14 +1424,51 @@ WKBackForwardListItem* NavigationManagerImpl::WKWebViewCache::GetWKItemAtIndex(
   if (index >= GetBackForwardListItemCount()) {
     return nil;
   }
+  return snapshot_items_[index];
+}
+
+void NavigationManagerImpl::WKWebViewCache::
+    InvalidateBackForwardListSnapshot() {
+  snapshot_valid_ = false;
+  snapshot_list_ = nil;
+  snapshot_current_item_ = nil;
+  snapshot_items_.clear();
+  snapshot_current_item_index_ = -1;
+}
 
-  // Convert the index to an offset relative to backForwardList.currentItem (
-  // which is also the last committed item), then use WKBackForwardList API to
-  // retrieve the item.
-  int offset = static_cast<int>(index) - GetCurrentItemIndex();
+void NavigationManagerImpl::WKWebViewCache::
+    UpdateBackForwardListSnapshotIfNeeded() const {
+  DCHECK(IsAttachedToWebView());
   id<CRWWebViewNavigationProxy> proxy =
       navigation_manager_->delegate_->GetWebViewNavigationProxy();
-  return [proxy.backForwardList itemAtIndex:offset];
+  WKBackForwardList* list = proxy.backForwardList;
+  WKBackForwardListItem* current_item = list.currentItem;
+  // WebKit may update the list before the navigation manager is notified, e.g.
+  // on back-forward navigations. Every change of the back-forward list which
+  // adds or removes items also changes its current item, so checking it is
+  // enough to detect those without allocating the back and forward lists.
+  if (snapshot_valid_ && list == snapshot_list_ &&
+      current_item == snapshot_current_item_) {
+    return;
+  }
+
+  NSArray<WKBackForwardListItem*>* back_list = list.backList;
+  NSArray<WKBackForwardListItem*>* forward_list = list.forwardList;
+  snapshot_items_.clear();
+  snapshot_items_.reserve(back_list.count + (current_item ? 1 : 0) +
+                          forward_list.count);
+  for (WKBackForwardListItem* item in back_list)
+    snapshot_items_.push_back(item);
+  if (current_item)
+    snapshot_items_.push_back(current_item);
+  for (WKBackForwardListItem* item in forward_list)
+    snapshot_items_.push_back(item);
+
+  snapshot_current_item_index_ =
+      current_item ? static_cast<int>(back_list.count) : -1;
+  snapshot_list_ = list;
+  snapshot_current_item_ = current_item;
+  snapshot_valid_ = true;
 }
 
 }  // namespace web
@@ -1441,6 +1441,38 @@ TEST_F(NavigationManagerTest, GetIndexOfItem) {
   EXPECT_EQ(-1, navigation_manager()->GetIndexOfItem(item_not_found.get()));
 }
 
+// Tests that the snapshot of the WKBackForwardList follows the changes of the
+// list.
+TEST_F(NavigationManagerTest, BackForwardListSnapshot) {
+  [mock_wk_list_ setCurrentURL:@"http://www.url.com/1"
+                  backListURLs:@[ @"http://www.url.com/0" ]
+               forwardListURLs:@[ @"http://www.url.com/2" ]];
+  ASSERT_EQ(3, navigation_manager()->GetItemCount());
+  ASSERT_EQ(1, navigation_manager()->GetLastCommittedItemIndex());
+  NavigationItem* item2 = navigation_manager()->GetItemAtIndex(2);
+  EXPECT_EQ(2, navigation_manager()->GetIndexOfItem(item2));
+
+  // Back-forward navigations change the current item of the list.
+  SimulateGoToIndex(2);
+  EXPECT_EQ(3, navigation_manager()->GetItemCount());
+  EXPECT_EQ(2, navigation_manager()->GetLastCommittedItemIndex());
+  EXPECT_EQ(2, navigation_manager()->GetIndexOfItem(item2));
+
+  // Committing a navigation invalidates the snapshot.
+  WKBackForwardListItem* current_item = mock_wk_list_.currentItem;
+  mock_wk_list_.forwardList = @[ [CRWFakeBackForwardList
+      itemWithURLString:@"http://www.url.com/3"] ];
+  navigation_manager()->AddPendingItem(
+      GURL("http://www.url.com/2"), Referrer(), ui::PAGE_TRANSITION_TYPED,
+      web::NavigationInitiationType::BROWSER_INITIATED,
+      /*is_post_navigation=*/false, web::HttpsUpgradeType::kNone);
+  navigation_manager()->CommitPendingItem();
+  ASSERT_EQ(current_item, mock_wk_list_.currentItem);
+  EXPECT_EQ(4, navigation_manager()->GetItemCount());
+  EXPECT_EQ(2, navigation_manager()->GetIndexOfItem(
+                   navigation_manager()->GetLastCommittedItem()));
+}
+
 // Tests that GetBackwardItems() and GetForwardItems() return expected entries
 // when current item is in the middle of the navigation history.
 TEST_F(NavigationManagerTest, TestBackwardForwardItems) {
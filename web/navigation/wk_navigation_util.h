@@ -37,6 +37,10 @@ extern const int kMaxSessionSize;
 // restore_session.html URL.
 extern const char kRestoreSessionSessionHashPrefix[];
 
+// URL fragment prefix used to encode the session history in the compact binary
+// format in a restore_session.html URL.
+extern const char kRestoreSessionBinarySessionHashPrefix[];
+
 // URL fragment prefix used to encode target URL in a restore_session.html URL.
 extern const char kRestoreSessionTargetUrlHashPrefix[];
 
@@ -69,6 +73,15 @@ GURL GetRestoreSessionBaseUrl();
 // web view, recreates all the history entries in |items| and the current loaded
 // item is the entry at |last_committed_item_index|.  Sets |first_index| to the
 // new beginning of items.
+//
+// The session history is encoded as JSON after kRestoreSessionSessionHashPrefix
+// or, if features::kCompactRestoreSessionUrl is enabled, in a binary format
+// encoded as base64url after kRestoreSessionBinarySessionHashPrefix. The binary
+// format is a sequence of unsigned LEB128 varints and of byte strings prefixed
+// by their varint length: the format version (1), the opposite of the offset
+// of the last committed entry relative to the last entry, the number of
+// entries and, for each entry, the length of the prefix its URL shares with
+// the URL of the previous entry, the rest of its URL and its UTF-8 title.
 void CreateRestoreSessionUrl(
     int last_committed_item_index,
     const std::vector<std::unique_ptr<NavigationItem>>& items,
@@ -6,12 +6,17 @@
 
 #include <algorithm>
 
+#include "base/base64url.h"
+#include "base/feature_list.h"
 #include "base/json/json_writer.h"
 #include "base/mac/bundle_locations.h"
 #include "base/metrics/field_trial_params.h"
 #include "base/strings/escape.h"
+#include "base/strings/strcat.h"
+#include "base/strings/string_piece.h"
 #include "base/strings/string_util.h"
 #include "base/strings/sys_string_conversions.h"
+#include "base/strings/utf_string_conversions.h"
 #include "base/values.h"
 #include "ios/web/common/features.h"
 #import "ios/web/navigation/crw_error_page_helper.h"
@@ -34,9 +39,109 @@ namespace wk_navigation_util {
 const int kMaxSessionSize = 75;
 
 const char kRestoreSessionSessionHashPrefix[] = "session=";
+const char kRestoreSessionBinarySessionHashPrefix[] = "sessionb=";
 const char kRestoreSessionTargetUrlHashPrefix[] = "targetUrl=";
 NSString* const kReferrerHeaderName = @"Referer";
 
+namespace {
+
+// Version of the binary session format, see CreateRestoreSessionUrl().
+const size_t kBinarySessionVersion = 1;
+
+// Maximum size of the varint encoding of a size_t.
+const size_t kMaxVarintSize = (sizeof(size_t) * 8 + 6) / 7;
+
+// Appends |value| to |output| as an unsigned LEB128 varint.
+void AppendVarint(size_t value, std::string* output) {
+  while (value >= 0x80) {
+    output->push_back(static_cast<char>((value & 0x7F) | 0x80));
+    value >>= 7;
+  }
+  output->push_back(static_cast<char>(value));
+}
+
+// Appends |bytes| to |output|, prefixed by its length.
+void AppendLengthPrefixed(base::StringPiece bytes, std::string* output) {
+  AppendVarint(bytes.size(), output);
+  output->append(bytes.data(), bytes.size());
+}
+
+// Returns the URL fragment encoding the |size| items of |items| starting at
+// |first| as JSON.
+std::string CreateJSONSessionFragment(
+    const std::vector<std::unique_ptr<NavigationItem>>& items,
+    int first,
+    int size,
+    int committed_item_offset) {
+  // The URLs and titles of the restored entries are stored in two separate
+  // lists instead of a single list of objects to reduce the size of the JSON
+  // string to be included in the query parameter.
+  base::Value restored_urls(base::Value::Type::LIST);
+  base::Value restored_titles(base::Value::Type::LIST);
+  for (int i = first; i < first + size; i++) {
+    NavigationItem* item = items[i].get();
+    restored_urls.Append(item->GetURL().spec());
+    restored_titles.Append(item->GetTitle());
+  }
+  base::Value session(base::Value::Type::DICTIONARY);
+  session.SetKey("offset", base::Value(committed_item_offset));
+  session.SetKey("urls", std::move(restored_urls));
+  session.SetKey("titles", std::move(restored_titles));
+
+  std::string session_json;
+  base::JSONWriter::Write(session, &session_json);
+  return kRestoreSessionSessionHashPrefix +
+         base::EscapeQueryParamValue(session_json, false /* use_plus */);
+}
+
+// Returns the URL fragment encoding the |size| items of |items| starting at
+// |first| in the binary format.
+std::string CreateBinarySessionFragment(
+    const std::vector<std::unique_ptr<NavigationItem>>& items,
+    int first,
+    int size,
+    int committed_item_offset) {
+  DCHECK_LE(committed_item_offset, 0);
+
+  std::vector<std::string> titles;
+  titles.reserve(size);
+  size_t max_encoded_size = 3 * kMaxVarintSize;
+  for (int i = first; i < first + size; i++) {
+    titles.push_back(base::UTF16ToUTF8(items[i]->GetTitle()));
+    max_encoded_size += items[i]->GetURL().spec().size() +
+                        titles.back().size() + 3 * kMaxVarintSize;
+  }
+
+  std::string session;
+  session.reserve(max_encoded_size);
+  AppendVarint(kBinarySessionVersion, &session);
+  AppendVarint(-committed_item_offset, &session);
+  AppendVarint(size, &session);
+  base::StringPiece previous_url;
+  for (int i = 0; i < size; i++) {
+    base::StringPiece url = items[first + i]->GetURL().spec();
+    const size_t max_shared_size = std::min(url.size(), previous_url.size());
+    size_t shared_size = 0;
+    while (shared_size < max_shared_size &&
+           url[shared_size] == previous_url[shared_size]) {
+      ++shared_size;
+    }
+    AppendVarint(shared_size, &session);
+    AppendLengthPrefixed(url.substr(shared_size), &session);
+    AppendLengthPrefixed(titles[i], &session);
+    previous_url = url;
+  }
+  DCHECK_LE(session.size(), max_encoded_size);
+
+  std::string encoded_session;
+  base::Base64UrlEncode(session, base::Base64UrlEncodePolicy::OMIT_PADDING,
+                        &encoded_session);
+  return base::StrCat(
+      {kRestoreSessionBinarySessionHashPrefix, encoded_session});
+}
+
+}  // namespace
+
 int GetSafeItemRange(int last_committed_item_index,
                      int item_count,
                      int* offset,
@@ -101,28 +206,13 @@ void CreateRestoreSessionUrl(
       GetSafeItemRange(last_committed_item_index, items.size(),
                        &first_restored_item_offset, &new_size);
 
-  // The URLs and titles of the restored entries are stored in two separate
-  // lists instead of a single list of objects to reduce the size of the JSON
-  // string to be included in the query parameter.
-  base::Value restored_urls(base::Value::Type::LIST);
-  base::Value restored_titles(base::Value::Type::LIST);
-  for (int i = first_restored_item_offset;
-       i < new_size + first_restored_item_offset; i++) {
-    NavigationItem* item = items[i].get();
-    restored_urls.Append(item->GetURL().spec());
-    restored_titles.Append(item->GetTitle());
-  }
-  base::Value session(base::Value::Type::DICTIONARY);
   int committed_item_offset = new_last_committed_item_index + 1 - new_size;
-  session.SetKey("offset", base::Value(committed_item_offset));
-  session.SetKey("urls", std::move(restored_urls));
-  session.SetKey("titles", std::move(restored_titles));
-
-  std::string session_json;
-  base::JSONWriter::Write(session, &session_json);
   std::string ref =
-      kRestoreSessionSessionHashPrefix +
-      base::EscapeQueryParamValue(session_json, false /* use_plus */);
+      base::FeatureList::IsEnabled(features::kCompactRestoreSessionUrl)
+          ? CreateBinarySessionFragment(items, first_restored_item_offset,
+                                        new_size, committed_item_offset)
+          : CreateJSONSessionFragment(items, first_restored_item_offset,
+                                      new_size, committed_item_offset);
   GURL::Replacements replacements;
   replacements.SetRefStr(ref);
   *first_index = first_restored_item_offset;
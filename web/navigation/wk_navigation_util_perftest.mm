@@ -0,0 +1,100 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#import "ios/web/navigation/wk_navigation_util.h"
+
+#include <memory>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/utf_string_conversions.h"
+#include "base/test/scoped_feature_list.h"
+#include "ios/web/common/features.h"
+#import "ios/web/navigation/navigation_item_impl.h"
+#include "ios/testing/perf_test_util.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/platform_test.h"
+#include "url/gurl.h"
+
+#if !defined(__has_feature) || !__has_feature(objc_arc)
+#error "This file requires ARC support."
+#endif
+
+namespace web {
+namespace wk_navigation_util {
+
+namespace {
+
+// Number of times the restore session URL is created per measure.
+const size_t kIterations = 100;
+
+// Returns |count| navigation items with distinct titles and URLs.
+std::vector<std::unique_ptr<NavigationItem>> CreateNavigationItems(
+    int count) {
+  std::vector<std::unique_ptr<NavigationItem>> items;
+  for (int i = 0; i < count; ++i) {
+    auto item = std::make_unique<NavigationItemImpl>();
+    const std::string index = base::NumberToString(i);
+    item->SetURL(GURL("https://www.example.com/path/" + index + "?q=" + index));
+    item->SetTitle(base::UTF8ToUTF16("Title of the page " + index));
+    items.push_back(std::move(item));
+  }
+  return items;
+}
+
+}  // namespace
+
+using WKNavigationUtilPerfTest = PlatformTest;
+
+// Measures the creation of the restore session URL for sessions of various
+// sizes, the largest being truncated to kMaxSessionSize items.
+TEST_F(WKNavigationUtilPerfTest, CreateRestoreSessionUrl) {
+  for (int count : {1, 10, kMaxSessionSize, 2 * kMaxSessionSize}) {
+    const std::vector<std::unique_ptr<NavigationItem>> items =
+        CreateNavigationItems(count);
+    const auto* items_ptr = &items;
+    __block GURL url;
+    __block int first_index = 0;
+    const double time = testing::MeasureMicroseconds(
+        kIterations, base::BindRepeating(^{
+          CreateRestoreSessionUrl(count - 1, *items_ptr, &url, &first_index);
+        }));
+    EXPECT_TRUE(IsRestoreSessionUrl(url));
+    testing::ReportPerfResult("CreateRestoreSessionUrl",
+                              base::NumberToString(count) + " items", time,
+                              "us");
+  }
+}
+
+// Compares the time to create the restore session URL and its size with the
+// JSON and the compact binary encodings of the session history.
+TEST_F(WKNavigationUtilPerfTest, CompactRestoreSessionUrl) {
+  for (bool compact : {false, true}) {
+    base::test::ScopedFeatureList scoped_feature_list;
+    scoped_feature_list.InitWithFeatureState(
+        features::kCompactRestoreSessionUrl, compact);
+    const std::string encoding = compact ? "binary" : "json";
+    for (int count : {10, kMaxSessionSize}) {
+      const std::vector<std::unique_ptr<NavigationItem>> items =
+          CreateNavigationItems(count);
+      const auto* items_ptr = &items;
+      __block GURL url;
+      __block int first_index = 0;
+      const double time = testing::MeasureMicroseconds(
+          kIterations, base::BindRepeating(^{
+            CreateRestoreSessionUrl(count - 1, *items_ptr, &url, &first_index);
+          }));
+      EXPECT_TRUE(IsRestoreSessionUrl(url));
+      const std::string story =
+          encoding + " " + base::NumberToString(count) + " items";
+      testing::ReportPerfResult("RestoreSessionUrlTime", story, time, "us");
+      testing::ReportPerfResult("RestoreSessionUrlSize", story,
+                                url.spec().size(), "bytes");
+    }
+  }
+}
+
+}  // namespace wk_navigation_util
+}  // namespace web
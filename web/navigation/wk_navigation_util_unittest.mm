@@ -7,11 +7,14 @@
 #include <memory>
 #include <vector>
 
+#include "base/base64url.h"
 #include "base/json/json_reader.h"
 #include "base/strings/escape.h"
+#include "base/strings/string_util.h"
 #include "base/strings/stringprintf.h"
 #include "base/strings/sys_string_conversions.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/test/scoped_feature_list.h"
 #include "base/values.h"
 #include "ios/web/common/features.h"
 #import "ios/web/navigation/navigation_item_impl.h"
@@ -20,6 +23,7 @@
 #import "net/base/mac/url_conversions.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "testing/platform_test.h"
+#include "third_party/abseil-cpp/absl/types/optional.h"
 #include "url/scheme_host_port.h"
 
 #if !defined(__has_feature) || !__has_feature(objc_arc)
@@ -55,6 +59,83 @@ base::JSONReader::Result ExtractSessionDict(GURL restore_session_url) {
                                                        base::JSON_PARSE_RFC);
 }
 
+// Session history decoded from the binary format.
+struct BinarySession {
+  int offset = 0;
+  std::vector<std::string> urls;
+  std::vector<std::string> titles;
+};
+
+// Reads an unsigned LEB128 varint from |data| at |position|.
+bool ReadVarint(const std::string& data, size_t* position, size_t* value) {
+  *value = 0;
+  for (size_t shift = 0; *position < data.size(); shift += 7) {
+    const uint8_t byte = static_cast<uint8_t>(data[(*position)++]);
+    *value |= static_cast<size_t>(byte & 0x7F) << shift;
+    if (!(byte & 0x80))
+      return true;
+  }
+  return false;
+}
+
+// Reads a length-prefixed byte string from |data| at |position|.
+bool ReadBytes(const std::string& data, size_t* position, std::string* bytes) {
+  size_t length = 0;
+  if (!ReadVarint(data, position, &length) ||
+      length > data.size() - *position) {
+    return false;
+  }
+  *bytes = data.substr(*position, length);
+  *position += length;
+  return true;
+}
+
+// Decodes the session history encoded in the binary format in
+// |restore_session_url|.
+absl::optional<BinarySession> DecodeBinarySession(
+    const GURL& restore_session_url) {
+  const std::string& ref = restore_session_url.ref();
+  if (!base::StartsWith(ref, kRestoreSessionBinarySessionHashPrefix))
+    return absl::nullopt;
+  std::string data;
+  if (!base::Base64UrlDecode(
+          ref.substr(strlen(kRestoreSessionBinarySessionHashPrefix)),
+          base::Base64UrlDecodePolicy::DISALLOW_PADDING, &data)) {
+    return absl::nullopt;
+  }
+
+  size_t position = 0;
+  size_t version = 0;
+  size_t offset = 0;
+  size_t count = 0;
+  if (!ReadVarint(data, &position, &version) || version != 1 ||
+      !ReadVarint(data, &position, &offset) ||
+      !ReadVarint(data, &position, &count)) {
+    return absl::nullopt;
+  }
+
+  BinarySession session;
+  session.offset = -static_cast<int>(offset);
+  std::string previous_url;
+  for (size_t i = 0; i < count; ++i) {
+    size_t shared_size = 0;
+    std::string url_suffix;
+    std::string title;
+    if (!ReadVarint(data, &position, &shared_size) ||
+        shared_size > previous_url.size() ||
+        !ReadBytes(data, &position, &url_suffix) ||
+        !ReadBytes(data, &position, &title)) {
+      return absl::nullopt;
+    }
+    previous_url = previous_url.substr(0, shared_size) + url_suffix;
+    session.urls.push_back(previous_url);
+    session.titles.push_back(title);
+  }
+  if (position != data.size())
+    return absl::nullopt;
+  return session;
+}
+
 }  // namespace
 
 typedef PlatformTest WKNavigationUtilTest;
@@ -152,6 +233,45 @@ TEST_F(WKNavigationUtilTest, CreateRestoreSessionUrl) {
             session_json);
 }
 
+// Tests that the session history is encoded in the binary format when
+// kCompactRestoreSessionUrl is enabled, and that the shared URL prefixes and
+// the non-ASCII titles are preserved.
+TEST_F(WKNavigationUtilTest, CreateBinaryRestoreSessionUrl) {
+  base::test::ScopedFeatureList scoped_feature_list;
+  scoped_feature_list.InitAndEnableFeature(features::kCompactRestoreSessionUrl);
+
+  const char* const kUrls[] = {
+      "https://www.example.com/a/b",
+      "https://www.example.com/a/c?q=1",
+      "https://www.example.org/",
+      "https://www.example.org/",
+  };
+  std::vector<std::unique_ptr<NavigationItem>> items;
+  for (const char* url : kUrls) {
+    auto item = std::make_unique<NavigationItemImpl>();
+    item->SetURL(GURL(url));
+    item->SetTitle(u"Caf\u00e9 " + base::UTF8ToUTF16(url));
+    items.push_back(std::move(item));
+  }
+
+  int first_index = 0;
+  GURL restore_session_url;
+  CreateRestoreSessionUrl(1 /* last_committed_item_index */, items,
+                          &restore_session_url, &first_index);
+  ASSERT_EQ(0, first_index);
+  ASSERT_TRUE(IsRestoreSessionUrl(restore_session_url));
+
+  absl::optional<BinarySession> session =
+      DecodeBinarySession(restore_session_url);
+  ASSERT_TRUE(session);
+  EXPECT_EQ(-2, session->offset);
+  ASSERT_EQ(std::size(kUrls), session->urls.size());
+  for (size_t i = 0; i < std::size(kUrls); ++i) {
+    EXPECT_EQ(items[i]->GetURL().spec(), session->urls[i]);
+    EXPECT_EQ(base::UTF16ToUTF8(items[i]->GetTitle()), session->titles[i]);
+  }
+}
+
 // In the past the math within CreateRestoreSessionUrl has had some edge case
 // crashes.  Ensure that nothing crashes.
 TEST_F(WKNavigationUtilTest, CreateRestoreSessionBruteForce) {
@@ -0,0 +1,76 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef IOS_WEB_NET_COOKIES_COOKIE_DOMAIN_SNAPSHOT_H_
+#define IOS_WEB_NET_COOKIES_COOKIE_DOMAIN_SNAPSHOT_H_
+
+#import <Foundation/Foundation.h>
+
+#include <map>
+#include <string>
+
+#include "base/memory/weak_ptr.h"
+#include "base/sequence_checker.h"
+#include "base/strings/string_piece.h"
+
+class GURL;
+
+namespace web {
+
+// An index of a system cookie store content keyed by registrable domain.
+// The snapshot is built from the NSArray returned by a getAllCookies: call
+// and is only rebuilt when a different array is provided, i.e. once per
+// change of the underlying store. URL lookups then only need to consider the
+// cookies stored under the URL registrable domain instead of every cookie.
+// Must be used on a single sequence (the IO thread).
+class CookieDomainSnapshot {
+ public:
+  CookieDomainSnapshot();
+
+  CookieDomainSnapshot(const CookieDomainSnapshot&) = delete;
+  CookieDomainSnapshot& operator=(const CookieDomainSnapshot&) = delete;
+
+  ~CookieDomainSnapshot();
+
+  // Rebuilds the index from |cookies| unless the snapshot was already built
+  // from this exact array instance. Returns whether the index was rebuilt.
+  bool UpdateIfNeeded(NSArray<NSHTTPCookie*>* cookies);
+
+  // Returns the cookies of the snapshot that may match |url|, in the order
+  // they appeared in the source array. The result is a superset of the
+  // cookies to send with a request to |url|; callers still need to check path,
+  // secure and same-site attributes.
+  NSArray<NSHTTPCookie*>* GetCandidateCookiesForURL(const GURL& url) const;
+
+  // Drops the current index. The next call to UpdateIfNeeded() will rebuild
+  // it.
+  void Reset();
+
+  // Returns the number of distinct keys in the index.
+  size_t domain_count() const { return cookies_by_domain_.size(); }
+
+  base::WeakPtr<CookieDomainSnapshot> GetWeakPtr();
+
+  // Returns the key under which cookies for |host| are indexed: the
+  // registrable domain of |host|, or |host| itself when it has none (IP
+  // addresses, single-label hosts or public suffixes). A leading dot, as found
+  // in domain cookies, is ignored.
+  static std::string IndexKeyForHost(base::StringPiece host);
+
+ private:
+  // The array the index was built from. Retained so that its identity can be
+  // compared with subsequent getAllCookies: results.
+  NSArray<NSHTTPCookie*>* source_cookies_ = nil;
+
+  // Cookies from |source_cookies_| grouped by IndexKeyForHost(cookie.domain).
+  std::map<std::string, NSMutableArray<NSHTTPCookie*>*> cookies_by_domain_;
+
+  SEQUENCE_CHECKER(sequence_checker_);
+
+  base::WeakPtrFactory<CookieDomainSnapshot> weak_factory_{this};
+};
+
+}  // namespace web
+
+#endif  // IOS_WEB_NET_COOKIES_COOKIE_DOMAIN_SNAPSHOT_H_
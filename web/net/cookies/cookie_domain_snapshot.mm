@@ -0,0 +1,78 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#import "ios/web/net/cookies/cookie_domain_snapshot.h"
+
+#include "base/strings/string_util.h"
+#include "base/strings/sys_string_conversions.h"
+#include "net/base/registry_controlled_domains/registry_controlled_domain.h"
+#include "url/gurl.h"
+
+#if !defined(__has_feature) || !__has_feature(objc_arc)
+#error "This file requires ARC support."
+#endif
+
+namespace web {
+
+CookieDomainSnapshot::CookieDomainSnapshot() {
+  // The snapshot is created with its owning cookie store, which may happen on
+  // a different thread than the one it is used on.
+  DETACH_FROM_SEQUENCE(sequence_checker_);
+}
+
+CookieDomainSnapshot::~CookieDomainSnapshot() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+}
+
+bool CookieDomainSnapshot::UpdateIfNeeded(NSArray<NSHTTPCookie*>* cookies) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  DCHECK(cookies);
+  if (cookies == source_cookies_)
+    return false;
+
+  cookies_by_domain_.clear();
+  for (NSHTTPCookie* cookie in cookies) {
+    NSMutableArray<NSHTTPCookie*>*& bucket =
+        cookies_by_domain_[IndexKeyForHost(
+            base::SysNSStringToUTF8(cookie.domain))];
+    if (!bucket)
+      bucket = [NSMutableArray array];
+    [bucket addObject:cookie];
+  }
+  source_cookies_ = cookies;
+  return true;
+}
+
+NSArray<NSHTTPCookie*>* CookieDomainSnapshot::GetCandidateCookiesForURL(
+    const GURL& url) const {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  DCHECK(source_cookies_);
+  auto it = cookies_by_domain_.find(IndexKeyForHost(url.host_piece()));
+  if (it == cookies_by_domain_.end())
+    return @[];
+  return it->second;
+}
+
+void CookieDomainSnapshot::Reset() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  source_cookies_ = nil;
+  cookies_by_domain_.clear();
+}
+
+base::WeakPtr<CookieDomainSnapshot> CookieDomainSnapshot::GetWeakPtr() {
+  return weak_factory_.GetWeakPtr();
+}
+
+// static
+std::string CookieDomainSnapshot::IndexKeyForHost(base::StringPiece host) {
+  if (base::StartsWith(host, "."))
+    host.remove_prefix(1);
+  std::string key = base::ToLowerASCII(host);
+  std::string registrable_domain =
+      net::registry_controlled_domains::GetDomainAndRegistry(
+          key, net::registry_controlled_domains::INCLUDE_PRIVATE_REGISTRIES);
+  return registrable_domain.empty() ? key : registrable_domain;
+}
+
+}  // namespace web
@@ -0,0 +1,89 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#import "ios/web/net/cookies/cookie_domain_snapshot.h"
+
+#import <Foundation/Foundation.h>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/platform_test.h"
+#include "url/gurl.h"
+
+#if !defined(__has_feature) || !__has_feature(objc_arc)
+#error "This file requires ARC support."
+#endif
+
+namespace web {
+
+namespace {
+
+// Returns a cookie named |name| for |domain|.
+NSHTTPCookie* CreateCookie(NSString* name, NSString* domain) {
+  return [NSHTTPCookie cookieWithProperties:@{
+    NSHTTPCookiePath : @"/",
+    NSHTTPCookieName : name,
+    NSHTTPCookieValue : @"value",
+    NSHTTPCookieDomain : domain,
+  }];
+}
+
+}  // namespace
+
+using CookieDomainSnapshotTest = PlatformTest;
+
+// Tests that index keys are registrable domains, falling back to the host.
+TEST_F(CookieDomainSnapshotTest, IndexKeyForHost) {
+  EXPECT_EQ("google.com", CookieDomainSnapshot::IndexKeyForHost("google.com"));
+  EXPECT_EQ("google.com",
+            CookieDomainSnapshot::IndexKeyForHost("foo.Google.com"));
+  EXPECT_EQ("google.com", CookieDomainSnapshot::IndexKeyForHost(".google.com"));
+  EXPECT_EQ("google.co.uk",
+            CookieDomainSnapshot::IndexKeyForHost("www.google.co.uk"));
+  EXPECT_EQ("127.0.0.1", CookieDomainSnapshot::IndexKeyForHost("127.0.0.1"));
+  EXPECT_EQ("localhost", CookieDomainSnapshot::IndexKeyForHost("localhost"));
+}
+
+// Tests that lookups only return the cookies of the URL registrable domain.
+TEST_F(CookieDomainSnapshotTest, GetCandidateCookiesForURL) {
+  NSHTTPCookie* host_cookie = CreateCookie(@"a", @"www.google.com");
+  NSHTTPCookie* domain_cookie = CreateCookie(@"b", @".google.com");
+  NSHTTPCookie* other_cookie = CreateCookie(@"c", @"example.com");
+  CookieDomainSnapshot snapshot;
+  EXPECT_TRUE(
+      snapshot.UpdateIfNeeded(@[ host_cookie, other_cookie, domain_cookie ]));
+  EXPECT_EQ(2U, snapshot.domain_count());
+
+  NSArray<NSHTTPCookie*>* result =
+      snapshot.GetCandidateCookiesForURL(GURL("https://mail.google.com/"));
+  ASSERT_EQ(2U, result.count);
+  EXPECT_EQ(host_cookie, result[0]);
+  EXPECT_EQ(domain_cookie, result[1]);
+
+  result = snapshot.GetCandidateCookiesForURL(GURL("http://example.com/a"));
+  ASSERT_EQ(1U, result.count);
+  EXPECT_EQ(other_cookie, result[0]);
+
+  EXPECT_EQ(0U, snapshot.GetCandidateCookiesForURL(GURL("http://chromium.org"))
+                    .count);
+}
+
+// Tests that the index is only rebuilt when a different array is provided.
+TEST_F(CookieDomainSnapshotTest, RebuildOnlyOnNewArray) {
+  NSArray<NSHTTPCookie*>* cookies = @[ CreateCookie(@"a", @"google.com") ];
+  CookieDomainSnapshot snapshot;
+  EXPECT_TRUE(snapshot.UpdateIfNeeded(cookies));
+  EXPECT_FALSE(snapshot.UpdateIfNeeded(cookies));
+
+  NSArray<NSHTTPCookie*>* new_cookies = @[ CreateCookie(@"b", @"example.com") ];
+  EXPECT_TRUE(snapshot.UpdateIfNeeded(new_cookies));
+  EXPECT_EQ(
+      0U, snapshot.GetCandidateCookiesForURL(GURL("http://google.com")).count);
+  EXPECT_EQ(
+      1U, snapshot.GetCandidateCookiesForURL(GURL("http://example.com")).count);
+
+  snapshot.Reset();
+  EXPECT_TRUE(snapshot.UpdateIfNeeded(new_cookies));
+}
+
+}  // namespace web
@@ -34,6 +34,17 @@ void PrioritizeWKHTTPCookieStoreCallbacks() {
 // thread.
 @property(nonatomic) NSArray<NSHTTPCookie*>* cachedCookies;
 
+// Completion handlers waiting for the in-flight getAllCookies call, or nil if
+// there is no such call. Concurrent getAllCookies requests are coalesced so
+// that all of them receive the same NSArray instance, which lets callers key
+// derived data (e.g. a domain index) on the array identity.
+@property(nonatomic)
+    NSMutableArray<void (^)(NSArray<NSHTTPCookie*>*)>* pendingHandlers;
+
+// Clears the cached cookies and detaches any in-flight fetch so that its
+// result is not cached.
+- (void)invalidateCachedCookies;
+
 @end
 
 @implementation CRWWKHTTPCookieStore
@@ -45,11 +56,23 @@ void PrioritizeWKHTTPCookieStoreCallbacks() {
     dispatch_async(dispatch_get_main_queue(), ^{
       completionHandler(result);
     });
+  } else if (_pendingHandlers) {
+    [_pendingHandlers addObject:[completionHandler copy]];
   } else {
+    NSMutableArray<void (^)(NSArray<NSHTTPCookie*>*)>* handlers =
+        [NSMutableArray arrayWithObject:[completionHandler copy]];
+    _pendingHandlers = handlers;
     __weak __typeof(self) weakSelf = self;
     [_HTTPCookieStore getAllCookies:^(NSArray<NSHTTPCookie*>* cookies) {
-      weakSelf.cachedCookies = cookies;
-      completionHandler(cookies);
+      __typeof(self) strongSelf = weakSelf;
+      // Only cache the result if the store wasn't invalidated while the fetch
+      // was in flight.
+      if (strongSelf && strongSelf.pendingHandlers == handlers) {
+        strongSelf.cachedCookies = cookies;
+        strongSelf.pendingHandlers = nil;
+      }
+      for (void (^handler)(NSArray<NSHTTPCookie*>*) in handlers)
+        handler(cookies);
     }];
     PrioritizeWKHTTPCookieStoreCallbacks();
   }
@@ -58,20 +81,20 @@ void PrioritizeWKHTTPCookieStoreCallbacks() {
 - (void)setCookie:(NSHTTPCookie*)cookie
     completionHandler:(nullable void (^)(void))completionHandler {
   DCHECK_CURRENTLY_ON(web::WebThread::UI);
-  _cachedCookies = nil;
+  [self invalidateCachedCookies];
   [_HTTPCookieStore setCookie:cookie completionHandler:completionHandler];
 }
 
 - (void)deleteCookie:(NSHTTPCookie*)cookie
     completionHandler:(nullable void (^)(void))completionHandler {
   DCHECK_CURRENTLY_ON(web::WebThread::UI);
-  _cachedCookies = nil;
+  [self invalidateCachedCookies];
   [_HTTPCookieStore deleteCookie:cookie completionHandler:completionHandler];
 }
 
 - (void)setHTTPCookieStore:(WKHTTPCookieStore*)newCookieStore {
   DCHECK_CURRENTLY_ON(web::WebThread::UI);
-  _cachedCookies = nil;
+  [self invalidateCachedCookies];
   if (newCookieStore == _HTTPCookieStore)
     return;
   [_HTTPCookieStore removeObserver:self];
@@ -82,7 +105,14 @@ void PrioritizeWKHTTPCookieStoreCallbacks() {
 #pragma mark WKHTTPCookieStoreObserver method
 
 - (void)cookiesDidChangeInCookieStore:(WKHTTPCookieStore*)cookieStore {
+  [self invalidateCachedCookies];
+}
+
+#pragma mark Private
+
+- (void)invalidateCachedCookies {
   _cachedCookies = nil;
+  _pendingHandlers = nil;
 }
 
 @end
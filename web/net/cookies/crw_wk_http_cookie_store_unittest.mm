@@ -126,6 +126,33 @@ TEST_F(CRWWKHTTPCookieStoreTest, GetCookiesCachedCorrectly) {
   EXPECT_OCMOCK_VERIFY(mock_http_cookie_store_);
 }
 
+// Tests that concurrent getAllCookies calls are coalesced into a single fetch
+// and all receive the same array instance.
+TEST_F(CRWWKHTTPCookieStoreTest, ConcurrentGetCookiesCoalesced) {
+  EXPECT_TRUE(SetCookie(test_cookie_1_));
+
+  OCMExpect([mock_http_cookie_store_ getAllCookies:[OCMArg any]])
+      .andForwardToRealObject();
+  __block NSArray<NSHTTPCookie*>* result_1 = nil;
+  __block NSArray<NSHTTPCookie*>* result_2 = nil;
+  [crw_cookie_store_ getAllCookies:^(NSArray<NSHTTPCookie*>* cookies) {
+    result_1 = cookies;
+  }];
+  // The second call is issued before the first one completes and must not
+  // trigger another fetch on the internal cookie store.
+  [[mock_http_cookie_store_ reject] getAllCookies:[OCMArg any]];
+  [crw_cookie_store_ getAllCookies:^(NSArray<NSHTTPCookie*>* cookies) {
+    result_2 = cookies;
+  }];
+  EXPECT_TRUE(WaitUntilConditionOrTimeout(kWaitForCookiesTimeout, ^bool {
+    return result_1 && result_2;
+  }));
+
+  EXPECT_EQ(1U, result_1.count);
+  EXPECT_EQ(result_1, result_2);
+  EXPECT_OCMOCK_VERIFY(mock_http_cookie_store_);
+}
+
 // Tests that |setCookie:| works correctly and invalidates the cache.
 TEST_F(CRWWKHTTPCookieStoreTest, SetCookie) {
   // Verify that internal cookie store setCookie method was called.
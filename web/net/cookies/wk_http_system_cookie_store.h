@@ -8,7 +8,10 @@
 #import <Foundation/Foundation.h>
 #import <WebKit/WebKit.h>
 
+#include <memory>
+
 #import "ios/net/cookies/system_cookie_store.h"
+#import "ios/web/net/cookies/cookie_domain_snapshot.h"
 #import "ios/web/net/cookies/crw_wk_http_cookie_store.h"
 #import "ios/web/web_state/ui/wk_web_view_configuration_provider_observer.h"
 
@@ -64,15 +67,25 @@ class WKHTTPSystemCookieStore : public net::SystemCookieStore,
   // Filters |cookies| to match |include_url|, sorts based on RFC6265 using
   // |weak_time_manager| and then runs |callback|.
   // If |include_url| is empty then cookies are processed without filtering.
+  // Otherwise only the cookies indexed under the |include_url| registrable
+  // domain in |weak_snapshot| are considered, after |weak_snapshot| has been
+  // refreshed from |cookies| if needed.
   static void ProcessGetCookiesResultInIOThread(
       net::SystemCookieStore::SystemCookieCallbackForCookies callback,
       base::WeakPtr<net::CookieCreationTimeManager> weak_time_manager,
+      base::WeakPtr<CookieDomainSnapshot> weak_snapshot,
       const GURL& include_url,
       NSArray<NSHTTPCookie*>* cookies);
 
   // Using CRWWKHTTPCookieStore instead of using WKHTTPCookieStore directly to
   // work around several bugs on WKHTTPCookieStore.
   CRWWKHTTPCookieStore* crw_cookie_store_ = nil;
+
+  // Index of the last getAllCookies result by registrable domain. Only used
+  // on the IO thread. It is rebuilt once each time |crw_cookie_store_|
+  // returns a new cookie array, i.e. once per change of the store, and is
+  // shared by all the GetCookiesForURLAsync calls in between.
+  std::unique_ptr<CookieDomainSnapshot> snapshot_;
 };
 
 }  // namespace web
@@ -69,7 +69,8 @@ bool ShouldIncludeForRequestUrl(NSHTTPCookie* cookie, const GURL& url) {
 
 WKHTTPSystemCookieStore::WKHTTPSystemCookieStore(
     WKWebViewConfigurationProvider* config_provider)
-    : crw_cookie_store_([[CRWWKHTTPCookieStore alloc] init]) {
+    : crw_cookie_store_([[CRWWKHTTPCookieStore alloc] init]),
+      snapshot_(std::make_unique<CookieDomainSnapshot>()) {
   crw_cookie_store_.HTTPCookieStore = config_provider->GetWebViewConfiguration()
                                           .websiteDataStore.httpCookieStore;
   config_provider->AddObserver(this);
@@ -209,6 +210,7 @@ void WKHTTPSystemCookieStore::GetCookiesAsyncInternal(
   __block SystemCookieCallbackForCookies shared_callback = std::move(callback);
   base::WeakPtr<net::CookieCreationTimeManager> weak_time_manager =
       creation_time_manager_->GetWeakPtr();
+  base::WeakPtr<CookieDomainSnapshot> weak_snapshot = snapshot_->GetWeakPtr();
   __weak __typeof(crw_cookie_store_) weak_cookie_store = crw_cookie_store_;
   GURL block_url = include_url;
   web::GetUIThreadTaskRunner({})->PostTask(
@@ -217,13 +219,14 @@ void WKHTTPSystemCookieStore::GetCookiesAsyncInternal(
         if (strong_cookie_store) {
           [strong_cookie_store
               getAllCookies:^(NSArray<NSHTTPCookie*>* cookies) {
-                ProcessGetCookiesResultInIOThread(std::move(shared_callback),
-                                                  weak_time_manager, block_url,
-                                                  cookies);
+                ProcessGetCookiesResultInIOThread(
+                    std::move(shared_callback), weak_time_manager,
+                    weak_snapshot, block_url, cookies);
               }];
         } else {
           ProcessGetCookiesResultInIOThread(std::move(shared_callback),
-                                            weak_time_manager, block_url, @[]);
+                                            weak_time_manager, weak_snapshot,
+                                            block_url, @[]);
         }
       }));
 }
@@ -232,6 +235,7 @@ void WKHTTPSystemCookieStore::GetCookiesAsyncInternal(
 void WKHTTPSystemCookieStore::ProcessGetCookiesResultInIOThread(
     net::SystemCookieStore::SystemCookieCallbackForCookies callback,
     base::WeakPtr<net::CookieCreationTimeManager> weak_time_manager,
+    base::WeakPtr<CookieDomainSnapshot> weak_snapshot,
     const GURL& include_url,
     NSArray<NSHTTPCookie*>* _Nonnull cookies) {
   if (callback.is_null())
@@ -243,8 +247,16 @@ void WKHTTPSystemCookieStore::ProcessGetCookiesResultInIOThread(
       shared_callback = std::move(callback);
   RunBlockOnIOThread(^{
     if (!block_url.is_empty()) {
+      // Only look at the cookies stored under the URL registrable domain.
+      // The snapshot is only rebuilt when |block_cookies| is a different array
+      // than the one it was built from.
+      NSArray<NSHTTPCookie*>* candidate_cookies = block_cookies;
+      if (weak_snapshot) {
+        weak_snapshot->UpdateIfNeeded(block_cookies);
+        candidate_cookies = weak_snapshot->GetCandidateCookiesForURL(block_url);
+      }
       NSMutableArray* filtered_cookies = [NSMutableArray array];
-      for (NSHTTPCookie* cookie in block_cookies) {
+      for (NSHTTPCookie* cookie in candidate_cookies) {
         if (ShouldIncludeForRequestUrl(cookie, block_url)) {
           [filtered_cookies addObject:cookie];
         }
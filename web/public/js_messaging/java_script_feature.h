@@ -119,6 +119,12 @@ class JavaScriptFeature {
     // Returns the JavaScript string of the script with |script_filename_|.
     NSString* GetScriptString() const;
 
+    // Returns a closure which computes the string returned by
+    // GetScriptString(), so that it isn't read from disk when needed. The
+    // placeholder replacements are resolved by this call, so the closure can
+    // run on any thread.
+    base::OnceClosure CreateScriptStringPrewarmClosure() const;
+
     InjectionTime GetInjectionTime() const { return injection_time_; }
     TargetFrames GetTargetFrames() const { return target_frames_; }
 
@@ -131,9 +137,12 @@ class JavaScriptFeature {
                   ReinjectionBehavior reinjection_behavior,
                   const PlaceholderReplacementsCallback& replacements_callback);
 
-    // Returns |script| after swapping the placeholders with their value as
-    // instructed by |replacements_callback_|.
-    NSString* ReplacePlaceholders(NSString* script) const;
+    // Returns the placeholder replacements of the script, or nil.
+    PlaceholderReplacements GetPlaceholderReplacements() const;
+
+    // Returns the token making the script injectable once, or nil if it is
+    // reinjected on document recreation.
+    NSString* GetInjectionToken() const;
 
     std::string script_filename_;
     InjectionTime injection_time_;
@@ -7,6 +7,7 @@
 
 namespace web {
 
+class BrowserState;
 class JavaScriptFeature;
 
 namespace java_script_features {
@@ -23,6 +24,13 @@ JavaScriptFeature* GetCommonJavaScriptFeature();
 // __gCrWeb.message APIs.
 JavaScriptFeature* GetMessageJavaScriptFeature();
 
+// Loads the scripts of the JavaScriptFeatures injected in the web views of
+// |browser_state| on a background thread, so that configuring its first web
+// view doesn't read them from disk on the main thread. To be called as early
+// as possible once |browser_state| is created. Must be called on the main
+// thread.
+void PrewarmJavaScriptFeatureScripts(BrowserState* browser_state);
+
 }  // namespace java_script_features
 }  // namespace web
 
@@ -41,9 +41,18 @@ class CertPolicy {
   // This function returns either ALLOWED or UNKNOWN, but never DENIED.
   Judgment Check(net::X509Certificate* cert, net::CertStatus error) const;
 
+  // Same as above, for the certificate whose chain fingerprint is
+  // |fingerprint|. Does not allocate.
+  Judgment Check(const net::SHA256HashValue& fingerprint,
+                 net::CertStatus error) const;
+
   // Causes the policy to allow this certificate for a given |error|.
   void Allow(net::X509Certificate* cert, net::CertStatus error);
 
+  // Same as above, for the certificate whose chain fingerprint is
+  // |fingerprint|.
+  void Allow(const net::SHA256HashValue& fingerprint, net::CertStatus error);
+
  private:
   // The set of fingerprints of allowed certificates.
   std::map<net::SHA256HashValue, net::CertStatus> allowed_;
@@ -6,6 +6,7 @@
 #define IOS_WEB_PUBLIC_SECURITY_CERTIFICATE_POLICY_CACHE_H_
 
 #include <map>
+#include <memory>
 #include <string>
 
 #include "ios/web/public/security/cert_policy.h"
@@ -13,6 +14,8 @@
 
 namespace web {
 
+class ChainFingerprintCache;
+
 // A manager for certificate policy decisions for hosts, used to remember
 // decisions about how to handle problematic certs.
 // This class is thread-safe only in that in can be created and passed around
@@ -50,6 +53,9 @@ class CertificatePolicyCache
 
   // Certificate policies for each host.
   std::map<std::string, CertPolicy> cert_policy_for_host_;
+  // Chain fingerprints of the recently queried certificates, so that repeated
+  // decisions for the same chain don't hash it again.
+  std::unique_ptr<ChainFingerprintCache> fingerprint_cache_;
 };
 
 }  // namespace web
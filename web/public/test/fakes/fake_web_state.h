@@ -39,6 +39,7 @@ class FakeWebState : public WebState {
   void SetDelegate(WebStateDelegate* delegate) override;
   bool IsRealized() const final;
   WebState* ForceRealized() final;
+  bool Unrealize() final;
   bool IsWebUsageEnabled() const override;
   void SetWebUsageEnabled(bool enabled) override;
   UIView* GetView() override;
@@ -72,6 +72,17 @@ WebState* FakeWebState::ForceRealized() {
   return this;
 }
 
+bool FakeWebState::Unrealize() {
+  if (!is_realized_)
+    return false;
+  is_realized_ = false;
+  // The web usage of the WebState realized next is enabled by default.
+  web_usage_enabled_ = true;
+  for (auto& observer : observers_)
+    observer.WebStateUnrealized(this);
+  return true;
+}
+
 BrowserState* FakeWebState::GetBrowserState() const {
   return browser_state_;
 }
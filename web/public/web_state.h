@@ -184,7 +184,8 @@ class WebState : public base::SupportsUserData {
 
   ~WebState() override {}
 
-  // Gets/Sets the delegate.
+  // Gets/Sets the delegate. The delegate is kept while the WebState is
+  // unrealized, and setting it does not realize the WebState.
   virtual WebStateDelegate* GetDelegate() = 0;
   virtual void SetDelegate(WebStateDelegate* delegate) = 0;
 
@@ -221,6 +222,17 @@ class WebState : public base::SupportsUserData {
   //    web_state->ForceRealized()->SetDelegate(this);
   virtual WebState* ForceRealized() = 0;
 
+  // Brings a realized WebState back to the "unrealized" state, destroying its
+  // WKWebView and NavigationManager and keeping only their serialized
+  // representation, so that the memory they use is released. The WebState
+  // will be realized again when needed (e.g. when it is activated). Returns
+  // whether the WebState was unrealized; it is not if it was not realized,
+  // or if its state could not be restored from the serialized representation
+  // (e.g. while a JavaScript dialog is presented or when displaying WebUI).
+  //
+  // This is used to discard the background WebStates on memory pressure.
+  virtual bool Unrealize() = 0;
+
   // Whether or not a web view is allowed to exist in this WebState. Defaults
   // to false; this should be enabled before attempting to access the view.
   virtual bool IsWebUsageEnabled() const = 0;
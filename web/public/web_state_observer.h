@@ -155,6 +155,11 @@ class WebStateObserver : public base::CheckedObserver {
   // operational after being restored).
   virtual void WebStateRealized(WebState* web_state) {}
 
+  // Invoked when the WebState becomes unrealized (see WebState::Unrealize()),
+  // after its web view has been destroyed. WebStateRealized() is invoked again
+  // if the WebState is later realized.
+  virtual void WebStateUnrealized(WebState* web_state) {}
+
   // Invoked when the WebState is being destroyed. Gives subclasses a chance
   // to cleanup.
   virtual void WebStateDestroyed(WebState* web_state) {}
@@ -85,6 +85,9 @@ enum Permission : NSUInteger;
 // Invoked by WebStateObserverBridge::WebStateRealized.
 - (void)webStateRealized:(web::WebState*)webState;
 
+// Invoked by WebStateObserverBridge::WebStateUnrealized.
+- (void)webStateUnrealized:(web::WebState*)webState;
+
 // Note: after |webStateDestroyed:| is invoked, the WebState being observed
 // is no longer valid.
 - (void)webStateDestroyed:(web::WebState*)webState;
@@ -135,6 +138,7 @@ class WebStateObserverBridge : public web::WebStateObserver {
                                      WebFrame* web_frame) override;
   void RenderProcessGone(web::WebState* web_state) override;
   void WebStateRealized(web::WebState* web_state) override;
+  void WebStateUnrealized(web::WebState* web_state) override;
   void WebStateDestroyed(web::WebState* web_state) override;
 
  private:
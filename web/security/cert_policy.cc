@@ -16,7 +16,12 @@ CertPolicy::~CertPolicy() {}
 // |error| is an exact match to or subset of the errors in the saved CertStatus.
 CertPolicy::Judgment CertPolicy::Check(net::X509Certificate* cert,
                                        net::CertStatus error) const {
-  auto allowed_iter = allowed_.find(cert->CalculateChainFingerprint256());
+  return Check(cert->CalculateChainFingerprint256(), error);
+}
+
+CertPolicy::Judgment CertPolicy::Check(const net::SHA256HashValue& fingerprint,
+                                       net::CertStatus error) const {
+  auto allowed_iter = allowed_.find(fingerprint);
   if ((allowed_iter != allowed_.end()) && (allowed_iter->second & error) &&
       !(~(allowed_iter->second & error) ^ ~error)) {
     return ALLOWED;
@@ -25,9 +30,14 @@ CertPolicy::Judgment CertPolicy::Check(net::X509Certificate* cert,
 }
 
 void CertPolicy::Allow(net::X509Certificate* cert, net::CertStatus error) {
+  Allow(cert->CalculateChainFingerprint256(), error);
+}
+
+void CertPolicy::Allow(const net::SHA256HashValue& fingerprint,
+                       net::CertStatus error) {
   // If this same cert had already been saved with a different error status,
   // this will replace it with the new error status.
-  allowed_[cert->CalculateChainFingerprint256()] = error;
+  allowed_[fingerprint] = error;
 }
 
 }  // namespace web
@@ -0,0 +1,64 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ios/web/public/security/cert_policy.h"
+
+#include "base/bind.h"
+#include "base/memory/ref_counted.h"
+#include "ios/testing/perf_test_util.h"
+#include "net/cert/x509_certificate.h"
+#include "net/test/test_certificate_data.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/platform_test.h"
+
+namespace web {
+
+namespace {
+
+// Number of policy checks per measure.
+const size_t kIterations = 10000;
+
+// Checks |cert| against |policy| and expects it to be allowed.
+void CheckAllowed(const CertPolicy* policy, net::X509Certificate* cert) {
+  EXPECT_EQ(CertPolicy::ALLOWED,
+            policy->Check(cert, net::CERT_STATUS_DATE_INVALID));
+}
+
+// Checks |fingerprint| against |policy| and expects it to be allowed.
+void CheckFingerprintAllowed(const CertPolicy* policy,
+                             const net::SHA256HashValue& fingerprint) {
+  EXPECT_EQ(CertPolicy::ALLOWED,
+            policy->Check(fingerprint, net::CERT_STATUS_DATE_INVALID));
+}
+
+}  // namespace
+
+using CertPolicyPerfTest = PlatformTest;
+
+// Measures the check of an allowed certificate, with and without a
+// precomputed chain fingerprint.
+TEST_F(CertPolicyPerfTest, Check) {
+  scoped_refptr<net::X509Certificate> cert(
+      net::X509Certificate::CreateFromBytes(google_der));
+  ASSERT_TRUE(cert);
+  CertPolicy policy;
+  policy.Allow(cert.get(), net::CERT_STATUS_DATE_INVALID);
+
+  testing::ReportPerfResult(
+      "CertPolicy", "Check certificate",
+      testing::MeasureMicroseconds(
+          kIterations,
+          base::BindRepeating(&CheckAllowed, &policy, base::RetainedRef(cert))),
+      "us");
+
+  testing::ReportPerfResult(
+      "CertPolicy", "Check fingerprint",
+      testing::MeasureMicroseconds(
+          kIterations,
+          base::BindRepeating(&CheckFingerprintAllowed, &policy,
+                              cert->CalculateChainFingerprint256())),
+      "us");
+}
+
+}  // namespace web
@@ -6,10 +6,12 @@
 
 #include "base/check_op.h"
 #include "ios/web/public/thread/web_thread.h"
+#include "ios/web/security/chain_fingerprint_cache.h"
 
 namespace web {
 
-CertificatePolicyCache::CertificatePolicyCache() {}
+CertificatePolicyCache::CertificatePolicyCache()
+    : fingerprint_cache_(std::make_unique<ChainFingerprintCache>()) {}
 
 CertificatePolicyCache::~CertificatePolicyCache() {}
 
@@ -17,7 +19,8 @@ void CertificatePolicyCache::AllowCertForHost(net::X509Certificate* cert,
                                               const std::string& host,
                                               net::CertStatus error) {
   DCHECK_CURRENTLY_ON(WebThread::IO);
-  cert_policy_for_host_[host].Allow(cert, error);
+  cert_policy_for_host_[host].Allow(fingerprint_cache_->GetFingerprint(cert),
+                                    error);
 }
 
 CertPolicy::Judgment CertificatePolicyCache::QueryPolicy(
@@ -25,12 +28,16 @@ CertPolicy::Judgment CertificatePolicyCache::QueryPolicy(
     const std::string& host,
     net::CertStatus error) {
   DCHECK_CURRENTLY_ON(WebThread::IO);
-  return cert_policy_for_host_[host].Check(cert, error);
+  auto iter = cert_policy_for_host_.find(host);
+  if (iter == cert_policy_for_host_.end())
+    return CertPolicy::UNKNOWN;
+  return iter->second.Check(fingerprint_cache_->GetFingerprint(cert), error);
 }
 
 void CertificatePolicyCache::ClearCertificatePolicies() {
   DCHECK_CURRENTLY_ON(WebThread::IO);
   cert_policy_for_host_.clear();
+  fingerprint_cache_->Clear();
 }
 
 }  // namespace web
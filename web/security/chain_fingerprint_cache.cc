@@ -0,0 +1,76 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ios/web/security/chain_fingerprint_cache.h"
+
+#include <stdint.h>
+
+#include <utility>
+
+#include "base/hash/hash.h"
+#include "net/cert/x509_certificate.h"
+
+namespace web {
+
+namespace {
+
+// Returns a hash of the addresses of the buffers of the chain of |cert|.
+size_t HashChainBuffers(const net::X509Certificate* cert) {
+  size_t hash =
+      base::HashInts64(0, reinterpret_cast<uintptr_t>(cert->cert_buffer()));
+  for (const auto& buffer : cert->intermediate_buffers())
+    hash = base::HashInts64(hash, reinterpret_cast<uintptr_t>(buffer.get()));
+  return hash;
+}
+
+}  // namespace
+
+ChainFingerprintCache::Entry::Entry() = default;
+ChainFingerprintCache::Entry::Entry(Entry&& other) = default;
+ChainFingerprintCache::Entry& ChainFingerprintCache::Entry::operator=(
+    Entry&& other) = default;
+ChainFingerprintCache::Entry::~Entry() = default;
+
+bool ChainFingerprintCache::Entry::MatchesChainOf(
+    const net::X509Certificate* cert) const {
+  const auto& intermediates = cert->intermediate_buffers();
+  if (buffers.size() != intermediates.size() + 1 ||
+      buffers[0].get() != cert->cert_buffer()) {
+    return false;
+  }
+  for (size_t i = 0; i < intermediates.size(); ++i) {
+    if (buffers[i + 1].get() != intermediates[i].get())
+      return false;
+  }
+  return true;
+}
+
+ChainFingerprintCache::ChainFingerprintCache(size_t max_size)
+    : entries_(max_size) {}
+
+ChainFingerprintCache::~ChainFingerprintCache() = default;
+
+net::SHA256HashValue ChainFingerprintCache::GetFingerprint(
+    const net::X509Certificate* cert) {
+  const size_t hash = HashChainBuffers(cert);
+  auto iter = entries_.Get(hash);
+  if (iter != entries_.end() && iter->second.MatchesChainOf(cert))
+    return iter->second.fingerprint;
+
+  Entry entry;
+  entry.buffers.reserve(cert->intermediate_buffers().size() + 1);
+  entry.buffers.push_back(bssl::UpRef(cert->cert_buffer()));
+  for (const auto& buffer : cert->intermediate_buffers())
+    entry.buffers.push_back(bssl::UpRef(buffer.get()));
+  entry.fingerprint = cert->CalculateChainFingerprint256();
+  const net::SHA256HashValue fingerprint = entry.fingerprint;
+  entries_.Put(hash, std::move(entry));
+  return fingerprint;
+}
+
+void ChainFingerprintCache::Clear() {
+  entries_.Clear();
+}
+
+}  // namespace web
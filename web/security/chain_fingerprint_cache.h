@@ -0,0 +1,72 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef IOS_WEB_SECURITY_CHAIN_FINGERPRINT_CACHE_H_
+#define IOS_WEB_SECURITY_CHAIN_FINGERPRINT_CACHE_H_
+
+#include <stddef.h>
+
+#include <vector>
+
+#include "base/containers/lru_cache.h"
+#include "net/base/hash_value.h"
+#include "third_party/boringssl/src/include/openssl/pool.h"
+
+namespace net {
+class X509Certificate;
+}
+
+namespace web {
+
+// Memoizes the SHA-256 chain fingerprints of certificates, keyed by the
+// identity of the CRYPTO_BUFFERs of their chain. Certificate buffers are
+// deduplicated by a pool, so the certificates of the same chain received for
+// different requests share their buffers. Entries keep a reference on the
+// buffers so that their addresses can't be reused while they are cached.
+// Looking up a cached fingerprint does not allocate. Not thread safe.
+class ChainFingerprintCache {
+ public:
+  // Default maximum number of cached chains.
+  static constexpr size_t kDefaultMaxSize = 64;
+
+  explicit ChainFingerprintCache(size_t max_size = kDefaultMaxSize);
+
+  ChainFingerprintCache(const ChainFingerprintCache&) = delete;
+  ChainFingerprintCache& operator=(const ChainFingerprintCache&) = delete;
+
+  ~ChainFingerprintCache();
+
+  // Returns the value of |cert->CalculateChainFingerprint256()|, computing it
+  // only if the chain of |cert| is not cached.
+  net::SHA256HashValue GetFingerprint(const net::X509Certificate* cert);
+
+  // Removes all the cached fingerprints.
+  void Clear();
+
+  // Returns the number of cached chains.
+  size_t size() const { return entries_.size(); }
+
+ private:
+  // A cached chain and its fingerprint.
+  struct Entry {
+    Entry();
+    Entry(Entry&& other);
+    Entry& operator=(Entry&& other);
+    ~Entry();
+
+    // Returns whether the chain of |cert| is the cached chain.
+    bool MatchesChainOf(const net::X509Certificate* cert) const;
+
+    // The leaf buffer followed by the intermediate buffers.
+    std::vector<bssl::UniquePtr<CRYPTO_BUFFER>> buffers;
+    net::SHA256HashValue fingerprint;
+  };
+
+  // Cached chains, by hash of the addresses of their buffers.
+  base::HashingLRUCache<size_t, Entry> entries_;
+};
+
+}  // namespace web
+
+#endif  // IOS_WEB_SECURITY_CHAIN_FINGERPRINT_CACHE_H_
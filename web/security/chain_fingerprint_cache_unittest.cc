@@ -0,0 +1,89 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ios/web/security/chain_fingerprint_cache.h"
+
+#include <utility>
+#include <vector>
+
+#include "base/memory/ref_counted.h"
+#include "net/cert/x509_certificate.h"
+#include "net/test/test_certificate_data.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/platform_test.h"
+
+namespace web {
+
+class ChainFingerprintCacheTest : public PlatformTest {
+ protected:
+  void SetUp() override {
+    PlatformTest::SetUp();
+    google_cert_ = net::X509Certificate::CreateFromBytes(google_der);
+    ASSERT_TRUE(google_cert_);
+    webkit_cert_ = net::X509Certificate::CreateFromBytes(webkit_der);
+    ASSERT_TRUE(webkit_cert_);
+  }
+
+  // Returns a certificate with the same buffers as |cert| and |intermediate|
+  // as intermediate.
+  scoped_refptr<net::X509Certificate> CreateChain(
+      net::X509Certificate* cert,
+      net::X509Certificate* intermediate) {
+    std::vector<bssl::UniquePtr<CRYPTO_BUFFER>> intermediates;
+    intermediates.push_back(bssl::UpRef(intermediate->cert_buffer()));
+    return net::X509Certificate::CreateFromBuffer(
+        bssl::UpRef(cert->cert_buffer()), std::move(intermediates));
+  }
+
+  scoped_refptr<net::X509Certificate> google_cert_;
+  scoped_refptr<net::X509Certificate> webkit_cert_;
+};
+
+// Tests that the cached fingerprints are the chain fingerprints.
+TEST_F(ChainFingerprintCacheTest, GetFingerprint) {
+  ChainFingerprintCache cache;
+  EXPECT_EQ(google_cert_->CalculateChainFingerprint256(),
+            cache.GetFingerprint(google_cert_.get()));
+  EXPECT_EQ(google_cert_->CalculateChainFingerprint256(),
+            cache.GetFingerprint(google_cert_.get()));
+  EXPECT_EQ(1u, cache.size());
+
+  scoped_refptr<net::X509Certificate> chain =
+      CreateChain(google_cert_.get(), webkit_cert_.get());
+  EXPECT_EQ(chain->CalculateChainFingerprint256(),
+            cache.GetFingerprint(chain.get()));
+  EXPECT_NE(google_cert_->CalculateChainFingerprint256(),
+            cache.GetFingerprint(chain.get()));
+  EXPECT_EQ(2u, cache.size());
+
+  cache.Clear();
+  EXPECT_EQ(0u, cache.size());
+}
+
+// Tests that certificates sharing their buffers share their cache entry.
+TEST_F(ChainFingerprintCacheTest, SharedBuffers) {
+  ChainFingerprintCache cache;
+  scoped_refptr<net::X509Certificate> chain =
+      CreateChain(google_cert_.get(), webkit_cert_.get());
+  scoped_refptr<net::X509Certificate> same_chain =
+      CreateChain(google_cert_.get(), webkit_cert_.get());
+  ASSERT_NE(chain.get(), same_chain.get());
+
+  EXPECT_EQ(cache.GetFingerprint(chain.get()),
+            cache.GetFingerprint(same_chain.get()));
+  EXPECT_EQ(1u, cache.size());
+}
+
+// Tests that the least recently used chains are evicted.
+TEST_F(ChainFingerprintCacheTest, Eviction) {
+  ChainFingerprintCache cache(/*max_size=*/1);
+  cache.GetFingerprint(google_cert_.get());
+  EXPECT_EQ(webkit_cert_->CalculateChainFingerprint256(),
+            cache.GetFingerprint(webkit_cert_.get()));
+  EXPECT_EQ(1u, cache.size());
+  EXPECT_EQ(google_cert_->CalculateChainFingerprint256(),
+            cache.GetFingerprint(google_cert_.get()));
+}
+
+}  // namespace web
@@ -7,6 +7,8 @@
 
 #include <CoreFoundation/CoreFoundation.h>
 
+#include <vector>
+
 #include "base/observer_list.h"
 #include "base/supports_user_data.h"
 
@@ -16,6 +18,7 @@
 namespace web {
 
 class BrowserState;
+class JavaScriptFeature;
 class WKContentRuleListProvider;
 class WKWebViewConfigurationProviderObserver;
 
@@ -87,6 +90,10 @@ class WKWebViewConfigurationProvider : public base::SupportsUserData::Data {
  private:
   explicit WKWebViewConfigurationProvider(BrowserState* browser_state);
   WKWebViewConfigurationProvider() = delete;
+
+  // Returns the JavaScriptFeatures configured in the web views.
+  std::vector<JavaScriptFeature*> GetJavaScriptFeatures();
+
   CRWWebUISchemeHandler* scheme_handler_ = nil;
   WKWebViewConfiguration* configuration_ = nil;
   BrowserState* browser_state_;
@@ -6,6 +6,8 @@
 
 #import <Foundation/Foundation.h>
 #import <WebKit/WebKit.h>
+
+#include <string>
 #include <vector>
 
 #include "base/check.h"
@@ -21,6 +23,7 @@
 #import "ios/web/js_messaging/web_frames_manager_java_script_feature.h"
 #import "ios/web/navigation/session_restore_java_script_feature.h"
 #include "ios/web/public/browser_state.h"
+#import "ios/web/public/js_messaging/java_script_feature.h"
 #include "ios/web/public/web_client.h"
 #import "ios/web/web_state/ui/wk_content_rule_list_provider.h"
 #import "ios/web/web_state/ui/wk_web_view_configuration_provider_observer.h"
@@ -179,6 +182,20 @@ WKWebViewConfigurationProvider::GetWebViewConfiguration() {
   return [configuration_ copy];
 }
 
+std::vector<JavaScriptFeature*>
+WKWebViewConfigurationProvider::GetJavaScriptFeatures() {
+  std::vector<JavaScriptFeature*> features;
+  for (JavaScriptFeature* feature :
+       java_script_features::GetBuiltInJavaScriptFeatures(browser_state_)) {
+    features.push_back(feature);
+  }
+  for (JavaScriptFeature* feature :
+       GetWebClient()->GetJavaScriptFeatures(browser_state_)) {
+    features.push_back(feature);
+  }
+  return features;
+}
+
 WKContentRuleListProvider*
 WKWebViewConfigurationProvider::GetContentRuleListProvider() {
   return content_rule_list_provider_.get();
@@ -189,17 +206,7 @@ void WKWebViewConfigurationProvider::UpdateScripts() {
 
   JavaScriptFeatureManager* java_script_feature_manager =
       JavaScriptFeatureManager::FromBrowserState(browser_state_);
-
-  std::vector<JavaScriptFeature*> features;
-  for (JavaScriptFeature* feature :
-       java_script_features::GetBuiltInJavaScriptFeatures(browser_state_)) {
-    features.push_back(feature);
-  }
-  for (JavaScriptFeature* feature :
-       GetWebClient()->GetJavaScriptFeatures(browser_state_)) {
-    features.push_back(feature);
-  }
-  java_script_feature_manager->ConfigureFeatures(features);
+  java_script_feature_manager->ConfigureFeatures(GetJavaScriptFeatures());
 
   WKUserContentController* userContentController =
       GetWebViewConfiguration().userContentController;
@@ -256,6 +256,7 @@ class WebStateImpl final : public WebState {
   void SetDelegate(WebStateDelegate* delegate) final;
   bool IsRealized() const final;
   WebState* ForceRealized() final;
+  bool Unrealize() final;
   bool IsWebUsageEnabled() const final;
   void SetWebUsageEnabled(bool enabled) final;
   UIView* GetView() final;
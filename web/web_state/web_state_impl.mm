@@ -316,11 +316,15 @@ void WebStateImpl::RemoveAllWebFrames() {
 #pragma mark - WebState implementation
 
 WebStateDelegate* WebStateImpl::GetDelegate() {
-  return LIKELY(pimpl_) ? pimpl_->GetDelegate() : nullptr;
+  return LIKELY(pimpl_) ? pimpl_->GetDelegate() : saved_->GetDelegate();
 }
 
 void WebStateImpl::SetDelegate(WebStateDelegate* delegate) {
-  RealizedState()->SetDelegate(delegate);
+  if (LIKELY(pimpl_)) {
+    pimpl_->SetDelegate(delegate);
+  } else {
+    saved_->SetDelegate(delegate);
+  }
 }
 
 bool WebStateImpl::IsRealized() const {
@@ -335,6 +339,8 @@ WebState* WebStateImpl::ForceRealized() {
     const CreateParams params = saved_->GetCreateParams();
     CRWSessionStorage* session_storage = saved_->GetSessionStorage();
     FaviconStatus favicon_status = saved_->GetFaviconStatus();
+    WebStateDelegate* delegate = saved_->GetDelegate();
+    saved_->SetDelegate(nullptr);
     DCHECK(session_storage);
 
     // Create the RealizedWebState. At this point the WebStateImpl has
@@ -353,6 +359,7 @@ WebState* WebStateImpl::ForceRealized() {
     // and `pimpl_` set.
     pimpl_->Init(params, session_storage);
     pimpl_->SetFaviconStatus(favicon_status);
+    pimpl_->SetDelegate(delegate);
 
     // Notify all observers that the WebState has become realized.
     for (auto& observer : observers_)
@@ -364,6 +371,46 @@ WebState* WebStateImpl::ForceRealized() {
   return this;
 }
 
+bool WebStateImpl::Unrealize() {
+  DCHECK(!is_being_destroyed_);
+
+  if (!pimpl_)
+    return false;
+
+  // The WebUI and the presented JavaScript dialog can't be recreated from
+  // the serialized state.
+  if (pimpl_->HasWebUI() || pimpl_->IsJavaScriptDialogRunning())
+    return false;
+
+  CRWSessionStorage* session_storage = pimpl_->BuildSessionStorage();
+  if (!session_storage)
+    return false;
+
+  CreateParams params(pimpl_->GetBrowserState());
+  params.created_with_opener = pimpl_->HasOpener();
+  params.last_active_time = pimpl_->GetLastActiveTime();
+  FaviconStatus favicon_status = pimpl_->GetFaviconStatus();
+  WebStateDelegate* delegate = pimpl_->GetDelegate();
+
+  // Close the web view while `pimpl_` is still set, as the CRWWebController
+  // may call back into the WebStateImpl while closing.
+  pimpl_->TearDownForUnrealize();
+
+  // As in ForceRealized(), both `pimpl_` and `saved_` are non-null for a
+  // short time which can't be observed by outside code.
+  saved_ = std::make_unique<SerializedData>(this, params, session_storage);
+  saved_->SetFaviconStatus(favicon_status);
+  saved_->SetDelegate(delegate);
+  pimpl_.reset();
+
+  // Notify all observers that the WebState has become unrealized, so that
+  // they release what they created when it was realized.
+  for (auto& observer : observers_)
+    observer.WebStateUnrealized(this);
+
+  return true;
+}
+
 bool WebStateImpl::IsWebUsageEnabled() const {
   return LIKELY(pimpl_) ? pimpl_->IsWebUsageEnabled() : true;
 }
@@ -49,6 +49,11 @@ class WebStateImpl::RealizedWebState final : public NavigationManagerDelegate {
   // pointer (thus it must be non-null).
   void TearDown();
 
+  // Tears down the RealizedWebState when the WebState goes back to the
+  // "unrealized" state. Unlike TearDown(), the WebState itself is not
+  // destroyed, so its observers and policy deciders are not notified.
+  void TearDownForUnrealize();
+
   // Returns the NavigationManagerImpl associated with the owning WebStateImpl.
   const NavigationManagerImpl& GetNavigationManager() const;
   NavigationManagerImpl& GetNavigationManager();
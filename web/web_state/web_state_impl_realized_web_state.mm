@@ -128,6 +128,12 @@ void WebStateImpl::RealizedWebState::TearDown() {
   SetDelegate(nullptr);
 }
 
+void WebStateImpl::RealizedWebState::TearDownForUnrealize() {
+  [web_controller_ close];
+  ClearWebUI();
+  SetDelegate(nullptr);
+}
+
 const NavigationManagerImpl&
 WebStateImpl::RealizedWebState::GetNavigationManager() const {
   return *navigation_manager_;
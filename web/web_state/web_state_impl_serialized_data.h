@@ -53,6 +53,8 @@ class WebStateImpl::SerializedData {
   const std::u16string& GetTitle() const;
   const FaviconStatus& GetFaviconStatus() const;
   void SetFaviconStatus(const FaviconStatus& favicon_status);
+  WebStateDelegate* GetDelegate();
+  void SetDelegate(WebStateDelegate* delegate);
   int GetNavigationItemCount() const;
   const GURL& GetVisibleURL() const;
   const GURL& GetLastCommittedURL() const;
@@ -86,6 +88,10 @@ class WebStateImpl::SerializedData {
 
   // Favicon status.
   FaviconStatus favicon_status_;
+
+  // Delegate, not owned by this object. Kept while the WebState is unrealized
+  // so that it is installed again when the WebState is realized.
+  WebStateDelegate* delegate_ = nullptr;
 };
 
 }  // namespace web
@@ -12,6 +12,7 @@
 #import "ios/web/public/session/crw_navigation_item_storage.h"
 #import "ios/web/public/session/crw_session_storage.h"
 #import "ios/web/public/session/serializable_user_data_manager.h"
+#import "ios/web/public/web_state_delegate.h"
 #import "ios/web/public/web_state_observer.h"
 
 namespace web {
@@ -47,6 +48,7 @@ void WebStateImpl::SerializedData::TearDown() {
     observer.WebStateDestroyed();
   for (auto& observer : policy_deciders())
     observer.ResetWebState();
+  SetDelegate(nullptr);
 }
 
 WebState::CreateParams WebStateImpl::SerializedData::GetCreateParams() const {
@@ -100,6 +102,20 @@ void WebStateImpl::SerializedData::SetFaviconStatus(
   favicon_status_ = favicon_status;
 }
 
+WebStateDelegate* WebStateImpl::SerializedData::GetDelegate() {
+  return delegate_;
+}
+
+void WebStateImpl::SerializedData::SetDelegate(WebStateDelegate* delegate) {
+  if (delegate == delegate_)
+    return;
+  if (delegate_)
+    delegate_->Detach(owner_);
+  delegate_ = delegate;
+  if (delegate_)
+    delegate_->Attach(owner_);
+}
+
 int WebStateImpl::SerializedData::GetNavigationItemCount() const {
   return session_storage_.itemStorages.count;
 }
@@ -14,6 +14,7 @@
 #include "base/bind.h"
 #include "base/logging.h"
 #include "base/mac/foundation_util.h"
+#include "base/scoped_observation.h"
 #import "base/strings/sys_string_conversions.h"
 #include "base/test/gmock_callback_support.h"
 #import "base/test/ios/wait_util.h"
@@ -1294,4 +1295,101 @@ TEST_F(WebStateImplTest, ReadAndWriteSessionStateData) {
     return web_state_->GetVisibleURL() == web_state->GetVisibleURL();
   }));
 }
+
+// Counts the realization and unrealization notifications of a WebState.
+class RealizationObserver : public WebStateObserver {
+ public:
+  explicit RealizationObserver(WebState* web_state) {
+    observation_.Observe(web_state);
+  }
+
+  int realized_count() const { return realized_count_; }
+  int unrealized_count() const { return unrealized_count_; }
+
+  // WebStateObserver:
+  void WebStateRealized(WebState* web_state) override {
+    EXPECT_TRUE(web_state->IsRealized());
+    ++realized_count_;
+  }
+  void WebStateUnrealized(WebState* web_state) override {
+    EXPECT_FALSE(web_state->IsRealized());
+    ++unrealized_count_;
+  }
+  void WebStateDestroyed(WebState* web_state) override {
+    observation_.Reset();
+  }
+
+ private:
+  int realized_count_ = 0;
+  int unrealized_count_ = 0;
+  base::ScopedObservation<WebState, WebStateObserver> observation_{this};
+};
+
+// Tests that a WebState can be unrealized and realized again without losing
+// its identity and history, and that the observers are notified of each
+// transition.
+TEST_F(WebStateImplTest, Unrealize) {
+  AddCommittedNavigationItem();
+  NSString* stable_identifier = web_state_->GetStableIdentifier();
+  const GURL visible_url = web_state_->GetVisibleURL();
+  ASSERT_TRUE(web_state_->IsRealized());
+  RealizationObserver observer(web_state_.get());
+
+  EXPECT_TRUE(web_state_->Unrealize());
+  EXPECT_FALSE(web_state_->IsRealized());
+  EXPECT_FALSE(web_state_->Unrealize());
+  EXPECT_EQ(1, observer.unrealized_count());
+
+  // The serialized state is still available while unrealized.
+  EXPECT_NSEQ(stable_identifier, web_state_->GetStableIdentifier());
+  EXPECT_EQ(visible_url, web_state_->GetVisibleURL());
+  EXPECT_EQ(1, web_state_->GetNavigationItemCount());
+
+  web_state_->ForceRealized();
+  EXPECT_TRUE(web_state_->IsRealized());
+  EXPECT_EQ(1, observer.realized_count());
+  EXPECT_NSEQ(stable_identifier, web_state_->GetStableIdentifier());
+  EXPECT_EQ(1, web_state_->GetNavigationManager()->GetItemCount());
+
+  // The WebState can go through the cycle again.
+  EXPECT_TRUE(web_state_->Unrealize());
+  web_state_->ForceRealized();
+  EXPECT_EQ(2, observer.unrealized_count());
+  EXPECT_EQ(2, observer.realized_count());
+}
+
+// Tests that the delegate is kept while the WebState is unrealized and is
+// installed again when it is realized.
+TEST_F(WebStateImplTest, UnrealizeKeepsDelegate) {
+  AddCommittedNavigationItem();
+  FakeWebStateDelegate delegate;
+  web_state_->SetDelegate(&delegate);
+
+  ASSERT_TRUE(web_state_->Unrealize());
+  EXPECT_EQ(&delegate, web_state_->GetDelegate());
+
+  web_state_->ForceRealized();
+  EXPECT_EQ(&delegate, web_state_->GetDelegate());
+
+  // The delegate is used by the realized WebState.
+  web_state_->CloseWebState();
+  ASSERT_TRUE(delegate.last_close_web_state_request());
+  EXPECT_EQ(web_state_.get(),
+            delegate.last_close_web_state_request()->web_state);
+
+  web_state_->SetDelegate(nullptr);
+}
+
+// Tests that the delegate of an unrealized WebState can be cleared without
+// realizing it, as the WebStateDelegate does when it is destroyed.
+TEST_F(WebStateImplTest, ClearDelegateOfUnrealizedWebState) {
+  AddCommittedNavigationItem();
+  {
+    FakeWebStateDelegate delegate;
+    web_state_->SetDelegate(&delegate);
+    ASSERT_TRUE(web_state_->Unrealize());
+  }
+  EXPECT_FALSE(web_state_->IsRealized());
+  EXPECT_FALSE(web_state_->GetDelegate());
+}
 }  // namespace web
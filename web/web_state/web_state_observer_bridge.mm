@@ -164,6 +164,12 @@ void WebStateObserverBridge::WebStateRealized(web::WebState* web_state) {
   }
 }
 
+void WebStateObserverBridge::WebStateUnrealized(web::WebState* web_state) {
+  if ([observer_ respondsToSelector:@selector(webStateUnrealized:)]) {
+    [observer_ webStateUnrealized:web_state];
+  }
+}
+
 void WebStateObserverBridge::WebStateDestroyed(web::WebState* web_state) {
   SEL selector = @selector(webStateDestroyed:);
   if ([observer_ respondsToSelector:selector]) {